@@ -75,19 +75,9 @@ macro(find_boost)
     "1.61.1" "1.61.0" "1.61"
     "1.60.1" "1.60.0" "1.60"
     "1.59.1" "1.59.0" "1.59"
-    "1.58.1" "1.58.0" "1.58"
-    "1.57.1" "1.57.0" "1.57"
-    "1.56.1" "1.56.0" "1.56"
-    "1.55.1" "1.55.0" "1.55"
-    "1.54.1" "1.54.0" "1.54"
-    "1.53.1" "1.53.0" "1.53"
-    "1.52.1" "1.52.0" "1.52"
-    "1.51.1" "1.51.0" "1.51"
-    "1.50.1" "1.50.0" "1.50"
-    "1.49.1" "1.49.0" "1.49"
-    "1.48.1" "1.48.0" "1.48")
+    "1.58.1" "1.58.0" "1.58")
 
-  find_package(Boost 1.48.0 COMPONENTS ${ARGN})
+  find_package(Boost 1.58.0 COMPONENTS ${ARGN})
 
 endmacro(find_boost)
 
@@ -281,10 +281,12 @@ public:
 
     /// main method of AccurateMassSearchEngine
     /// input map is not const, since it will get annotated with results
+    /// Features are queried in parallel; results are reported in input order.
     void run(FeatureMap&, MzTab&) const;
 
     /// main method of AccurateMassSearchEngine
     /// input map is not const, since it will get annotated with results
+    /// Consensus features are queried in parallel; results are reported in input order.
     /// @note Call init() before calling run!
     void run(ConsensusMap&, MzTab&) const;
 
@@ -346,6 +348,9 @@ private:
     void parseAdductsFile_(const String& filename, std::vector<AdductInfo>& result);
     void searchMass_(double neutral_query_mass, double diff_mass, std::pair<Size, Size>& hit_indices) const;
 
+    /// parses the formula of each DB entry once and records for each adduct which entries are compatible (see AdductInfo::isCompatible); entries with unparsable formulas are reported with a warning and treated as incompatible
+    void computeAdductCompatibility_(const std::vector<AdductInfo>& adducts, std::vector<std::vector<bool> >& compatible) const;
+
     /// add search results to a Consensus/Feature
     void annotate_(const std::vector<AccurateMassSearchResult>&, BaseFeature&) const;
 
@@ -410,6 +415,10 @@ private:
     std::vector<AdductInfo> pos_adducts_;
     std::vector<AdductInfo> neg_adducts_;
 
+    /// per adduct (same order as pos_adducts_/neg_adducts_): one flag per entry of mass_mappings_, true if the entry can carry the adduct
+    std::vector<std::vector<bool> > pos_compatible_;
+    std::vector<std::vector<bool> > neg_compatible_;
+
     String database_name_;
     String database_version_;
 
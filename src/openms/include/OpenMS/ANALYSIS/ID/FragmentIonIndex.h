@@ -0,0 +1,193 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/ANALYSIS/RNPXL/ModifiedPeptideGenerator.h>
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+#include <OpenMS/KERNEL/StandardTypes.h>
+
+#include <utility>
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Inverted index from fragment ion m/z to candidate peptides
+
+    The index holds all (modified) peptides of a database, sorted by mass,
+    and a postings list for each fragment m/z bin: the peptides that
+    produce a b or y ion (charge 1, including b1) in that bin. The
+    postings of each bin are sorted by peptide, so the peptides within a
+    precursor mass window are a contiguous part of every postings list.
+
+    Spectra are pre-scored by counting, for each candidate peptide in a
+    precursor mass window, the spectrum peaks that fall into one of its
+    fragment bins (countSharedPeaks()). Search engines can then compute
+    their full score only for the best candidates.
+
+    Peptides are identified by their unmodified sequence and the index of
+    their modified variant in the output of
+    ModifiedPeptideGenerator::applyVariableModifications (after applying
+    the fixed modifications), so the modified sequence can be recreated.
+
+    The index can be stored in a binary file and loaded again. A settings
+    string (e.g. describing the database and modifications used for
+    building) is stored along with it, so callers can check whether a
+    stored index can be reused.
+  */
+  class OPENMS_DLLAPI FragmentIonIndex
+  {
+  public:
+
+    /// A (modified) peptide in the index
+    struct Peptide
+    {
+      UInt32 sequence_index; ///< index of the unmodified sequence (see getSequence())
+      UInt32 modification_index; ///< index of the modified variant
+      double mass; ///< monoisotopic mass (uncharged)
+    };
+
+    /// Default constructor (empty index)
+    FragmentIonIndex();
+
+    /**
+      @brief Builds the index
+
+      @param sequences Unmodified peptide sequences (duplicates are removed)
+      @param fixed_modifications Fixed modifications (see ModifiedPeptideGenerator::getModifications)
+      @param variable_modifications Variable modifications
+      @param max_variable_mods_per_peptide Maximum number of variable modifications per peptide
+      @param bin_size Width of the fragment m/z bins (in Th)
+
+      @exception Exception::InvalidParameter if @p bin_size is not positive and finite, or too small to index all fragment m/z values
+    */
+    void build(std::vector<String> sequences,
+               const ModifiedPeptideGenerator::MapToResidueType& fixed_modifications,
+               const ModifiedPeptideGenerator::MapToResidueType& variable_modifications,
+               Size max_variable_mods_per_peptide,
+               double bin_size);
+
+    /**
+      @brief Stores the index in a binary file
+
+      @exception Exception::UnableToCreateFile if the file cannot be written
+    */
+    void store(const String& filename) const;
+
+    /**
+      @brief Loads an index stored with store()
+
+      @exception Exception::FileNotFound if the file does not exist
+      @exception Exception::ParseError if the file is not a valid index file
+    */
+    void load(const String& filename);
+
+    /// sets the settings string stored with the index
+    void setSettings(const String& settings);
+
+    /// returns the settings string stored with the index
+    const String& getSettings() const;
+
+    /// returns the width of the fragment m/z bins
+    double getBinSize() const;
+
+    /// returns the number of (modified) peptides
+    Size size() const;
+
+    /// returns the (modified) peptide with index @p index (peptides are sorted by mass)
+    const Peptide& getPeptide(Size index) const;
+
+    /// returns the unmodified sequence with index @p sequence_index
+    const String& getSequence(Size sequence_index) const;
+
+    /**
+      @brief Recreates the modified sequence of peptide @p index
+
+      @param fixed_modifications Same fixed modifications as used for building
+      @param variable_modifications Same variable modifications as used for building
+      @param max_variable_mods_per_peptide Same value as used for building
+    */
+    AASequence getModifiedSequence(Size index,
+                                   const ModifiedPeptideGenerator::MapToResidueType& fixed_modifications,
+                                   const ModifiedPeptideGenerator::MapToResidueType& variable_modifications,
+                                   Size max_variable_mods_per_peptide) const;
+
+    /// returns the range [first, last) of peptides with masses in [@p min_mass, @p max_mass]
+    std::pair<Size, Size> getPeptideRange(double min_mass, double max_mass) const;
+
+    /**
+      @brief Counts the peaks of @p spectrum shared with each peptide in [@p first, @p last)
+
+      A peak is shared with a peptide if one of the peptide's fragment bins
+      overlaps the tolerance window around the peak. Counts are approximate
+      (within one bin width) and meant for pre-selecting candidates.
+
+      @param spectrum Spectrum (charge 1 fragment m/z, sorted by m/z)
+      @param fragment_mass_tolerance Fragment mass tolerance
+      @param fragment_mass_tolerance_unit_ppm Unit of the tolerance is ppm (or Th if false)
+      @param first First peptide
+      @param last Peptide after the last one
+      @param counts Receives the counts; entry i belongs to peptide @p first + i
+    */
+    void countSharedPeaks(const PeakSpectrum& spectrum,
+                          double fragment_mass_tolerance,
+                          bool fragment_mass_tolerance_unit_ppm,
+                          Size first,
+                          Size last,
+                          std::vector<UInt32>& counts) const;
+
+  protected:
+
+    /// unmodified sequences (sorted)
+    std::vector<String> sequences_;
+
+    /// (modified) peptides (sorted by mass)
+    std::vector<Peptide> peptides_;
+
+    /// start of the postings of each bin (plus end of the last bin)
+    std::vector<UInt64> bin_offsets_;
+
+    /// peptide indices of all bins, consecutively
+    std::vector<UInt32> postings_;
+
+    /// width of the fragment m/z bins
+    double bin_size_;
+
+    /// settings used to build the index
+    String settings_;
+  };
+
+} // namespace OpenMS
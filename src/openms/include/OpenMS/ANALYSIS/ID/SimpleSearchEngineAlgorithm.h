@@ -35,7 +35,10 @@
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 #include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
 
+#include <OpenMS/ANALYSIS/ID/FragmentIonIndex.h>
 #include <OpenMS/ANALYSIS/RNPXL/ModifiedPeptideGenerator.h>
+#include <OpenMS/CHEMISTRY/ProteaseDigestion.h>
+#include <OpenMS/FORMAT/FASTAFile.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
 
 #include <vector>
@@ -88,6 +91,32 @@ class OPENMS_DLLAPI SimpleSearchEngineAlgorithm :
     /// @brief filter, deisotope, decharge spectra
     static void preprocessSpectra_(PeakMap& exp, double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm);
 
+    /**
+      @brief load the fragment ion index (if stored with matching settings) or build it from the digested database
+
+      The index is stored in the file given by "fragment_index:file" (if set) after building.
+    */
+    void createFragmentIndex_(const std::vector<FASTAFile::FASTAEntry>& fasta_db,
+      const ProteaseDigestion& digestor,
+      const ModifiedPeptideGenerator::MapToResidueType& fixed_modifications,
+      const ModifiedPeptideGenerator::MapToResidueType& variable_modifications,
+      FragmentIonIndex& index) const;
+
+    /**
+      @brief score spectra against the peptides of a fragment ion index
+
+      Candidates within the precursor tolerance are pre-scored by the number of shared fragment peaks.
+      The best "fragment_index:max_candidates" of them are scored with the HyperScore.
+      Sequences of the stored hits point into @p index.
+    */
+    void searchFragmentIndex_(const PeakMap& spectra,
+      const FragmentIonIndex& index,
+      const ModifiedPeptideGenerator::MapToResidueType& fixed_modifications,
+      const ModifiedPeptideGenerator::MapToResidueType& variable_modifications,
+      bool precursor_mass_tolerance_unit_ppm,
+      bool fragment_mass_tolerance_unit_ppm,
+      std::vector<std::vector<AnnotatedHit_> >& annotated_hits) const;
+
     /// @brief filter and annotate search results
     /// most of the parameters are used to properly add meta data to the id objects
     void postProcessHits_(const PeakMap& exp, 
@@ -141,6 +170,11 @@ class OPENMS_DLLAPI SimpleSearchEngineAlgorithm :
     String peptide_motif_;
 
     Size report_top_hits_;
+
+    bool fragment_index_use_;
+    String fragment_index_file_;
+    double fragment_index_bin_size_;
+    Size fragment_index_max_candidates_;
 };
 
 } // namespace
@@ -19,6 +19,7 @@ ConsensusIDAlgorithmSimilarity.h
 ConsensusIDAlgorithmWorst.h
 ConsensusMapMergerAlgorithm.h
 FalseDiscoveryRate.h
+FragmentIonIndex.h
 FIAMSDataProcessor.h
 FIAMSScheduler.h
 HiddenMarkovModel.h
@@ -43,6 +43,10 @@
 
 #include <OpenMS/KERNEL/ConversionHelper.h>
 
+#include <exception>
+#include <limits>
+#include <vector>
+
 namespace OpenMS
 {
   /**
@@ -82,6 +86,45 @@ public:
     void align(const PeakMap& map, TransformationDescription& trafo);
     void align(const ConsensusMap& map, TransformationDescription& trafo);
 
+    /**
+      @brief Aligns several maps to the reference
+
+      The maps are aligned concurrently (if there is more than one; otherwise
+      the pose clustering of the single map runs in parallel).
+      @p trafos is resized to the number of maps.
+    */
+    template <typename MapType>
+    void align(const std::vector<MapType>& maps, std::vector<TransformationDescription>& trafos)
+    {
+      trafos.assign(maps.size(), TransformationDescription());
+
+      Size error_idx = std::numeric_limits<Size>::max();
+      std::exception_ptr error;
+
+#pragma omp parallel for schedule(dynamic, 1) if (maps.size() > 1)
+      for (SignedSize i = 0; i < (SignedSize)maps.size(); ++i)
+      {
+        try
+        {
+          align(maps[i], trafos[i]);
+        }
+        catch (...)
+        {
+#pragma omp critical (MapAlignmentAlgorithmPoseClustering_error)
+          if ((Size)i < error_idx)
+          {
+            error_idx = i;
+            error = std::current_exception();
+          }
+        }
+      }
+
+      if (error)
+      {
+        std::rethrow_exception(error);
+      }
+    }
+
     /// Sets the reference for the alignment
     template <typename MapType>
     void setReference(const MapType& map)
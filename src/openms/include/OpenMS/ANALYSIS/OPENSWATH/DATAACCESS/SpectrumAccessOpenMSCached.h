@@ -55,10 +55,10 @@ namespace OpenMS
     (ISpectrumAccess) using the CachedmzML class which is able to read and
     write a cached mzML file.
 
-    @note This implementation is @a not thread-safe since it keeps internally a
-    single file access pointer which it moves when accessing a specific
-    data item. The caller is responsible to ensure that access is performed
-    atomically.
+    @note Data items are read from a read-only memory mapping of the cached
+    file which is shared with all (light) clones of an object. Concurrent
+    access to spectra and chromatograms from multiple threads is safe and
+    does not require a separate file handle per thread.
 
   */
   class OPENMS_DLLAPI SpectrumAccessOpenMSCached :
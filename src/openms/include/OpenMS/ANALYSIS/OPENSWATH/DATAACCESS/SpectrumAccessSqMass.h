@@ -70,6 +70,10 @@ namespace OpenMS
    * sqlite3 supports multiple parallel read threads as long as they use a
    * different db connection.
    *
+   * The native id, MS level and retention time of all spectra are read once
+   * on construction (and shared between copies), so getSpectrumMetaById and
+   * getSpectraByRT are answered from memory without accessing the database.
+   *
    * Sample usage:
    *
    *
@@ -90,12 +94,26 @@ namespace OpenMS
 public:
     typedef OpenMS::MSSpectrum MSSpectrumType;
     typedef OpenMS::MSChromatogram MSChromatogramType;
+    /// Meta data of all spectra in a file (see MzMLSqliteHandler::getSpectraRTIndex)
+    typedef boost::shared_ptr<const std::vector<Internal::MzMLSqliteHandler::SpectrumRTEntry> > SpectraRTIndexPtr;
 
     /// Constructor
     SpectrumAccessSqMass(const OpenMS::Internal::MzMLSqliteHandler& handler);
 
     SpectrumAccessSqMass(const OpenMS::Internal::MzMLSqliteHandler& handler, const std::vector<int> & indices);
 
+    /**
+      @brief Constructor using meta data that was already read from the file
+
+      Use this to create several accessors for subsets of the same file (e.g.
+      one per SWATH window) without reading the SPECTRUM table for each of them.
+
+      @param handler Access to the sqMass file
+      @param indices Subset of spectra (all spectra if empty)
+      @param spectra_rt Result of handler.getSpectraRTIndex() (shared, not copied)
+    */
+    SpectrumAccessSqMass(const OpenMS::Internal::MzMLSqliteHandler& handler, const std::vector<int> & indices, const SpectraRTIndexPtr& spectra_rt);
+
     SpectrumAccessSqMass(const SpectrumAccessSqMass& sp, const std::vector<int>& indices);
 
     /// Destructor
@@ -126,10 +144,19 @@ public:
 
 private:
 
+    /// Initialize the in-memory meta data and retention time index of the selected spectra
+    void initRTIndex_(const SpectraRTIndexPtr& spectra_rt);
+
     /// Access to underlying sqMass file
     OpenMS::Internal::MzMLSqliteHandler handler_;
     /// Optional subset of spectral indices
     std::vector<int> sidx_;
+    /// Meta data of all spectra in the file (ordered by spectrum id, shared between copies)
+    SpectraRTIndexPtr spectra_rt_;
+    /// Meta data entry (in spectra_rt_) for each accessible spectrum
+    std::vector<Size> meta_idx_;
+    /// Pairs of (retention time, accessible spectrum index), sorted by retention time
+    std::vector<std::pair<double, Size> > rt_index_;
   };
 } //end namespace OpenMS
 
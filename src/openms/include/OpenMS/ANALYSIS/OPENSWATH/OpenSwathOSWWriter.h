@@ -42,6 +42,7 @@
 #include <OpenMS/KERNEL/FeatureMap.h>
 
 #include <fstream>
+#include <memory>
 
 namespace OpenMS
 {
@@ -122,8 +123,24 @@ namespace OpenMS
     bool sonar_;
     bool enable_uis_scoring_;
 
+    /// Queue and thread of the background writer (see writeLines())
+    struct WriteQueue_;
+    std::unique_ptr<WriteQueue_> queue_;
+
+    /// Writes all pending output and stops the background writer
+    void stopWriter_();
+
   public:
 
+    /// Statistics of the background writer
+    struct WriterStatistics
+    {
+      Size batches_written = 0; ///< number of batches (writeLines() calls) written to disk
+      Size transactions = 0; ///< number of database transactions used to write them
+      Size max_queue_depth = 0; ///< largest number of batches waiting to be written
+      Size producer_waits = 0; ///< how often writeLines() had to wait because the queue was full
+    };
+
     OpenSwathOSWWriter(const String& output_filename,
                        const UInt64 run_id,
                        const String& input_filename = "inputfile",
@@ -131,6 +148,20 @@ namespace OpenMS
                        bool sonar = false,
                        bool uis_scores = false);
 
+    /// Copy constructor (copies the settings, not the pending output)
+    OpenSwathOSWWriter(const OpenSwathOSWWriter& rhs);
+
+    /// Assignment operator (copies the settings, pending output is written first)
+    OpenSwathOSWWriter& operator=(const OpenSwathOSWWriter& rhs);
+
+    /**
+      @brief Destructor (waits until all pending output is written)
+
+      A destructor cannot throw, so write errors not yet reported are only
+      logged here. Call flush() before to have them thrown.
+    */
+    ~OpenSwathOSWWriter();
+
     bool isActive() const;
 
     /**
@@ -186,18 +217,34 @@ namespace OpenMS
     /**
      * @brief Write data to disk
      *
-     * Takes a set of pre-prepared data statements from prepareLine and flushes them to disk
-     * 
+     * Takes a set of pre-prepared data statements from prepareLine and
+     * queues them for writing. A background thread keeps a single database
+     * connection open and writes all batches queued in the meantime in one
+     * transaction. If too many batches are pending, this call blocks until
+     * the writer has caught up.
+     *
      * @param to_osw_output Statements generated by prepareLine
      *
-     * @note Try to call this function as little as possible (it opens a new
-     * database connection each time)
+     * @note This function is thread-safe.
      *
-     * @note Only call inside an OpenMP critical section
+     * @throw Exception::SqlOperationFailed or Exception::IllegalArgument if
+     * writing a previously queued batch failed
      *
      */
     void writeLines(const std::vector<String>& to_osw_output);
 
+    /**
+     * @brief Wait until all queued data is written to disk
+     *
+     * @throw Exception::SqlOperationFailed or Exception::IllegalArgument if
+     * writing failed
+     *
+     */
+    void flush();
+
+    /// Statistics of the background writer (queue depth and backpressure)
+    WriterStatistics getStatistics() const;
+
   };
 
 }
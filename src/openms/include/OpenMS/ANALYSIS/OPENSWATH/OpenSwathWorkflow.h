@@ -119,13 +119,8 @@ protected:
     /** @brief Constructor
      *
      *  @param use_ms1_traces Whether to use MS1 data
-     *  @param threads_outer_loop How many threads should be used for the outer
-     *  loop (-1 will use all threads in the outer loop)
-     *
-     *  @note The total number of threads should be divisible by this number
-     *  (e.g. use 8 in outer loop if you have 24 threads in total and 3 will be
-     *  used for the inner loop).
-     *
+     *  @param threads_outer_loop Deprecated and ignored, windows and batches
+     *  are scheduled jointly (see OpenSwathWorkflow::performExtraction())
      *
      **/
     OpenSwathWorkflowBase(bool use_ms1_traces, bool use_ms1_ion_mobility, bool prm, int threads_outer_loop) :
@@ -205,11 +200,7 @@ protected:
 
     /** @brief How many threads should be used for the outer loop
      *
-     *  @note A value of -1 will use all threads in the outer loop
-     *
-     *  @note The total number of threads should be divisible by this number
-     *  (e.g. use 8 in outer loop if you have 24 threads in total and 3 will be
-     *  used for the inner loop).
+     *  @deprecated No longer used, kept for API compatibility
      *
      **/
     int threads_outer_loop_;
@@ -367,9 +358,8 @@ protected:
    *
    *    - Obtain precursor ion chromatograms (if enabled) through MS1Extraction_()
    *    - Perform scoring of precursor ion chromatograms if no MS2 is given
-   *    - Iterate through each SWATH-MS window:
-   *      - Select which transitions to extract (proceed in batches) using OpenSwathHelper::selectSwathTransitions()
-   *      - Iterate through each batch of transitions:
+   *    - For each SWATH-MS window, select which transitions to extract using OpenSwathHelper::selectSwathTransitions()
+   *    - Split the transitions of each window into batches; every (window, batch) pair is processed as an independent task:
    *        - Extract current batch of transitions from current SWATH window:
    *          - Select transitions for current batch (see selectCompoundsForBatch_())
    *          - Prepare transition extraction (see prepareExtractionCoordinates_())
@@ -391,15 +381,10 @@ protected:
      *
      *  @param use_ms1_traces Whether to use MS1 data
      *  @param use_ms1_ion_mobility Whether to use ion mobility extraction on MS1 traces
-     *  @param threads_outer_loop How many threads should be used for the outer
-     *  loop (-1 will use all threads in the outer loop)
+     *  @param threads_outer_loop Deprecated and ignored, windows and batches
+     *  are scheduled jointly (see performExtraction())
      *  @param prm Whether data is acquired in targeted DIA (e.g. PRM mode) with potentially overlapping windows
      *
-     *  @note The total number of threads should be divisible by this number
-     *  (e.g. use 8 in outer loop if you have 24 threads in total and 3 will be
-     *  used for the inner loop).
-     *
-     *
      **/
     OpenSwathWorkflow(bool use_ms1_traces, bool use_ms1_ion_mobility, bool prm, int threads_outer_loop) :
       OpenSwathWorkflowBase(use_ms1_traces, use_ms1_ion_mobility, prm, threads_outer_loop)
@@ -429,6 +414,9 @@ protected:
      * \p load_into_memory where larger batch sizes increase memory and
      * potentially decrease the utility of parallelization while loading data
      * into memory will increase memory usage but decrease execution time.
+     * All batches of all windows are distributed dynamically over the
+     * available threads; a window is only held in memory while some of its
+     * batches are being processed.
      *
     */
     void performExtraction(const std::vector< OpenSwath::SwathMap > & swath_maps,
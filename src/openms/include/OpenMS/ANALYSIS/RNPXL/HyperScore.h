@@ -41,6 +41,7 @@
 
 namespace OpenMS
 {
+  class FragmentIonLadder;
 
 /**
  *  @brief An implementation of the X!Tandem HyperScore PSM scoring function
@@ -63,9 +64,19 @@ struct OPENMS_DLLAPI HyperScore
 
   static double compute(double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm, const PeakSpectrum& exp_spectrum, const PeakSpectrum& theo_spectrum);
 
+  /** @brief compute the (ln transformed) X!Tandem HyperScore for a b/y ion ladder
+   *
+   *  Same as above for a theoretical spectrum generated with FragmentIonLadder (all ions have intensity 1).
+   *  Ion types are read from the ladder, so no string annotations are needed.
+   */
+  static double compute(double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm, const PeakSpectrum& exp_spectrum, const FragmentIonLadder& theo_ladder);
+
   private:
     /// helper to compute the log factorial
     static double logfactorial_(const int x, int base = 2);
+
+    /// HyperScore from the dot product and the numbers of matching b and y ions
+    static double fromCounts_(double dot_product, int b_ion_count, int y_ion_count);
 };
 
 }
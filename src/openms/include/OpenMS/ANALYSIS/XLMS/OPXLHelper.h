@@ -40,6 +40,7 @@
 #include <OpenMS/FORMAT/FASTAFile.h>
 #include <OpenMS/CHEMISTRY/EnzymaticDigestion.h>
 #include <OpenMS/ANALYSIS/RNPXL/ModifiedPeptideGenerator.h>
+#include <functional>
 #include <numeric>
 
 namespace OpenMS
@@ -111,6 +112,27 @@ namespace OpenMS
        */
       static std::vector<OPXLDataStructs::XLPrecursor> enumerateCrossLinksAndMasses(const std::vector<OPXLDataStructs::AASeqWithMass>&  peptides, double cross_link_mass_light, const DoubleList& cross_link_mass_mono_link, const StringList& cross_link_residue1, const StringList& cross_link_residue2, const std::vector< double >& spectrum_precursors, std::vector< int >& precursor_correction_positions, double precursor_mass_tolerance, bool precursor_mass_tolerance_unit_ppm);
 
+      /**
+       * @brief Enumerates all possible combinations containing a cross-link, without storing all of them at once
+
+          Enumerates the same candidates as the overload returning a vector, but passes them to @p process_batch in batches
+          of at most @p batch_size candidates. The batch is cleared afterwards, so memory usage does not depend on the
+          total number of candidates. Peptide pairs are enumerated per precursor mass with a two-pointer sweep over the
+          mass-sorted peptides, which only visits alpha peptides that can have a matching (heavier) beta peptide.
+
+       * @param peptides The peptides with precomputed masses from the digestDatabase function, sorted by mass
+       * @param cross_link_mass_light Mass of the cross-linker, only the light one if a labeled linker is used
+       * @param cross_link_mass_mono_link A list of possible masses for the cross-link, if it is attached to a peptide on one side
+       * @param cross_link_residue1 A list of residues, to which the first side of the linker can react
+       * @param cross_link_residue2 A list of residues, to which the second side of the linker can react
+       * @param spectrum_precursors A vector of MS2 precursor masses. Used to filter out candidates.
+       * @param precursor_mass_tolerance The precursor mass tolerance
+       * @param precursor_mass_tolerance_unit_ppm The unit of the precursor mass tolerance ("Da" or "ppm")
+       * @param batch_size The maximal number of candidates per batch
+       * @param process_batch Called for each batch with the candidates and the positions of the used precursor corrections (may be modified)
+       */
+      static void enumerateCrossLinksAndMasses(const std::vector<OPXLDataStructs::AASeqWithMass>&  peptides, double cross_link_mass_light, const DoubleList& cross_link_mass_mono_link, const StringList& cross_link_residue1, const StringList& cross_link_residue2, const std::vector< double >& spectrum_precursors, double precursor_mass_tolerance, bool precursor_mass_tolerance_unit_ppm, Size batch_size, const std::function<void(std::vector<OPXLDataStructs::XLPrecursor>&, std::vector< int >&)>& process_batch);
+
       /**
        * @brief Digests a database with the given EnzymaticDigestion settings and precomputes masses for all peptides
 
@@ -270,6 +292,31 @@ namespace OpenMS
                                                                                                 bool use_sequence_tags = false,
                                                                                                 const std::vector<std::string>& tags = std::vector<std::string>());
 
+      /**
+       * @brief Searches for cross-link candidates for a MS/MS spectrum, without storing all of them at once
+
+          Same as the overload returning a vector, but the candidates are enumerated in batches of at most @p batch_size
+          peptide pairs, built into ProteinProteinCrossLinks and passed to @p process_batch. Callers can score each batch
+          and keep only the best matches.
+
+       * @param batch_size The maximal number of peptide pairs (and mono- or loop-linked peptides) per batch
+       * @param process_batch Called for each non-empty batch of candidates (may be modified)
+       */
+      static void collectPrecursorCandidates(const IntList& precursor_correction_steps,
+                                             double precursor_mass,
+                                             double precursor_mass_tolerance,
+                                             bool precursor_mass_tolerance_unit_ppm,
+                                             const std::vector<OPXLDataStructs::AASeqWithMass>& filtered_peptide_masses,
+                                             double cross_link_mass,
+                                             const DoubleList& cross_link_mass_mono_link,
+                                             const StringList& cross_link_residue1,
+                                             const StringList& cross_link_residue2,
+                                             const String& cross_link_name,
+                                             bool use_sequence_tags,
+                                             const std::vector<std::string>& tags,
+                                             Size batch_size,
+                                             const std::function<void(std::vector<OPXLDataStructs::ProteinProteinCrossLink>&)>& process_batch);
+
       /**
        * @brief Computes the mass error of a precursor mass to a hit
 
@@ -177,6 +177,7 @@ private:
     String enzyme_name_;
 
     Int number_top_hits_;
+    Size candidate_batch_size_;
     String deisotope_mode_;
 
     String add_y_ions_;
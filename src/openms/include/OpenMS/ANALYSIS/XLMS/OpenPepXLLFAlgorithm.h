@@ -164,6 +164,7 @@ private:
     String enzyme_name_;
 
     Int number_top_hits_;
+    Size candidate_batch_size_;
     String deisotope_mode_;
     bool use_sequence_tags_;
     Size sequence_tag_min_length_;
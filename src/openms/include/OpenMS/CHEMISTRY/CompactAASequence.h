@@ -0,0 +1,192 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CHEMISTRY/AASequence.h>
+#include <OpenMS/CHEMISTRY/Residue.h>
+#include <OpenMS/CONCEPT/Types.h>
+
+#include <functional>
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Compact, read-only peptide representation with cached prefix masses
+
+    Search engines weigh the same candidate peptides (and their prefixes and
+    suffixes) many times per spectrum. With AASequence, every such query
+    re-sums the residue masses. This class is built once from an AASequence
+    and stores:
+
+    - the residues as interned IDs (each distinct Residue instance, i.e.
+      amino acid plus modification, gets a process-wide unique ID),
+    - the cumulative internal residue masses of all prefixes,
+    - a fingerprint hash of the sequence including terminal modifications.
+
+    Masses of the full sequence and of all prefix and suffix ions are then
+    computed in constant time. They are equal (up to floating-point rounding)
+    to the masses computed by AASequence for the same sequence, prefix or
+    suffix. Use toAASequence() to convert back.
+
+    @note Like AASequence::getMonoWeight, mass queries throw
+    Exception::InvalidValue if the queried part of the sequence contains the
+    unknown amino acid 'X' without a mass.
+  */
+  class OPENMS_DLLAPI CompactAASequence
+  {
+  public:
+
+    /// Interned residue ID
+    typedef UInt32 ResidueID;
+
+    /// Default constructor (empty sequence)
+    CompactAASequence();
+
+    /// Constructor from an AASequence
+    explicit CompactAASequence(const AASequence& seq);
+
+    /**
+      @brief Replaces the content with @p seq
+
+      Reuses the allocated storage, so repeatedly assigning peptides of
+      similar length to the same object does not allocate.
+    */
+    void assign(const AASequence& seq);
+
+    /// Converts back to an AASequence
+    AASequence toAASequence() const;
+
+    /// returns the number of residues
+    Size size() const;
+
+    /// returns true if the sequence is empty
+    bool empty() const;
+
+    /// returns the interned residue IDs of the sequence
+    const std::vector<ResidueID>& getResidueIDs() const;
+
+    /// returns the residue at position @p index
+    const Residue& getResidue(Size index) const;
+
+    /// returns the N-terminal modification (or nullptr)
+    const ResidueModification* getNTerminalModification() const;
+
+    /// returns the C-terminal modification (or nullptr)
+    const ResidueModification* getCTerminalModification() const;
+
+    /// returns the fingerprint hash (equal sequences have equal hashes)
+    std::size_t getHash() const;
+
+    /**
+      @brief returns the cumulative internal residue masses
+
+      Entry i is the summed internal monoisotopic mass of the first i
+      residues (without terminal modifications), i.e. the vector has size()
+      + 1 entries and starts with 0.
+    */
+    const std::vector<double>& getPrefixMasses() const;
+
+    /// monoisotopic weight of the whole sequence, same as AASequence::getMonoWeight
+    double getMonoWeight(Residue::ResidueType type = Residue::Full, Int charge = 0) const;
+
+    /**
+      @brief monoisotopic weight of the prefix of length @p length
+
+      Same as AASequence::getPrefix(length).getMonoWeight(type, charge), e.g.
+      the b ion of length 3 is getPrefixMonoWeight(3, Residue::BIon, 1).
+      Returns 0 for length 0.
+
+      @exception Exception::IndexOverflow if @p length is larger than size()
+    */
+    double getPrefixMonoWeight(Size length, Residue::ResidueType type = Residue::Full, Int charge = 0) const;
+
+    /**
+      @brief monoisotopic weight of the suffix of length @p length
+
+      Same as AASequence::getSuffix(length).getMonoWeight(type, charge), e.g.
+      the y ion of length 3 is getSuffixMonoWeight(3, Residue::YIon, 1).
+      Returns 0 for length 0.
+
+      @exception Exception::IndexOverflow if @p length is larger than size()
+    */
+    double getSuffixMonoWeight(Size length, Residue::ResidueType type = Residue::Full, Int charge = 0) const;
+
+    /// equality operator
+    bool operator==(const CompactAASequence& rhs) const;
+
+    /// inequality operator
+    bool operator!=(const CompactAASequence& rhs) const;
+
+    /// returns the interned ID of @p residue (assigning a new one if necessary)
+    static ResidueID getResidueID(const Residue* residue);
+
+    /// returns the residue with interned ID @p id
+    static const Residue* getResidueByID(ResidueID id);
+
+  protected:
+
+    /// mass of the residues in [begin, end) plus terminal modifications and ion type
+    double getMonoWeight_(Size begin, Size end, bool n_term, bool c_term, Residue::ResidueType type, Int charge) const;
+
+    std::vector<ResidueID> residues_;
+
+    std::vector<double> prefix_masses_;
+
+    const ResidueModification* n_term_mod_;
+
+    const ResidueModification* c_term_mod_;
+
+    /// position of the first and last unknown residue 'X' (size() if none)
+    Size first_unknown_;
+
+    Size last_unknown_;
+
+    std::size_t hash_;
+  };
+
+} // namespace OpenMS
+
+namespace std
+{
+  /// hash for CompactAASequence
+  template <> struct hash<OpenMS::CompactAASequence>
+  {
+    std::size_t operator()(const OpenMS::CompactAASequence& seq) const
+    {
+      return seq.getHash();
+    }
+  };
+} // namespace std
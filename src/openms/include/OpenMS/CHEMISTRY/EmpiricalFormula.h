@@ -42,6 +42,8 @@
 
 #include <OpenMS/CONCEPT/Types.h>
 
+#include <boost/container/small_vector.hpp>
+
 namespace OpenMS
 {
   class String;
@@ -83,18 +85,24 @@ namespace OpenMS
   {
 
 protected:
-	  /// Internal typedef for the used map type
-	  typedef std::map<const Element*, SignedSize> MapType_;
+	  /**
+	    @brief Internal typedef for the element storage
+
+	    (element, count) pairs sorted by element (i.e. in the same order as a std::map
+	    keyed by element). Up to six elements (e.g. CHNOPS plus one more) are stored
+	    inline, so typical formulas never allocate.
+	  */
+	  typedef boost::container::small_vector<std::pair<const Element*, SignedSize>, 6> MapType_;
 
 public:
     /** @name Typedefs
     */
     //@{
-    /// Iterators
+    /// Iterators (read-only, writing an element would break the sort order of the storage)
     typedef MapType_::const_iterator ConstIterator;
     typedef MapType_::const_iterator const_iterator;
-    typedef MapType_::iterator Iterator;
-    typedef MapType_::iterator iterator;
+    typedef MapType_::const_iterator Iterator;
+    typedef MapType_::const_iterator iterator;
     //@}
 
     /** @name Constructors and Destructors
@@ -272,10 +280,6 @@ public:
     inline ConstIterator begin() const { return formula_.begin(); }
 
     inline ConstIterator end() const { return formula_.end(); }
-    
-    inline Iterator begin() { return formula_.begin(); }
-
-    inline Iterator end() { return formula_.end(); }
     //@}
 
 protected:
@@ -283,11 +287,17 @@ protected:
     /// remove elements with count 0
     void removeZeroedElements_();
 
+    /// returns the position of @p element in @p ef, or ef.end() if it is not contained
+    static MapType_::const_iterator find_(const MapType_& ef, const Element* element);
+
+    /// adds @p number atoms of @p element to @p ef (inserting it if necessary; zero counts are kept)
+    static void add_(MapType_& ef, const Element* element, SignedSize number);
+
     MapType_ formula_;
 
     Int charge_;
 
-    Int parseFormula_(std::map<const Element*, SignedSize>& ef, const String& formula) const;
+    Int parseFormula_(MapType_& ef, const String& formula) const;
 
   };
 
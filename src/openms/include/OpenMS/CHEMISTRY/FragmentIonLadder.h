@@ -0,0 +1,199 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CHEMISTRY/CompactAASequence.h>
+#include <OpenMS/CHEMISTRY/Residue.h>
+#include <OpenMS/CHEMISTRY/ResidueModification.h>
+#include <OpenMS/CONCEPT/Constants.h>
+#include <OpenMS/CONCEPT/Types.h>
+
+#include <limits>
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Sorted b/y ion ladder of a peptide, stored as parallel arrays
+
+    Fast alternative to TheoreticalSpectrumGenerator for search engines that
+    only need the m/z values of the plain prefix (b) and suffix (y) ions. The
+    ions are written to the public arrays (m/z, ion type, ion number and
+    charge), sorted by m/z. No ion names or data arrays are created, and the
+    arrays are reused, so generating ladders for many peptides with the same
+    object does not allocate once the arrays have grown to the largest
+    peptide.
+
+    The ion series and the charge range are template parameters of
+    generate(), so the generation loop is specialized for each combination.
+    With the same settings, the ions equal those of
+    TheoreticalSpectrumGenerator::getSpectrum with "add_b_ions" and
+    "add_y_ions" (and no other ion types, losses or isotopes) up to
+    floating-point rounding. All ions have intensity 1, like the default b
+    and y ion intensities of TheoreticalSpectrumGenerator.
+  */
+  class OPENMS_DLLAPI FragmentIonLadder
+  {
+  public:
+
+    /// m/z of the ions (sorted ascending)
+    std::vector<double> mz;
+
+    /// ion type of each ion (Residue::BIon or Residue::YIon)
+    std::vector<Residue::ResidueType> ion_type;
+
+    /// ion number of each ion (i.e. the number of residues in the fragment)
+    std::vector<UInt32> ion_number;
+
+    /// charge of each ion
+    std::vector<Int> charge;
+
+    /// returns the number of ions
+    Size size() const
+    {
+      return mz.size();
+    }
+
+    /// returns true if the ladder contains no ions
+    bool empty() const
+    {
+      return mz.empty();
+    }
+
+    /// removes all ions (keeps the allocated storage)
+    void clear();
+
+    /**
+      @brief Replaces the content with the ion ladder of @p peptide
+
+      @tparam B_IONS Add b ions (prefixes of length 2 (or 1, see @p add_first_prefix_ion) to size() - 1)
+      @tparam Y_IONS Add y ions (suffixes of length 1 to size() - 1)
+      @tparam MIN_CHARGE Lowest ion charge
+      @tparam MAX_CHARGE Highest ion charge
+      @param peptide The peptide
+      @param add_first_prefix_ion Add the b1 ion (like the "add_first_prefix_ion" parameter of TheoreticalSpectrumGenerator)
+    */
+    template <bool B_IONS, bool Y_IONS, int MIN_CHARGE, int MAX_CHARGE>
+    void generate(const CompactAASequence& peptide, bool add_first_prefix_ion = false)
+    {
+      static_assert(B_IONS || Y_IONS, "At least one ion series has to be generated.");
+      static_assert(0 < MIN_CHARGE && MIN_CHARGE <= MAX_CHARGE, "Invalid charge range.");
+
+      // one ion stream per series and charge; each stream is sorted by m/z
+      const int n_series = int(B_IONS) + int(Y_IONS);
+      const int n_streams = n_series * (MAX_CHARGE - MIN_CHARGE + 1);
+
+      static const double internal_to_b = Residue::getInternalToBIon().getMonoWeight();
+      static const double internal_to_y = Residue::getInternalToYIon().getMonoWeight();
+
+      clear();
+      const Size n = peptide.size();
+      if (n < 2) return;
+
+      const std::vector<double>& prefix = peptide.getPrefixMasses();
+      const ResidueModification* n_term_mod = peptide.getNTerminalModification();
+      const ResidueModification* c_term_mod = peptide.getCTerminalModification();
+      const double b_offset = internal_to_b + (n_term_mod != nullptr ? n_term_mod->getDiffMonoMass() : 0.0);
+      const double y_offset = internal_to_y + (c_term_mod != nullptr ? c_term_mod->getDiffMonoMass() : 0.0);
+
+      Size next[n_streams];
+      double next_mz[n_streams];
+      Size n_ions = 0;
+      for (int s = 0; s < n_streams; ++s)
+      {
+        next[s] = isBStream_<B_IONS, Y_IONS>(s) && !add_first_prefix_ion ? 2 : 1;
+        n_ions += n - next[s];
+        if (next[s] < n)
+        {
+          next_mz[s] = ionMZ_<B_IONS, Y_IONS, MIN_CHARGE>(s, next[s], prefix, b_offset, y_offset);
+        }
+      }
+      reserve_(n_ions);
+
+      // merge the streams
+      for (Size i = 0; i < n_ions; ++i)
+      {
+        int best = -1;
+        double best_mz = std::numeric_limits<double>::max();
+        for (int s = 0; s < n_streams; ++s)
+        {
+          if (next[s] < n && next_mz[s] < best_mz)
+          {
+            best = s;
+            best_mz = next_mz[s];
+          }
+        }
+        mz.push_back(best_mz);
+        ion_type.push_back(isBStream_<B_IONS, Y_IONS>(best) ? Residue::BIon : Residue::YIon);
+        ion_number.push_back(UInt32(next[best]));
+        charge.push_back(MIN_CHARGE + best / n_series);
+        if (++next[best] < n)
+        {
+          next_mz[best] = ionMZ_<B_IONS, Y_IONS, MIN_CHARGE>(best, next[best], prefix, b_offset, y_offset);
+        }
+      }
+
+      // streams are only unsorted for residues with negative masses
+      sortIfUnsorted_();
+    }
+
+  protected:
+
+    /// reserves space for @p n ions in all arrays
+    void reserve_(Size n);
+
+    /// sorts the arrays by m/z if necessary (in place)
+    void sortIfUnsorted_();
+
+    /// returns true if stream @p s holds b ions
+    template <bool B_IONS, bool Y_IONS>
+    static bool isBStream_(int s)
+    {
+      return B_IONS && (!Y_IONS || s % 2 == 0);
+    }
+
+    /// m/z of ion number @p k of stream @p s
+    template <bool B_IONS, bool Y_IONS, int MIN_CHARGE>
+    static double ionMZ_(int s, Size k, const std::vector<double>& prefix, double b_offset, double y_offset)
+    {
+      const int z = MIN_CHARGE + s / (int(B_IONS) + int(Y_IONS));
+      const double mass = isBStream_<B_IONS, Y_IONS>(s) ?
+        prefix[k] + b_offset :
+        prefix.back() - prefix[prefix.size() - 1 - k] + y_offset;
+      return (mass + z * Constants::PROTON_MASS_U) / z;
+    }
+  };
+
+} // namespace OpenMS
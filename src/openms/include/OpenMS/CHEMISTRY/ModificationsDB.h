@@ -71,6 +71,11 @@ namespace OpenMS
       databases. This can be done by providing a path through
       initializeModificationsDB(), however it is important that this is done
       *before* the first call to getInstance().
+
+      All query methods are thread-safe and do not lock: they read an immutable
+      snapshot of the database, which is replaced (copy-on-write) whenever a
+      modification is added. Adding modifications is serialized and therefore
+      comparatively expensive.
   */
   class OPENMS_DLLAPI ModificationsDB
   {
@@ -220,6 +225,47 @@ protected:
     /// Stores the mappings of (unique) names to the modifications
     std::unordered_map<String, std::set<const ResidueModification*> > modification_names_;
 
+    /// Part of the name mappings (names are distributed over the shards by their hash)
+    typedef std::unordered_map<String, std::set<const ResidueModification*> > NameShard_;
+
+    /**
+      @brief Immutable copy of mods_ and modification_names_, which all accessors read without locking
+
+      The name mappings are split into shards, so that adding a modification
+      only copies the few shards containing its names; all other shards are
+      shared with the previous snapshot.
+    */
+    struct Snapshot_
+    {
+      /// number of name shards
+      static const Size NAME_SHARDS = 256;
+
+      std::vector<const ResidueModification*> mods;
+      std::vector<std::shared_ptr<const NameShard_> > name_shards;
+
+      /// returns the shard index of @p name
+      static Size shardOf(const String& name);
+
+      /// returns the modifications with synonym @p name, or nullptr if there are none
+      const std::set<const ResidueModification*>* find(const String& name) const;
+    };
+
+    /// The current snapshot; only ever replaced as a whole (see publishSnapshot_())
+    std::shared_ptr<const Snapshot_> snapshot_;
+
+    /// Returns the current snapshot (stays valid and unchanged while the caller holds it)
+    std::shared_ptr<const Snapshot_> getSnapshot_() const;
+
+    /**
+      @brief Makes the current content of mods_ and modification_names_ visible to readers
+
+      Must be called after every change of mods_ or modification_names_, by the
+      thread holding the writer lock (critical section OpenMS_ModificationsDB).
+      If only @p new_mod was appended to mods_ (and registered under
+      @p changed_names), only the affected shards are copied.
+    */
+    void publishSnapshot_(const ResidueModification* new_mod = nullptr, const std::vector<String>& changed_names = std::vector<String>());
+
     /** @brief Helper function to check if a residue matches the origin for a modification
      *
      * Special cases are handled as follows:
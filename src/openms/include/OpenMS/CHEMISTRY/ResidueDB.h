@@ -39,6 +39,7 @@
 #include <OpenMS/CONCEPT/Macros.h> // for OPENMS_PRECONDITION
 
 #include <map>
+#include <memory>
 #include <set>
 
 namespace OpenMS
@@ -52,6 +53,11 @@ namespace OpenMS
       @brief OpenMS stores a central database of all residues in the ResidueDB.
       All (unmodified) residues are added to the database on construction.
       Modified residues get created and added if getModifiedResidue is called.
+
+      All accessors are thread-safe. Unmodified residues never change after
+      construction and modified residues are read from an immutable snapshot,
+      so lookups do not lock; only the creation of a new modified residue is
+      serialized.
   */
   class OPENMS_DLLAPI ResidueDB
   {
@@ -166,6 +172,9 @@ protected:
 
     /// adds names of single modified residue to the index
     void addModifiedResidueNames_(const Residue*);
+
+    /// makes the current content of residue_mod_names_ and const_modified_residues_ visible to readers (call holding the lock)
+    void publishModifiedResidues_();
     
     std::map<String, std::map<String, const Residue*> > residue_mod_names_;
 
@@ -184,5 +193,15 @@ protected:
     std::array<const Residue*, 256> residue_by_one_letter_code_ = {{nullptr}};
 
     std::map<String, std::set<const Residue*> > residues_by_set_;    
+
+    /// immutable copy of residue_mod_names_ and const_modified_residues_, read without locking
+    struct ModifiedResidues_
+    {
+      std::map<String, std::map<String, const Residue*> > names;
+      std::set<const Residue*> residues;
+    };
+
+    /// the current snapshot; only ever replaced as a whole (see publishModifiedResidues_())
+    std::shared_ptr<const ModifiedResidues_> modified_residues_;
   };
 }
@@ -5,6 +5,7 @@ set(directory include/OpenMS/CHEMISTRY)
 set(sources_list_h
 AAIndex.h
 AASequence.h
+CompactAASequence.h
 CrossLinksDB.h
 DecoyGenerator.h
 Element.h
@@ -12,6 +13,7 @@ ElementDB.h
 EmpiricalFormula.h
 EnzymaticDigestionLogModel.h
 EnzymaticDigestion.h
+FragmentIonLadder.h
 DigestionEnzyme.h
 DigestionEnzymeProtein.h
 DigestionEnzymeRNA.h
@@ -37,8 +37,10 @@
 #include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
 #include <OpenMS/CONCEPT/Exception.h>
 #include <OpenMS/COMPARISON/SPECTRA/BinnedSpectrum.h>
+#include <OpenMS/DATASTRUCTURES/Matrix.h>
 
 #include <cmath>
+#include <vector>
 
 namespace OpenMS
 {
@@ -51,6 +53,12 @@ namespace OpenMS
     documentation of the concrete functors.
     Functors normalized in the range [0,1] are identifiable at the set "normalized" parameter of the ParameterHandler
 
+    Besides the pairwise operators, one-vs-many and many-vs-many comparisons are provided by compare().
+    They return the same scores as the pairwise operator, but are computed in parallel and, for functors that
+    implement batchKernel_() and batchScore_(), with a batched kernel: spectra are packed into contiguous
+    (CSR) blocks, and each spectrum of the first set is scattered into a dense array once per block of the
+    second set, so the shared bins of a pair are found by direct lookup instead of merging sparse iterators.
+
     @ingroup SpectraComparison
   */
   class OPENMS_DLLAPI BinnedSpectrumCompareFunctor :
@@ -78,6 +86,24 @@ public:
     /// function call operator, calculates self similarity
     virtual double operator()(const BinnedSpectrum& spec) const = 0;
 
+    /**
+      @brief One-vs-many comparison
+
+      @param spec Spectrum compared to each of @p specs
+      @param specs Spectra given in a binned representation (compatible with @p spec)
+      @return Similarity of @p spec to each of @p specs (same order as @p specs)
+    */
+    std::vector<double> compare(const BinnedSpectrum& spec, const std::vector<BinnedSpectrum>& specs) const;
+
+    /**
+      @brief Many-vs-many comparison
+
+      @param specs1 Spectra given in a binned representation (rows of the result)
+      @param specs2 Spectra given in a binned representation (columns of the result)
+      @return Matrix with the similarity of specs1[i] and specs2[j] at (i, j)
+    */
+    Matrix<double> compare(const std::vector<BinnedSpectrum>& specs1, const std::vector<BinnedSpectrum>& specs2) const;
+
     /// registers all derived products
     static void registerChildren();
 
@@ -87,6 +113,46 @@ public:
       return "BinnedSpectrumCompareFunctor";
     }
 
+protected:
+    /// quantities of a single spectrum used by batched comparisons
+    struct SpectrumStatistics_
+    {
+      double sum = 0; ///< sum of bin intensities
+      double sum_of_squares = 0; ///< sum of squared bin intensities
+      Size non_zeros = 0; ///< number of occupied bins
+    };
+
+    /// quantities accumulated over the bins of a spectrum pair by batched comparisons
+    struct PairStatistics_
+    {
+      double dot_product = 0; ///< sum of products of bin intensities
+      double agreeing_intensities = 0; ///< sum of max(0, mean(a, b) - |a - b|) over bins (see BinnedSumAgreeingIntensities)
+      Size shared_bins = 0; ///< number of bins occupied in both spectra
+    };
+
+    /// kernel used by compare()
+    enum class BatchKernel_
+    {
+      PAIRWISE, ///< call the pairwise operator for each pair
+      SHARED_BINS, ///< batched kernel computing PairStatistics_::dot_product and PairStatistics_::shared_bins
+      SHARED_BINS_AGREEING ///< as SHARED_BINS, additionally computing PairStatistics_::agreeing_intensities
+    };
+
+    /// kernel used by compare(), derived classes that implement batchScore_() should return a batched kernel
+    virtual BatchKernel_ batchKernel_() const;
+
+    /**
+      @brief Score of a spectrum pair computed from the statistics collected by a batched kernel
+
+      Needs to yield the same score as the pairwise operator.
+
+      @throw Exception::NotImplemented if the functor does not support batched comparisons
+    */
+    virtual double batchScore_(const SpectrumStatistics_& spec1, const SpectrumStatistics_& spec2, const PairStatistics_& pair) const;
+
+private:
+    /// compares each of @p specs1 to each of @p specs2, writing row-major to @p scores
+    void compareBatch_(const std::vector<const BinnedSpectrum*>& specs1, const std::vector<const BinnedSpectrum*>& specs2, double* scores) const;
   };
 
 }
@@ -100,6 +100,8 @@ public:
 
 protected:
     void updateMembers_() override;
+    BatchKernel_ batchKernel_() const override;
+    double batchScore_(const SpectrumStatistics_& spec1, const SpectrumStatistics_& spec2, const PairStatistics_& pair) const override;
     double precursor_mass_tolerance_;
   };
 
@@ -40,6 +40,8 @@
 #include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 
+#include <boost/dynamic_bitset_fwd.hpp>
+
 namespace OpenMS
 {
 
@@ -65,6 +67,11 @@ namespace OpenMS
       length as well as having the minimal sample rate criterion fulfilled) get
       added to the result.
 
+      Filtering of the spectra and the extension of apices are parallelized
+      (OpenMP). Apices are extended concurrently in blocks and committed in
+      order of decreasing intensity, so the result does not depend on the
+      number of threads.
+
       @htmlinclude OpenMS_MassTraceDetection.parameters
 
       @ingroup Quantitation
@@ -110,6 +117,17 @@ namespace OpenMS
           Size peak_idx;
         };
 
+        /// A mass trace grown from an apex, before it is committed to the result
+        struct TraceCandidate_
+        {
+          /// the trace (only set if @p accepted)
+          MassTrace trace;
+          /// (scan, peak) indices of all gathered peaks, starting with the apex
+          std::vector<std::pair<Size, Size> > gathered_idx;
+          /// whether the trace passes the length and quality criteria
+          bool accepted = false;
+        };
+
         /// The internal run method
         void run_(const std::vector<Apex>& chrom_apices,
                   const Size peak_count,
@@ -118,6 +136,20 @@ namespace OpenMS
                   std::vector<MassTrace> & found_masstraces,
                   const Size max_traces = 0);
 
+        /**
+          @brief Extends a mass trace from @p apex up and down in RT, skipping peaks marked in @p peak_visited
+
+          Only reads the members of this class and may be called concurrently.
+
+          @return Whether the trace passes the length and quality criteria (same as @p candidate.accepted)
+        */
+        bool extendApex_(const Apex& apex,
+                         const PeakMap& work_exp,
+                         const std::vector<Size>& spec_offsets,
+                         const boost::dynamic_bitset<>& peak_visited,
+                         const int fwhm_meta_idx,
+                         TraceCandidate_& candidate);
+
         // parameter stuff
         double mass_error_ppm_;
         double noise_threshold_int_;
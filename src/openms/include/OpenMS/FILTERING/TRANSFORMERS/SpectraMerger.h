@@ -205,71 +205,42 @@ public:
     {
 
       // convert spectra's precursors to clusterizable data
-      Size data_size;
-      std::vector<BinaryTreeNode> tree;
-      Map<Size, Size> index_mapping;
-      // local scope to save memory - we do not need the clustering stuff later
-      {
-        std::vector<BaseFeature> data;
+      std::vector<BaseFeature> data;
+      std::vector<Size> index_mapping; // index in cluster data ==> experiment index
 
-        for (Size i = 0; i < exp.size(); ++i)
+      for (Size i = 0; i < exp.size(); ++i)
+      {
+        if (exp[i].getMSLevel() != 2)
         {
-          if (exp[i].getMSLevel() != 2)
-          {
-            continue;
-          }
-
-          // remember which index in distance data ==> experiment index
-          index_mapping[data.size()] = i;
-
-          // make cluster element
-          BaseFeature bf;
-          bf.setRT(exp[i].getRT());
-          std::vector<Precursor> pcs = exp[i].getPrecursors();
-          if (pcs.empty())
-          {
-            throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("Scan #") + String(i) + " does not contain any precursor information! Unable to cluster!");
-          }
-          if (pcs.size() > 1)
-          {
-            OPENMS_LOG_WARN << "More than one precursor found. Using first one!" << std::endl;
-          }
-          bf.setMZ(pcs[0].getMZ());
-          data.push_back(bf);
+          continue;
         }
-        data_size = data.size();
 
-        SpectraDistance_ llc;
-        llc.setParameters(param_.copy("precursor_method:", true));
-        SingleLinkage sl;
-        DistanceMatrix<float> dist; // will be filled
-        ClusterHierarchical ch;
+        // remember which index in distance data ==> experiment index
+        index_mapping.push_back(i);
 
-        //ch.setThreshold(0.99);
-        // clustering ; threshold is implicitly at 1.0, i.e. distances of 1.0 (== similarity 0) will not be clustered
-        ch.cluster<BaseFeature, SpectraDistance_>(data, llc, sl, tree, dist);
-      }
-
-      // extract the clusters
-      ClusterAnalyzer ca;
-      std::vector<std::vector<Size> > clusters;
-      // count number of real tree nodes (not the -1 ones):
-      Size node_count = 0;
-      for (Size ii = 0; ii < tree.size(); ++ii)
-      {
-        if (tree[ii].distance >= 1)
+        // make cluster element
+        BaseFeature bf;
+        bf.setRT(exp[i].getRT());
+        std::vector<Precursor> pcs = exp[i].getPrecursors();
+        if (pcs.empty())
         {
-          tree[ii].distance = -1;  // manually set to disconnect, as SingleLinkage does not support it
+          throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("Scan #") + String(i) + " does not contain any precursor information! Unable to cluster!");
         }
-        if (tree[ii].distance != -1)
+        if (pcs.size() > 1)
         {
-          ++node_count;
+          OPENMS_LOG_WARN << "More than one precursor found. Using first one!" << std::endl;
         }
+        bf.setMZ(pcs[0].getMZ());
+        data.push_back(bf);
       }
-      ca.cut(data_size - node_count, tree, clusters);
 
-      //std::cerr << "Treesize: " << (tree.size()+1) << "   #clusters: " << clusters.size() << std::endl;
-      //std::cerr << "tree:\n" << ca.newickTree(tree, true) << "\n";
+      Param distance_param = param_.copy("precursor_method:", true);
+      distance_param.remove("linkage");
+      SpectraDistance_ llc;
+      llc.setParameters(distance_param);
+
+      std::vector<std::vector<Size> > clusters = clusterPrecursors_(data, llc, param_.getValue("precursor_method:linkage") == "complete");
+      data.clear();
 
       // convert to blocks
       MergeBlocks spectra_to_merge;
@@ -479,6 +450,24 @@ public:
 
 protected:
 
+    /**
+        @brief clusters precursors by RT and m/z
+
+        Only precursors within the RT and m/z tolerances of @p distance can be linked. Candidate pairs are looked up
+        in an RT/m/z grid with cells of tolerance size, so memory and run time scale with the number of
+        candidate pairs instead of quadratically with the number of precursors.
+        With single linkage, the clusters are the connected components of the sparse similarity graph, i.e. the same
+        clusters as obtained by hierarchical single linkage clustering of the full distance matrix, cut at distance 1.
+        With complete linkage, each connected component is clustered separately (components are independent, since
+        precursors of different components are never closer than distance 1).
+
+        @param data precursors (RT and m/z)
+        @param distance similarity of two precursors
+        @param complete_linkage use complete linkage instead of single linkage
+        @return clusters with more than one element, each given as sorted indices into @p data
+    */
+    std::vector<std::vector<Size> > clusterPrecursors_(const std::vector<BaseFeature>& data, const SpectraDistance_& distance, bool complete_linkage) const;
+
     /**
         @brief merges blocks of spectra of a certain level
 
@@ -48,6 +48,7 @@
 #include <algorithm>
 #include <iterator>
 #include <cmath>
+#include <type_traits>
 #include <vector>
 
 #include <QByteArray>
@@ -166,7 +167,28 @@ private:
     };
 
     static const char encoder_[];
-    static const char decoder_[];
+
+    /**
+      @brief Decodes base64 characters into raw bytes
+
+      The length @p in_size has to be a non-zero multiple of 4 and @p out has
+      to provide space for (@p in_size / 4) * 3 bytes.
+
+      @return The number of decoded bytes (without padding) or -1 if @p in contains characters outside of the base64 alphabet
+    */
+    static SignedSize decodeBase64_(const char * in, Size in_size, unsigned char * out);
+
+    /// Decodes a Base64 string to raw bytes, skipping line breaks and other non-base64 characters
+    static void decodeBytes_(const String & in, String & out);
+
+    /// Inflates zlib-compressed bytes directly into the memory of @p out
+    template <typename ToType>
+    static void inflate_(const String & in, std::vector<ToType> & out);
+
+    /// Reverses the byte order of all (32 or 64 bit) elements in @p data
+    template <typename ToType>
+    static void swapByteOrder_(std::vector<ToType> & data);
+
     /// Decodes a Base64 string to a vector of floating point numbers
     template <typename ToType>
     static void decodeUncompressed_(const String & in, ByteOrder from_byte_order, std::vector<ToType> & out);
@@ -350,59 +372,17 @@ private:
   void Base64::decodeCompressed_(const String & in, ByteOrder from_byte_order, std::vector<ToType> & out)
   {
     out.clear();
-    if (in == "") return;
+    if (in.empty()) return;
 
-    const Size element_size = sizeof(ToType);
-
-    String decompressed;
-
-    QByteArray qt_byte_array = QByteArray::fromRawData(in.c_str(), (int) in.size());
-    QByteArray bazip = QByteArray::fromBase64(qt_byte_array);
-    QByteArray czip;
-    czip.resize(4);
-    czip[0] = (bazip.size() & 0xff000000) >> 24;
-    czip[1] = (bazip.size() & 0x00ff0000) >> 16;
-    czip[2] = (bazip.size() & 0x0000ff00) >> 8;
-    czip[3] = (bazip.size() & 0x000000ff);
-    czip += bazip;
-    QByteArray base64_uncompressed = qUncompress(czip);
-
-    if (base64_uncompressed.isEmpty())
-    {
-      throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Decompression error?");
-    }
-    decompressed.resize(base64_uncompressed.size());
-
-    std::copy(base64_uncompressed.begin(), base64_uncompressed.end(), decompressed.begin());
-
-    void* byte_buffer = reinterpret_cast<void *>(&decompressed[0]);
-    Size buffer_size = decompressed.size();
+    String compressed;
+    decodeBytes_(in, compressed);
+    inflate_(compressed, out);
 
-    const ToType * float_buffer = reinterpret_cast<const ToType *>(byte_buffer);
-    if (buffer_size % element_size != 0)
-    {
-      throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Bad BufferCount?");
-    }
-    
-    Size float_count = buffer_size / element_size;
-    
     // change endianness if necessary
     if ((OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_LITTLEENDIAN) || (!OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_BIGENDIAN))
     {
-      if (element_size == 4) // 32 bit
-      {
-        UInt32 * p = reinterpret_cast<UInt32 *>(byte_buffer);
-        std::transform(p, p + float_count, p, endianize32);
-      }
-      else // 64 bit
-      {
-        UInt64 * p = reinterpret_cast<UInt64 *>(byte_buffer);
-        std::transform(p, p + float_count, p, endianize64);
-      }
+      swapByteOrder_(out);
     }
-
-    // copy values
-    out.assign(float_buffer, float_buffer + float_count);
   }
 
   template <typename ToType>
@@ -421,103 +401,86 @@ private:
       throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Malformed base64 input, length is not a multiple of 4.");
     }
 
-    Size src_size = in.size();
-    // last one or two '=' are skipped if contained
-    int padding = 0;
-    if (in[src_size - 1] == '=') padding++;
-    if (in[src_size - 2] == '=') padding++;
-
-    src_size -= padding;
-
-    UInt a;
-    UInt b;
-
-    UInt offset = 0;
-    int inc = 1;
-    UInt written = 0;
-
     const Size element_size = sizeof(ToType);
+    const Size max_bytes = in.size() / 4 * 3;
 
-    // enough for either float or double
-    char element[8] = "\x00\x00\x00\x00\x00\x00\x00";
+    // decode directly into the memory of the output vector (rounded up to
+    // full elements), trailing bytes of an incomplete element are dropped
+    // (the padding of well-formed input never completes an element)
+    out.resize((max_bytes + element_size - 1) / element_size);
+    if (decodeBase64_(in.c_str(), in.size(), reinterpret_cast<unsigned char *>(out.data())) < 0)
+    {
+      out.clear();
+      throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Malformed base64 input, contains invalid characters.");
+    }
+    out.resize(max_bytes / element_size);
 
     // Parse little endian data in big endian OpenMS (or other way round)
     if ((OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_LITTLEENDIAN) || 
        (!OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_BIGENDIAN))
     {
-      offset = (element_size - 1);              // other endian
-      inc = -1;
-    }
-    else
-    {
-      offset = 0;
-      inc = 1;
+      swapByteOrder_(out);
     }
+  }
 
-    //reserve enough space in the output vector
-    out.reserve((UInt)(std::ceil((4.0 * src_size) / 3.0) + 6.0));
+  template <typename ToType>
+  void Base64::inflate_(const String & in, std::vector<ToType> & out)
+  {
+    const Size element_size = sizeof(ToType);
 
-    // sort all read bytes correctly into a char[4] (double) or
-    // char[8] (float) and push_back when necessary.
-    for (Size i = 0; i < src_size; i += 4)
+    z_stream stream = z_stream();
+    if (inflateInit(&stream) != Z_OK)
     {
-      // decode 4 Base64-Chars to 3 Byte
-      // -------------------------------
-
-      // decode the first two chars
-      a = decoder_[(int)in[i] - 43] - 62;
-      b = decoder_[(int)in[i + 1] - 43] - 62;
-      if (i + 1 >= src_size)
-      {
-        b = 0;
-      }
-      // write first byte (6 bits from a and 2 highest bits from b)
-      element[offset] = (unsigned char) ((a << 2) | (b >> 4));
-      written++;
-      offset = (offset + inc) % element_size;
-
-      if (written % element_size == 0)
-      {
-        ToType * to_type = reinterpret_cast<ToType *>(&element[0]);
-        out.push_back((*to_type));
-        strcpy(element, "");
-      }
-
-      // decode the third char
-      a = decoder_[(int)in[i + 2] - 43] - 62;
-      if (i + 2 >= src_size)
+      throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Decompression error?");
+    }
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(in.c_str()));
+    stream.avail_in = (uInt) in.size();
+
+    // inflate straight into the output vector, which is grown on demand
+    // (binary peak data rarely compresses better than 1:4)
+    out.resize(std::max<Size>(4 * in.size() / element_size, 16));
+    int zlib_error;
+    do
+    {
+      Size inflated = stream.total_out;
+      if (inflated == out.size() * element_size)
       {
-        a = 0;
+        out.resize(2 * out.size());
       }
-      // write second byte (4 lowest bits from b and 4 highest bits from a)
-      element[offset] = (unsigned char) (((b & 15) << 4) | (a >> 2));
-      written++;
-      offset = (offset + inc) % element_size;
+      stream.next_out = reinterpret_cast<Bytef *>(out.data()) + inflated;
+      stream.avail_out = (uInt) (out.size() * element_size - inflated);
+      zlib_error = inflate(&stream, Z_NO_FLUSH);
+    }
+    while (zlib_error == Z_OK || (zlib_error == Z_BUF_ERROR && stream.avail_out == 0));
 
-      if (written % element_size == 0)
-      {
-        ToType * to_type = reinterpret_cast<ToType *>(&element[0]);
-        out.push_back((*to_type));
-        strcpy(element, "");
-      }
+    const Size buffer_size = stream.total_out;
+    inflateEnd(&stream);
 
-      // decode the fourth char
-      b = decoder_[(int)in[i + 3] - 43] - 62;
-      if (i + 3 >= src_size)
-      {
-        b = 0;
-      }
-      // write third byte (2 lowest bits from a and 6 bits from b)
-      element[offset] = (unsigned char) (((a & 3) << 6) | b);
-      written++;
-      offset = (offset + inc) % element_size;
+    if (zlib_error != Z_STREAM_END || buffer_size == 0)
+    {
+      out.clear();
+      throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Decompression error?");
+    }
+    if (buffer_size % element_size != 0)
+    {
+      out.clear();
+      throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Bad BufferCount?");
+    }
+    out.resize(buffer_size / element_size);
+  }
 
-      if (written % element_size == 0)
-      {
-        ToType * to_type = reinterpret_cast<ToType *>(&element[0]);
-        out.push_back((*to_type));
-        strcpy(element, "");
-      }
+  template <typename ToType>
+  void Base64::swapByteOrder_(std::vector<ToType> & data)
+  {
+    if (sizeof(ToType) == 4) // 32 bit
+    {
+      UInt32 * p = reinterpret_cast<UInt32 *>(data.data());
+      std::transform(p, p + data.size(), p, endianize32);
+    }
+    else // 64 bit
+    {
+      UInt64 * p = reinterpret_cast<UInt64 *>(data.data());
+      std::transform(p, p + data.size(), p, endianize64);
     }
   }
 
@@ -644,253 +607,44 @@ private:
   template <typename ToType>
   void Base64::decodeIntegersCompressed_(const String & in, ByteOrder from_byte_order, std::vector<ToType> & out)
   {
-    out.clear();
-    if (in == "")
-      return;
-
-    void * byte_buffer;
-    Size buffer_size;
-    const Size element_size = sizeof(ToType);
-
-    String decompressed;
-
-    QByteArray qt_byte_array = QByteArray::fromRawData(in.c_str(), (int) in.size());
-    QByteArray bazip = QByteArray::fromBase64(qt_byte_array);
-    QByteArray czip;
-    czip.resize(4);
-    czip[0] = (bazip.size() & 0xff000000) >> 24;
-    czip[1] = (bazip.size() & 0x00ff0000) >> 16;
-    czip[2] = (bazip.size() & 0x0000ff00) >> 8;
-    czip[3] = (bazip.size() & 0x000000ff);
-    czip += bazip;
-    QByteArray base64_uncompressed = qUncompress(czip);
-    if (base64_uncompressed.isEmpty())
+    // integer types share the memory layout of the encoded values
+    if (std::is_integral<ToType>::value)
     {
-      throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Decompression error?");
+      decodeCompressed_(in, from_byte_order, out);
+      return;
     }
-    decompressed.resize(base64_uncompressed.size());
-
-    std::copy(base64_uncompressed.begin(), base64_uncompressed.end(), decompressed.begin());
 
-    byte_buffer = reinterpret_cast<void *>(&decompressed[0]);
-    buffer_size = decompressed.size();
+    typedef typename std::conditional<sizeof(ToType) == 4, Int32, Int64>::type IntType;
+    std::vector<IntType> values;
+    decodeCompressed_(in, from_byte_order, values);
 
-    //change endianness if necessary
-    if ((OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_LITTLEENDIAN) || (!OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_BIGENDIAN))
+    out.resize(values.size());
+    // do NOT use assign here, as it will give a lot of type conversion warnings on VS compiler
+    for (Size i = 0; i < values.size(); ++i)
     {
-      if (element_size == 4)
-      {
-        const Int32 * float_buffer = reinterpret_cast<const Int32 *>(byte_buffer);
-        if (buffer_size % element_size != 0)
-          throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Bad BufferCount?");
-        Size float_count = buffer_size / element_size;
-        UInt32 * p = reinterpret_cast<UInt32 *>(byte_buffer);
-        std::transform(p, p + float_count, p, endianize32);
-
-        out.resize(float_count);
-        // do NOT use assign here, as it will give a lot of type conversion warnings on VS compiler
-        for (Size i = 0; i < float_count; ++i)
-        {
-          out[i] = (ToType) * float_buffer;
-          ++float_buffer;
-        }
-      }
-      else
-      {
-        const Int64 * float_buffer = reinterpret_cast<const Int64 *>(byte_buffer);
-
-        if (buffer_size % element_size != 0)
-          throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Bad BufferCount?");
-
-        Size float_count = buffer_size / element_size;
-
-        UInt64 * p = reinterpret_cast<UInt64 *>(byte_buffer);
-        std::transform(p, p + float_count, p, endianize64);
-
-        out.resize(float_count);
-        // do NOT use assign here, as it will give a lot of type conversion warnings on VS compiler
-        for (Size i = 0; i < float_count; ++i)
-        {
-          out[i] = (ToType) * float_buffer;
-          ++float_buffer;
-        }
-      }
-    }
-    else
-    {
-      if (element_size == 4)
-      {
-        const Int * float_buffer = reinterpret_cast<const Int *>(byte_buffer);
-        if (buffer_size % element_size != 0)
-          throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Bad BufferCount while decoding?");
-
-        Size float_count = buffer_size / element_size;
-        out.resize(float_count);
-        // do NOT use assign here, as it will give a lot of type conversion warnings on VS compiler
-        for (Size i = 0; i < float_count; ++i)
-        {
-          out[i] = (ToType) * float_buffer;
-          ++float_buffer;
-        }
-      }
-      else
-      {
-        const Int64 * float_buffer = reinterpret_cast<const Int64 *>(byte_buffer);
-
-        if (buffer_size % element_size != 0)
-          throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Bad BufferCount while decoding?");
-
-        Size float_count = buffer_size / element_size;
-        out.resize(float_count);
-        // do NOT use assign here, as it will give a lot of type conversion warnings on VS compiler
-        for (Size i = 0; i < float_count; ++i)
-        {
-          out[i] = (ToType) * float_buffer;
-          ++float_buffer;
-        }
-      }
+      out[i] = (ToType) values[i];
     }
-
   }
 
   template <typename ToType>
   void Base64::decodeIntegersUncompressed_(const String & in, ByteOrder from_byte_order, std::vector<ToType> & out)
   {
-    out.clear();
-
-    // The length of a base64 string is a always a multiple of 4 (always 3
-    // bytes are encoded as 4 characters)
-    if (in.size() < 4)
+    // integer types share the memory layout of the encoded values
+    if (std::is_integral<ToType>::value)
     {
+      decodeUncompressed_(in, from_byte_order, out);
       return;
     }
 
-    Size src_size = in.size();
-    // last one or two '=' are skipped if contained
-    int padding = 0;
-    if (in[src_size - 1] == '=') padding++;
-    if (in[src_size - 2] == '=') padding++;
-
-    src_size -= padding;
-
-    UInt a;
-    UInt b;
+    typedef typename std::conditional<sizeof(ToType) == 4, Int32, Int64>::type IntType;
+    std::vector<IntType> values;
+    decodeUncompressed_(in, from_byte_order, values);
 
-    UInt offset = 0;
-    int inc = 1;
-    UInt written = 0;
-
-    const Size element_size = sizeof(ToType);
-
-    // enough for either float or double
-    char element[8] = "\x00\x00\x00\x00\x00\x00\x00";
-
-    if ((OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_LITTLEENDIAN) || (!OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_BIGENDIAN))
+    out.resize(values.size());
+    // do NOT use assign here, as it will give a lot of type conversion warnings on VS compiler
+    for (Size i = 0; i < values.size(); ++i)
     {
-      offset = (element_size - 1);              // other endian
-      inc = -1;
-    }
-    else
-    {
-      offset = 0;
-      inc = 1;
-    }
-
-    //reserve enough space in the output vector
-    out.reserve((UInt)(std::ceil((4.0 * src_size) / 3.0) + 6.0));
-
-    // sort all read bytes correctly into a char[4] (double) or
-    // char[8] (float) and push_back when necessary.
-    for (Size i = 0; i < src_size; i += 4)
-    {
-
-      // decode 4 Base64-Chars to 3 Byte
-      // -------------------------------
-
-      // decode the first two chars
-      a = decoder_[(int)in[i] - 43] - 62;
-      b = decoder_[(int)in[i + 1] - 43] - 62;
-      if (i + 1 >= src_size)
-      {
-        b = 0;
-      }
-      // write first byte (6 bits from a and 2 highest bits from b)
-      element[offset] = (unsigned char) ((a << 2) | (b >> 4));
-      written++;
-      offset = (offset + inc) % element_size;
-
-      if (written % element_size == 0)
-      {
-        ToType float_value;
-        if (element_size == 4)
-        {
-          Int32 * value = reinterpret_cast<Int32 *>(&element[0]);
-          float_value = (ToType) * value;
-        }
-        else
-        {
-          Int64 * value = reinterpret_cast<Int64 *>(&element[0]);
-          float_value = (ToType) * value;
-        }
-        out.push_back(float_value);
-        strcpy(element, "");
-      }
-
-      // decode the third char
-      a = decoder_[(int)in[i + 2] - 43] - 62;
-      if (i + 2 >= src_size)
-      {
-        a = 0;
-      }
-      // write second byte (4 lowest bits from b and 4 highest bits from a)
-      element[offset] = (unsigned char) (((b & 15) << 4) | (a >> 2));
-      written++;
-      offset = (offset + inc) % element_size;
-
-      if (written % element_size == 0)
-      {
-        ToType float_value;
-        if (element_size == 4)
-        {
-          Int32 * value = reinterpret_cast<Int32 *>(&element[0]);
-          float_value = (ToType) * value;
-        }
-        else
-        {
-          Int64 * value = reinterpret_cast<Int64 *>(&element[0]);
-          float_value = (ToType) * value;
-        }
-        out.push_back(float_value);
-        strcpy(element, "");
-      }
-
-      // decode the fourth char
-      b = decoder_[(int)in[i + 3] - 43] - 62;
-      if (i + 3 >= src_size)
-      {
-        b = 0;
-      }
-      // write third byte (2 lowest bits from a and 6 bits from b)
-      element[offset] = (unsigned char) (((a & 3) << 6) | b);
-      written++;
-      offset = (offset + inc) % element_size;
-
-      if (written % element_size == 0)
-      {
-        ToType float_value;
-        if (element_size == 4)
-        {
-          Int32 * value = reinterpret_cast<Int32 *>(&element[0]);
-          float_value = (ToType) * value;
-        }
-        else
-        {
-          Int64 * value = reinterpret_cast<Int64 *>(&element[0]);
-          float_value = (ToType) * value;
-        }
-        out.push_back(float_value);
-        strcpy(element, "");
-      }
+      out[i] = (ToType) values[i];
     }
   }
 
@@ -36,8 +36,18 @@
 
 #include <OpenMS/KERNEL/MSExperiment.h>
 
+#include <boost/shared_ptr.hpp>
+
 #include <fstream>
 
+namespace boost
+{
+  namespace interprocess
+  {
+    class mapped_region;
+  }
+}
+
 namespace OpenMS
 {
 
@@ -49,6 +59,12 @@ namespace OpenMS
     be very fast and done in random order (once the in-memory index is built
     for the file).
 
+    The cached file is mapped read-only into memory, copies of an object
+    share the same mapping. Data items are read directly from the mapped
+    memory without any file pointer, so multiple threads can access the
+    same file concurrently (e.g. through copies of this object) and the
+    operating system page cache is used for buffering.
+
   */
   class OPENMS_DLLAPI CachedmzML
   {
@@ -108,11 +124,17 @@ protected:
 
     void load_(const String& filename);
 
+    /// Returns a pointer into the mapped cached file at position @p pos
+    const char* getMappedData_(std::streampos pos) const;
+
+    /// Returns a pointer past the last byte of the mapped cached file
+    const char* getMappedDataEnd_() const;
+
     /// Meta data
     MSExperiment meta_ms_experiment_;
 
-    /// Internal filestream 
-    std::ifstream ifs_;
+    /// Read-only memory mapping of the cached file (shared between copies)
+    boost::shared_ptr<boost::interprocess::mapped_region> mapped_region_;
 
     /// Name of the mzML file
     String filename_;
@@ -183,6 +183,31 @@ public:
       @throws Exception::ParseError is thrown if the chromatogram size cannot be read
     */
     static std::vector<OpenSwath::BinaryDataArrayPtr> readChromatogramFast(std::ifstream& ifs);
+
+    /**
+      @brief Fast access to a spectrum in memory (e.g. a memory-mapped cached file)
+
+      In contrast to the stream-based version, no shared state is modified
+      which allows concurrent access to the same memory from multiple threads.
+
+      @param data Pointer to the start of the spectrum (base address plus the position from the spectra index)
+      @param end Pointer past the last readable byte (e.g. end of the mapped file), no data beyond it is accessed
+      @param ms_level Output parameter to store the MS level of the spectrum (1, 2, 3 ...)
+      @param rt Output parameter to store the retention time of the spectrum
+
+      @throws Exception::ParseError is thrown if the spectrum cannot be read or extends beyond @p end
+    */
+    static std::vector<OpenSwath::BinaryDataArrayPtr> readSpectrumFast(const char* data, const char* end, int& ms_level, double& rt);
+
+    /**
+      @brief Fast access to a chromatogram in memory (e.g. a memory-mapped cached file)
+
+      @param data Pointer to the start of the chromatogram (base address plus the position from the chromatogram index)
+      @param end Pointer past the last readable byte (e.g. end of the mapped file), no data beyond it is accessed
+
+      @throws Exception::ParseError is thrown if the chromatogram cannot be read or extends beyond @p end
+    */
+    static std::vector<OpenSwath::BinaryDataArrayPtr> readChromatogramFast(const char* data, const char* end);
     //@}
 
     /**
@@ -205,6 +230,28 @@ public:
     */
     static void readChromatogram(ChromatogramType& chromatogram, std::ifstream& ifs);
 
+    /**
+      @brief Read a single spectrum from memory directly into an OpenMS MSSpectrum
+
+      @param spectrum Output spectrum
+      @param data Pointer to the start of the spectrum
+      @param end Pointer past the last readable byte
+
+      @throws Exception::ParseError is thrown if the spectrum cannot be read or extends beyond @p end
+    */
+    static void readSpectrum(SpectrumType& spectrum, const char* data, const char* end);
+
+    /**
+      @brief Read a single chromatogram from memory directly into an OpenMS MSChromatogram
+
+      @param chromatogram Output chromatogram
+      @param data Pointer to the start of the chromatogram
+      @param end Pointer past the last readable byte
+
+      @throws Exception::ParseError is thrown if the chromatogram cannot be read or extends beyond @p end
+    */
+    static void readChromatogram(ChromatogramType& chromatogram, const char* data, const char* end);
+
 protected:
 
     /// write a single spectrum to filestream
@@ -217,6 +264,16 @@ protected:
     static inline void readDataFast_(std::ifstream& ifs, std::vector<OpenSwath::BinaryDataArrayPtr>& data, const Size& data_size, 
       const Size& nr_float_arrays);
 
+    /// helper method for fast reading of spectra and chromatograms from memory (advances @p pos, never reads at or beyond @p end)
+    static inline void readDataFast_(const char*& pos, const char* end, std::vector<OpenSwath::BinaryDataArrayPtr>& data, const Size& data_size,
+      const Size& nr_float_arrays);
+
+    /// helper method to fill an MSSpectrum from data arrays
+    static void fillSpectrum_(SpectrumType& spectrum, const std::vector<OpenSwath::BinaryDataArrayPtr>& data, int ms_level, double rt);
+
+    /// helper method to fill an MSChromatogram from data arrays
+    static void fillChromatogram_(ChromatogramType& chromatogram, const std::vector<OpenSwath::BinaryDataArrayPtr>& data);
+
     /// Members
     std::vector<std::streampos> spectra_index_;
     std::vector<std::streampos> chrom_index_;
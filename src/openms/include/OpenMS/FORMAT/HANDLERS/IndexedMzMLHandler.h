@@ -43,9 +43,18 @@
 #include <OpenMS/KERNEL/MSChromatogram.h>
 
 #include <string>
-#include <fstream>
 #include <unordered_map>
 
+#include <boost/shared_ptr.hpp>
+
+namespace boost
+{
+  namespace interprocess
+  {
+    class mapped_region;
+  }
+}
+
 namespace OpenMS
 {
 
@@ -70,10 +79,11 @@ namespace Internal
     extracting all the offsets of the <chromatogram> and <spectrum> tags. These
     offsets are stored as members of this class as well as the offset to the <indexList> element
 
-    @note This implementation is @a not thread-safe since it keeps internally a
-    single file access pointer which it moves when accessing a specific
-    data item. The caller is responsible to ensure that access is performed
-    atomically.
+    The file is mapped read-only into memory and a spectrum or chromatogram is
+    read by copying its XML text directly from the offset stored in the
+    index. Copies of this object share the same mapping. Since no file access
+    pointer is kept, all data access functions are const and may be called
+    concurrently from multiple threads on the same object.
 
   */
   class OPENMS_DLLAPI IndexedMzMLHandler
@@ -92,8 +102,8 @@ namespace Internal
     std::streampos index_offset_;
     /// Whether spectra are written before chromatograms in this file
     bool spectra_before_chroms_;
-    /// The current filestream (opened by openFile)
-    std::ifstream filestream_;
+    /// Read-only memory mapping of the file (opened by openFile, shared between copies)
+    boost::shared_ptr<boost::interprocess::mapped_region> mapped_region_;
     /// Whether parsing the indexedmzML file was successful
     bool parsing_success_;
     /// Whether to skip XML checks
@@ -109,9 +119,12 @@ namespace Internal
     */
     void parseFooter_(String filename);
 
-    std::string getChromatogramById_helper_(int id);
+    /// Return the XML text between the two file offsets (thread-safe)
+    std::string getText_(std::streampos startidx, std::streampos endidx) const;
+
+    std::string getChromatogramById_helper_(int id) const;
 
-    std::string getSpectrumById_helper_(int id);
+    std::string getSpectrumById_helper_(int id) const;
 
     public:
 
@@ -165,7 +178,7 @@ namespace Internal
 
       @return The spectrum at position id
     */
-    OpenMS::Interfaces::SpectrumPtr getSpectrumById(int id);
+    OpenMS::Interfaces::SpectrumPtr getSpectrumById(int id) const;
 
     /**
       @brief Retrieve the raw data for the spectrum at position "id"
@@ -175,7 +188,7 @@ namespace Internal
 
       @return The spectrum at position id
     */
-    const OpenMS::MSSpectrum getMSSpectrumById(int id);
+    const OpenMS::MSSpectrum getMSSpectrumById(int id) const;
 
     /**
       @brief Retrieve the raw data for the spectrum with native id "id"
@@ -186,7 +199,7 @@ namespace Internal
       @param id The spectrum native id
       @param s The spectrum to be used and filled with data
     */
-    void getMSSpectrumByNativeId(std::string id, OpenMS::MSSpectrum& s);
+    void getMSSpectrumByNativeId(const std::string& id, OpenMS::MSSpectrum& s) const;
 
     /**
       @brief Retrieve the raw data for the spectrum at position "id"
@@ -197,7 +210,22 @@ namespace Internal
       @param id The spectrum id
       @param s The spectrum to be used and filled with data
     */
-    void getMSSpectrumById(int id, OpenMS::MSSpectrum& s);
+    void getMSSpectrumById(int id, OpenMS::MSSpectrum& s) const;
+
+    /**
+      @brief Retrieve the raw data for multiple spectra at once
+
+      The spectra are decoded in parallel. If @p spectra already contains one
+      entry per id (e.g. pre-filled with meta data), these entries are filled
+      with data, otherwise @p spectra is resized to the number of ids.
+
+      @throw Exception if getParsingSuccess() returns false
+      @throw Exception if any id is not within [0, getNrSpectra()-1]
+
+      @param ids The spectrum ids
+      @param spectra The spectra to be used and filled with data
+    */
+    void getMSSpectraById(const std::vector<int>& ids, std::vector<OpenMS::MSSpectrum>& spectra) const;
 
     /**
       @brief Retrieve the raw data for the chromatogram at position "id"
@@ -207,7 +235,7 @@ namespace Internal
 
       @return The chromatogram at position id
     */
-    OpenMS::Interfaces::ChromatogramPtr getChromatogramById(int id);
+    OpenMS::Interfaces::ChromatogramPtr getChromatogramById(int id) const;
 
     /**
       @brief Retrieve the raw data for the chromatogram at position "id"
@@ -217,7 +245,7 @@ namespace Internal
 
       @return The chromatogram at position id
     */
-    const OpenMS::MSChromatogram getMSChromatogramById(int id);
+    const OpenMS::MSChromatogram getMSChromatogramById(int id) const;
 
     /**
       @brief Retrieve the raw data for the chromatogram with native id "id"
@@ -228,7 +256,7 @@ namespace Internal
       @param id The chromatogram native id
       @param s The chromatogram to be used and filled with data
     */
-    void getMSChromatogramByNativeId(std::string id, OpenMS::MSChromatogram& c);
+    void getMSChromatogramByNativeId(const std::string& id, OpenMS::MSChromatogram& c) const;
 
     /**
       @brief Retrieve the raw data for the chromatogram at position "id"
@@ -239,7 +267,7 @@ namespace Internal
       @param id The chromatogram id
       @param c The chromatogram to be used and filled with data
     */
-    void getMSChromatogramById(int id, OpenMS::MSChromatogram& c);
+    void getMSChromatogramById(int id, OpenMS::MSChromatogram& c) const;
 
     /// Whether to skip some XML checks (removing whitespace from base64 arrays) and be fast instead
     void setSkipXMLChecks(bool skip)
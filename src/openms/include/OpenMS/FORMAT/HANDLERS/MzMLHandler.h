@@ -49,6 +49,8 @@
 #include <OpenMS/FORMAT/ControlledVocabulary.h>
 #include <OpenMS/FORMAT/VALIDATORS/SemanticValidator.h>
 
+#include <future>
+
 
 //MISSING:
 // - more than one selected ion per precursor (warning if more than one)
@@ -218,7 +220,9 @@ protected:
           @brief Populate all spectra on the stack with data from input
 
           Will populate all spectra on the current work stack with data (using
-          multiple threads if available) and append them to the result.
+          multiple threads if available) in the background, while the XML
+          parser continues with the next batch. The previous batch is appended
+          to the result first, so the input order is preserved.
       */
       void populateSpectraWithData_();
 
@@ -226,10 +230,18 @@ protected:
           @brief Populate all chromatograms on the stack with data from input
 
           Will populate all chromatograms on the current work stack with data (using
-          multiple threads if available) and append them to the result.
+          multiple threads if available) in the background, while the XML
+          parser continues with the next batch. The previous batch is appended
+          to the result first, so the input order is preserved.
       */
       void populateChromatogramsWithData_();
 
+      /// Waits for the batch of spectra decoded in the background and appends it to the result
+      void appendDecodedSpectra_();
+
+      /// Waits for the batch of chromatograms decoded in the background and appends it to the result
+      void appendDecodedChromatograms_();
+
       /**
           @brief Add extra data arrays to a spectrum
 
@@ -463,6 +475,9 @@ protected:
       /// Vector of spectrum data stored for later parallel processing
       std::vector<SpectrumData> spectrum_data_;
 
+      /// Batch of spectra which is currently decoded in the background
+      std::vector<SpectrumData> spectrum_data_decoding_;
+
       /**
           @brief Data necessary to generate a single chromatogram
 
@@ -480,6 +495,15 @@ protected:
       /// Vector of chromatogram data stored for later parallel processing
       std::vector<ChromatogramData> chromatogram_data_;
 
+      /// Batch of chromatograms which is currently decoded in the background
+      std::vector<ChromatogramData> chromatogram_data_decoding_;
+
+      /// Background decoding of spectrum_data_decoding_ (declared after the data, so it is waited for first on destruction)
+      std::future<void> spectrum_decoding_;
+
+      /// Background decoding of chromatogram_data_decoding_ (declared after the data, so it is waited for first on destruction)
+      std::future<void> chromatogram_decoding_;
+
       //@}
       
       /**@name temporary data structures to hold written data
@@ -39,6 +39,8 @@
 
 #include <OpenMS/OPENSWATHALGO/DATAACCESS/SwathMap.h>
 
+#include <limits>
+
 // forward declarations
 struct sqlite3;
 struct sqlite3_stmt;
@@ -165,6 +167,26 @@ public:
       */
       std::vector<size_t> getSpectraIndicesbyRT(double RT, double deltaRT, const std::vector<int> & indices) const;
 
+      /// Light-weight meta data of a single spectrum (see getSpectraRTIndex)
+      struct SpectrumRTEntry
+      {
+        int id = -1; ///< SPECTRUM.ID of the spectrum
+        String native_id; ///< native id of the spectrum
+        int ms_level = -1; ///< MS level of the spectrum
+        double rt = std::numeric_limits<double>::quiet_NaN(); ///< retention time of the spectrum (NaN if not available)
+      };
+
+      /**
+          @brief Get id, native id, MS level and retention time of all spectra
+
+          This reads only the SPECTRUM table (no data and no joins) in a
+          single query and can be used to answer retention time queries in
+          memory instead of calling getSpectraIndicesbyRT repeatedly.
+
+          @return One entry per spectrum, ordered by spectrum id
+      */
+      std::vector<SpectrumRTEntry> getSpectraRTIndex() const;
+
 protected:
 
       void populateChromatogramsWithData_(sqlite3 *db, std::vector<MSChromatogram>& chromatograms) const;
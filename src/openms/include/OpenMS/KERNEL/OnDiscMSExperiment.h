@@ -56,14 +56,20 @@ namespace OpenMS
 
     @ingroup Kernel
 
-    @note This implementation is @a not thread-safe since it keeps internally a
-    single file access pointer which it moves when accessing a specific
-    data item. Please provide a separate copy to each thread, e.g. 
+    Spectra and chromatograms are read from a read-only memory mapping of the
+    file (see Internal::IndexedMzMLHandler), so all data access functions may
+    be called concurrently from multiple threads on the same object, e.g.
 
     @code
-    #pragma omp parallel for firstprivate(ondisc_map) 
+    #pragma omp parallel for
+    for (SignedSize i = 0; i < (SignedSize)ondisc_map.getNrSpectra(); ++i)
+    {
+      MSSpectrum s = ondisc_map.getSpectrum(i);
+    }
     @endcode
 
+    Use getSpectra to retrieve a batch of spectra, which are then decoded in parallel.
+
   */
   class OPENMS_DLLAPI OnDiscMSExperiment
   {
@@ -104,7 +110,9 @@ public:
     OnDiscMSExperiment(const OnDiscMSExperiment& source) :
       filename_(source.filename_),
       indexed_mzml_file_(source.indexed_mzml_file_),
-      meta_ms_experiment_(source.meta_ms_experiment_)
+      meta_ms_experiment_(source.meta_ms_experiment_),
+      chromatograms_native_ids_(source.chromatograms_native_ids_),
+      spectra_native_ids_(source.spectra_native_ids_)
     {
     }
 
@@ -112,8 +120,8 @@ public:
       @brief Equality operator
 
       This only checks whether the underlying file is the same and the parsed
-      meta-information is the same. Note that the file reader (e.g. the
-      std::ifstream of the file) might be in a different state.
+      meta-information is the same. Note that the file mapping itself is not
+      compared.
     */
     bool operator==(const OnDiscMSExperiment& rhs) const
     {
@@ -194,7 +202,7 @@ public:
 
       @param id The index of the spectrum
     */
-    MSSpectrum getSpectrum(Size id)
+    MSSpectrum getSpectrum(Size id) const
     {
       if (!meta_ms_experiment_) return indexed_mzml_file_.getMSSpectrumById(int(id));
 
@@ -203,10 +211,19 @@ public:
       return spectrum;
     }
 
+    /**
+      @brief returns multiple spectra, decoded in parallel
+
+      @param ids The indices of the spectra
+
+      @throw Exception::IndexOverflow if any index is not within [0, getNrSpectra()-1]
+    */
+    std::vector<MSSpectrum> getSpectra(const std::vector<Size>& ids) const;
+
     /**
       @brief returns a single spectrum
     */
-    OpenMS::Interfaces::SpectrumPtr getSpectrumById(Size id)
+    OpenMS::Interfaces::SpectrumPtr getSpectrumById(Size id) const
     {
       return indexed_mzml_file_.getSpectrumById((int)id);
     }
@@ -216,7 +233,7 @@ public:
 
       @param id The index of the chromatogram
     */
-    MSChromatogram getChromatogram(Size id)
+    MSChromatogram getChromatogram(Size id) const
     {
       if (!meta_ms_experiment_) return indexed_mzml_file_.getMSChromatogramById(int(id));
 
@@ -230,19 +247,19 @@ public:
 
       @param id The native identifier of the chromatogram
     */
-    MSChromatogram getChromatogramByNativeId(const std::string& id);
+    MSChromatogram getChromatogramByNativeId(const std::string& id) const;
 
     /**
       @brief returns a single spectrum
 
       @param id The native identifier of the spectrum
     */
-    MSSpectrum getSpectrumByNativeId(const std::string& id);
+    MSSpectrum getSpectrumByNativeId(const std::string& id) const;
 
     /**
       @brief returns a single chromatogram
     */
-    OpenMS::Interfaces::ChromatogramPtr getChromatogramById(Size id)
+    OpenMS::Interfaces::ChromatogramPtr getChromatogramById(Size id) const
     {
       return indexed_mzml_file_.getChromatogramById(id);
     }
@@ -255,14 +272,14 @@ public:
 
 private:
 
-    /// Private Assignment operator -> we cannot copy file streams in IndexedMzMLHandler
+    /// Private Assignment operator
     OnDiscMSExperiment& operator=(const OnDiscMSExperiment& /* source */);
 
     void loadMetaData_(const String& filename);
 
-    MSChromatogram getMetaChromatogramById_(const std::string& id);
+    MSChromatogram getMetaChromatogramById_(const std::string& id) const;
 
-    MSSpectrum getMetaSpectrumById_(const std::string& id);
+    MSSpectrum getMetaSpectrumById_(const std::string& id) const;
 
 protected:
 
@@ -272,9 +289,9 @@ protected:
     Internal::IndexedMzMLHandler indexed_mzml_file_;
     /// The meta-data
     boost::shared_ptr<PeakMap> meta_ms_experiment_;
-    /// Mapping of chromatogram native ids to offsets
+    /// Mapping of chromatogram native ids to offsets (filled when loading the meta-data)
     std::unordered_map< std::string, Size > chromatograms_native_ids_;
-    /// Mapping of spectra native ids to offsets
+    /// Mapping of spectra native ids to offsets (filled when loading the meta-data)
     std::unordered_map< std::string, Size > spectra_native_ids_;
   };
 
@@ -131,8 +131,8 @@ public:
 
     /**
      * @brief Applies the peak-picking algorithm to a map (MSExperiment). This
-     * method picks peaks for each scan in the map consecutively. The resulting
-     * picked peaks are written to the output map.
+     * method picks the scans and chromatograms of the map in parallel. The
+     * resulting picked peaks are written to the output map in input order.
      *
      * @param input  input map in profile mode
      * @param output  output map with picked peaks
@@ -142,8 +142,8 @@ public:
 
     /**
      * @brief Applies the peak-picking algorithm to a map (MSExperiment). This
-     * method picks peaks for each scan in the map consecutively. The resulting
-     * picked peaks are written to the output map.
+     * method picks the scans and chromatograms of the map in parallel. The
+     * resulting picked peaks are written to the output map in input order.
      *
      * @param input  input map in profile mode
      * @param output  output map with picked peaks
@@ -159,8 +159,10 @@ public:
 
     /**
       @brief Applies the peak-picking algorithm to a map (MSExperiment). This
-      method picks peaks for each scan in the map consecutively. The resulting
-      picked peaks are written to the output map.
+      method picks the scans and chromatograms of the map in parallel. The
+      resulting picked peaks are written to the output map in input order.
+
+      For streaming data that does not fit into memory, see PeakPickerHiResConsumer.
 
       Currently we have to give up const-correctness but we know that everything on disc is constant
     */
@@ -0,0 +1,107 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/INTERFACES/IMSDataConsumer.h>
+#include <OpenMS/TRANSFORMATIONS/RAW2PEAK/PeakPickerHiRes.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Consumer that picks peaks in streamed spectra and chromatograms and passes them on
+
+    Spectra and chromatograms (e.g. streamed by MzMLFile::transform) are
+    collected in batches of @p batch_size, which are picked in parallel with
+    PeakPickerHiRes::pick and then passed on to the next consumer in input
+    order. Only one batch is kept in memory at a time, so large profile
+    files can be picked with bounded memory.
+
+    Spectra are picked if their MS level is listed in the "ms_levels"
+    parameter of the peak picker or, if the list is empty, if they are not
+    centroided. All other spectra are passed on unchanged. Chromatograms are
+    always picked.
+
+    @note Call flush() after the last spectrum or chromatogram has been
+    consumed to pass on the last batch. The next consumer has to outlive
+    this object.
+  */
+  class OPENMS_DLLAPI PeakPickerHiResConsumer :
+    public Interfaces::IMSDataConsumer
+  {
+  public:
+
+    /**
+      @brief Constructor
+
+      @param pp The peak picker (copied)
+      @param next_consumer The consumer which receives the picked data (not owned)
+      @param batch_size Number of spectra or chromatograms picked together
+    */
+    PeakPickerHiResConsumer(const PeakPickerHiRes& pp, Interfaces::IMSDataConsumer* next_consumer, Size batch_size = 500);
+
+    /// Destructor (passes on any data not yet flushed)
+    ~PeakPickerHiResConsumer() override;
+
+    void setExpectedSize(Size expectedSpectra, Size expectedChromatograms) override;
+
+    void setExperimentalSettings(const ExperimentalSettings& exp) override;
+
+    void consumeSpectrum(SpectrumType& s) override;
+
+    void consumeChromatogram(ChromatogramType& c) override;
+
+    /// Picks all buffered spectra and chromatograms and passes them on to the next consumer
+    void flush();
+
+  protected:
+
+    /// Picks and passes on all buffered spectra
+    void flushSpectra_();
+
+    /// Picks and passes on all buffered chromatograms
+    void flushChromatograms_();
+
+    PeakPickerHiRes pp_;
+    Interfaces::IMSDataConsumer* next_consumer_;
+    Size batch_size_;
+    std::vector<Int> ms_levels_;
+    std::vector<SpectrumType> spectra_;
+    std::vector<ChromatogramType> chromatograms_;
+  };
+
+} // namespace OpenMS
+
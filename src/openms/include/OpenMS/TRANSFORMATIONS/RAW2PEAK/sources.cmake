@@ -9,6 +9,7 @@ OptimizePeakDeconvolution.h
 OptimizePick.h
 PeakPickerCWT.h
 PeakPickerHiRes.h
+PeakPickerHiResConsumer.h
 PeakPickerIterative.h
 PeakPickerMaxima.h
 PeakPickerSH.h
@@ -42,6 +42,7 @@
 #include <OpenMS/METADATA/ProteinIdentification.h>
 #include <OpenMS/METADATA/PeptideIdentification.h>
 
+#include <exception>
 #include <numeric>
 
 namespace OpenMS
@@ -566,16 +567,17 @@ namespace OpenMS
     }
 
     // Depending on ion_mode_internal_, either positive or negative adducts are used
-    std::vector<AdductInfo>::const_iterator it_s, it_e;
+    const std::vector<AdductInfo>* adducts;
+    const std::vector<std::vector<bool> >* compatible;
     if (ion_mode == "positive")
     {
-      it_s = pos_adducts_.begin();
-      it_e = pos_adducts_.end();
+      adducts = &pos_adducts_;
+      compatible = &pos_compatible_;
     }
     else if (ion_mode == "negative")
     {
-      it_s = neg_adducts_.begin();
-      it_e = neg_adducts_.end();
+      adducts = &neg_adducts_;
+      compatible = &neg_compatible_;
     }
     else
     {
@@ -583,8 +585,11 @@ namespace OpenMS
     }
 
     std::pair<Size, Size> hit_idx;
-    for (std::vector<AdductInfo>::const_iterator it = it_s; it != it_e; ++it)
+    for (Size adduct_idx = 0; adduct_idx < adducts->size(); ++adduct_idx)
     {
+      std::vector<AdductInfo>::const_iterator it = adducts->begin() + adduct_idx;
+      const std::vector<bool>& adduct_compatible = (*compatible)[adduct_idx];
+
       if (observed_charge != 0 && (std::abs(observed_charge) != std::abs(it->getCharge())))
       { // charge of evidence and adduct must match in absolute terms (absolute, since any FeatureFinder gives only positive charges, even for negative-mode spectra)
         // observed_charge==0 will pass, since we basically do not know its real charge (apparently, no isotopes were found)
@@ -629,8 +634,8 @@ namespace OpenMS
       // store information from query hits in AccurateMassSearchResult objects
       for (Size i = hit_idx.first; i < hit_idx.second; ++i)
       {
-        // check if DB entry is compatible to the adduct
-        if (!it->isCompatible(EmpiricalFormula(mass_mappings_[i].formula)))
+        // check if DB entry is compatible to the adduct (precomputed in init())
+        if (!adduct_compatible[i])
         {
           // only written if TOPP tool has --debug
           OPENMS_LOG_DEBUG << "'" << mass_mappings_[i].formula << "' cannot have adduct '" << it->getName() << "'. Omitting.\n";
@@ -772,6 +777,9 @@ namespace OpenMS
     parseAdductsFile_(pos_adducts_fname_, pos_adducts_);
     parseAdductsFile_(neg_adducts_fname_, neg_adducts_);
 
+    computeAdductCompatibility_(pos_adducts_, pos_compatible_);
+    computeAdductCompatibility_(neg_adducts_, neg_compatible_);
+
     is_initialized_ = true;
   }
 
@@ -788,48 +796,70 @@ namespace OpenMS
       ion_mode_internal = resolveAutoMode_(fmap);
     }
 
-    // map for storing overall results
-    QueryResultsTable overall_results;
-    Size dummy_count(0);
-    for (Size i = 0; i < fmap.size(); ++i)
-    {
-      std::vector<AccurateMassSearchResult> query_results;
-
-      // std::cout << i << ": " << fmap[i].getMetaValue(3) << " mass: " << fmap[i].getMZ() << " num_traces: " << fmap[i].getMetaValue("num_of_masstraces") << " charge: " << fmap[i].getCharge() << std::endl;
-      queryByFeature(fmap[i], i, ion_mode_internal, query_results);
+    // query all features in parallel (the engine is read-only after init());
+    // results are collected per feature and reported in input order below
+    QueryResultsTable feature_results(fmap.size());
+    std::vector<char> missing_masstraces(fmap.size(), false);
+    Size error_idx = std::numeric_limits<Size>::max();
+    std::exception_ptr error;
 
-      if (query_results.size() == 0) continue; // cannot happen if a 'not-found' dummy was added
+#pragma omp parallel for schedule(dynamic, 100)
+    for (SignedSize i = 0; i < (SignedSize)fmap.size(); ++i)
+    {
+      try
+      {
+        std::vector<AccurateMassSearchResult>& query_results = feature_results[i];
+        queryByFeature(fmap[i], i, ion_mode_internal, query_results);
 
-      bool is_dummy = (query_results[0].getMatchingIndex() == (Size)-1);
-      if (is_dummy) ++dummy_count;
+        if (query_results.empty()) continue; // cannot happen if a 'not-found' dummy was added
 
-      if (iso_similarity_ && !is_dummy)
-      {
-        if (!fmap[i].metaValueExists("num_of_masstraces"))
+        bool is_dummy = (query_results[0].getMatchingIndex() == (Size)-1);
+        if (iso_similarity_ && !is_dummy)
         {
-          OPENMS_LOG_WARN << "Feature does not contain meta value 'num_of_masstraces'. Cannot compute isotope similarity.";
-        }
-        else if ((Size)fmap[i].getMetaValue("num_of_masstraces") > 1)
-        { // compute isotope pattern similarities (do not take the best-scoring one, since it might have really bad ppm or other properties --
-          // it is impossible to decide here which one is best
-          for (Size hit_idx = 0; hit_idx < query_results.size(); ++hit_idx)
+          if (!fmap[i].metaValueExists("num_of_masstraces"))
           {
-            String emp_formula(query_results[hit_idx].getFormulaString());
-            double iso_sim(computeIsotopePatternSimilarity_(fmap[i], EmpiricalFormula(emp_formula)));
-            query_results[hit_idx].setIsotopesSimScore(iso_sim);
+            missing_masstraces[i] = true;
+          }
+          else if ((Size)fmap[i].getMetaValue("num_of_masstraces") > 1)
+          { // compute isotope pattern similarities (do not take the best-scoring one, since it might have really bad ppm or other properties --
+            // it is impossible to decide here which one is best
+            for (Size hit_idx = 0; hit_idx < query_results.size(); ++hit_idx)
+            {
+              String emp_formula(query_results[hit_idx].getFormulaString());
+              double iso_sim(computeIsotopePatternSimilarity_(fmap[i], EmpiricalFormula(emp_formula)));
+              query_results[hit_idx].setIsotopesSimScore(iso_sim);
+            }
           }
         }
       }
+      catch (...)
+      {
+#pragma omp critical (AccurateMassSearchEngine_error)
+        if ((Size)i < error_idx)
+        {
+          error_idx = i;
+          error = std::current_exception();
+        }
+      }
+    }
+    if (error) std::rethrow_exception(error);
 
-      // debug output
-      //        for (Size hit_idx = 0; hit_idx < query_results.size(); ++hit_idx)
-      //        {
-      //            query_results[hit_idx].outputResults();
-      //        }
+    // map for storing overall results
+    QueryResultsTable overall_results;
+    Size dummy_count(0);
+    for (Size i = 0; i < fmap.size(); ++i)
+    {
+      std::vector<AccurateMassSearchResult>& query_results = feature_results[i];
+      if (query_results.empty()) continue;
+
+      if (query_results[0].getMatchingIndex() == (Size)-1) ++dummy_count;
+      if (missing_masstraces[i])
+      {
+        OPENMS_LOG_WARN << "Feature does not contain meta value 'num_of_masstraces'. Cannot compute isotope similarity.";
+      }
 
-      // String feat_label(fmap[i].getMetaValue(3));
-      overall_results.push_back(query_results);
       annotate_(query_results, fmap[i]);
+      overall_results.push_back(std::move(query_results));
     }
     // add dummy protein identification which is required to keep peptidehits alive during store()
     fmap.getProteinIdentifications().resize(fmap.getProteinIdentifications().size() + 1);
@@ -902,16 +932,33 @@ namespace OpenMS
     ConsensusMap::ColumnHeaders fd_map = cmap.getColumnHeaders();
     Size num_of_maps = fd_map.size();
 
-    // map for storing overall results
-    QueryResultsTable overall_results;
+    // map for storing overall results (queried in parallel, annotated in input order)
+    QueryResultsTable overall_results(cmap.size());
+    Size error_idx = std::numeric_limits<Size>::max();
+    std::exception_ptr error;
+
+#pragma omp parallel for schedule(dynamic, 100)
+    for (SignedSize i = 0; i < (SignedSize)cmap.size(); ++i)
+    {
+      try
+      {
+        queryByConsensusFeature(cmap[i], i, num_of_maps, ion_mode_internal, overall_results[i]);
+      }
+      catch (...)
+      {
+#pragma omp critical (AccurateMassSearchEngine_error)
+        if ((Size)i < error_idx)
+        {
+          error_idx = i;
+          error = std::current_exception();
+        }
+      }
+    }
+    if (error) std::rethrow_exception(error);
 
     for (Size i = 0; i < cmap.size(); ++i)
     {
-      std::vector<AccurateMassSearchResult> query_results;
-      // std::cout << i << ": " << cmap[i].getMetaValue(3) << " mass: " << cmap[i].getMZ() << " num_traces: " << cmap[i].getMetaValue("num_of_masstraces") << " charge: " << cmap[i].getCharge() << std::endl;
-      queryByConsensusFeature(cmap[i], i, num_of_maps, ion_mode_internal, query_results);
-      annotate_(query_results, cmap[i]);
-      overall_results.push_back(query_results);
+      annotate_(overall_results[i], cmap[i]);
     }
     // add dummy protein identification which is required to keep peptidehits alive during store()
     cmap.getProteinIdentifications().resize(cmap.getProteinIdentifications().size() + 1);
@@ -1457,6 +1504,59 @@ namespace OpenMS
     return;
   }
 
+  void AccurateMassSearchEngine::computeAdductCompatibility_(const std::vector<AdductInfo>& adducts, std::vector<std::vector<bool> >& compatible) const
+  {
+    compatible.assign(adducts.size(), std::vector<bool>(mass_mappings_.size(), false));
+    if (adducts.empty()) return;
+
+    // parse every DB formula only once (instead of once per adduct and query);
+    // each thread writes whole blocks of 64 entries to avoid sharing the words of std::vector<bool>
+    const SignedSize block_size = 64;
+    const SignedSize n_blocks = (mass_mappings_.size() + block_size - 1) / block_size;
+    Size error_idx = std::numeric_limits<Size>::max();
+    std::exception_ptr error;
+    std::vector<Size> unparsable; // entries whose formula cannot be parsed are incompatible with all adducts
+
+#pragma omp parallel for schedule(dynamic, 16)
+    for (SignedSize block = 0; block < n_blocks; ++block)
+    {
+      const Size end = std::min(Size((block + 1) * block_size), mass_mappings_.size());
+      for (Size i = block * block_size; i < end; ++i)
+      {
+        try
+        {
+          EmpiricalFormula db_entry(mass_mappings_[i].formula);
+          for (Size adduct_idx = 0; adduct_idx < adducts.size(); ++adduct_idx)
+          {
+            compatible[adduct_idx][i] = adducts[adduct_idx].isCompatible(db_entry);
+          }
+        }
+        catch (Exception::ParseError&)
+        {
+#pragma omp critical (AccurateMassSearchEngine_error)
+          unparsable.push_back(i);
+        }
+        catch (...)
+        {
+#pragma omp critical (AccurateMassSearchEngine_error)
+          if (i < error_idx)
+          {
+            error_idx = i;
+            error = std::current_exception();
+          }
+        }
+      }
+    }
+    if (error) std::rethrow_exception(error);
+
+    std::sort(unparsable.begin(), unparsable.end());
+    for (Size i : unparsable)
+    {
+      OPENMS_LOG_WARN << "Formula '" << mass_mappings_[i].formula << "' of database entry " << ListUtils::concatenate(mass_mappings_[i].massIDs, ",")
+                      << " cannot be parsed. The entry will not be reported for any adduct." << std::endl;
+    }
+  }
+
   void AccurateMassSearchEngine::searchMass_(double neutral_query_mass, double diff_mass, std::pair<Size, Size>& hit_indices) const
   {
     //OPENMS_LOG_INFO << "searchMass: neutral_query_mass=" << neutral_query_mass << " diff_mz=" << diff_mz << " ppm allowed:" << mass_error_value_ << std::endl;
@@ -0,0 +1,484 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/ANALYSIS/ID/FragmentIonIndex.h>
+
+#include <OpenMS/CHEMISTRY/AASequence.h>
+#include <OpenMS/CHEMISTRY/CompactAASequence.h>
+#include <OpenMS/CHEMISTRY/FragmentIonLadder.h>
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/MATH/MISC/MathFunctions.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <fstream>
+#include <limits>
+
+using namespace std;
+
+namespace OpenMS
+{
+  namespace
+  {
+    const UInt32 FRAGMENT_ION_INDEX_MAGIC = 0x46494931; // "FII1"
+    const UInt32 FRAGMENT_ION_INDEX_VERSION = 1;
+
+    template <typename T>
+    void writeValue_(ofstream& ofs, const T& value)
+    {
+      ofs.write((const char*)&value, sizeof(value));
+    }
+
+    template <typename T>
+    void readValue_(ifstream& ifs, T& value)
+    {
+      ifs.read((char*)&value, sizeof(value));
+    }
+
+    void writeString_(ofstream& ofs, const String& s)
+    {
+      UInt64 length = s.size();
+      writeValue_(ofs, length);
+      ofs.write(s.c_str(), length);
+    }
+
+    /// true if @p count elements of @p element_size bytes can still be read before @p end (sets the failbit otherwise)
+    bool fits_(ifstream& ifs, UInt64 count, Size element_size, streamoff end)
+    {
+      const streamoff pos = ifs.tellg();
+      if (!ifs || pos < 0 || pos > end || count > UInt64(end - pos) / element_size)
+      {
+        ifs.setstate(std::ios::failbit);
+        return false;
+      }
+      return true;
+    }
+
+    void readString_(ifstream& ifs, String& s, streamoff end)
+    {
+      UInt64 length = 0;
+      readValue_(ifs, length);
+      if (!fits_(ifs, length, 1, end)) return;
+      s.resize(length);
+      if (length > 0) ifs.read(&s[0], length);
+    }
+
+    template <typename T>
+    void writeVector_(ofstream& ofs, const vector<T>& v)
+    {
+      UInt64 size = v.size();
+      writeValue_(ofs, size);
+      if (size > 0) ofs.write((const char*)&v[0], size * sizeof(T));
+    }
+
+    template <typename T>
+    void readVector_(ifstream& ifs, vector<T>& v, streamoff end)
+    {
+      UInt64 size = 0;
+      readValue_(ifs, size);
+      if (!fits_(ifs, size, sizeof(T), end)) return;
+      v.resize(size);
+      if (size > 0) ifs.read((char*)&v[0], size * sizeof(T));
+    }
+
+    /// fragment bins of a single (modified) peptide during building
+    struct IndexedPeptide
+    {
+      FragmentIonIndex::Peptide peptide;
+      vector<UInt32> bins;
+    };
+  }
+
+  FragmentIonIndex::FragmentIonIndex() :
+    bin_size_(0.05)
+  {
+  }
+
+  void FragmentIonIndex::build(vector<String> sequences,
+                               const ModifiedPeptideGenerator::MapToResidueType& fixed_modifications,
+                               const ModifiedPeptideGenerator::MapToResidueType& variable_modifications,
+                               Size max_variable_mods_per_peptide,
+                               double bin_size)
+  {
+    if (!(bin_size > 0.0) || !std::isfinite(bin_size))
+    {
+      throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Fragment bin size must be positive.");
+    }
+
+    sort(sequences.begin(), sequences.end());
+    sequences.erase(unique(sequences.begin(), sequences.end()), sequences.end());
+
+    sequences_.swap(sequences);
+    bin_size_ = bin_size;
+
+    // generate all modified variants and their fragment bins (independently per sequence)
+    vector<vector<IndexedPeptide> > variants(sequences_.size());
+    Size error_idx = numeric_limits<Size>::max();
+    std::exception_ptr error;
+
+#pragma omp parallel for schedule(dynamic, 100)
+    for (SignedSize i = 0; i < (SignedSize)sequences_.size(); ++i)
+    {
+      try
+      {
+        AASequence aas = AASequence::fromString(sequences_[i]);
+        ModifiedPeptideGenerator::applyFixedModifications(fixed_modifications, aas);
+        vector<AASequence> all_modified_peptides;
+        ModifiedPeptideGenerator::applyVariableModifications(variable_modifications, aas, max_variable_mods_per_peptide, all_modified_peptides);
+
+        CompactAASequence compact;
+        FragmentIonLadder ladder;
+        vector<IndexedPeptide>& current = variants[i];
+        current.resize(all_modified_peptides.size());
+        for (Size j = 0; j != all_modified_peptides.size(); ++j)
+        {
+          compact.assign(all_modified_peptides[j]);
+          ladder.generate<true, true, 1, 1>(compact, true);
+
+          IndexedPeptide& ip = current[j];
+          ip.peptide.sequence_index = (UInt32)i;
+          ip.peptide.modification_index = (UInt32)j;
+          ip.peptide.mass = compact.getMonoWeight();
+
+          // ladder is sorted by m/z, so bins are non-decreasing
+          ip.bins.reserve(ladder.size());
+          for (double mz : ladder.mz)
+          {
+            // bin + 1 is used as offset index, so the largest bin must stay below the UInt32 range
+            const double bin_index = floor(mz / bin_size_);
+            if (!(bin_index < (double)numeric_limits<UInt32>::max()))
+            {
+              throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                "Fragment bin size " + String(bin_size_) + " is too small for fragment m/z " + String(mz) + ".");
+            }
+            UInt32 bin = (UInt32)bin_index;
+            if (ip.bins.empty() || ip.bins.back() != bin) ip.bins.push_back(bin);
+          }
+        }
+      }
+      catch (...)
+      {
+#pragma omp critical (FragmentIonIndex_error)
+        {
+          if ((Size)i < error_idx)
+          {
+            error_idx = i;
+            error = std::current_exception();
+          }
+        }
+      }
+    }
+    if (error) std::rethrow_exception(error);
+
+    // sort peptides by mass (ties resolved by sequence and variant for a deterministic order)
+    vector<const IndexedPeptide*> order;
+    for (const auto& v : variants)
+    {
+      for (const auto& ip : v) order.push_back(&ip);
+    }
+    sort(order.begin(), order.end(), [](const IndexedPeptide* a, const IndexedPeptide* b)
+    {
+      if (a->peptide.mass != b->peptide.mass) return a->peptide.mass < b->peptide.mass;
+      if (a->peptide.sequence_index != b->peptide.sequence_index) return a->peptide.sequence_index < b->peptide.sequence_index;
+      return a->peptide.modification_index < b->peptide.modification_index;
+    });
+
+    if (order.size() > (Size)numeric_limits<UInt32>::max())
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Too many peptides for fragment ion index.", String(order.size()));
+    }
+
+    // count postings per bin ...
+    UInt32 max_bin = 0;
+    for (const IndexedPeptide* ip : order)
+    {
+      if (!ip->bins.empty()) max_bin = std::max(max_bin, ip->bins.back());
+    }
+    bin_offsets_.assign(order.empty() ? 1 : (Size)max_bin + 2, 0);
+    for (const IndexedPeptide* ip : order)
+    {
+      for (UInt32 bin : ip->bins) ++bin_offsets_[bin + 1];
+    }
+    for (Size b = 1; b < bin_offsets_.size(); ++b) bin_offsets_[b] += bin_offsets_[b - 1];
+
+    // ... and fill them in peptide order (so postings of each bin are sorted)
+    peptides_.clear();
+    peptides_.reserve(order.size());
+    postings_.resize(bin_offsets_.back());
+    vector<UInt64> next(bin_offsets_.begin(), bin_offsets_.end() - 1);
+    for (const IndexedPeptide* ip : order)
+    {
+      const UInt32 peptide_index = (UInt32)peptides_.size();
+      peptides_.push_back(ip->peptide);
+      for (UInt32 bin : ip->bins) postings_[next[bin]++] = peptide_index;
+    }
+  }
+
+  void FragmentIonIndex::store(const String& filename) const
+  {
+    ofstream ofs(filename.c_str(), std::ios::binary);
+    if (!ofs)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+
+    writeValue_(ofs, FRAGMENT_ION_INDEX_MAGIC);
+    writeValue_(ofs, FRAGMENT_ION_INDEX_VERSION);
+    writeValue_(ofs, bin_size_);
+    writeString_(ofs, settings_);
+
+    UInt64 n_sequences = sequences_.size();
+    writeValue_(ofs, n_sequences);
+    for (const String& s : sequences_) writeString_(ofs, s);
+
+    UInt64 n_peptides = peptides_.size();
+    writeValue_(ofs, n_peptides);
+    for (const Peptide& p : peptides_)
+    {
+      writeValue_(ofs, p.sequence_index);
+      writeValue_(ofs, p.modification_index);
+      writeValue_(ofs, p.mass);
+    }
+
+    writeVector_(ofs, bin_offsets_);
+    writeVector_(ofs, postings_);
+
+    if (!ofs)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+  }
+
+  void FragmentIonIndex::load(const String& filename)
+  {
+    if (!File::exists(filename))
+    {
+      throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+
+    ifstream ifs(filename.c_str(), std::ios::binary | std::ios::ate);
+    // sizes read from the file are checked against its length before allocating
+    const streamoff end = ifs.tellg();
+    ifs.seekg(0, std::ios::beg);
+    UInt32 magic = 0, version = 0;
+    readValue_(ifs, magic);
+    readValue_(ifs, version);
+    if (!ifs || magic != FRAGMENT_ION_INDEX_MAGIC || version != FRAGMENT_ION_INDEX_VERSION)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "File might not be a fragment ion index file (wrong magic number or version). Aborting!", filename);
+    }
+
+    FragmentIonIndex tmp;
+    readValue_(ifs, tmp.bin_size_);
+    if (!ifs || !(tmp.bin_size_ > 0.0) || !std::isfinite(tmp.bin_size_))
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "Invalid fragment bin size in fragment ion index file. Aborting!", filename);
+    }
+    readString_(ifs, tmp.settings_, end);
+
+    UInt64 n_sequences = 0;
+    readValue_(ifs, n_sequences);
+    if (fits_(ifs, n_sequences, sizeof(UInt64), end))
+    {
+      tmp.sequences_.resize(n_sequences);
+      for (String& s : tmp.sequences_) readString_(ifs, s, end);
+    }
+
+    UInt64 n_peptides = 0;
+    readValue_(ifs, n_peptides);
+    const Size peptide_record_size = sizeof(UInt32) + sizeof(UInt32) + sizeof(double);
+    if (fits_(ifs, n_peptides, peptide_record_size, end))
+    {
+      tmp.peptides_.resize(n_peptides);
+      for (Peptide& p : tmp.peptides_)
+      {
+        readValue_(ifs, p.sequence_index);
+        readValue_(ifs, p.modification_index);
+        readValue_(ifs, p.mass);
+      }
+    }
+
+    readVector_(ifs, tmp.bin_offsets_, end);
+    readVector_(ifs, tmp.postings_, end);
+
+    if (!ifs || tmp.bin_offsets_.empty() || tmp.bin_offsets_.front() != 0 || tmp.bin_offsets_.back() != tmp.postings_.size())
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "Fragment ion index file is truncated or corrupt. Aborting!", filename);
+    }
+
+    // the search accesses all of these without further checks
+    for (Size b = 1; b < tmp.bin_offsets_.size(); ++b)
+    {
+      if (tmp.bin_offsets_[b] < tmp.bin_offsets_[b - 1])
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Fragment ion index file is corrupt (bin offsets are not sorted). Aborting!", filename);
+      }
+    }
+    for (UInt32 posting : tmp.postings_)
+    {
+      if (posting >= tmp.peptides_.size())
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Fragment ion index file is corrupt (invalid peptide " + String(posting) + " in postings). Aborting!", filename);
+      }
+    }
+    for (Size i = 0; i < tmp.peptides_.size(); ++i)
+    {
+      const Peptide& p = tmp.peptides_[i];
+      if (p.sequence_index >= tmp.sequences_.size())
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Fragment ion index file is corrupt (invalid sequence " + String(p.sequence_index) + " of peptide " + String(i) + "). Aborting!", filename);
+      }
+      // getPeptideRange() relies on peptides sorted by mass
+      if (i > 0 && p.mass < tmp.peptides_[i - 1].mass)
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Fragment ion index file is corrupt (peptides are not sorted by mass). Aborting!", filename);
+      }
+    }
+
+    *this = std::move(tmp);
+  }
+
+  void FragmentIonIndex::setSettings(const String& settings)
+  {
+    settings_ = settings;
+  }
+
+  const String& FragmentIonIndex::getSettings() const
+  {
+    return settings_;
+  }
+
+  double FragmentIonIndex::getBinSize() const
+  {
+    return bin_size_;
+  }
+
+  Size FragmentIonIndex::size() const
+  {
+    return peptides_.size();
+  }
+
+  const FragmentIonIndex::Peptide& FragmentIonIndex::getPeptide(Size index) const
+  {
+    return peptides_[index];
+  }
+
+  const String& FragmentIonIndex::getSequence(Size sequence_index) const
+  {
+    return sequences_[sequence_index];
+  }
+
+  AASequence FragmentIonIndex::getModifiedSequence(Size index,
+                                                   const ModifiedPeptideGenerator::MapToResidueType& fixed_modifications,
+                                                   const ModifiedPeptideGenerator::MapToResidueType& variable_modifications,
+                                                   Size max_variable_mods_per_peptide) const
+  {
+    const Peptide& p = peptides_[index];
+    AASequence aas = AASequence::fromString(sequences_[p.sequence_index]);
+    ModifiedPeptideGenerator::applyFixedModifications(fixed_modifications, aas);
+    vector<AASequence> all_modified_peptides;
+    ModifiedPeptideGenerator::applyVariableModifications(variable_modifications, aas, max_variable_mods_per_peptide, all_modified_peptides);
+    if (p.modification_index >= all_modified_peptides.size())
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, p.modification_index, all_modified_peptides.size());
+    }
+    return all_modified_peptides[p.modification_index];
+  }
+
+  pair<Size, Size> FragmentIonIndex::getPeptideRange(double min_mass, double max_mass) const
+  {
+    auto first = lower_bound(peptides_.begin(), peptides_.end(), min_mass,
+      [](const Peptide& p, double mass) { return p.mass < mass; });
+    auto last = upper_bound(first, peptides_.end(), max_mass,
+      [](double mass, const Peptide& p) { return mass < p.mass; });
+    return make_pair(Size(first - peptides_.begin()), Size(last - peptides_.begin()));
+  }
+
+  void FragmentIonIndex::countSharedPeaks(const PeakSpectrum& spectrum,
+                                          double fragment_mass_tolerance,
+                                          bool fragment_mass_tolerance_unit_ppm,
+                                          Size first,
+                                          Size last,
+                                          vector<UInt32>& counts) const
+  {
+    counts.assign(last > first ? last - first : 0, 0);
+    if (counts.empty() || bin_offsets_.size() < 2) return;
+
+    // last peak counted for each peptide (a peak may hit several bins of the same peptide)
+    vector<UInt32> last_peak(counts.size(), 0);
+    const Size n_bins = bin_offsets_.size() - 1;
+
+    for (Size k = 0; k != spectrum.size(); ++k)
+    {
+      const double mz = spectrum[k].getMZ();
+      // ppm tolerances refer to the theoretical m/z, so the window is widened slightly
+      // to cover all theoretical fragments that match this peak (and float rounding)
+      double tolerance = fragment_mass_tolerance_unit_ppm ? Math::ppmToMass(fragment_mass_tolerance, mz) * 1.001 : fragment_mass_tolerance;
+      tolerance += 1e-6;
+
+      const double low_mz = std::max(0.0, mz - tolerance);
+      Size low_bin = (Size)floor(low_mz / bin_size_);
+      Size high_bin = (Size)floor((mz + tolerance) / bin_size_);
+      if (low_bin >= n_bins) break; // spectrum is sorted: no peptide has fragments beyond this point
+      high_bin = std::min(high_bin, n_bins - 1);
+
+      const UInt32 stamp = (UInt32)k + 1;
+      for (Size bin = low_bin; bin <= high_bin; ++bin)
+      {
+        auto begin = postings_.begin() + bin_offsets_[bin];
+        auto end = postings_.begin() + bin_offsets_[bin + 1];
+        for (auto it = lower_bound(begin, end, (UInt32)first); it != end && *it < last; ++it)
+        {
+          const Size i = *it - first;
+          if (last_peak[i] != stamp)
+          {
+            last_peak[i] = stamp;
+            ++counts[i];
+          }
+        }
+      }
+    }
+  }
+
+} // namespace OpenMS
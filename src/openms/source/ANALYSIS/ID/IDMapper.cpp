@@ -36,6 +36,7 @@
 #include <OpenMS/MATH/MISC/MathFunctions.h>
 #include <OpenMS/METADATA/SpectrumLookup.h>
 
+#include <exception>
 #include <unordered_set>
 
 
@@ -44,6 +45,44 @@ using namespace std;
 namespace OpenMS
 {
 
+  namespace
+  {
+    /// (m/z, consensus feature index) of all consensus features or all of their sub-elements, sorted by m/z
+    typedef vector<pair<double, Size> > ConsensusMZIndex;
+
+    ConsensusMZIndex buildConsensusMZIndex_(const ConsensusMap& map, bool measure_from_subelements)
+    {
+      ConsensusMZIndex index;
+      index.reserve(map.size());
+      for (Size cm_index = 0; cm_index < map.size(); ++cm_index)
+      {
+        if (!measure_from_subelements)
+        {
+          index.emplace_back(map[cm_index].getMZ(), cm_index);
+          continue;
+        }
+        for (const FeatureHandle& handle : map[cm_index].getFeatures())
+        {
+          index.emplace_back(handle.getMZ(), cm_index);
+        }
+      }
+      sort(index.begin(), index.end());
+      return index;
+    }
+
+    /// appends the indices of all consensus features with a position within @p mz_tolerance (absolute) of @p mz to @p candidates
+    void addConsensusCandidates_(const ConsensusMZIndex& index, double mz, double mz_tolerance, vector<Size>& candidates)
+    {
+      // the window is widened slightly, since candidates are checked exactly by the caller
+      const double tolerance = mz_tolerance * (1.0 + 1e-9) + 1e-9;
+      ConsensusMZIndex::const_iterator it = lower_bound(index.begin(), index.end(), make_pair(mz - tolerance, Size(0)));
+      for (; it != index.end() && it->first <= mz + tolerance; ++it)
+      {
+        candidates.push_back(it->second);
+      }
+    }
+  }
+
   IDMapper::IDMapper() :
     DefaultParamHandler("IDMapper"),
     rt_tolerance_(5.0),
@@ -271,109 +310,132 @@ namespace OpenMS
     // keep track of assigned/unassigned precursors
     std::map<Size, Size> assigned_precursors;
 
-    // store which peptides fit which feature (and avoid double entries)
-    // consensusMap -> {peptide_index}
-    vector<set<size_t>> mapping(map.size());
-
-    DoubleList mz_values;
-    double rt_pep;
-    IntList charges;
+    // index consensus features (or their sub-elements) by m/z, so that each
+    // ID is only compared to features within its m/z tolerance instead of the whole map
+    const ConsensusMZIndex mz_index = buildConsensusMZIndex_(map, measure_from_subelements);
 
     // for statistics
     Size id_matches_none(0), id_matches_single(0), id_matches_multiple(0);
 
-    // iterate over the peptide IDs
-    for (Size i = 0; i < ids.size(); ++i)
+    // find matching consensus features for all IDs in parallel: per ID, pairs of
+    // consensus feature index (ascending) and map index of the matching sub-element (or -1)
+    vector<vector<pair<Size, Int> > > id_matches(ids.size());
+    Size error_idx = numeric_limits<Size>::max();
+    exception_ptr error;
+
+#pragma omp parallel for schedule(dynamic, 100)
+    for (SignedSize i = 0; i < (SignedSize)ids.size(); ++i)
     {
       if (ids[i].getHits().empty()) continue;
 
-      getIDDetails_(ids[i], rt_pep, mz_values, charges);
-
-      bool id_mapped(false);
-
-      // iterate over the features
-      for (Size cm_index = 0; cm_index < map.size(); ++cm_index)
+      try
       {
-        // if set to TRUE, we leave the i_mz-loop as we added the whole ID with all hits
-        bool was_added = false; // was current pep-m/z matched?!
+        DoubleList mz_values;
+        double rt_pep;
+        IntList charges;
+        getIDDetails_(ids[i], rt_pep, mz_values, charges);
 
-        // iterate over m/z values of pepIds
+        vector<Size> candidates;
         for (Size i_mz = 0; i_mz < mz_values.size(); ++i_mz)
         {
-          double mz_pep = mz_values[i_mz];
+          addConsensusCandidates_(mz_index, mz_values[i_mz], getAbsoluteMZTolerance_(mz_values[i_mz]), candidates);
+        }
+        sort(candidates.begin(), candidates.end());
+        candidates.erase(unique(candidates.begin(), candidates.end()), candidates.end());
 
-          // charge states to use for checking:
-          IntList current_charges;
-          if (!ignore_charge_)
+        // iterate over the candidate features
+        for (Size cm_index : candidates)
+        {
+          // iterate over m/z values of pepIds
+          for (Size i_mz = 0; i_mz < mz_values.size(); ++i_mz)
           {
-            // if "mz_ref." is "precursor", we have only one m/z value to check,
-            // but still one charge state per peptide hit that could match:
-            if (mz_values.size() == 1)
-            {
-              current_charges = charges;
-            }
-            else
+            double mz_pep = mz_values[i_mz];
+
+            // charge states to use for checking:
+            IntList current_charges;
+            if (!ignore_charge_)
             {
-              current_charges.push_back(charges[i_mz]);
+              // if "mz_ref." is "precursor", we have only one m/z value to check,
+              // but still one charge state per peptide hit that could match:
+              if (mz_values.size() == 1)
+              {
+                current_charges = charges;
+              }
+              else
+              {
+                current_charges.push_back(charges[i_mz]);
+              }
+              current_charges.push_back(0); // "not specified" always matches
             }
-            current_charges.push_back(0); // "not specified" always matches
-          }
 
-          //check if we compare distance from centroid or subelements
-          if (!measure_from_subelements)
-          {
-            if (isMatch_(rt_pep - map[cm_index].getRT(), mz_pep, map[cm_index].getMZ()) && (ignore_charge_ || ListUtils::contains(current_charges, map[cm_index].getCharge())))
+            bool was_added = false; // was current pep-m/z matched?!
+
+            //check if we compare distance from centroid or subelements
+            if (!measure_from_subelements)
             {
-              id_mapped = true;
-              was_added = true;
-              map[cm_index].getPeptideIdentifications().push_back(ids[i]);
-              ++assigned_ids[i];
+              if (isMatch_(rt_pep - map[cm_index].getRT(), mz_pep, map[cm_index].getMZ()) && (ignore_charge_ || ListUtils::contains(current_charges, map[cm_index].getCharge())))
+              {
+                id_matches[i].emplace_back(cm_index, -1);
+                was_added = true;
+              }
             }
-          }
-          else
-          {
-            for (ConsensusFeature::HandleSetType::const_iterator it_handle = map[cm_index].getFeatures().begin();
-                 it_handle != map[cm_index].getFeatures().end();
-                 ++it_handle)
+            else
             {
-              if (isMatch_(rt_pep - it_handle->getRT(), mz_pep, it_handle->getMZ())  && (ignore_charge_ || ListUtils::contains(current_charges, it_handle->getCharge())))
+              for (ConsensusFeature::HandleSetType::const_iterator it_handle = map[cm_index].getFeatures().begin();
+                   it_handle != map[cm_index].getFeatures().end();
+                   ++it_handle)
               {
-                id_mapped = true;
-                was_added = true;
-                if (mapping[cm_index].count(i) == 0)
+                if (isMatch_(rt_pep - it_handle->getRT(), mz_pep, it_handle->getMZ())  && (ignore_charge_ || ListUtils::contains(current_charges, it_handle->getCharge())))
                 {
                   // Store the map index of the peptide feature in the id the feature was mapped to.
-                  PeptideIdentification id_pep = ids[i];
-                  if (annotate_ids_with_subelements)
-                  {
-                    id_pep.setMetaValue("map_index", it_handle->getMapIndex());
-                  }
-
-                  map[cm_index].getPeptideIdentifications().push_back(id_pep);
-                  ++assigned_ids[i];
-                  mapping[cm_index].insert(i);
+                  id_matches[i].emplace_back(cm_index, annotate_ids_with_subelements ? Int(it_handle->getMapIndex()) : -1);
+                  was_added = true;
+                  break; // we added this peptide already.. no need to check other handles
                 }
-                break; // we added this peptide already.. no need to check other handles
               }
             }
-            // continue to here
-          }
 
-          if (was_added) break;
-
-        } // m/z values to check
+            // we added the whole ID with all hits, no need to check other m/z values
+            if (was_added) break;
 
-        // break to here
+          } // m/z values to check
+        } // features
+      }
+      catch (...)
+      {
+#pragma omp critical (IDMapper_error)
+        if ((Size)i < error_idx)
+        {
+          error_idx = i;
+          error = current_exception();
+        }
+      }
+    } // Identifications
+    if (error) rethrow_exception(error);
 
-      } // features
+    // annotate in the order of the IDs (as a serial search would)
+    for (Size i = 0; i < ids.size(); ++i)
+    {
+      if (ids[i].getHits().empty()) continue;
 
       // the id has not been mapped to any consensus feature
-      if (!id_mapped)
+      if (id_matches[i].empty())
       {
         map.getUnassignedPeptideIdentifications().push_back(ids[i]);
         ++id_matches_none;
+        continue;
       }
-    } // Identifications
+
+      for (const pair<Size, Int>& match : id_matches[i])
+      {
+        map[match.first].getPeptideIdentifications().push_back(ids[i]);
+        if (match.second >= 0)
+        {
+          map[match.first].getPeptideIdentifications().back().setMetaValue("map_index", Size(match.second));
+        }
+        ++assigned_ids[i];
+      }
+    }
 
     for (std::map<Size, Size>::const_iterator it = assigned_ids.begin(); it != assigned_ids.end(); ++it)
     {
@@ -453,8 +515,13 @@ namespace OpenMS
         }
         precursor_empty_id.setIdentifier(empty_protein_id.getIdentifier());
 
-        // iterate over the consensus features
-        for (Size cm_index = 0; cm_index < map.size(); ++cm_index)
+        // iterate over the consensus features close in m/z (in map order)
+        vector<Size> candidates;
+        addConsensusCandidates_(mz_index, mz_p, getAbsoluteMZTolerance_(mz_p), candidates);
+        sort(candidates.begin(), candidates.end());
+        candidates.erase(unique(candidates.begin(), candidates.end()), candidates.end());
+
+        for (Size cm_index : candidates)
         {
           // charge states to use for checking:
           IntList current_charges;
@@ -39,6 +39,8 @@
 #include <OpenMS/ANALYSIS/RNPXL/HyperScore.h>
 
 #include <OpenMS/CHEMISTRY/ModificationsDB.h>
+#include <OpenMS/CHEMISTRY/CompactAASequence.h>
+#include <OpenMS/CHEMISTRY/FragmentIonLadder.h>
 #include <OpenMS/CHEMISTRY/TheoreticalSpectrumGenerator.h>
 #include <OpenMS/CHEMISTRY/ResidueModification.h>
 #include <OpenMS/CHEMISTRY/DecoyGenerator.h>
@@ -59,6 +61,7 @@
 
 #include <OpenMS/FORMAT/MzMLFile.h>
 #include <OpenMS/FORMAT/FASTAFile.h>
+#include <OpenMS/SYSTEM/File.h>
 
 #include <OpenMS/KERNEL/MSSpectrum.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
@@ -73,6 +76,7 @@
 
 #include <map>
 #include <algorithm>
+#include <limits>
 
 #ifdef _OPENMP
   #include <omp.h>
@@ -83,6 +87,26 @@ using namespace std;
 
 namespace OpenMS
 {
+  namespace
+  {
+    /// 64-bit FNV-1a hash over all peptides (each followed by a separator), stable across runs and platforms
+    UInt64 hashPeptides(const vector<String>& peptides)
+    {
+      UInt64 hash = 14695981039346656037ULL;
+      auto add = [&hash](unsigned char c)
+      {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+      };
+      for (const String& p : peptides)
+      {
+        for (char c : p) add((unsigned char)c);
+        add(',');
+      }
+      return hash;
+    }
+  }
+
   SimpleSearchEngineAlgorithm::SimpleSearchEngineAlgorithm() :
     DefaultParamHandler("SimpleSearchEngineAlgorithm"),
     ProgressLogger()
@@ -146,6 +170,15 @@ namespace OpenMS
     defaults_.setValue("report:top_hits", 1, "Maximum number of top scoring hits per spectrum that are reported.");
     defaults_.setSectionDescription("report", "Reporting Options");
 
+    defaults_.setValue("fragment_index:use", "false", "Search with a fragment ion index: candidates are pre-scored by the number of shared fragment peaks and only the best ones are scored with the HyperScore (faster for wide precursor tolerances).");
+    defaults_.setValidStrings("fragment_index:use", {"true","false"} );
+    defaults_.setValue("fragment_index:file", "", "If set, the fragment ion index is loaded from this file (if it was built with the same database and settings) or stored in it after building.");
+    defaults_.setValue("fragment_index:bin_size", 0.05, "Width of the fragment m/z bins of the index (in Th).");
+    defaults_.setMinFloat("fragment_index:bin_size", 0.001);
+    defaults_.setValue("fragment_index:max_candidates", 100, "Number of candidates (with most shared fragment peaks) per spectrum scored with the HyperScore (0 = all candidates sharing at least one peak, same results as without index).");
+    defaults_.setMinInt("fragment_index:max_candidates", 0);
+    defaults_.setSectionDescription("fragment_index", "Fragment Ion Index Options");
+
     defaultsToParam_();
   }
 
@@ -178,6 +211,11 @@ namespace OpenMS
 
     report_top_hits_ = param_.getValue("report:top_hits");
 
+    fragment_index_use_ = param_.getValue("fragment_index:use") == "true";
+    fragment_index_file_ = param_.getValue("fragment_index:file");
+    fragment_index_bin_size_ = param_.getValue("fragment_index:bin_size");
+    fragment_index_max_candidates_ = param_.getValue("fragment_index:max_candidates");
+
     decoys_ = param_.getValue("decoys") == "true";
     annotate_psm_ = param_.getValue("annotate:PSM");
   }
@@ -375,6 +413,224 @@ void SimpleSearchEngineAlgorithm::postProcessHits_(const PeakMap& exp,
     protein_ids[0].setSearchParameters(std::move(search_parameters));
   }
 
+  void SimpleSearchEngineAlgorithm::createFragmentIndex_(const vector<FASTAFile::FASTAEntry>& fasta_db,
+    const ProteaseDigestion& digestor,
+    const ModifiedPeptideGenerator::MapToResidueType& fixed_modifications,
+    const ModifiedPeptideGenerator::MapToResidueType& variable_modifications,
+    FragmentIonIndex& index) const
+  {
+    boost::regex peptide_motif_regex(peptide_motif_);
+
+    // digest database (same filters as the search without index)
+    startProgress(0, 1, "Digesting database...");
+    vector<vector<String> > digests(fasta_db.size());
+#pragma omp parallel for schedule(dynamic, 100)
+    for (SignedSize fasta_index = 0; fasta_index < (SignedSize)fasta_db.size(); ++fasta_index)
+    {
+      vector<StringView> current_digest;
+      digestor.digestUnmodified(fasta_db[fasta_index].sequence, current_digest, peptide_min_size_, peptide_max_size_);
+      for (auto const & c : current_digest)
+      {
+        String current_peptide = c.getString();
+        if (current_peptide.find_first_of("XBZ") != std::string::npos) { continue; }
+        if (!peptide_motif_.empty() && !boost::regex_match(current_peptide, peptide_motif_regex)) { continue; }
+        digests[fasta_index].push_back(std::move(current_peptide));
+      }
+    }
+    vector<String> peptides;
+    for (auto& d : digests)
+    {
+      peptides.insert(peptides.end(), std::make_move_iterator(d.begin()), std::make_move_iterator(d.end()));
+    }
+    vector<vector<String> >().swap(digests);
+    sort(peptides.begin(), peptides.end());
+    peptides.erase(unique(peptides.begin(), peptides.end()), peptides.end());
+    endProgress();
+
+    // everything the index content depends on (the peptide order of the database does not matter)
+    String settings = "bin_size=" + String(fragment_index_bin_size_)
+      + ";fixed=" + ListUtils::concatenate(modifications_fixed_, ",")
+      + ";variable=" + ListUtils::concatenate(modifications_variable_, ",")
+      + ";variable_max_per_peptide=" + String(modifications_max_variable_mods_per_peptide_)
+      + ";peptides=" + String(peptides.size())
+      + ";hash=" + String(hashPeptides(peptides));
+
+    if (!fragment_index_file_.empty() && File::exists(fragment_index_file_))
+    {
+      try
+      {
+        index.load(fragment_index_file_);
+        if (index.getSettings() == settings)
+        {
+          OPENMS_LOG_INFO << "Loaded fragment ion index with " << index.size() << " peptides from '" << fragment_index_file_ << "'." << endl;
+          return;
+        }
+        OPENMS_LOG_WARN << "Fragment ion index in '" << fragment_index_file_ << "' was built with different database or settings. Rebuilding it." << endl;
+      }
+      catch (Exception::BaseException& e)
+      {
+        OPENMS_LOG_WARN << "Fragment ion index in '" << fragment_index_file_ << "' could not be read (" << e.what() << "). Rebuilding it." << endl;
+      }
+    }
+
+    startProgress(0, 1, "Building fragment ion index...");
+    index.build(std::move(peptides), fixed_modifications, variable_modifications, modifications_max_variable_mods_per_peptide_, fragment_index_bin_size_);
+    index.setSettings(settings);
+    endProgress();
+    OPENMS_LOG_INFO << "Built fragment ion index with " << index.size() << " peptides." << endl;
+
+    if (!fragment_index_file_.empty())
+    {
+      index.store(fragment_index_file_);
+    }
+  }
+
+  void SimpleSearchEngineAlgorithm::searchFragmentIndex_(const PeakMap& spectra,
+    const FragmentIonIndex& index,
+    const ModifiedPeptideGenerator::MapToResidueType& fixed_modifications,
+    const ModifiedPeptideGenerator::MapToResidueType& variable_modifications,
+    bool precursor_mass_tolerance_unit_ppm,
+    bool fragment_mass_tolerance_unit_ppm,
+    vector<vector<AnnotatedHit_> >& annotated_hits) const
+  {
+    // variant of a peptide that does not exist for its sequence (index does not match the modifications)
+    bool invalid_variant = false;
+    Size invalid_modification_index = 0, invalid_variant_count = 0;
+
+    // each spectrum is processed by a single thread, so no locking of the hits is needed
+#pragma omp parallel for schedule(dynamic, 10)
+    for (SignedSize scan_index = 0; scan_index < (SignedSize)spectra.size(); ++scan_index)
+    {
+      const PeakSpectrum& exp_spectrum = spectra[scan_index];
+      const vector<Precursor>& precursor = exp_spectrum.getPrecursors();
+
+      // same spectrum filters as for the precursor mass lookup
+      if (precursor.size() != 1 || exp_spectrum.size() < peptide_min_size_) { continue; }
+      Size precursor_charge = precursor[0].getCharge();
+      if (precursor_charge < precursor_min_charge_ || precursor_charge > precursor_max_charge_) { continue; }
+      const double precursor_mz = precursor[0].getMZ();
+
+      // candidates (with shared peak counts) of all considered precursor masses
+      vector<pair<UInt32, UInt32> > candidates; // (shared peaks, peptide index)
+      vector<UInt32> counts;
+      for (int isotope_number : precursor_isotopes_)
+      {
+        double precursor_mass = (double) precursor_charge * precursor_mz - (double) precursor_charge * Constants::PROTON_MASS_U;
+        if (isotope_number != 0) { precursor_mass -= isotope_number * Constants::C13C12_MASSDIFF_U; }
+
+        // peptide masses m with |precursor_mass - m| <= 0.5 * tolerance(m) (see search without index)
+        double min_mass, max_mass;
+        if (precursor_mass_tolerance_unit_ppm)
+        {
+          const double half_tolerance = 0.5 * precursor_mass_tolerance_ * 1e-6;
+          min_mass = precursor_mass / (1.0 + half_tolerance);
+          max_mass = precursor_mass / (1.0 - half_tolerance);
+        }
+        else
+        {
+          min_mass = precursor_mass - 0.5 * precursor_mass_tolerance_;
+          max_mass = precursor_mass + 0.5 * precursor_mass_tolerance_;
+        }
+        // widened for rounding, exact check below
+        pair<Size, Size> range = index.getPeptideRange(min_mass - 1e-6, max_mass + 1e-6);
+        if (range.first == range.second) { continue; }
+
+        index.countSharedPeaks(exp_spectrum, fragment_mass_tolerance_, fragment_mass_tolerance_unit_ppm, range.first, range.second, counts);
+        for (Size i = 0; i != counts.size(); ++i)
+        {
+          if (counts[i] == 0) { continue; }
+          const double mass = index.getPeptide(range.first + i).mass;
+          const double tolerance = precursor_mass_tolerance_unit_ppm ? 0.5 * mass * precursor_mass_tolerance_ * 1e-6 : 0.5 * precursor_mass_tolerance_;
+          if (precursor_mass < mass - tolerance || precursor_mass > mass + tolerance) { continue; }
+          candidates.emplace_back(counts[i], (UInt32)(range.first + i));
+        }
+      }
+      if (candidates.empty()) { continue; }
+
+      // remove candidates found for several precursor masses
+      sort(candidates.begin(), candidates.end(), [](const pair<UInt32, UInt32>& a, const pair<UInt32, UInt32>& b)
+      {
+        return a.second < b.second;
+      });
+      candidates.erase(unique(candidates.begin(), candidates.end()), candidates.end());
+
+      // keep the candidates with most shared peaks
+      if (fragment_index_max_candidates_ > 0 && candidates.size() > fragment_index_max_candidates_)
+      {
+        auto more_shared_peaks = [](const pair<UInt32, UInt32>& a, const pair<UInt32, UInt32>& b)
+        {
+          if (a.first != b.first) return a.first > b.first;
+          return a.second < b.second;
+        };
+        std::nth_element(candidates.begin(), candidates.begin() + fragment_index_max_candidates_, candidates.end(), more_shared_peaks);
+        candidates.resize(fragment_index_max_candidates_);
+      }
+
+      // group candidates by sequence, so modified variants are generated once per sequence
+      sort(candidates.begin(), candidates.end(), [&index](const pair<UInt32, UInt32>& a, const pair<UInt32, UInt32>& b)
+      {
+        const FragmentIonIndex::Peptide& pa = index.getPeptide(a.second);
+        const FragmentIonIndex::Peptide& pb = index.getPeptide(b.second);
+        if (pa.sequence_index != pb.sequence_index) return pa.sequence_index < pb.sequence_index;
+        return pa.modification_index < pb.modification_index;
+      });
+
+      vector<AnnotatedHit_>& hits = annotated_hits[scan_index];
+      vector<AASequence> all_modified_peptides;
+      UInt32 current_sequence_index = numeric_limits<UInt32>::max();
+      CompactAASequence compact_candidate;
+      FragmentIonLadder theo_ladder;
+      for (const auto& c : candidates)
+      {
+        const FragmentIonIndex::Peptide& peptide = index.getPeptide(c.second);
+        if (peptide.sequence_index != current_sequence_index)
+        {
+          current_sequence_index = peptide.sequence_index;
+          AASequence aas = AASequence::fromString(index.getSequence(current_sequence_index));
+          ModifiedPeptideGenerator::applyFixedModifications(fixed_modifications, aas);
+          all_modified_peptides.clear();
+          ModifiedPeptideGenerator::applyVariableModifications(variable_modifications, aas, modifications_max_variable_mods_per_peptide_, all_modified_peptides);
+        }
+
+        if (peptide.modification_index >= all_modified_peptides.size())
+        {
+          // cannot throw inside the parallel region, reported below
+#pragma omp critical (fragment_index_error)
+          {
+            invalid_variant = true;
+            invalid_modification_index = peptide.modification_index;
+            invalid_variant_count = all_modified_peptides.size();
+          }
+          continue;
+        }
+
+        compact_candidate.assign(all_modified_peptides[peptide.modification_index]);
+        theo_ladder.generate<true, true, 1, 1>(compact_candidate, true);
+        const double score = HyperScore::compute(fragment_mass_tolerance_, fragment_mass_tolerance_unit_ppm, exp_spectrum, theo_ladder);
+
+        if (score == 0) { continue; } // no hit?
+
+        AnnotatedHit_ ah;
+        ah.sequence = StringView(index.getSequence(current_sequence_index));
+        ah.peptide_mod_index = peptide.modification_index;
+        ah.score = score;
+        hits.push_back(ah);
+
+        // prevent vector from growing indefinitly (memory) but don't shrink the vector every time
+        if (hits.size() >= 2 * report_top_hits_)
+        {
+          std::partial_sort(hits.begin(), hits.begin() + report_top_hits_, hits.end(), AnnotatedHit_::hasBetterScore);
+          hits.resize(report_top_hits_);
+        }
+      }
+    }
+
+    if (invalid_variant)
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, invalid_modification_index, invalid_variant_count);
+    }
+  }
+
   SimpleSearchEngineAlgorithm::ExitCodes SimpleSearchEngineAlgorithm::search(const String& in_mzML, const String& in_db, vector<ProteinIdentification>& protein_ids, vector<PeptideIdentification>& peptide_ids) const
   {
     boost::regex peptide_motif_regex(peptide_motif_);
@@ -449,13 +705,6 @@ void SimpleSearchEngineAlgorithm::postProcessHits_(const PeakMap& exp,
       }
     }
 
-    // create spectrum generator
-    TheoreticalSpectrumGenerator spectrum_generator;
-    Param param(spectrum_generator.getParameters());
-    param.setValue("add_first_prefix_ion", "true");
-    param.setValue("add_metainfo", "true");
-    spectrum_generator.setParameters(param);
-
     // preallocate storage for PSMs
     vector<vector<AnnotatedHit_> > annotated_hits(spectra.size(), vector<AnnotatedHit_>());
     for (auto & a : annotated_hits) { a.reserve(2 * report_top_hits_); }
@@ -496,138 +745,151 @@ void SimpleSearchEngineAlgorithm::postProcessHits_(const PeakMap& exp,
       endProgress();
       digestor.setMissedCleavages(peptide_missed_cleavages_);
     }
-    startProgress(0, fasta_db.size(), "Scoring peptide models against spectra...");
 
-    // lookup for processed peptides. must be defined outside of omp section and synchronized
-    set<StringView> processed_petides;
-
-    Size count_proteins(0), count_peptides(0);
+    // kept alive until post-processing (the hits refer to its sequences)
+    FragmentIonIndex fragment_index;
+    if (fragment_index_use_)
+    {
+      createFragmentIndex_(fasta_db, digestor, fixed_modifications, variable_modifications, fragment_index);
 
-#pragma omp parallel for schedule(static) default(none) shared(annotated_hits, spectrum_generator, multimap_mass_2_scan_index, fixed_modifications, variable_modifications, fasta_db, digestor, processed_petides, count_proteins, count_peptides, precursor_mass_tolerance_unit_ppm, fragment_mass_tolerance_unit_ppm, peptide_motif_regex, spectra, annotated_hits_lock)
-      for (SignedSize fasta_index = 0; fasta_index < (SignedSize)fasta_db.size(); ++fasta_index)
-      {
+      startProgress(0, 1, "Scoring spectra with fragment ion index...");
+      searchFragmentIndex_(spectra, fragment_index, fixed_modifications, variable_modifications, precursor_mass_tolerance_unit_ppm, fragment_mass_tolerance_unit_ppm, annotated_hits);
+      endProgress();
+    }
+    else
+    {
+      startProgress(0, fasta_db.size(), "Scoring peptide models against spectra...");
 
-      #pragma omp atomic
-      ++count_proteins;
+      // lookup for processed peptides. must be defined outside of omp section and synchronized
+      set<StringView> processed_petides;
 
-      IF_MASTERTHREAD
-      {
-        setProgress(count_proteins);
-      }
+      Size count_proteins(0), count_peptides(0);
 
-      vector<StringView> current_digest;
-      digestor.digestUnmodified(fasta_db[fasta_index].sequence, current_digest, peptide_min_size_, peptide_max_size_);
+#pragma omp parallel for schedule(static) default(none) shared(annotated_hits, multimap_mass_2_scan_index, fixed_modifications, variable_modifications, fasta_db, digestor, processed_petides, count_proteins, count_peptides, precursor_mass_tolerance_unit_ppm, fragment_mass_tolerance_unit_ppm, peptide_motif_regex, spectra, annotated_hits_lock)
+        for (SignedSize fasta_index = 0; fasta_index < (SignedSize)fasta_db.size(); ++fasta_index)
+        {
 
-      for (auto const & c : current_digest)
-      { 
-        const String current_peptide = c.getString();
-        if (current_peptide.find_first_of("XBZ") != std::string::npos) { continue; }
+        #pragma omp atomic
+        ++count_proteins;
 
-        // if a peptide motif is provided skip all peptides without match
-        if (!peptide_motif_.empty() && !boost::regex_match(current_peptide, peptide_motif_regex)) { continue; }          
-      
-        bool already_processed = false;
-        #pragma omp critical (processed_peptides_access)
+        IF_MASTERTHREAD
         {
-          // peptide (and all modified variants) already processed so skip it
-          if (processed_petides.find(c) != processed_petides.end())
-          {
-            already_processed = true;
-          }
-          else
-          {
-            processed_petides.insert(c);
-          }
+          setProgress(count_proteins);
         }
 
-        // skip peptides that have already been processed
-        if (already_processed) { continue; }
+        vector<StringView> current_digest;
+        digestor.digestUnmodified(fasta_db[fasta_index].sequence, current_digest, peptide_min_size_, peptide_max_size_);
 
-        #pragma omp atomic
-        ++count_peptides;
+        // reused for all candidates of this protein
+        CompactAASequence compact_candidate;
+        FragmentIonLadder theo_ladder;
 
-        vector<AASequence> all_modified_peptides;
+        for (auto const & c : current_digest)
+        { 
+          const String current_peptide = c.getString();
+          if (current_peptide.find_first_of("XBZ") != std::string::npos) { continue; }
 
-        // this critial section is because ResidueDB is not thread safe and new residues are created based on the PTMs
-        #pragma omp critical (residuedb_access)
-        {
-          AASequence aas = AASequence::fromString(current_peptide);
-          ModifiedPeptideGenerator::applyFixedModifications(fixed_modifications, aas);
-          ModifiedPeptideGenerator::applyVariableModifications(variable_modifications, aas, modifications_max_variable_mods_per_peptide_, all_modified_peptides);
-        }
+          // if a peptide motif is provided skip all peptides without match
+          if (!peptide_motif_.empty() && !boost::regex_match(current_peptide, peptide_motif_regex)) { continue; }          
+      
+          bool already_processed = false;
+          #pragma omp critical (processed_peptides_access)
+          {
+            // peptide (and all modified variants) already processed so skip it
+            if (processed_petides.find(c) != processed_petides.end())
+            {
+              already_processed = true;
+            }
+            else
+            {
+              processed_petides.insert(c);
+            }
+          }
 
-        for (SignedSize mod_pep_idx = 0; mod_pep_idx < (SignedSize)all_modified_peptides.size(); ++mod_pep_idx)
-        {
-          const AASequence& candidate = all_modified_peptides[mod_pep_idx];
-          double current_peptide_mass = candidate.getMonoWeight();
+          // skip peptides that have already been processed
+          if (already_processed) { continue; }
 
-          // determine MS2 precursors that match to the current peptide mass
-          multimap<double, Size>::const_iterator low_it;
-          multimap<double, Size>::const_iterator up_it;
+          #pragma omp atomic
+          ++count_peptides;
 
-          if (precursor_mass_tolerance_unit_ppm) // ppm
+          vector<AASequence> all_modified_peptides;
+
+          // this critial section is because ResidueDB is not thread safe and new residues are created based on the PTMs
+          #pragma omp critical (residuedb_access)
           {
-            low_it = multimap_mass_2_scan_index.lower_bound(current_peptide_mass - 0.5 * current_peptide_mass * precursor_mass_tolerance_ * 1e-6);
-            up_it = multimap_mass_2_scan_index.upper_bound(current_peptide_mass + 0.5 * current_peptide_mass * precursor_mass_tolerance_ * 1e-6);
+            AASequence aas = AASequence::fromString(current_peptide);
+            ModifiedPeptideGenerator::applyFixedModifications(fixed_modifications, aas);
+            ModifiedPeptideGenerator::applyVariableModifications(variable_modifications, aas, modifications_max_variable_mods_per_peptide_, all_modified_peptides);
           }
-          else // Dalton
+
+          for (SignedSize mod_pep_idx = 0; mod_pep_idx < (SignedSize)all_modified_peptides.size(); ++mod_pep_idx)
           {
-            low_it = multimap_mass_2_scan_index.lower_bound(current_peptide_mass - 0.5 * precursor_mass_tolerance_);
-            up_it = multimap_mass_2_scan_index.upper_bound(current_peptide_mass + 0.5 * precursor_mass_tolerance_);
-          }
+            const AASequence& candidate = all_modified_peptides[mod_pep_idx];
+            double current_peptide_mass = candidate.getMonoWeight();
 
-          // no matching precursor in data
-          if (low_it == up_it) { continue; }
+            // determine MS2 precursors that match to the current peptide mass
+            multimap<double, Size>::const_iterator low_it;
+            multimap<double, Size>::const_iterator up_it;
 
-          // create theoretical spectrum
-          PeakSpectrum theo_spectrum;
+            if (precursor_mass_tolerance_unit_ppm) // ppm
+            {
+              low_it = multimap_mass_2_scan_index.lower_bound(current_peptide_mass - 0.5 * current_peptide_mass * precursor_mass_tolerance_ * 1e-6);
+              up_it = multimap_mass_2_scan_index.upper_bound(current_peptide_mass + 0.5 * current_peptide_mass * precursor_mass_tolerance_ * 1e-6);
+            }
+            else // Dalton
+            {
+              low_it = multimap_mass_2_scan_index.lower_bound(current_peptide_mass - 0.5 * precursor_mass_tolerance_);
+              up_it = multimap_mass_2_scan_index.upper_bound(current_peptide_mass + 0.5 * precursor_mass_tolerance_);
+            }
 
-          // add peaks for b and y ions with charge 1
-          spectrum_generator.getSpectrum(theo_spectrum, candidate, 1, 1);
+            // no matching precursor in data
+            if (low_it == up_it) { continue; }
 
-          // sort by mz
-          theo_spectrum.sortByPosition();
+            // create theoretical spectrum: b (including b1) and y ions with charge 1, sorted by m/z
+            compact_candidate.assign(candidate);
+            theo_ladder.generate<true, true, 1, 1>(compact_candidate, true);
 
-          for (; low_it != up_it; ++low_it)
-          {
-            const Size& scan_index = low_it->second;
-            const PeakSpectrum& exp_spectrum = spectra[scan_index];
-            // const int& charge = exp_spectrum.getPrecursors()[0].getCharge();
-            const double& score = HyperScore::compute(fragment_mass_tolerance_, fragment_mass_tolerance_unit_ppm, exp_spectrum, theo_spectrum);
+            for (; low_it != up_it; ++low_it)
+            {
+              const Size& scan_index = low_it->second;
+              const PeakSpectrum& exp_spectrum = spectra[scan_index];
+              // const int& charge = exp_spectrum.getPrecursors()[0].getCharge();
+              const double& score = HyperScore::compute(fragment_mass_tolerance_, fragment_mass_tolerance_unit_ppm, exp_spectrum, theo_ladder);
 
-            if (score == 0) { continue; } // no hit?
+              if (score == 0) { continue; } // no hit?
 
-            // add peptide hit
-            AnnotatedHit_ ah;
-            ah.sequence = c;
-            ah.peptide_mod_index = mod_pep_idx;
-            ah.score = score;
+              // add peptide hit
+              AnnotatedHit_ ah;
+              ah.sequence = c;
+              ah.peptide_mod_index = mod_pep_idx;
+              ah.score = score;
 
 #ifdef _OPENMP
-            omp_set_lock(&(annotated_hits_lock[scan_index]));
-            {
-#endif
-              annotated_hits[scan_index].push_back(ah);
-
-              // prevent vector from growing indefinitly (memory) but don't shrink the vector every time
-              if (annotated_hits[scan_index].size() >= 2 * report_top_hits_)
+              omp_set_lock(&(annotated_hits_lock[scan_index]));
               {
-                std::partial_sort(annotated_hits[scan_index].begin(), annotated_hits[scan_index].begin() + report_top_hits_, annotated_hits[scan_index].end(), AnnotatedHit_::hasBetterScore);
-                annotated_hits[scan_index].resize(report_top_hits_); 
-              }
+#endif
+                annotated_hits[scan_index].push_back(ah);
+
+                // prevent vector from growing indefinitly (memory) but don't shrink the vector every time
+                if (annotated_hits[scan_index].size() >= 2 * report_top_hits_)
+                {
+                  std::partial_sort(annotated_hits[scan_index].begin(), annotated_hits[scan_index].begin() + report_top_hits_, annotated_hits[scan_index].end(), AnnotatedHit_::hasBetterScore);
+                  annotated_hits[scan_index].resize(report_top_hits_); 
+                }
 #ifdef _OPENMP
-            }
-            omp_unset_lock(&(annotated_hits_lock[scan_index]));
+              }
+              omp_unset_lock(&(annotated_hits_lock[scan_index]));
 #endif
+            }
           }
         }
       }
-    }
-    endProgress();
+      endProgress();
 
-    OPENMS_LOG_INFO << "Proteins: " << count_proteins << endl;
-    OPENMS_LOG_INFO << "Peptides: " << count_peptides << endl;
-    OPENMS_LOG_INFO << "Processed peptides: " << processed_petides.size() << endl;
+      OPENMS_LOG_INFO << "Proteins: " << count_proteins << endl;
+      OPENMS_LOG_INFO << "Peptides: " << count_peptides << endl;
+      OPENMS_LOG_INFO << "Processed peptides: " << processed_petides.size() << endl;
+    }
 
     startProgress(0, 1, "Post-processing PSMs...");
     SimpleSearchEngineAlgorithm::postProcessHits_(spectra, 
@@ -19,6 +19,7 @@ ConsensusIDAlgorithmSimilarity.cpp
 ConsensusIDAlgorithmWorst.cpp
 ConsensusMapMergerAlgorithm.cpp
 FalseDiscoveryRate.cpp
+FragmentIonIndex.cpp
 FIAMSDataProcessor.cpp
 FIAMSScheduler.cpp
 HiddenMarkovModel.cpp
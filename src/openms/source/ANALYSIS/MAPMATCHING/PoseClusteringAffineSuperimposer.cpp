@@ -37,6 +37,12 @@
 #include <OpenMS/MATH/STATISTICS/BasicStatistics.h>
 #include <OpenMS/MATH/MISC/LinearInterpolation.h>
 
+#include <atomic>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 
 // #define Debug_PoseClusteringAffineSuperimposer
 
@@ -176,135 +182,185 @@ namespace OpenMS
       dump_pairs_file << "#" << ' ' << "i" << ' ' << "j" << ' ' << "k" << ' ' << "l" << ' ' << std::endl;
     }
 
-    // first point in model map (i)
-    for (Size i = 0, i_low = 0, i_high = 0, k_low = 0, k_high = 0; i < model_map_size - 1; ++i)
+    // Points i of the model map are processed independently (in parallel).
+    // Each thread votes into its own copy of the hash tables; the copies are
+    // added up in thread order afterwards. Dumping pairs writes to a single
+    // file, so this is done single-threaded.
+    typedef Math::LinearInterpolation<double, double> LinearInterpolationType_;
+    std::vector<std::vector<LinearInterpolationType_> > thread_hashes;
+
+    // both maps are sorted by m/z
+    auto mz_less = [](const Peak2D& p, double mz) { return p.getMZ() < mz; };
+    auto mz_greater = [](double mz, const Peak2D& p) { return mz < p.getMZ(); };
+
+#pragma omp parallel if (!do_dump_pairs)
     {
-      // Adjust window around i in model map (get all features in a m/z range of item i in the model map)
-      while (i_low < model_map_size && model_map[i_low].getMZ() < model_map[i].getMZ() - mz_pair_max_distance)
-        ++i_low;
-      while (i_high < model_map_size && model_map[i_high].getMZ() <= model_map[i].getMZ() + mz_pair_max_distance)
-        ++i_high;
-      // stop if there are too many features are in our window
-      double i_winlength_factor = 1. / (i_high - i_low);
-      i_winlength_factor -= winlength_factor_baseline;
-      if (i_winlength_factor <= 0)
-        continue;
-
-      // Adjust window around k in scene map (get all features in a m/z range of item i in the scene map)
-      while (k_low < scene_map_size && scene_map[k_low].getMZ() < model_map[i].getMZ() - mz_pair_max_distance)
-        ++k_low;
-      while (k_high < scene_map_size && scene_map[k_high].getMZ() <= model_map[i].getMZ() + mz_pair_max_distance)
-        ++k_high;
-
-      // Iterate through all matching features in the scene map that are
-      // within the m/z distance of item i from the model map.
-      // first point in scene map (k)
-      for (Size k = k_low; k < k_high; ++k)
+#ifdef _OPENMP
+      const Size thread = omp_get_thread_num();
+#pragma omp single
+      thread_hashes.resize(omp_get_num_threads());
+#else
+      const Size thread = 0;
+      thread_hashes.resize(1);
+#endif
+
+      // same mapping as the shared hash tables, but empty
+      std::vector<LinearInterpolationType_> hashes = { scaling_hash_1, scaling_hash_2, rt_low_hash_, rt_high_hash_ };
+      for (LinearInterpolationType_& h : hashes)
       {
+        std::fill(h.getData().begin(), h.getData().end(), 0.0);
+      }
+      LinearInterpolationType_& thread_scaling_hash_1 = hashes[0];
+      LinearInterpolationType_& thread_scaling_hash_2 = hashes[1];
+      LinearInterpolationType_& thread_rt_low_hash = hashes[2];
+      LinearInterpolationType_& thread_rt_high_hash = hashes[3];
+
+      // first point in model map (i)
+      // (cyclic schedule: the work per point decreases with i)
+#pragma omp for schedule(static, 1)
+      for (SignedSize i = 0; i < (SignedSize)model_map_size - 1; ++i)
+      {
+        // Window around i in model map (get all features in a m/z range of item i in the model map)
+        const double mz_i = model_map[i].getMZ();
+        const Size i_low = std::lower_bound(model_map.begin(), model_map.end(), mz_i - mz_pair_max_distance, mz_less) - model_map.begin();
+        const Size i_high = std::upper_bound(model_map.begin(), model_map.end(), mz_i + mz_pair_max_distance, mz_greater) - model_map.begin();
         // stop if there are too many features are in our window
-        double k_winlength_factor = 1. / (k_high - k_low);
-        k_winlength_factor -= winlength_factor_baseline;
-        if (k_winlength_factor <= 0)
+        double i_winlength_factor = 1. / (i_high - i_low);
+        i_winlength_factor -= winlength_factor_baseline;
+        if (i_winlength_factor <= 0)
           continue;
 
-        // compute similarity of intensities i k by taking the ratio of the two intensities
-        double similarity_ik;
-        {
-          const double int_i = model_map[i].getIntensity();
-          const double int_k = scene_map[k].getIntensity() * total_intensity_ratio;
-          similarity_ik = (int_i < int_k) ? int_i / int_k : int_k / int_i;
-          // weight is inverse proportional to number of elements with similar mz
-          similarity_ik *= i_winlength_factor;
-          similarity_ik *= k_winlength_factor;
-        }
+        // Window around k in scene map (get all features in a m/z range of item i in the scene map)
+        const Size k_low = std::lower_bound(scene_map.begin(), scene_map.end(), mz_i - mz_pair_max_distance, mz_less) - scene_map.begin();
+        const Size k_high = std::upper_bound(scene_map.begin(), scene_map.end(), mz_i + mz_pair_max_distance, mz_greater) - scene_map.begin();
 
-        // second point in model map (j)
-        for (Size j = i + 1, j_low = i_low, j_high = i_low, l_low = k_low, l_high = k_high; j < model_map_size; ++j)
+        // Iterate through all matching features in the scene map that are
+        // within the m/z distance of item i from the model map.
+        // first point in scene map (k)
+        for (Size k = k_low; k < k_high; ++k)
         {
-          // diff in model map -> skip features that are too far away in RT
-          double diff_model = model_map[j].getRT() - model_map[i].getRT();
-          if (fabs(diff_model) < rt_pair_min_distance)
+          // stop if there are too many features are in our window
+          double k_winlength_factor = 1. / (k_high - k_low);
+          k_winlength_factor -= winlength_factor_baseline;
+          if (k_winlength_factor <= 0)
             continue;
 
-          // Adjust window around j in model map
-          while (j_low < model_map_size && model_map[j_low].getMZ() < model_map[i].getMZ() - mz_pair_max_distance)
-            ++j_low;
-          while (j_high < model_map_size && model_map[j_high].getMZ() <= model_map[i].getMZ() + mz_pair_max_distance)
-            ++j_high;
-          double j_winlength_factor = 1. / (j_high - j_low);
-          j_winlength_factor -= winlength_factor_baseline;
-          if (j_winlength_factor <= 0)
-            continue;
-
-          // Adjust window around l in scene map
-          while (l_low < scene_map_size && scene_map[l_low].getMZ() < model_map[j].getMZ() - mz_pair_max_distance)
-            ++l_low;
-          while (l_high < scene_map_size && scene_map[l_high].getMZ() <= model_map[j].getMZ() + mz_pair_max_distance)
-            ++l_high;
+          // compute similarity of intensities i k by taking the ratio of the two intensities
+          double similarity_ik;
+          {
+            const double int_i = model_map[i].getIntensity();
+            const double int_k = scene_map[k].getIntensity() * total_intensity_ratio;
+            similarity_ik = (int_i < int_k) ? int_i / int_k : int_k / int_i;
+            // weight is inverse proportional to number of elements with similar mz
+            similarity_ik *= i_winlength_factor;
+            similarity_ik *= k_winlength_factor;
+          }
 
-          // second point in scene map (l)
-          for (Size l = l_low; l < l_high; ++l)
+          // second point in model map (j)
+          for (Size j = i + 1, j_low = i_low, j_high = i_low, l_low = k_low, l_high = k_high; j < model_map_size; ++j)
           {
-            double l_winlength_factor = 1. / (l_high - l_low);
-            l_winlength_factor -= winlength_factor_baseline;
-            if (l_winlength_factor <= 0)
+            // diff in model map -> skip features that are too far away in RT
+            double diff_model = model_map[j].getRT() - model_map[i].getRT();
+            if (fabs(diff_model) < rt_pair_min_distance)
               continue;
 
-            // diff in scene map -> skip features that are too far away in RT
-            double diff_scene = scene_map[l].getRT() - scene_map[k].getRT();
-
-            // avoid cross mappings (i,j) -> (k,l) (e.g. i_rt < j_rt and k_rt > l_rt)
-            // and point pairs with equal retention times (e.g. i_rt == j_rt)
-            if (fabs(diff_scene) < rt_pair_min_distance || ((diff_model > 0) != (diff_scene > 0)))
+            // Adjust window around j in model map
+            while (j_low < model_map_size && model_map[j_low].getMZ() < model_map[i].getMZ() - mz_pair_max_distance)
+              ++j_low;
+            while (j_high < model_map_size && model_map[j_high].getMZ() <= model_map[i].getMZ() + mz_pair_max_distance)
+              ++j_high;
+            double j_winlength_factor = 1. / (j_high - j_low);
+            j_winlength_factor -= winlength_factor_baseline;
+            if (j_winlength_factor <= 0)
               continue;
 
-            // compute the transformation (i,j) -> (k,l)
-            double scaling = diff_model / diff_scene;
-            double shift = model_map[i].getRT() - scene_map[k].getRT() * scaling;
+            // Adjust window around l in scene map
+            while (l_low < scene_map_size && scene_map[l_low].getMZ() < model_map[j].getMZ() - mz_pair_max_distance)
+              ++l_low;
+            while (l_high < scene_map_size && scene_map[l_high].getMZ() <= model_map[j].getMZ() + mz_pair_max_distance)
+              ++l_high;
 
-            // compute similarity of intensities i k j l
-            double similarity_ik_jl;
+            // second point in scene map (l)
+            for (Size l = l_low; l < l_high; ++l)
             {
-              // compute similarity of intensities j l
-              const double int_j = model_map[j].getIntensity();
-              const double int_l = scene_map[l].getIntensity() * total_intensity_ratio;
-              double similarity_jl = (int_j < int_l) ? int_j / int_l : int_l / int_j;
-              // weight is inverse proportional to number of elements with similar mz
-              similarity_jl *= j_winlength_factor;
-              similarity_jl *= l_winlength_factor;
-              similarity_ik_jl = similarity_ik * similarity_jl;
-            }
-
-            // hash the images of scaling, rt_low and rt_high into their respective hash tables
-            // store the scaling parameter and the (estimated) transformation of start/end of the maps in hashes
-            //   -> in round 2, discard values outside of scale_low_1 and
-            //   scale_high_1 (estimated before in scalingEstimate)
-            if (hashing_round == 1)
-            {
-              // hashing round 1 (estimate the scaling only)
-              scaling_hash_1.addValue(log(scaling), similarity_ik_jl);
-            }
-            else if (scaling >= scale_low_1 && scaling <= scale_high_1)
-            {
-              // hashing round 2 (estimate scaling and shift)
-              scaling_hash_2.addValue(log(scaling), similarity_ik_jl);
+              double l_winlength_factor = 1. / (l_high - l_low);
+              l_winlength_factor -= winlength_factor_baseline;
+              if (l_winlength_factor <= 0)
+                continue;
+
+              // diff in scene map -> skip features that are too far away in RT
+              double diff_scene = scene_map[l].getRT() - scene_map[k].getRT();
 
-              const double rt_low_image = shift + rt_low * scaling;
-              rt_low_hash_.addValue(rt_low_image, similarity_ik_jl);
-              const double rt_high_image = shift + rt_high * scaling;
-              rt_high_hash_.addValue(rt_high_image, similarity_ik_jl);
+              // avoid cross mappings (i,j) -> (k,l) (e.g. i_rt < j_rt and k_rt > l_rt)
+              // and point pairs with equal retention times (e.g. i_rt == j_rt)
+              if (fabs(diff_scene) < rt_pair_min_distance || ((diff_model > 0) != (diff_scene > 0)))
+                continue;
 
-              if (do_dump_pairs)
+              // compute the transformation (i,j) -> (k,l)
+              double scaling = diff_model / diff_scene;
+              double shift = model_map[i].getRT() - scene_map[k].getRT() * scaling;
+
+              // compute similarity of intensities i k j l
+              double similarity_ik_jl;
+              {
+                // compute similarity of intensities j l
+                const double int_j = model_map[j].getIntensity();
+                const double int_l = scene_map[l].getIntensity() * total_intensity_ratio;
+                double similarity_jl = (int_j < int_l) ? int_j / int_l : int_l / int_j;
+                // weight is inverse proportional to number of elements with similar mz
+                similarity_jl *= j_winlength_factor;
+                similarity_jl *= l_winlength_factor;
+                similarity_ik_jl = similarity_ik * similarity_jl;
+              }
+
+              // hash the images of scaling, rt_low and rt_high into their respective hash tables
+              // store the scaling parameter and the (estimated) transformation of start/end of the maps in hashes
+              //   -> in round 2, discard values outside of scale_low_1 and
+              //   scale_high_1 (estimated before in scalingEstimate)
+              if (hashing_round == 1)
+              {
+                // hashing round 1 (estimate the scaling only)
+                thread_scaling_hash_1.addValue(log(scaling), similarity_ik_jl);
+              }
+              else if (scaling >= scale_low_1 && scaling <= scale_high_1)
               {
-                dump_pairs_file << i << ' ' << model_map[i].getRT() << ' ' << model_map[i].getMZ() << ' ' << j << ' ' << model_map[j].getRT() << ' '
-                                << model_map[j].getMZ() << ' ' << k << ' ' << scene_map[k].getRT() << ' ' << scene_map[k].getMZ() << ' ' << l << ' '
-                                << scene_map[l].getRT() << ' ' << scene_map[l].getMZ() << ' ' << similarity_ik_jl << ' ' << std::endl;
+                // hashing round 2 (estimate scaling and shift)
+                thread_scaling_hash_2.addValue(log(scaling), similarity_ik_jl);
+
+                const double rt_low_image = shift + rt_low * scaling;
+                thread_rt_low_hash.addValue(rt_low_image, similarity_ik_jl);
+                const double rt_high_image = shift + rt_high * scaling;
+                thread_rt_high_hash.addValue(rt_high_image, similarity_ik_jl);
+
+                if (do_dump_pairs)
+                {
+                  dump_pairs_file << i << ' ' << model_map[i].getRT() << ' ' << model_map[i].getMZ() << ' ' << j << ' ' << model_map[j].getRT() << ' '
+                                  << model_map[j].getMZ() << ' ' << k << ' ' << scene_map[k].getRT() << ' ' << scene_map[k].getMZ() << ' ' << l << ' '
+                                  << scene_map[l].getRT() << ' ' << scene_map[l].getMZ() << ' ' << similarity_ik_jl << ' ' << std::endl;
+                }
               }
-            }
-          }   // l
-        }   // j
-      }   // k
-    }   // i
+            }   // l
+          }   // j
+        }   // k
+      }   // i
+
+      thread_hashes[thread].swap(hashes);
+    }
+
+    // add up the votes of all threads
+    LinearInterpolationType_* shared_hashes[] = { &scaling_hash_1, &scaling_hash_2, &rt_low_hash_, &rt_high_hash_ };
+    for (const std::vector<LinearInterpolationType_>& hashes : thread_hashes)
+    {
+      if (hashes.empty()) continue;
+      for (Size h = 0; h < 4; ++h)
+      {
+        std::vector<double>& data = shared_hashes[h]->getData();
+        for (Size b = 0; b < data.size(); ++b)
+        {
+          data[b] += hashes[h].getData()[b];
+        }
+      }
+    }
   }
 
   /**
@@ -900,9 +956,9 @@ namespace OpenMS
     setProgress((actual_progress = 20));
 
     // The serial number is incremented for each invocation of this, to avoid
-    // overwriting of hash table dumps.
-    static Int dump_buckets_serial = 0;
-    ++dump_buckets_serial;
+    // overwriting of hash table dumps. (Maps may be aligned concurrently.)
+    static std::atomic<Int> dump_buckets_counter(0);
+    const Int dump_buckets_serial = ++dump_buckets_counter;
 
     //**************************************************************************
     // Step 4: Hashing
@@ -38,6 +38,8 @@
 #include <OpenMS/KERNEL/FeatureHandle.h>
 #include <OpenMS/MATH/MISC/MathFunctions.h>
 
+#include <exception>
+
 //#define DEBUG_QTCLUSTERFINDER_IDS
 
 using std::list;
@@ -326,11 +328,21 @@ namespace OpenMS
       // add last partition (a bit more since we use "smaller than" below)
       partition_boundaries.push_back(massrange.back() + 1.0);
 
+      // The partitions are independent and are clustered in parallel, each
+      // by its own finder (distance functor, used features and cluster data
+      // depend on the partition). The results are appended in partition
+      // order, so the output is the same as when clustering serially.
+      const SignedSize nr_partitions = partition_boundaries.size() - 1;
+      std::vector<ConsensusMap> partition_results(nr_partitions);
+      Size error_idx = std::numeric_limits<Size>::max();
+      std::exception_ptr error;
+
       ProgressLogger logger;
       Size progress = 0;
       logger.setLogType(ProgressLogger::CMD);
       logger.startProgress(0, partition_boundaries.size(), "Linking features");
-      for (size_t j = 0; j < partition_boundaries.size()-1; j++)
+#pragma omp parallel for schedule(dynamic, 1)
+      for (SignedSize j = 0; j < nr_partitions; j++)
       {
         double partition_start = partition_boundaries[j];
         double partition_end = partition_boundaries[j+1];
@@ -353,11 +365,39 @@ namespace OpenMS
         }
 
         // run algo on current partition
-        run_internal_(tmp_input_maps, result_map, false);
+        try
+        {
+          QTClusterFinder partition_finder;
+          partition_finder.setParameters(param_);
+          partition_finder.bin_tolerances_ = bin_tolerances_;
+          partition_finder.run_internal_(tmp_input_maps, partition_results[j], false);
+        }
+        catch (...)
+        {
+          // report the error of the first failing partition, as in serial mode
+#pragma omp critical (QTClusterFinder_error)
+          if ((Size)j < error_idx)
+          {
+            error_idx = j;
+            error = std::current_exception();
+          }
+        }
+
+#pragma omp critical (QTClusterFinder_progress)
         logger.setProgress(progress++);
       }
-
       logger.endProgress();
+
+      if (error) std::rethrow_exception(error);
+
+      for (ConsensusMap& partition_result : partition_results)
+      {
+        for (ConsensusFeature& feature : partition_result)
+        {
+          result_map.push_back(std::move(feature));
+        }
+        partition_result.clear(true);
+      }
     }
   }
 
@@ -37,11 +37,82 @@
 #include <OpenMS/DATASTRUCTURES/String.h>
 
 #include <OpenMS/CONCEPT/Exception.h>
+
+#include <algorithm>
 #include <iostream>
 
 namespace OpenMS
 {
 
+  namespace
+  {
+    /**
+     * @brief Index of extraction coordinates bucketed by retention time.
+     *
+     * Each coordinate with an RT window is stored in every RT bucket that its
+     * window overlaps; coordinates without an RT window are kept separately.
+     * All lists are ascending in coordinate index (and thus in m/z), so that
+     * the coordinates active for a spectrum can be visited in m/z order by
+     * merging the unrestricted list with a single bucket.
+     */
+    struct ExtractionRTIndex
+    {
+      double rt_min = 0.0;
+      double bucket_width = 1.0;
+      std::vector< std::vector<Size> > buckets;
+      std::vector<Size> unrestricted;
+
+      ExtractionRTIndex(const std::vector<ChromatogramExtractorAlgorithm::ExtractionCoordinates>& coordinates,
+                        const std::vector<double>& spectrum_rts)
+      {
+        rt_min = *std::min_element(spectrum_rts.begin(), spectrum_rts.end());
+        double rt_max = *std::max_element(spectrum_rts.begin(), spectrum_rts.end());
+
+        std::vector<double> widths;
+        for (Size k = 0; k < coordinates.size(); ++k)
+        {
+          double width = coordinates[k].rt_end - coordinates[k].rt_start;
+          if (width > 0) widths.push_back(width);
+          else unrestricted.push_back(k);
+        }
+        if (widths.empty()) return;
+
+        // half the median window width: a typical coordinate spans two to
+        // three buckets; do not create more buckets than there are spectra
+        std::nth_element(widths.begin(), widths.begin() + widths.size() / 2, widths.end());
+        bucket_width = std::max(widths[widths.size() / 2] / 2.0, (rt_max - rt_min) / spectrum_rts.size());
+        if (bucket_width <= 0.0) bucket_width = 1.0;
+        buckets.resize(bucketOf(rt_max) + 1);
+
+        for (Size k = 0; k < coordinates.size(); ++k)
+        {
+          const ChromatogramExtractorAlgorithm::ExtractionCoordinates& c = coordinates[k];
+          // never active for any spectrum
+          if (c.rt_end - c.rt_start <= 0 || c.rt_end < rt_min || c.rt_start > rt_max) continue;
+
+          Size last = bucketOf(std::min(c.rt_end, rt_max));
+          for (Size b = bucketOf(std::max(c.rt_start, rt_min)); b <= last; ++b)
+          {
+            buckets[b].push_back(k);
+          }
+        }
+      }
+
+      Size bucketOf(double rt) const
+      {
+        if (rt <= rt_min) return 0;
+        return std::min(static_cast<Size>((rt - rt_min) / bucket_width), buckets.empty() ? Size(0) : buckets.size() - 1);
+      }
+
+      /// Coordinates with an RT window that may contain @p rt (ascending)
+      const std::vector<Size>& candidates(double rt) const
+      {
+        static const std::vector<Size> empty;
+        return buckets.empty() ? empty : buckets[bucketOf(rt)];
+      }
+    };
+  }
+
   void ChromatogramExtractorAlgorithm::extract_value_tophat(
       const std::vector<double>::const_iterator& mz_start,
             std::vector<double>::const_iterator& mz_it,
@@ -296,6 +367,30 @@ namespace OpenMS
         "Input to extractChromatogram needs to be sorted by m/z");
     }
 
+    // collect the retention times and index the coordinates by their RT
+    // window, so each spectrum only visits the coordinates active at its RT
+    std::vector<double> spectrum_rts(input_size);
+    for (Size scan_idx = 0; scan_idx < input_size; ++scan_idx)
+    {
+      spectrum_rts[scan_idx] = input->getSpectrumMetaById(scan_idx).RT;
+    }
+    ExtractionRTIndex rt_index(extraction_coordinates, spectrum_rts);
+
+    // reserve the output so the chromatograms do not grow one point at a time
+    std::vector<double> sorted_rts(spectrum_rts);
+    std::sort(sorted_rts.begin(), sorted_rts.end());
+    for (Size k = 0; k < extraction_coordinates.size(); ++k)
+    {
+      Size nr_points = input_size;
+      if (extraction_coordinates[k].rt_end - extraction_coordinates[k].rt_start > 0)
+      {
+        nr_points = std::upper_bound(sorted_rts.begin(), sorted_rts.end(), extraction_coordinates[k].rt_end) -
+                    std::lower_bound(sorted_rts.begin(), sorted_rts.end(), extraction_coordinates[k].rt_start);
+      }
+      output[k]->getTimeArray()->data.reserve(output[k]->getTimeArray()->data.size() + nr_points);
+      output[k]->getIntensityArray()->data.reserve(output[k]->getIntensityArray()->data.size() + nr_points);
+    }
+
     //go through all spectra
     startProgress(0, input_size, "Extracting chromatograms");
     for (Size scan_idx = 0; scan_idx < input_size; ++scan_idx)
@@ -303,7 +398,7 @@ namespace OpenMS
       setProgress(scan_idx);
 
       OpenSwath::SpectrumPtr sptr = input->getSpectrumById(scan_idx);
-      OpenSwath::SpectrumMeta s_meta = input->getSpectrumMetaById(scan_idx);
+      const double current_rt = spectrum_rts[scan_idx];
 
       OpenSwath::BinaryDataArrayPtr mz_arr = sptr->getMZArray();
       OpenSwath::BinaryDataArrayPtr int_arr = sptr->getIntensityArray();
@@ -338,10 +433,25 @@ namespace OpenMS
       // ProductMZ. We can use this to step through the spectrum and at the
       // same time step through the transitions. We increase the peak counter
       // until we hit the next transition and then extract the signal.
-      for (Size k = 0; k < extraction_coordinates.size(); ++k)
+      // Only the coordinates without RT window and those in the RT bucket of
+      // the current spectrum are visited (merged to keep ascending m/z).
+      const std::vector<Size>& rt_candidates = rt_index.candidates(current_rt);
+      std::vector<Size>::const_iterator cand_it = rt_candidates.begin();
+      std::vector<Size>::const_iterator unres_it = rt_index.unrestricted.begin();
+      while (cand_it != rt_candidates.end() || unres_it != rt_index.unrestricted.end())
       {
+        Size k;
+        if (unres_it == rt_index.unrestricted.end() ||
+            (cand_it != rt_candidates.end() && *cand_it < *unres_it))
+        {
+          k = *cand_it++;
+        }
+        else
+        {
+          k = *unres_it++;
+        }
+
         double integrated_intensity = 0;
-        double current_rt = s_meta.RT;
         if (extraction_coordinates[k].rt_end - extraction_coordinates[k].rt_start > 0 &&
              (current_rt < extraction_coordinates[k].rt_start ||
               current_rt > extraction_coordinates[k].rt_end) )
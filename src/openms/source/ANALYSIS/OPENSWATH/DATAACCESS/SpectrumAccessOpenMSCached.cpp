@@ -68,16 +68,8 @@ namespace OpenMS
     int ms_level = -1;
     double rt = -1.0;
 
-    if ( !ifs_.seekg(spectra_index_[id]) )
-    {
-      std::cerr << "Error while reading spectrum " << id << " - seekg created an error when trying to change position to " << spectra_index_[id] << "." << std::endl;
-      std::cerr << "Maybe an invalid position was supplied to seekg, this can happen for example when reading large files (>2GB) on 32bit systems." << std::endl;
-      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
-        "Error while changing position of input stream pointer.", filename_cached_);
-    }
-
     OpenSwath::SpectrumPtr sptr(new OpenSwath::Spectrum);
-    sptr->getDataArrays() = Internal::CachedMzMLHandler::readSpectrumFast(ifs_, ms_level, rt);
+    sptr->getDataArrays() = Internal::CachedMzMLHandler::readSpectrumFast(getMappedData_(spectra_index_[id]), getMappedDataEnd_(), ms_level, rt);
 
     return sptr;
   }
@@ -98,16 +90,8 @@ namespace OpenMS
     OPENMS_PRECONDITION(id >= 0, "Id needs to be larger than zero");
     OPENMS_PRECONDITION(id < (int)getNrChromatograms(), "Id cannot be larger than number of chromatograms");
 
-    if ( !ifs_.seekg(chrom_index_[id]) )
-    {
-      std::cerr << "Error while reading chromatogram " << id << " - seekg created an error when trying to change position to " << chrom_index_[id] << "." << std::endl;
-      std::cerr << "Maybe an invalid position was supplied to seekg, this can happen for example when reading large files (>2GB) on 32bit systems." << std::endl;
-      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
-        "Error while changing position of input stream pointer.", filename_cached_);
-    }
-
     OpenSwath::ChromatogramPtr cptr(new OpenSwath::Chromatogram);
-    cptr->getDataArrays() = Internal::CachedMzMLHandler::readChromatogramFast(ifs_);
+    cptr->getDataArrays() = Internal::CachedMzMLHandler::readChromatogramFast(getMappedData_(chrom_index_[id]), getMappedDataEnd_());
     return cptr;
   }
 
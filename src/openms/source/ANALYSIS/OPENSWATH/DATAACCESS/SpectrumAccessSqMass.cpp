@@ -34,19 +34,38 @@
 
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SpectrumAccessSqMass.h>
 
+#include <boost/make_shared.hpp>
+
+#include <cmath>
+#include <limits>
+
 namespace OpenMS
 {
 
     /// Constructor
   SpectrumAccessSqMass::SpectrumAccessSqMass(const OpenMS::Internal::MzMLSqliteHandler& handler) :
       handler_(handler)
-    {}
+    {
+      initRTIndex_(boost::make_shared<const std::vector<Internal::MzMLSqliteHandler::SpectrumRTEntry> >(handler_.getSpectraRTIndex()));
+    }
 
     SpectrumAccessSqMass::SpectrumAccessSqMass(const OpenMS::Internal::MzMLSqliteHandler& handler, const std::vector<int> & indices) :
       handler_(handler),
       sidx_(indices)
-    {}
+    {
+      initRTIndex_(boost::make_shared<const std::vector<Internal::MzMLSqliteHandler::SpectrumRTEntry> >(handler_.getSpectraRTIndex()));
+    }
 
+    SpectrumAccessSqMass::SpectrumAccessSqMass(const OpenMS::Internal::MzMLSqliteHandler& handler, const std::vector<int> & indices, const SpectraRTIndexPtr& spectra_rt) :
+      handler_(handler),
+      sidx_(indices)
+    {
+      if (spectra_rt == nullptr)
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Spectrum meta data must not be empty.");
+      }
+      initRTIndex_(spectra_rt);
+    }
 
     SpectrumAccessSqMass::SpectrumAccessSqMass(const SpectrumAccessSqMass& sp, const std::vector<int>& indices) :
       handler_(sp.handler_)
@@ -69,6 +88,32 @@ namespace OpenMS
           sidx_.push_back( sp.sidx_[ indices[k] ] );
         }
       }
+      // the meta data of the file is shared, only the index is re-created
+      initRTIndex_(sp.spectra_rt_);
+    }
+
+    void SpectrumAccessSqMass::initRTIndex_(const SpectraRTIndexPtr& spectra_rt)
+    {
+      typedef Internal::MzMLSqliteHandler::SpectrumRTEntry SpectrumRTEntry;
+      spectra_rt_ = spectra_rt;
+      const std::vector<SpectrumRTEntry>& entries = *spectra_rt_;
+
+      // without a subset, spectrum index k refers to SPECTRUM.ID k
+      Size nr_spectra = sidx_.empty() ? entries.size() : sidx_.size();
+      meta_idx_.assign(nr_spectra, std::numeric_limits<Size>::max());
+      rt_index_.clear();
+      rt_index_.reserve(nr_spectra);
+      for (Size k = 0; k < nr_spectra; k++)
+      {
+        int spectrum_id = sidx_.empty() ? int(k) : sidx_[k];
+        auto it = std::lower_bound(entries.begin(), entries.end(), spectrum_id,
+            [](const SpectrumRTEntry& entry, int id) { return entry.id < id; });
+        if (it == entries.end() || it->id != spectrum_id) continue;
+
+        meta_idx_[k] = it - entries.begin();
+        if (!std::isnan(it->rt)) rt_index_.emplace_back(it->rt, k);
+      }
+      std::sort(rt_index_.begin(), rt_index_.end());
     }
 
     /// Destructor
@@ -77,7 +122,10 @@ namespace OpenMS
     /// Copy constructor
     SpectrumAccessSqMass::SpectrumAccessSqMass(const SpectrumAccessSqMass & rhs) :
       handler_(rhs.handler_),
-      sidx_(rhs.sidx_)
+      sidx_(rhs.sidx_),
+      spectra_rt_(rhs.spectra_rt_),
+      meta_idx_(rhs.meta_idx_),
+      rt_index_(rhs.rt_index_)
     {
     }
 
@@ -120,25 +168,17 @@ namespace OpenMS
 
     OpenSwath::SpectrumMeta SpectrumAccessSqMass::getSpectrumMetaById(int id) const
     {
-      std::vector<int> indices;
-      if (sidx_.empty())
+      if (id < 0 || id >= (int)meta_idx_.size() || meta_idx_[id] == std::numeric_limits<Size>::max())
       {
-        indices.push_back(id);
-      }
-      else
-      {
-        indices.push_back(sidx_[id]);
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+            String("Illegal spectral index ") + id + " for file of size " + getNrSpectra());
       }
 
-      // read MSSpectra and prepare for conversion
-      std::vector<MSSpectrum> tmp_spectra;
-      handler_.readSpectra(tmp_spectra, indices, false);
-
-      const MSSpectrumType& spectrum = tmp_spectra[0];
+      const Internal::MzMLSqliteHandler::SpectrumRTEntry& entry = (*spectra_rt_)[meta_idx_[id]];
       OpenSwath::SpectrumMeta m;
-      m.id = spectrum.getNativeID();
-      m.RT = spectrum.getRT();
-      m.ms_level = spectrum.getMSLevel();
+      m.id = entry.native_id;
+      m.RT = entry.rt;
+      m.ms_level = entry.ms_level;
       return m;
     }
 
@@ -190,39 +230,33 @@ namespace OpenMS
     std::vector<std::size_t> SpectrumAccessSqMass::getSpectraByRT(double RT, double deltaRT) const
     {
       OPENMS_PRECONDITION(deltaRT >= 0, "Delta RT needs to be a positive number");
-      std::vector<std::size_t> res = handler_.getSpectraIndicesbyRT(RT, deltaRT, sidx_);
 
-      if (sidx_.empty())
+      // same semantics as MzMLSqliteHandler::getSpectraIndicesbyRT, but
+      // answered from the in-memory index (results are ordered by RT)
+      std::vector<std::size_t> result;
+      if (deltaRT > 0.0)
       {
-        return res;
+        auto it = std::lower_bound(rt_index_.begin(), rt_index_.end(), std::make_pair(RT - deltaRT, Size(0)));
+        for (; it != rt_index_.end() && it->first <= RT + deltaRT; ++it)
+        {
+          result.push_back(it->second);
+        }
       }
       else
       {
-        // we need to map the resulting indices back to the external indices
-        std::vector<std::size_t> res_mapped;
-        for (Size k = 0; k < res.size(); k++)
+        // only the first spectrum *after* RT
+        auto it = std::lower_bound(rt_index_.begin(), rt_index_.end(), std::make_pair(RT, Size(0)));
+        if (it != rt_index_.end())
         {
-          for (Size s_it = 0; s_it < sidx_.size(); s_it++)
-          {
-            if (res[k] == (size_t)sidx_[s_it]) {res_mapped.push_back(s_it);}
-          }
+          result.push_back(it->second);
         }
-        return res_mapped;
       }
+      return result;
     }
 
     size_t SpectrumAccessSqMass::getNrSpectra() const
     {
-      size_t res;
-      if (sidx_.empty())
-      {
-        res = handler_.getNrSpectra();
-      }
-      else
-      {
-        res = sidx_.size();
-      }
-      return res;
+      return meta_idx_.size();
     }
 
     OpenSwath::ChromatogramPtr SpectrumAccessSqMass::getChromatogramById(int /* id */)
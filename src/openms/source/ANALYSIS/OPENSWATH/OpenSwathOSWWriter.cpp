@@ -34,12 +34,38 @@
 
 #include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathOSWWriter.h>
 
+#include <OpenMS/CONCEPT/LogStream.h>
 #include <OpenMS/FORMAT/SqliteConnector.h>
 
 #include <sqlite3.h>
 
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
 namespace OpenMS
 {
+  namespace
+  {
+    /// Number of batches waiting to be written before writeLines() blocks
+    const Size MAX_QUEUED_BATCHES = 64;
+  }
+
+  struct OpenSwathOSWWriter::WriteQueue_
+  {
+    std::mutex mutex;
+    std::condition_variable work_available; ///< a batch was queued or the writer should stop
+    std::condition_variable state_changed; ///< the writer took batches off the queue or finished a transaction
+    std::deque< std::vector<String> > pending;
+    bool writing = false;
+    bool stop = false;
+    std::exception_ptr error;
+    WriterStatistics statistics;
+    std::thread worker;
+  };
+
   OpenSwathOSWWriter::OpenSwathOSWWriter(const String& output_filename, const UInt64 run_id, const String& input_filename, bool ms1_scores, bool sonar, bool uis_scores) :
     output_filename_(output_filename),
     input_filename_(input_filename),
@@ -47,9 +73,65 @@ namespace OpenMS
     doWrite_(!output_filename.empty()),
     use_ms1_traces_(ms1_scores),
     sonar_(sonar),
-    enable_uis_scoring_(uis_scores)
+    enable_uis_scoring_(uis_scores),
+    queue_(new WriteQueue_)
   {}
 
+  OpenSwathOSWWriter::OpenSwathOSWWriter(const OpenSwathOSWWriter& rhs) :
+    output_filename_(rhs.output_filename_),
+    input_filename_(rhs.input_filename_),
+    run_id_(rhs.run_id_),
+    doWrite_(rhs.doWrite_),
+    use_ms1_traces_(rhs.use_ms1_traces_),
+    sonar_(rhs.sonar_),
+    enable_uis_scoring_(rhs.enable_uis_scoring_),
+    queue_(new WriteQueue_)
+  {}
+
+  OpenSwathOSWWriter& OpenSwathOSWWriter::operator=(const OpenSwathOSWWriter& rhs)
+  {
+    if (this == &rhs) return *this;
+
+    stopWriter_();
+    output_filename_ = rhs.output_filename_;
+    input_filename_ = rhs.input_filename_;
+    run_id_ = rhs.run_id_;
+    doWrite_ = rhs.doWrite_;
+    use_ms1_traces_ = rhs.use_ms1_traces_;
+    sonar_ = rhs.sonar_;
+    enable_uis_scoring_ = rhs.enable_uis_scoring_;
+    queue_.reset(new WriteQueue_);
+    return *this;
+  }
+
+  OpenSwathOSWWriter::~OpenSwathOSWWriter()
+  {
+    stopWriter_();
+  }
+
+  void OpenSwathOSWWriter::stopWriter_()
+  {
+    {
+      std::lock_guard<std::mutex> lock(queue_->mutex);
+      queue_->stop = true;
+    }
+    queue_->work_available.notify_one();
+    if (queue_->worker.joinable()) queue_->worker.join();
+
+    if (queue_->error)
+    {
+      try
+      {
+        std::rethrow_exception(queue_->error);
+      }
+      catch (const std::exception& e)
+      {
+        OPENMS_LOG_ERROR << "Writing to '" << output_filename_ << "' failed: " << e.what() << std::endl;
+      }
+      queue_->error = nullptr;
+    }
+  }
+
   bool OpenSwathOSWWriter::isActive() const
   {
     return doWrite_;
@@ -476,13 +558,107 @@ namespace OpenMS
 
   void OpenSwathOSWWriter::writeLines(const std::vector<String>& to_osw_output)
   {
-    SqliteConnector conn(output_filename_);
-    conn.executeStatement("BEGIN TRANSACTION");
-    for (Size i = 0; i < to_osw_output.size(); i++)
+    if (to_osw_output.empty()) return;
+
+    std::unique_lock<std::mutex> lock(queue_->mutex);
+    if (queue_->error) std::rethrow_exception(queue_->error);
+
+    if (!queue_->worker.joinable())
+    {
+      // The writer keeps a single connection open and writes everything
+      // queued since its last transaction in one go. After an error, the
+      // remaining batches are discarded and the error is reported to the
+      // caller on the next call to writeLines() or flush().
+      WriteQueue_* q = queue_.get();
+      const String filename = output_filename_;
+      q->worker = std::thread([q, filename]()
+      {
+        std::unique_ptr<SqliteConnector> conn;
+        std::unique_lock<std::mutex> lock(q->mutex);
+        while (true)
+        {
+          q->work_available.wait(lock, [q]() { return q->stop || !q->pending.empty(); });
+          if (q->pending.empty()) break; // stop requested and nothing left to write
+
+          std::deque< std::vector<String> > batches;
+          batches.swap(q->pending);
+          bool failed = (q->error != nullptr);
+          q->writing = true;
+          lock.unlock();
+          q->state_changed.notify_all();
+
+          std::exception_ptr error;
+          if (!failed)
+          {
+            try
+            {
+              if (conn == nullptr) conn.reset(new SqliteConnector(filename));
+              conn->executeStatement("BEGIN TRANSACTION");
+              for (const auto& batch : batches)
+              {
+                for (const auto& statement : batch)
+                {
+                  conn->executeStatement(statement);
+                }
+              }
+              conn->executeStatement("END TRANSACTION");
+            }
+            catch (...)
+            {
+              error = std::current_exception();
+              // release the database lock, nothing of this transaction is kept
+              if (conn != nullptr)
+              {
+                try
+                {
+                  conn->executeStatement("ROLLBACK");
+                }
+                catch (...)
+                {
+                }
+              }
+            }
+          }
+
+          lock.lock();
+          if (error != nullptr)
+          {
+            q->error = error;
+          }
+          else if (!failed)
+          {
+            q->statistics.batches_written += batches.size();
+            ++q->statistics.transactions;
+          }
+          q->writing = false;
+          q->state_changed.notify_all();
+        }
+      });
+    }
+
+    // backpressure: wait for the writer if it is falling behind
+    if (queue_->pending.size() >= MAX_QUEUED_BATCHES)
     {
-      conn.executeStatement(to_osw_output[i]);
+      ++queue_->statistics.producer_waits;
+      queue_->state_changed.wait(lock, [this]() { return queue_->pending.size() < MAX_QUEUED_BATCHES; });
     }
-    conn.executeStatement("END TRANSACTION");
+    queue_->pending.push_back(to_osw_output);
+    queue_->statistics.max_queue_depth = std::max(queue_->statistics.max_queue_depth, queue_->pending.size());
+    lock.unlock();
+    queue_->work_available.notify_one();
+  }
+
+  void OpenSwathOSWWriter::flush()
+  {
+    std::unique_lock<std::mutex> lock(queue_->mutex);
+    queue_->state_changed.wait(lock, [this]() { return queue_->pending.empty() && !queue_->writing; });
+    if (queue_->error) std::rethrow_exception(queue_->error);
+  }
+
+  OpenSwathOSWWriter::WriterStatistics OpenSwathOSWWriter::getStatistics() const
+  {
+    std::lock_guard<std::mutex> lock(queue_->mutex);
+    return queue_->statistics;
   }
 }
 
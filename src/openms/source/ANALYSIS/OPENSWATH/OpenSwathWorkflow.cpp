@@ -34,6 +34,8 @@
 
 #include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathWorkflow.h>
 
+#include <mutex>
+
 // OpenSwathCalibrationWorkflow
 namespace OpenMS
 {
@@ -465,7 +467,6 @@ namespace OpenMS
 
     std::cout << "Will analyze " << transition_exp.transitions.size() << " transitions in total." << std::endl;
     int progress = 0;
-    this->startProgress(0, swath_maps.size(), "Extracting and scoring transitions");
 
     // (i) Obtain precursor chromatograms (MS1) if precursor extraction is enabled
     ChromExtractParams ms1_cp(cp_ms1);
@@ -537,207 +538,201 @@ namespace OpenMS
       }
     }
 
-    // (iii) Perform extraction and scoring of fragment ion chromatograms (MS2)
-    // We set dynamic scheduling such that the maps are worked on in the order
-    // in which they were given to the program / acquired. This gives much
-    // better load balancing than static allocation.
-#ifdef _OPENMP
-#ifdef MT_ENABLE_NESTED_OPENMP
-    int total_nr_threads = omp_get_max_threads(); // store total number of threads we are allowed to use
-    if (threads_outer_loop_ > -1)
-    {
-      std::cout << "Setting up nested loop with " << std::min(threads_outer_loop_, omp_get_max_threads()) << " threads out of "<< omp_get_max_threads() << std::endl;
-      omp_set_nested(1);
-      omp_set_dynamic(0);
-      omp_set_num_threads(std::min(threads_outer_loop_, omp_get_max_threads()) ); // use at most threads_outer_loop_ threads here
-    }
-    else
-    {
-      std::cout << "Use non-nested loop with " << total_nr_threads << " threads." << std::endl;
-    }
-#endif
+    // (iii) Select the transitions to extract from each SWATH window
+    std::vector< OpenSwath::LightTargetedExperiment > window_transitions(swath_maps.size());
 #pragma omp parallel for schedule(dynamic,1)
-#endif
     for (SignedSize i = 0; i < boost::numeric_cast<SignedSize>(swath_maps.size()); ++i)
     {
-      if (!swath_maps[i].ms1) // skip MS1
-      {
+      if (swath_maps[i].ms1) continue; // skip MS1
 
-        // Step 1: select which transitions to extract (proceed in batches)
-        OpenSwath::LightTargetedExperiment transition_exp_used_all;
-        if (!prm_)
-        {
-          // Step 1.1: select transitions matching the window
-          OpenSwathHelper::selectSwathTransitions(transition_exp, transition_exp_used_all,
-              cp.min_upper_edge_dist, swath_maps[i].lower, swath_maps[i].upper);
-        }
-        else
+      OpenSwath::LightTargetedExperiment& transition_exp_used_all = window_transitions[i];
+      if (!prm_)
+      {
+        // select transitions matching the window
+        OpenSwathHelper::selectSwathTransitions(transition_exp, transition_exp_used_all,
+            cp.min_upper_edge_dist, swath_maps[i].lower, swath_maps[i].upper);
+      }
+      else
+      {
+        // select transitions based on matching PRM window (best window)
+        std::set<std::string> matching_compounds;
+        for (Size k = 0; k < prm_map.size(); k++)
         {
-          // Step 1.2: select transitions based on matching PRM window (best window)
-          std::set<std::string> matching_compounds;
-          for (Size k = 0; k < prm_map.size(); k++)
+          if (prm_map[k] == i)
           {
-            if (prm_map[k] == i)
-            {
-               const OpenSwath::LightTransition& tr = transition_exp.transitions[k];
-               transition_exp_used_all.transitions.push_back(tr);
-               matching_compounds.insert(tr.getPeptideRef());
-            }
+             const OpenSwath::LightTransition& tr = transition_exp.transitions[k];
+             transition_exp_used_all.transitions.push_back(tr);
+             matching_compounds.insert(tr.getPeptideRef());
           }
+        }
 
-          std::set<std::string> matching_proteins;
-          for (Size i = 0; i < transition_exp.compounds.size(); i++)
+        std::set<std::string> matching_proteins;
+        for (Size k = 0; k < transition_exp.compounds.size(); k++)
+        {
+          if (matching_compounds.find(transition_exp.compounds[k].id) != matching_compounds.end())
           {
-            if (matching_compounds.find(transition_exp.compounds[i].id) != matching_compounds.end())
+            transition_exp_used_all.compounds.push_back( transition_exp.compounds[k] );
+            for (Size j = 0; j < transition_exp.compounds[k].protein_refs.size(); j++)
             {
-              transition_exp_used_all.compounds.push_back( transition_exp.compounds[i] );
-              for (Size j = 0; j < transition_exp.compounds[i].protein_refs.size(); j++)
-              {
-                matching_proteins.insert(transition_exp.compounds[i].protein_refs[j]);
-              }
+              matching_proteins.insert(transition_exp.compounds[k].protein_refs[j]);
             }
           }
-          for (Size i = 0; i < transition_exp.proteins.size(); i++)
+        }
+        for (Size k = 0; k < transition_exp.proteins.size(); k++)
+        {
+          if (matching_proteins.find(transition_exp.proteins[k].id) != matching_proteins.end())
           {
-            if (matching_proteins.find(transition_exp.proteins[i].id) != matching_proteins.end())
-            {
-              transition_exp_used_all.proteins.push_back( transition_exp.proteins[i] );
-            }
+            transition_exp_used_all.proteins.push_back( transition_exp.proteins[k] );
           }
         }
+      }
+    }
 
-        if (transition_exp_used_all.getTransitions().size() > 0) // skip if no transitions found
-        {
+    // (iv) Split each window into batches of compounds. Every (window, batch)
+    // pair is an independent task; tasks are ordered by window so that the
+    // windows are worked on in the order in which they were given to the
+    // program / acquired and only a few windows are in flight at any time.
+    std::vector< std::pair<Size, Size> > tasks; // (window, batch)
+    std::vector<int> batch_sizes(swath_maps.size(), 0);
+    std::vector<Size> nr_batches(swath_maps.size(), 0);
+    for (Size i = 0; i < swath_maps.size(); ++i)
+    {
+      const OpenSwath::LightTargetedExperiment& transition_exp_used_all = window_transitions[i];
+      if (transition_exp_used_all.getTransitions().empty()) continue; // skip if no transitions found
+
+      int nr_compounds = (int)transition_exp_used_all.getCompounds().size();
+      batch_sizes[i] = std::max(1, (batchSize <= 0 || batchSize >= nr_compounds) ? nr_compounds : batchSize);
+      nr_batches[i] = std::max(1, (nr_compounds + batch_sizes[i] - 1) / batch_sizes[i]);
+      for (Size b = 0; b < nr_batches[i]; ++b)
+      {
+        tasks.emplace_back(i, b);
+      }
+    }
 
-          OpenSwath::SpectrumAccessPtr current_swath_map = swath_maps[i].sptr;
+    // Per-window state shared between the tasks of a window: the (possibly
+    // in-memory) map is created by the first task and released by the last
+    // one, which bounds memory to the windows currently in flight.
+    std::vector< OpenSwath::SpectrumAccessPtr > window_maps(swath_maps.size());
+    std::vector<Size> open_batches(nr_batches);
+    std::vector<std::mutex> window_mutex(swath_maps.size());
+
+    // (v) Perform extraction and scoring of fragment ion chromatograms (MS2)
+    // We use a single flat loop with dynamic scheduling over all tasks: idle
+    // threads pick up the next batch of any window, which balances windows of
+    // different size without nested parallelism.
+    std::cout << "Will process " << tasks.size() << " batches from " << swath_maps.size() << " SWATH windows." << std::endl;
+    this->startProgress(0, tasks.size(), "Extracting and scoring transitions");
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic,1)
+#endif
+    for (SignedSize t = 0; t < boost::numeric_cast<SignedSize>(tasks.size()); ++t)
+    {
+      const Size i = tasks[t].first;
+      const Size pep_idx = tasks[t].second;
+      const OpenSwath::LightTargetedExperiment& transition_exp_used_all = window_transitions[i];
+
+      // Obtain a thread-safe handle on the current SWATH map: an in-memory map
+      // is read-only and can be shared, otherwise each task uses a light clone
+      // (if multiple threads share a single filestream and call seek on it,
+      // chaos will ensue).
+      OpenSwath::SpectrumAccessPtr current_swath_map;
+      {
+        std::lock_guard<std::mutex> lock(window_mutex[i]);
+        if (window_maps[i] == nullptr)
+        {
           if (load_into_memory)
           {
             // This creates an InMemory object that keeps all data in memory
-            current_swath_map = boost::shared_ptr<SpectrumAccessOpenMSInMemory>( new SpectrumAccessOpenMSInMemory(*current_swath_map) );
-          }
-
-          int batch_size;
-          if (batchSize <= 0 || batchSize >= (int)transition_exp_used_all.getCompounds().size())
-          {
-            batch_size = transition_exp_used_all.getCompounds().size();
+            window_maps[i] = boost::shared_ptr<SpectrumAccessOpenMSInMemory>( new SpectrumAccessOpenMSInMemory(*swath_maps[i].sptr) );
           }
           else
           {
-            batch_size = batchSize;
+            window_maps[i] = swath_maps[i].sptr;
           }
-
-          SignedSize nr_batches = (transition_exp_used_all.getCompounds().size() / batch_size);
-
-#ifdef _OPENMP
-#ifdef MT_ENABLE_NESTED_OPENMP
-          // If we have a multiple of threads_outer_loop_ here, then use nested
-          // parallelization here. E.g. if we use 8 threads for the outer loop,
-          // but we have a total of 24 cores available, each of the 8 threads
-          // will then create a team of 3 threads to work on the batches
-          // individually.
-          //
-          // We should avoid oversubscribing the CPUs, therefore we use integer division.
-          // -- see https://docs.oracle.com/cd/E19059-01/stud.10/819-0501/2_nested.html
-          int outer_thread_nr = omp_get_thread_num();
-          omp_set_num_threads(std::max(1, total_nr_threads / threads_outer_loop_) );
-#pragma omp parallel for schedule(dynamic, 1)
-#endif
-#endif
-          for (SignedSize pep_idx = 0; pep_idx <= nr_batches; pep_idx++)
-          {
-            OpenSwath::SpectrumAccessPtr current_swath_map_inner = current_swath_map;
+        }
+        current_swath_map = load_into_memory ? window_maps[i] : window_maps[i]->lightClone();
+      }
 
 #ifdef _OPENMP
-#ifdef MT_ENABLE_NESTED_OPENMP
-            // To ensure multi-threading safe access to the individual spectra, we
-            // need to use a light clone of the spectrum access (if multiple threads
-            // share a single filestream and call seek on it, chaos will ensue).
-            if (total_nr_threads / threads_outer_loop_ > 1)
-            {
-              current_swath_map_inner = current_swath_map->lightClone();
-            }
-#endif
 #pragma omp critical (osw_write_stdout)
 #endif
-            {
-              std::cout << "Thread " <<
+      {
+        std::cout << "Thread " <<
 #ifdef _OPENMP
-#ifdef MT_ENABLE_NESTED_OPENMP
-              outer_thread_nr << "_" << omp_get_thread_num() << " " <<
-#else
-              omp_get_thread_num() << "_0 " <<
-#endif
+        omp_get_thread_num() << " " <<
 #else
-              "0" << 
+        "0 " <<
 #endif
-              "will analyze " << transition_exp_used_all.getCompounds().size() <<  " compounds and "
-              << transition_exp_used_all.getTransitions().size() <<  " transitions "
-              "from SWATH " << i << " (batch " << pep_idx << " out of " << nr_batches << ")" << std::endl;
-            }
-
-            // Create the new, batch-size transition experiment
-            OpenSwath::LightTargetedExperiment transition_exp_used;
-            selectCompoundsForBatch_(transition_exp_used_all, transition_exp_used, batch_size, pep_idx);
-
-            // Extract MS1 chromatograms for this batch
-            std::vector< MSChromatogram > ms1_chromatograms;
-            if (ms1_map_ != nullptr) 
-            {
-              OpenSwath::SpectrumAccessPtr threadsafe_ms1 = ms1_map_->lightClone();
-              MS1Extraction_(threadsafe_ms1, swath_maps, ms1_chromatograms, chromConsumer, ms1_cp,
-                  transition_exp_used, trafo_inverse, ms1_only, ms1_isotopes);
-            }
+        "will analyze " << transition_exp_used_all.getCompounds().size() <<  " compounds and "
+        << transition_exp_used_all.getTransitions().size() <<  " transitions "
+        "from SWATH " << i << " (batch " << pep_idx << " out of " << nr_batches[i] << ")" << std::endl;
+      }
 
-            // Step 2.1: extract these transitions
-            ChromatogramExtractor extractor;
-            std::vector< OpenSwath::ChromatogramPtr > chrom_list;
-            std::vector< ChromatogramExtractor::ExtractionCoordinates > coordinates;
+      // Create the new, batch-size transition experiment
+      OpenSwath::LightTargetedExperiment transition_exp_used;
+      selectCompoundsForBatch_(transition_exp_used_all, transition_exp_used, batch_sizes[i], pep_idx);
 
-            // Step 2.2: prepare the extraction coordinates and extract chromatograms
-            // chrom_list contains one entry for each fragment ion (transition) in transition_exp_used
-            prepareExtractionCoordinates_(chrom_list, coordinates, transition_exp_used, trafo_inverse, cp);
-            extractor.extractChromatograms(current_swath_map_inner, chrom_list, coordinates, cp.mz_extraction_window,
-                cp.ppm, cp.im_extraction_window, cp.extraction_function);
+      // Extract MS1 chromatograms for this batch
+      std::vector< MSChromatogram > ms1_chromatograms;
+      if (ms1_map_ != nullptr) 
+      {
+        OpenSwath::SpectrumAccessPtr threadsafe_ms1 = ms1_map_->lightClone();
+        MS1Extraction_(threadsafe_ms1, swath_maps, ms1_chromatograms, chromConsumer, ms1_cp,
+            transition_exp_used, trafo_inverse, ms1_only, ms1_isotopes);
+      }
 
-            // Step 2.3: convert chromatograms back to OpenMS::MSChromatogram and write to output
-            PeakMap chrom_exp;
-            extractor.return_chromatogram(chrom_list, coordinates, transition_exp_used,  SpectrumSettings(), 
-                                          chrom_exp.getChromatograms(), false, cp.im_extraction_window);
+      // Step 2.1: extract these transitions
+      ChromatogramExtractor extractor;
+      std::vector< OpenSwath::ChromatogramPtr > chrom_list;
+      std::vector< ChromatogramExtractor::ExtractionCoordinates > coordinates;
 
+      // Step 2.2: prepare the extraction coordinates and extract chromatograms
+      // chrom_list contains one entry for each fragment ion (transition) in transition_exp_used
+      prepareExtractionCoordinates_(chrom_list, coordinates, transition_exp_used, trafo_inverse, cp);
+      extractor.extractChromatograms(current_swath_map, chrom_list, coordinates, cp.mz_extraction_window,
+          cp.ppm, cp.im_extraction_window, cp.extraction_function);
 
-            // Step 3: score these extracted transitions
-            FeatureMap featureFile;
-            std::vector< OpenSwath::SwathMap > tmp = {swath_maps[i]};
-            tmp.back().sptr = current_swath_map_inner;
-            scoreAllChromatograms_(chrom_exp.getChromatograms(), ms1_chromatograms, tmp, transition_exp_used,
-                feature_finder_param, trafo, cp.rt_extraction_window, featureFile, tsv_writer, osw_writer, ms1_isotopes);
+      // Step 2.3: convert chromatograms back to OpenMS::MSChromatogram and write to output
+      PeakMap chrom_exp;
+      extractor.return_chromatogram(chrom_list, coordinates, transition_exp_used,  SpectrumSettings(), 
+                                    chrom_exp.getChromatograms(), false, cp.im_extraction_window);
 
-            // Step 4: write all chromatograms and features out into an output object / file
-            // (this needs to be done in a critical section since we only have one
-            // output file and one output map).
-            #pragma omp critical (osw_write_out)
-            {
-              writeOutFeaturesAndChroms_(chrom_exp.getChromatograms(), featureFile, out_featureFile, store_features, chromConsumer);
-            }
-          }
+      // Step 3: score these extracted transitions
+      FeatureMap featureFile;
+      std::vector< OpenSwath::SwathMap > tmp = {swath_maps[i]};
+      tmp.back().sptr = current_swath_map;
+      scoreAllChromatograms_(chrom_exp.getChromatograms(), ms1_chromatograms, tmp, transition_exp_used,
+          feature_finder_param, trafo, cp.rt_extraction_window, featureFile, tsv_writer, osw_writer, ms1_isotopes);
+
+      // Step 4: write all chromatograms and features out into an output object / file
+      // (this needs to be done in a critical section since we only have one
+      // output file and one output map).
+      #pragma omp critical (osw_write_out)
+      {
+        writeOutFeaturesAndChroms_(chrom_exp.getChromatograms(), featureFile, out_featureFile, store_features, chromConsumer);
+      }
 
-        } // continue 2 (no continue due to OpenMP)
-      } // continue 1 (no continue due to OpenMP)
+      // Release the window once its last batch is done
+      {
+        std::lock_guard<std::mutex> lock(window_mutex[i]);
+        if (--open_batches[i] == 0)
+        {
+          window_maps[i].reset();
+        }
+      }
 
       #pragma omp critical (progress)
       this->setProgress(++progress);
-
     }
     this->endProgress();
-    
-#ifdef _OPENMP
-#ifdef MT_ENABLE_NESTED_OPENMP
-    if (threads_outer_loop_ > -1)
+
+    if (osw_writer.isActive())
     {
-      omp_set_num_threads(total_nr_threads); // set number of available threads back to initial value
+      osw_writer.flush();
+      OpenSwathOSWWriter::WriterStatistics stats = osw_writer.getStatistics();
+      OPENMS_LOG_DEBUG << "OSW writer: wrote " << stats.batches_written << " batches in " << stats.transactions
+                       << " transactions (max. queue depth " << stats.max_queue_depth << ", " << stats.producer_waits << " waits)" << std::endl;
     }
-#endif    
-#endif    
   }
 
   void OpenSwathWorkflow::writeOutFeaturesAndChroms_(
@@ -997,15 +992,11 @@ namespace OpenMS
       }
     }
 
-    // Only write at the very end since this is a step that needs a barrier
+    // Only write at the very end; the writer queues the statements and
+    // writes them in the background (thread-safe, no critical section needed)
     if (osw_writer.isActive())
     {
-#ifdef _OPENMP
-#pragma omp critical (osw_write_tsv)
-#endif
-      {
-        osw_writer.writeLines(to_osw_output);
-      }
+      osw_writer.writeLines(to_osw_output);
     }
   }
 
@@ -1256,6 +1247,11 @@ namespace OpenMS
         this->setProgress(++progress);
       }
       this->endProgress();
+
+      if (osw_writer.isActive())
+      {
+        osw_writer.flush();
+      }
     }
 
 
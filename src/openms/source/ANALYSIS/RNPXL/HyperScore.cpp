@@ -34,6 +34,7 @@
 
 #include <OpenMS/ANALYSIS/RNPXL/HyperScore.h>
 
+#include <OpenMS/CHEMISTRY/FragmentIonLadder.h>
 #include <OpenMS/KERNEL/MSSpectrum.h>
 #include <OpenMS/DATASTRUCTURES/MatchedIterator.h>
 
@@ -114,6 +115,62 @@ namespace OpenMS
 
     }
 
+    return fromCounts_(dot_product, b_ion_count, y_ion_count);
+  }
+
+  double HyperScore::compute(double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm, const PeakSpectrum& exp_spectrum, const FragmentIonLadder& theo_ladder)
+  {
+    if (exp_spectrum.size() < 1 || theo_ladder.size() < 1)
+    {
+      std::cout << "Warning: HyperScore: One of the given spectra is empty." << std::endl;
+      return 0.0;
+    }
+
+    // same matching as MatchedIterator: closest experimental peak (within tolerance) for each theoretical ion
+    const float tolerance = fragment_mass_tolerance;
+    int y_ion_count = 0;
+    int b_ion_count = 0;
+    double dot_product = 0.0;
+    Size t = 0;
+    for (Size r = 0; r < theo_ladder.size(); ++r)
+    {
+      const double mz = theo_ladder.mz[r];
+      const float max_dist = fragment_mass_tolerance_unit_ppm ? Math::ppmToMass(tolerance, (float)mz) : tolerance;
+      float diff = std::numeric_limits<float>::max();
+      do
+      {
+        const float d = fabs(mz - exp_spectrum[t].getMZ());
+        if (diff > d) // getting better
+        {
+          diff = d;
+        }
+        else // getting worse (overshot)
+        {
+          --t;
+          break;
+        }
+        ++t;
+      } while (t != exp_spectrum.size());
+      if (t == exp_spectrum.size()) --t;
+
+      if (diff > max_dist) continue;
+
+      dot_product += exp_spectrum[t].getIntensity();
+      if (theo_ladder.ion_type[r] == Residue::YIon)
+      {
+        ++y_ion_count;
+      }
+      else if (theo_ladder.ion_type[r] == Residue::BIon)
+      {
+        ++b_ion_count;
+      }
+    }
+
+    return fromCounts_(dot_product, b_ion_count, y_ion_count);
+  }
+
+  double HyperScore::fromCounts_(double dot_product, int b_ion_count, int y_ion_count)
+  {
     // inefficient: calculates logs repeatedly
     //const double yFact = logfactorial_(y_ion_count);
     //const double bFact = logfactorial_(b_ion_count);
@@ -54,27 +54,71 @@ namespace OpenMS
 {
   vector<OPXLDataStructs::XLPrecursor> OPXLHelper::enumerateCrossLinksAndMasses(const vector<OPXLDataStructs::AASeqWithMass>& peptides, double cross_link_mass, const DoubleList& cross_link_mass_mono_link, const StringList& cross_link_residue1, const StringList& cross_link_residue2, const vector< double >& spectrum_precursors, vector< int >& precursor_correction_positions, double precursor_mass_tolerance, bool precursor_mass_tolerance_unit_ppm)
   {
-    // initialize empty vector for the results
+    // collect all batches
     vector<OPXLDataStructs::XLPrecursor> mass_to_candidates;
+    OPXLHelper::enumerateCrossLinksAndMasses(peptides, cross_link_mass, cross_link_mass_mono_link, cross_link_residue1, cross_link_residue2, spectrum_precursors, precursor_mass_tolerance, precursor_mass_tolerance_unit_ppm, 100000,
+      [&mass_to_candidates, &precursor_correction_positions](vector<OPXLDataStructs::XLPrecursor>& batch, vector< int >& batch_correction_positions)
+      {
+        mass_to_candidates.insert(mass_to_candidates.end(), std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+        precursor_correction_positions.insert(precursor_correction_positions.end(), batch_correction_positions.begin(), batch_correction_positions.end());
+      });
+    return mass_to_candidates;
+  }
 
-    double max_precursor = spectrum_precursors[spectrum_precursors.size()-1];
+  void OPXLHelper::enumerateCrossLinksAndMasses(const vector<OPXLDataStructs::AASeqWithMass>& peptides, double cross_link_mass, const DoubleList& cross_link_mass_mono_link, const StringList& cross_link_residue1, const StringList& cross_link_residue2, const vector< double >& spectrum_precursors, double precursor_mass_tolerance, bool precursor_mass_tolerance_unit_ppm, Size batch_size, const std::function<void(vector<OPXLDataStructs::XLPrecursor>&, vector< int >&)>& process_batch)
+  {
+    if (peptides.empty() || spectrum_precursors.empty()) return;
+    batch_size = std::max(batch_size, Size(1));
 
-    Size peptides_size = peptides.size();
+    // the current batch, handed to process_batch when full (and at the end)
+    vector<OPXLDataStructs::XLPrecursor> batch;
+    vector< int > batch_correction_positions;
+    batch.reserve(std::min(batch_size, Size(100000)));
 
-    // compute a very conservative total upper bound, based on the heaviest possible linear peptide
-    // can be used instead of peptides.end() in all cases for this precursor mass
-    vector<OPXLDataStructs::AASeqWithMass>::const_iterator conservative_upper_bound = upper_bound(peptides.cbegin(), peptides.cend(), max_precursor, OPXLDataStructs::AASeqWithMassComparator());
+    auto add_candidate = [&](double precursor_mass, Size alpha_index, Size beta_index, int pm)
+    {
+      OPXLDataStructs::XLPrecursor precursor;
+      precursor.precursor_mass = precursor_mass;
+      precursor.alpha_index = alpha_index;
+      precursor.beta_index = beta_index;
+      precursor.alpha_seq = peptides[alpha_index].unmodified_seq;
+      if (beta_index < peptides.size())
+      {
+        precursor.beta_seq = peptides[beta_index].unmodified_seq;
+      }
+      batch.push_back(precursor);
+      batch_correction_positions.push_back(pm);
 
-    // initialize additional iterators
-    // the upper bounds for a precursor mass can be used as the lower bounds
-    // for the next heavier precursor mass, narrowing down the search space for new bounds
-    vector<OPXLDataStructs::AASeqWithMass>::const_iterator first_loop = peptides.cbegin();
-    vector<OPXLDataStructs::AASeqWithMass>::const_iterator last_loop = peptides.cbegin();
+      if (batch.size() >= batch_size)
+      {
+        process_batch(batch, batch_correction_positions);
+        batch.clear();
+        batch_correction_positions.clear();
+      }
+    };
 
-    vector<OPXLDataStructs::AASeqWithMass>::const_iterator first_mono = peptides.cbegin();
-    vector<OPXLDataStructs::AASeqWithMass>::const_iterator last_mono = peptides.cbegin();
+    // test if a peptide could have loop-links: one cross-link with both sides attached to the same peptide
+    auto has_loop_link_residues = [&cross_link_residue1, &cross_link_residue2](const String& seq)
+    {
+      bool first_res = false; // is there a residue the first side of the linker can attach to?
+      bool second_res = false; // is there a residue the second side of the linker can attach to?
+      for (Size k = 0; k + 1 < seq.size(); ++k)
+      {
+        for (const String& res : cross_link_residue1)
+        {
+          if (res.size() == 1 && res[0] == seq[k]) { first_res = true; }
+        }
+        for (const String& res : cross_link_residue2)
+        {
+          if (res.size() == 1 && res[0] == seq[k]) { second_res = true; }
+        }
+      }
+      return first_res && second_res;
+    };
 
-    vector<OPXLDataStructs::AASeqWithMass>::const_iterator last_alpha = peptides.cbegin();
+    const Size peptides_size = peptides.size();
+    const auto begin = peptides.cbegin();
+    const auto end = peptides.cend();
 
     for (Size pm = 0; pm < spectrum_precursors.size(); ++pm)
     {
@@ -95,146 +139,62 @@ namespace OpenMS
       double min_peptide_mass = precursor_mass - cross_link_mass - allowed_error;
       double max_peptide_mass = precursor_mass - cross_link_mass + allowed_error;
 
-      first_loop = lower_bound(first_loop, conservative_upper_bound, min_peptide_mass, OPXLDataStructs::AASeqWithMassComparator());
-      last_loop = upper_bound(last_loop, conservative_upper_bound, max_peptide_mass, OPXLDataStructs::AASeqWithMassComparator());
+      Size first_index = lower_bound(begin, end, min_peptide_mass, OPXLDataStructs::AASeqWithMassComparator()) - begin;
+      Size last_index = upper_bound(begin, end, max_peptide_mass, OPXLDataStructs::AASeqWithMassComparator()) - begin;
 
-      int first_index = first_loop - peptides.cbegin();
-      int last_index = last_loop - peptides.cbegin();
-
-#pragma omp parallel for
-      for (int p1 = first_index; p1 < last_index; ++p1)
+      for (Size p1 = first_index; p1 < last_index; ++p1)
       {
-        const String& seq_first = peptides[p1].unmodified_seq;
-        // test if this peptide could have loop-links: one cross-link with both sides attached to the same peptide
-        bool first_res = false; // is there a residue the first side of the linker can attach to?
-        bool second_res = false; // is there a residue the second side of the linker can attach to?
-        for (Size k = 0; k < seq_first.size()-1; ++k)
-        {
-         for (Size i = 0; i < cross_link_residue1.size(); ++i)
-         {
-           if (cross_link_residue1[i].size() == 1 && string(1, seq_first[k]) == cross_link_residue1[i])
-           {
-             first_res = true;
-           }
-         }
-         for (Size i = 0; i < cross_link_residue2.size(); ++i)
-         {
-           if (cross_link_residue2[i].size() == 1 && string(1, seq_first[k]) == cross_link_residue2[i])
-           {
-             second_res = true;
-           }
-         }
-        }
-
         // If both sides of a cross-linker can link to this peptide, generate the loop-link
-        if (first_res && second_res)
+        // (only one peptide: use an out-of-range index for the second peptide)
+        if (has_loop_link_residues(peptides[p1].unmodified_seq))
         {
-         // Monoisotopic weight of the peptide + cross-linker
-         double cross_linked_peptide_mass = peptides[p1].peptide_mass + cross_link_mass;
-
-         // also only one peptide
-         OPXLDataStructs::XLPrecursor precursor;
-         precursor.precursor_mass = cross_linked_peptide_mass;
-         precursor.alpha_index = p1;
-         precursor.beta_index = peptides_size + 1; // an out-of-range index to represent an empty index
-         precursor.alpha_seq = seq_first;
-         precursor.beta_seq = "";
-
-#pragma omp critical (mass_to_candidates_access)
-         {
-           mass_to_candidates.push_back(precursor);
-           precursor_correction_positions.push_back(pm);
-         }
+          add_candidate(peptides[p1].peptide_mass + cross_link_mass, p1, peptides_size + 1, pm);
         }
-      } // end of parallel loop over loop-link candidates
+      }
 
       // ################################ Enumerate Mono-Links #################
-      for (Size i = 0; i < cross_link_mass_mono_link.size(); i++)
+      for (double mono_link_mass : cross_link_mass_mono_link)
       {
-        double mono_link_mass = cross_link_mass_mono_link[i];
-
         min_peptide_mass = precursor_mass - mono_link_mass - allowed_error;
         max_peptide_mass = precursor_mass - mono_link_mass + allowed_error;
 
-        // mono-link masses are sorted in descending order
-        // so we can use the results from the last search as a new lower bounds for both searches again
-        first_mono = lower_bound(first_mono, conservative_upper_bound, min_peptide_mass, OPXLDataStructs::AASeqWithMassComparator());
-        last_mono = upper_bound(last_mono, conservative_upper_bound, max_peptide_mass, OPXLDataStructs::AASeqWithMassComparator());
+        first_index = lower_bound(begin, end, min_peptide_mass, OPXLDataStructs::AASeqWithMassComparator()) - begin;
+        last_index = upper_bound(begin, end, max_peptide_mass, OPXLDataStructs::AASeqWithMassComparator()) - begin;
 
-        first_index = first_mono - peptides.cbegin();
-        last_index = last_mono - peptides.cbegin();
-
-#pragma omp parallel for
-        for (int p1 = first_index; p1 < last_index; ++p1)
+        for (Size p1 = first_index; p1 < last_index; ++p1)
         {
-          // Monoisotopic weight of the peptide + cross-linker
-          double cross_linked_peptide_mass = peptides[p1].peptide_mass + mono_link_mass;
-
-          // Make sure it is clear only one peptide is considered here. Use an out-of-range value for the second peptide.
-          OPXLDataStructs::XLPrecursor precursor;
-          precursor.precursor_mass = cross_linked_peptide_mass;
-          precursor.alpha_index = p1;
-          precursor.beta_index = peptides_size + 1; // an out-of-range index to represent an empty index
-          precursor.alpha_seq = peptides[p1].unmodified_seq;
-          precursor.beta_seq = "";
-
-#pragma omp critical (mass_to_candidates_access)
-         {
-           mass_to_candidates.push_back(precursor);
-           precursor_correction_positions.push_back(pm);
-         }
-        } // end of loop over candidates for a specific mono-link mass
-      } // end of loop over mono-link masses
+          add_candidate(peptides[p1].peptide_mass + mono_link_mass, p1, peptides_size + 1, pm);
+        }
+      }
 
       // ################################ Enumerate Cross-Links #################
-      // constrain the conservative upper bound even more,
-      // because we have to fit in two peptides this time
-      // maximal mass: difference between precursor mass and the smallest peptide + cross-linker
+      // two-pointer sweep: with increasing alpha mass, the window of matching beta masses moves to lighter peptides.
+      // beta is never lighter than alpha (beta index >= alpha index), so the sweep ends when the alpha index reaches the window.
       max_peptide_mass = precursor_mass - cross_link_mass - peptides[0].peptide_mass + allowed_error;
-      last_alpha = upper_bound(last_alpha, conservative_upper_bound, max_peptide_mass, OPXLDataStructs::AASeqWithMassComparator());
-      int last_alpha_index = last_alpha - peptides.cbegin();
+      Size first_beta = lower_bound(begin, end, precursor_mass - cross_link_mass - peptides[0].peptide_mass - allowed_error, OPXLDataStructs::AASeqWithMassComparator()) - begin;
+      Size last_beta = upper_bound(begin, end, max_peptide_mass, OPXLDataStructs::AASeqWithMassComparator()) - begin;
 
-#pragma omp parallel for
-      for (int p1 = 0; p1 < last_alpha_index; ++p1)
+      for (Size p1 = 0; p1 < last_beta; ++p1)
       {
         // Constrain search for beta
         double min_peptide_mass_beta = precursor_mass - cross_link_mass - peptides[p1].peptide_mass - allowed_error;
         double max_peptide_mass_beta = precursor_mass - cross_link_mass - peptides[p1].peptide_mass + allowed_error;
 
-        // the last_alpha upper bound is also a conservative upper bound here
-        vector<OPXLDataStructs::AASeqWithMass>::const_iterator first_beta = lower_bound(peptides.cbegin()+p1, last_alpha, min_peptide_mass_beta, OPXLDataStructs::AASeqWithMassComparator());
-        vector<OPXLDataStructs::AASeqWithMass>::const_iterator last_beta = upper_bound(peptides.cbegin()+p1, last_alpha, max_peptide_mass_beta, OPXLDataStructs::AASeqWithMassComparator());
-
-        if (first_beta == last_beta)
-        {
-          continue;
-        }
-
-        Size first_beta_index = first_beta - peptides.begin();
-        Size last_beta_index = last_beta - peptides.begin();
+        while (last_beta > 0 && peptides[last_beta - 1].peptide_mass > max_peptide_mass_beta) { --last_beta; }
+        while (first_beta > 0 && !(peptides[first_beta - 1].peptide_mass < min_peptide_mass_beta)) { --first_beta; }
 
-        for (Size p2 = first_beta_index; p2 < last_beta_index; ++p2)
+        for (Size p2 = std::max(first_beta, p1); p2 < last_beta; ++p2)
         {
           // Monoisotopic weight of the first peptide + the second peptide + cross-linker
-          double cross_linked_pair_mass = peptides[p1].peptide_mass + peptides[p2].peptide_mass + cross_link_mass;
-
-          // this time both peptides have valid indices
-          OPXLDataStructs::XLPrecursor precursor;
-          precursor.precursor_mass = cross_linked_pair_mass;
-          precursor.alpha_index = p1;
-          precursor.beta_index = p2;
-          precursor.alpha_seq = peptides[p1].unmodified_seq;
-          precursor.beta_seq = peptides[p2].unmodified_seq;
-
-#pragma omp critical (mass_to_candidates_access)
-         {
-           mass_to_candidates.push_back(precursor);
-           precursor_correction_positions.push_back(pm);
-         }
-        } // end of loop over betas
-      } // end of parallel loop over alphas
+          add_candidate(peptides[p1].peptide_mass + peptides[p2].peptide_mass + cross_link_mass, p1, p2, pm);
+        }
+      }
     } // end of loop over precursor masses
-    return mass_to_candidates;
+
+    if (!batch.empty())
+    {
+      process_batch(batch, batch_correction_positions);
+    }
   }
 
   std::vector<OPXLDataStructs::AASeqWithMass> OPXLHelper::digestDatabase(
@@ -1325,9 +1285,33 @@ namespace OpenMS
                                                                                                 String cross_link_name,
                                                                                                 bool use_sequence_tags,
                                                                                                 const std::vector<std::string>& tags)
+  {
+    // collect all batches
+    vector <OPXLDataStructs::ProteinProteinCrossLink> cross_link_candidates;
+    OPXLHelper::collectPrecursorCandidates(precursor_correction_steps, precursor_mass, precursor_mass_tolerance, precursor_mass_tolerance_unit_ppm, filtered_peptide_masses, cross_link_mass, cross_link_mass_mono_link, cross_link_residue1, cross_link_residue2, cross_link_name, use_sequence_tags, tags, 100000,
+      [&cross_link_candidates](vector <OPXLDataStructs::ProteinProteinCrossLink>& batch)
+      {
+        cross_link_candidates.insert(cross_link_candidates.end(), std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+      });
+    return cross_link_candidates;
+  }
+
+  void OPXLHelper::collectPrecursorCandidates(const IntList& precursor_correction_steps,
+                                              double precursor_mass,
+                                              double precursor_mass_tolerance,
+                                              bool precursor_mass_tolerance_unit_ppm,
+                                              const vector<OPXLDataStructs::AASeqWithMass>& filtered_peptide_masses,
+                                              double cross_link_mass,
+                                              const DoubleList& cross_link_mass_mono_link,
+                                              const StringList& cross_link_residue1,
+                                              const StringList& cross_link_residue2,
+                                              const String& cross_link_name,
+                                              bool use_sequence_tags,
+                                              const std::vector<std::string>& tags,
+                                              Size batch_size,
+                                              const std::function<void(std::vector<OPXLDataStructs::ProteinProteinCrossLink>&)>& process_batch)
   {
     // determine candidates
-    std::vector< OPXLDataStructs::XLPrecursor > candidates;
     std::vector< double > spectrum_precursor_vector;
     std::vector< double > allowed_error_vector;
 
@@ -1351,35 +1335,45 @@ namespace OpenMS
 
     } // end correction mass loop
 
-    std::vector< int > precursor_correction_positions;
     // if sequence tags are used and no tags were found, don't bother combining peptide pairs
-    if ( (use_sequence_tags && tags.size() > 0) ||
-         !use_sequence_tags)
+    if (use_sequence_tags && tags.empty())
     {
-      candidates = OPXLHelper::enumerateCrossLinksAndMasses(filtered_peptide_masses, cross_link_mass, cross_link_mass_mono_link, cross_link_residue1, cross_link_residue2, spectrum_precursor_vector, precursor_correction_positions, precursor_mass_tolerance, precursor_mass_tolerance_unit_ppm);
+      return;
     }
 
-    // an empty vector of sequence tags implies no filtering should be done in this case
+    Size candidates_size(0), filtered_candidates_size(0);
+    OPXLHelper::enumerateCrossLinksAndMasses(filtered_peptide_masses, cross_link_mass, cross_link_mass_mono_link, cross_link_residue1, cross_link_residue2, spectrum_precursor_vector, precursor_mass_tolerance, precursor_mass_tolerance_unit_ppm, batch_size,
+      [&](std::vector< OPXLDataStructs::XLPrecursor >& candidates, std::vector< int >& precursor_correction_positions)
+      {
+        candidates_size += candidates.size();
+        // an empty vector of sequence tags implies no filtering should be done in this case
+        if (use_sequence_tags)
+        {
+          OPXLHelper::filterPrecursorsByTags(candidates, precursor_correction_positions, tags);
+        }
+        filtered_candidates_size += candidates.size();
+
+        vector< int > precursor_corrections;
+        for (Size pc = 0; pc < precursor_correction_positions.size(); ++pc)
+        {
+          precursor_corrections.push_back(precursor_correction_steps[precursor_correction_positions[pc]]);
+        }
+        vector <OPXLDataStructs::ProteinProteinCrossLink> cross_link_candidates = OPXLHelper::buildCandidates(candidates, precursor_corrections, precursor_correction_positions, filtered_peptide_masses, cross_link_residue1, cross_link_residue2, cross_link_mass, cross_link_mass_mono_link, spectrum_precursor_vector, allowed_error_vector, cross_link_name);
+        if (!cross_link_candidates.empty())
+        {
+          process_batch(cross_link_candidates);
+        }
+      });
+
     if (use_sequence_tags)
     {
-      Size candidates_size = candidates.size();
-      OPXLHelper::filterPrecursorsByTags(candidates, precursor_correction_positions, tags);
-
 #pragma omp critical (LOG_DEBUG_access)
       {
         OPENMS_LOG_DEBUG << "Number of sequence tags: " << tags.size() << std::endl;
         OPENMS_LOG_DEBUG << "Candidate Peptide Pairs before sequence tag filtering: " << candidates_size << std::endl;
-        OPENMS_LOG_DEBUG << "Candidate Peptide Pairs  after sequence tag filtering: " << candidates.size() << std::endl;
+        OPENMS_LOG_DEBUG << "Candidate Peptide Pairs  after sequence tag filtering: " << filtered_candidates_size << std::endl;
       }
     }
-
-    vector< int > precursor_corrections;
-    for (Size pc = 0; pc < precursor_correction_positions.size(); ++pc)
-    {
-      precursor_corrections.push_back(precursor_correction_steps[precursor_correction_positions[pc]]);
-    }
-    vector <OPXLDataStructs::ProteinProteinCrossLink> cross_link_candidates = OPXLHelper::buildCandidates(candidates, precursor_corrections, precursor_correction_positions, filtered_peptide_masses, cross_link_residue1, cross_link_residue2, cross_link_mass, cross_link_mass_mono_link, spectrum_precursor_vector, allowed_error_vector, cross_link_name);
-    return cross_link_candidates;
   }
 
   double OPXLHelper::computePrecursorError(OPXLDataStructs::CrossLinkSpectrumMatch csm, double precursor_mz, int precursor_charge)
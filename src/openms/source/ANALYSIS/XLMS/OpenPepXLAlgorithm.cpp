@@ -111,6 +111,8 @@ using namespace OpenMS;
     defaults_.setSectionDescription("cross_linker", "Description of the cross-linker reagent");
 
     defaults_.setValue("algorithm:number_top_hits", 1, "Number of top hits reported for each spectrum pair");
+    defaults_.setValue("algorithm:candidate_batch_size", 100000, "Maximal number of candidates (peptide pairs, mono- and loop-links) enumerated and scored at once for a spectrum. Only the best matches of each batch are kept, so smaller values reduce memory usage for large databases.", ListUtils::create<String>("advanced"));
+    defaults_.setMinInt("algorithm:candidate_batch_size", 1);
     StringList deisotope_strings = ListUtils::create<String>("true,false,auto");
     defaults_.setValue("algorithm:deisotope", "auto", "Set to true, if the input spectra should be deisotoped before any other processing steps. If set to auto the spectra will be deisotoped, if the fragment mass tolerance is < 0.1 Da or < 100 ppm (0.1 Da at a mass of 1000)", ListUtils::create<String>("advanced"));
     defaults_.setValidStrings("algorithm:deisotope", deisotope_strings);
@@ -169,6 +171,7 @@ using namespace OpenMS;
     enzyme_name_ = static_cast<String>(param_.getValue("peptide:enzyme"));
 
     number_top_hits_ = static_cast<Int>(param_.getValue("algorithm:number_top_hits"));
+    candidate_batch_size_ = static_cast<Int>(param_.getValue("algorithm:candidate_batch_size"));
     deisotope_mode_ = static_cast<String>(param_.getValue("algorithm:deisotope"));
 
     add_y_ions_ = param_.getValue("ions:y_ions");
@@ -457,153 +460,167 @@ using namespace OpenMS;
         continue;
       }
 
-      vector <OPXLDataStructs::ProteinProteinCrossLink> cross_link_candidates = OPXLHelper::collectPrecursorCandidates(precursor_correction_steps_, precursor_mass, precursor_mass_tolerance_, precursor_mass_tolerance_unit_ppm_, filtered_peptide_masses, cross_link_mass_light_, cross_link_mass_mono_link_, cross_link_residue1_, cross_link_residue2_, cross_link_name_);
-
       spectrum_counter++;
       cout << "Processing spectrum pair " << spectrum_counter << " / " << spectrum_pairs.size() << endl;
       cout << "Light Spectrum ID: " << spectrum_light.getNativeID() << " |\tHeavy Spectrum ID: " << spectra[scan_index_heavy].getNativeID() << "\t| at: " << DateTime::now().getTime() << endl;
-      cout << "Number of peaks in light spectrum: " << spectrum_light.size() << " |\tNumber of candidates: " << cross_link_candidates.size() << endl;
 
       // lists for one spectrum, to determine best match to the spectrum
       vector< OPXLDataStructs::CrossLinkSpectrumMatch > all_csms_spectrum;
       vector< OPXLDataStructs::CrossLinkSpectrumMatch > mainscore_csms_spectrum;
 
+      // candidates are enumerated and scored in batches, only the best matches are kept for the full scoring below
+      // (storing all candidates of a proteome-wide database at once can exceed the available memory)
+      Size candidates_count(0);
+      OPXLHelper::collectPrecursorCandidates(precursor_correction_steps_, precursor_mass, precursor_mass_tolerance_, precursor_mass_tolerance_unit_ppm_, filtered_peptide_masses, cross_link_mass_light_, cross_link_mass_mono_link_, cross_link_residue1_, cross_link_residue2_, cross_link_name_, false, std::vector<std::string>(), candidate_batch_size_,
+        [&](vector <OPXLDataStructs::ProteinProteinCrossLink>& cross_link_candidates)
+        {
+          candidates_count += cross_link_candidates.size();
 
 #pragma omp parallel for schedule(guided)
-      for (SignedSize i = 0; i < static_cast<SignedSize>(cross_link_candidates.size()); ++i)
-      {
-        OPXLDataStructs::ProteinProteinCrossLink cross_link_candidate = cross_link_candidates[i];
+          for (SignedSize i = 0; i < static_cast<SignedSize>(cross_link_candidates.size()); ++i)
+          {
+            OPXLDataStructs::ProteinProteinCrossLink cross_link_candidate = cross_link_candidates[i];
+
+            std::vector< SimpleTSGXLMS::SimplePeak > theoretical_spec_linear_alpha;
+            theoretical_spec_linear_alpha.reserve(1500);
+            std::vector< SimpleTSGXLMS::SimplePeak > theoretical_spec_linear_beta;
+            std::vector< SimpleTSGXLMS::SimplePeak > theoretical_spec_xlinks_alpha;
+            std::vector< SimpleTSGXLMS::SimplePeak > theoretical_spec_xlinks_beta;
+
+            bool type_is_cross_link = cross_link_candidate.getType() == OPXLDataStructs::CROSS;
+            bool type_is_loop = cross_link_candidate.getType() == OPXLDataStructs::LOOP;
+            Size link_pos_B = 0;
+            if (type_is_loop)
+            {
+              link_pos_B = cross_link_candidate.cross_link_position.second;
+            }
+            AASequence alpha;
+            AASequence beta;
+            if (cross_link_candidate.alpha) { alpha = *cross_link_candidate.alpha; }
+            if (cross_link_candidate.beta) { beta = *cross_link_candidate.beta; }
 
-        std::vector< SimpleTSGXLMS::SimplePeak > theoretical_spec_linear_alpha;
-        theoretical_spec_linear_alpha.reserve(1500);
-        std::vector< SimpleTSGXLMS::SimplePeak > theoretical_spec_linear_beta;
-        std::vector< SimpleTSGXLMS::SimplePeak > theoretical_spec_xlinks_alpha;
-        std::vector< SimpleTSGXLMS::SimplePeak > theoretical_spec_xlinks_beta;
+            specGen_mainscore.getLinearIonSpectrum(theoretical_spec_linear_alpha, alpha, cross_link_candidate.cross_link_position.first, 2, link_pos_B);
+            if (type_is_cross_link)
+            {
+              theoretical_spec_linear_beta.reserve(1500);
+              specGen_mainscore.getLinearIonSpectrum(theoretical_spec_linear_beta, beta, cross_link_candidate.cross_link_position.second, 2);
+            }
 
-        bool type_is_cross_link = cross_link_candidate.getType() == OPXLDataStructs::CROSS;
-        bool type_is_loop = cross_link_candidate.getType() == OPXLDataStructs::LOOP;
-        Size link_pos_B = 0;
-        if (type_is_loop)
-        {
-          link_pos_B = cross_link_candidate.cross_link_position.second;
-        }
-        AASequence alpha;
-        AASequence beta;
-        if (cross_link_candidate.alpha) { alpha = *cross_link_candidate.alpha; }
-        if (cross_link_candidate.beta) { beta = *cross_link_candidate.beta; }
+            // Something like this can happen, e.g. with a loop link connecting the first and last residue of a peptide
+            if (theoretical_spec_linear_alpha.empty())
+            {
+              continue;
+            }
 
-        specGen_mainscore.getLinearIonSpectrum(theoretical_spec_linear_alpha, alpha, cross_link_candidate.cross_link_position.first, 2, link_pos_B);
-        if (type_is_cross_link)
-        {
-          theoretical_spec_linear_beta.reserve(1500);
-          specGen_mainscore.getLinearIonSpectrum(theoretical_spec_linear_beta, beta, cross_link_candidate.cross_link_position.second, 2);
-        }
+            vector< pair< Size, Size > > matched_spec_linear_alpha;
+            vector< pair< Size, Size > > matched_spec_linear_beta;
+            vector< pair< Size, Size > > matched_spec_xlinks_alpha;
+            vector< pair< Size, Size > > matched_spec_xlinks_beta;
 
-        // Something like this can happen, e.g. with a loop link connecting the first and last residue of a peptide
-        if (theoretical_spec_linear_alpha.empty())
-        {
-          continue;
-        }
+            if (linear_peaks.size() > 0)
+            {
+              DataArrays::IntegerDataArray exp_charges;
+              if (linear_peaks.getIntegerDataArrays().size() > 0)
+              {
+                exp_charges = linear_peaks.getIntegerDataArrays()[0];
+              }
+              OPXLSpectrumProcessingAlgorithms::getSpectrumAlignmentSimple(matched_spec_linear_alpha, fragment_mass_tolerance_, fragment_mass_tolerance_unit_ppm_, theoretical_spec_linear_alpha, linear_peaks, exp_charges);
+              OPXLSpectrumProcessingAlgorithms::getSpectrumAlignmentSimple(matched_spec_linear_beta, fragment_mass_tolerance_, fragment_mass_tolerance_unit_ppm_, theoretical_spec_linear_beta, linear_peaks, exp_charges);
+            }
+            // drop candidates with almost no linear fragment peak matches before making the more complex theoretical spectra and aligning them
+            // this removes hits that no one would trust after manual validation anyway and reduces time wasted on really bad spectra or candidates without any matching peaks
+            if (matched_spec_linear_alpha.size() < 2 || (type_is_cross_link && matched_spec_linear_beta.size() < 2) )
+            {
+              continue;
+            }
+            theoretical_spec_xlinks_alpha.reserve(1500);
 
-        vector< pair< Size, Size > > matched_spec_linear_alpha;
-        vector< pair< Size, Size > > matched_spec_linear_beta;
-        vector< pair< Size, Size > > matched_spec_xlinks_alpha;
-        vector< pair< Size, Size > > matched_spec_xlinks_beta;
+            if (type_is_cross_link)
+            {
 
-        if (linear_peaks.size() > 0)
-        {
-          DataArrays::IntegerDataArray exp_charges;
-          if (linear_peaks.getIntegerDataArrays().size() > 0)
-          {
-            exp_charges = linear_peaks.getIntegerDataArrays()[0];
-          }
-          OPXLSpectrumProcessingAlgorithms::getSpectrumAlignmentSimple(matched_spec_linear_alpha, fragment_mass_tolerance_, fragment_mass_tolerance_unit_ppm_, theoretical_spec_linear_alpha, linear_peaks, exp_charges);
-          OPXLSpectrumProcessingAlgorithms::getSpectrumAlignmentSimple(matched_spec_linear_beta, fragment_mass_tolerance_, fragment_mass_tolerance_unit_ppm_, theoretical_spec_linear_beta, linear_peaks, exp_charges);
-        }
-        // drop candidates with almost no linear fragment peak matches before making the more complex theoretical spectra and aligning them
-        // this removes hits that no one would trust after manual validation anyway and reduces time wasted on really bad spectra or candidates without any matching peaks
-        if (matched_spec_linear_alpha.size() < 2 || (type_is_cross_link && matched_spec_linear_beta.size() < 2) )
-        {
-          continue;
-        }
-        theoretical_spec_xlinks_alpha.reserve(1500);
+              theoretical_spec_xlinks_beta.reserve(1500);
+              specGen_mainscore.getXLinkIonSpectrum(theoretical_spec_xlinks_alpha, cross_link_candidate, true, 2, precursor_charge);
+              specGen_mainscore.getXLinkIonSpectrum(theoretical_spec_xlinks_beta, cross_link_candidate, false, 2, precursor_charge);
+            }
+            else
+            {
+              // Function for mono-links or loop-links
+              specGen_mainscore.getXLinkIonSpectrum(theoretical_spec_xlinks_alpha, alpha, cross_link_candidate.cross_link_position.first, precursor_mass, 1, precursor_charge, link_pos_B);
+            }
+            if (theoretical_spec_xlinks_alpha.empty())
+            {
+              continue;
+            }
 
-        if (type_is_cross_link)
-        {
+            if (xlink_peaks.size() > 0)
+            {
+              DataArrays::IntegerDataArray exp_charges;
+              if (xlink_peaks.getIntegerDataArrays().size() > 0)
+              {
+                exp_charges = xlink_peaks.getIntegerDataArrays()[0];
+              }
+              OPXLSpectrumProcessingAlgorithms::getSpectrumAlignmentSimple(matched_spec_xlinks_alpha, fragment_mass_tolerance_xlinks_, fragment_mass_tolerance_unit_ppm_, theoretical_spec_xlinks_alpha, xlink_peaks, exp_charges);
+              OPXLSpectrumProcessingAlgorithms::getSpectrumAlignmentSimple(matched_spec_xlinks_beta, fragment_mass_tolerance_xlinks_, fragment_mass_tolerance_unit_ppm_, theoretical_spec_xlinks_beta, xlink_peaks, exp_charges);
+            }
 
-          theoretical_spec_xlinks_beta.reserve(1500);
-          specGen_mainscore.getXLinkIonSpectrum(theoretical_spec_xlinks_alpha, cross_link_candidate, true, 2, precursor_charge);
-          specGen_mainscore.getXLinkIonSpectrum(theoretical_spec_xlinks_beta, cross_link_candidate, false, 2, precursor_charge);
-        }
-        else
-        {
-          // Function for mono-links or loop-links
-          specGen_mainscore.getXLinkIonSpectrum(theoretical_spec_xlinks_alpha, alpha, cross_link_candidate.cross_link_position.first, precursor_mass, 1, precursor_charge, link_pos_B);
-        }
-        if (theoretical_spec_xlinks_alpha.empty())
-        {
-          continue;
-        }
+            // the maximal xlink ion charge is (precursor charge - 1) and the minimal xlink ion charge is 2.
+            // we need the difference between min and max here, which is (precursor_charge - 3) in most cases
+            // but we also need a number > 0, we set 1 as the minimum, in case the precursor charge is only 3 or smaller
+            Size n_xlink_charges = 1;
+            if (precursor_charge > 3)
+            {
+              n_xlink_charges = precursor_charge - 3;
+            }
 
-        if (xlink_peaks.size() > 0)
-        {
-          DataArrays::IntegerDataArray exp_charges;
-          if (xlink_peaks.getIntegerDataArrays().size() > 0)
-          {
-            exp_charges = xlink_peaks.getIntegerDataArrays()[0];
-          }
-          OPXLSpectrumProcessingAlgorithms::getSpectrumAlignmentSimple(matched_spec_xlinks_alpha, fragment_mass_tolerance_xlinks_, fragment_mass_tolerance_unit_ppm_, theoretical_spec_xlinks_alpha, xlink_peaks, exp_charges);
-          OPXLSpectrumProcessingAlgorithms::getSpectrumAlignmentSimple(matched_spec_xlinks_beta, fragment_mass_tolerance_xlinks_, fragment_mass_tolerance_unit_ppm_, theoretical_spec_xlinks_beta, xlink_peaks, exp_charges);
-        }
+            // compute match odds (unweighted), the 3 is the number of charge states in the theoretical spectra
+            double match_odds_c_alpha = XQuestScores::matchOddsScoreSimpleSpec(theoretical_spec_linear_alpha, matched_spec_linear_alpha.size(), fragment_mass_tolerance_, fragment_mass_tolerance_unit_ppm_);
+            double match_odds_x_alpha = XQuestScores::matchOddsScoreSimpleSpec(theoretical_spec_xlinks_alpha, matched_spec_xlinks_alpha.size(), fragment_mass_tolerance_xlinks_, fragment_mass_tolerance_unit_ppm_, true, n_xlink_charges);
+            double match_odds = 0;
+            double match_odds_alpha = 0;
+            double match_odds_beta = 0;
 
-        // the maximal xlink ion charge is (precursor charge - 1) and the minimal xlink ion charge is 2.
-        // we need the difference between min and max here, which is (precursor_charge - 3) in most cases
-        // but we also need a number > 0, we set 1 as the minimum, in case the precursor charge is only 3 or smaller
-        Size n_xlink_charges = 1;
-        if (precursor_charge > 3)
-        {
-          n_xlink_charges = precursor_charge - 3;
-        }
+            if (type_is_cross_link)
+            {
+              double match_odds_c_beta = XQuestScores::matchOddsScoreSimpleSpec(theoretical_spec_linear_beta, matched_spec_linear_beta.size(), fragment_mass_tolerance_, fragment_mass_tolerance_unit_ppm_);
+              double match_odds_x_beta = XQuestScores::matchOddsScoreSimpleSpec(theoretical_spec_xlinks_beta, matched_spec_xlinks_beta.size(), fragment_mass_tolerance_xlinks_, fragment_mass_tolerance_unit_ppm_, true, n_xlink_charges);
+              match_odds = (match_odds_c_alpha + match_odds_x_alpha + match_odds_c_beta + match_odds_x_beta) / 4;
+              match_odds_alpha = (match_odds_c_alpha + match_odds_x_alpha) / 2;
+              match_odds_beta = (match_odds_c_beta + match_odds_x_beta) / 2;
+            }
+            else
+            {
+              match_odds = (match_odds_c_alpha + match_odds_x_alpha) / 2;
+              match_odds_alpha = match_odds;
+            }
 
-        // compute match odds (unweighted), the 3 is the number of charge states in the theoretical spectra
-        double match_odds_c_alpha = XQuestScores::matchOddsScoreSimpleSpec(theoretical_spec_linear_alpha, matched_spec_linear_alpha.size(), fragment_mass_tolerance_, fragment_mass_tolerance_unit_ppm_);
-        double match_odds_x_alpha = XQuestScores::matchOddsScoreSimpleSpec(theoretical_spec_xlinks_alpha, matched_spec_xlinks_alpha.size(), fragment_mass_tolerance_xlinks_, fragment_mass_tolerance_unit_ppm_, true, n_xlink_charges);
-        double match_odds = 0;
-        double match_odds_alpha = 0;
-        double match_odds_beta = 0;
+            OPXLDataStructs::CrossLinkSpectrumMatch csm;
+            csm.cross_link = cross_link_candidate;
+            csm.precursor_correction = cross_link_candidate.precursor_correction;
+            double rel_error = OPXLHelper::computePrecursorError(csm, precursor_mz, precursor_charge);
 
-        if (type_is_cross_link)
-        {
-          double match_odds_c_beta = XQuestScores::matchOddsScoreSimpleSpec(theoretical_spec_linear_beta, matched_spec_linear_beta.size(), fragment_mass_tolerance_, fragment_mass_tolerance_unit_ppm_);
-          double match_odds_x_beta = XQuestScores::matchOddsScoreSimpleSpec(theoretical_spec_xlinks_beta, matched_spec_xlinks_beta.size(), fragment_mass_tolerance_xlinks_, fragment_mass_tolerance_unit_ppm_, true, n_xlink_charges);
-          match_odds = (match_odds_c_alpha + match_odds_x_alpha + match_odds_c_beta + match_odds_x_beta) / 4;
-          match_odds_alpha = (match_odds_c_alpha + match_odds_x_alpha) / 2;
-          match_odds_beta = (match_odds_c_beta + match_odds_x_beta) / 2;
-        }
-        else
-        {
-          match_odds = (match_odds_c_alpha + match_odds_x_alpha) / 2;
-          match_odds_alpha = match_odds;
-        }
+            double new_match_odds_weight = 0.2;
+            double new_rel_error_weight = -0.03;
+            double new_score = new_match_odds_weight * std::log(1e-7 + match_odds) + new_rel_error_weight * abs(rel_error);
 
-        OPXLDataStructs::CrossLinkSpectrumMatch csm;
-        csm.cross_link = cross_link_candidate;
-        csm.precursor_correction = cross_link_candidate.precursor_correction;
-        double rel_error = OPXLHelper::computePrecursorError(csm, precursor_mz, precursor_charge);
+            csm.score = new_score;
+            csm.match_odds = match_odds;
+            csm.match_odds_alpha = match_odds_alpha;
+            csm.match_odds_beta = match_odds_beta;
+            csm.precursor_error_ppm = rel_error;
 
-        double new_match_odds_weight = 0.2;
-        double new_rel_error_weight = -0.03;
-        double new_score = new_match_odds_weight * std::log(1e-7 + match_odds) + new_rel_error_weight * abs(rel_error);
+#pragma omp critical (mainscore_csms_spectrum_access)
+            mainscore_csms_spectrum.push_back(csm);
+          }
 
-        csm.score = new_score;
-        csm.match_odds = match_odds;
-        csm.match_odds_alpha = match_odds_alpha;
-        csm.match_odds_beta = match_odds_beta;
-        csm.precursor_error_ppm = rel_error;
+          if (mainscore_csms_spectrum.size() > static_cast<Size>(number_top_hits_))
+          {
+            std::sort(mainscore_csms_spectrum.rbegin(), mainscore_csms_spectrum.rend(), OPXLDataStructs::CLSMScoreComparator());
+            mainscore_csms_spectrum.resize(number_top_hits_);
+          }
+        });
+
+      cout << "Number of peaks in light spectrum: " << spectrum_light.size() << " |\tNumber of candidates: " << candidates_count << endl;
 
-#pragma omp critical (mainscore_csms_spectrum_access)
-        mainscore_csms_spectrum.push_back(csm);
-      }
       // progresslogger.endProgress();
       std::sort(mainscore_csms_spectrum.rbegin(), mainscore_csms_spectrum.rend(), OPXLDataStructs::CLSMScoreComparator());
 
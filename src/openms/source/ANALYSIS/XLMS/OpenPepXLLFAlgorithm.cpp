@@ -108,6 +108,8 @@ using namespace OpenMS;
     defaults_.setSectionDescription("cross_linker", "Description of the cross-linker reagent");
 
     defaults_.setValue("algorithm:number_top_hits", 1, "Number of top hits reported for each spectrum pair");
+    defaults_.setValue("algorithm:candidate_batch_size", 100000, "Maximal number of candidates (peptide pairs, mono- and loop-links) enumerated and scored at once for a spectrum. Only the best matches of each batch are kept, so smaller values reduce memory usage for large databases.", ListUtils::create<String>("advanced"));
+    defaults_.setMinInt("algorithm:candidate_batch_size", 1);
     StringList deisotope_strings = StringList({"true", "false", "auto"});
     defaults_.setValue("algorithm:deisotope", "auto", "Set to true, if the input spectra should be deisotoped before any other processing steps. If set to auto the spectra will be deisotoped, if the fragment mass tolerance is < 0.1 Da or < 100 ppm (0.1 Da at a mass of 1000)", StringList({"advanced"}));
     defaults_.setValidStrings("algorithm:deisotope", deisotope_strings);
@@ -168,6 +170,7 @@ using namespace OpenMS;
     enzyme_name_ = static_cast<String>(param_.getValue("peptide:enzyme"));
 
     number_top_hits_ = static_cast<Int>(param_.getValue("algorithm:number_top_hits"));
+    candidate_batch_size_ = static_cast<Int>(param_.getValue("algorithm:candidate_batch_size"));
     deisotope_mode_ = static_cast<String>(param_.getValue("algorithm:deisotope"));
     use_sequence_tags_ = param_.getValue("algorithm:use_sequence_tags") == "true";
     sequence_tag_min_length_ = static_cast<Size>(param_.getValue("algorithm:sequence_tag_min_length"));
@@ -414,151 +417,163 @@ using namespace OpenMS;
       }
 
       vector< OPXLDataStructs::CrossLinkSpectrumMatch > top_csms_spectrum;
-      vector< OPXLDataStructs::ProteinProteinCrossLink > cross_link_candidates = OPXLHelper::collectPrecursorCandidates(precursor_correction_steps_, precursor_mass, precursor_mass_tolerance_, precursor_mass_tolerance_unit_ppm_, filtered_peptide_masses, cross_link_mass_, cross_link_mass_mono_link_, cross_link_residue1_, cross_link_residue2_, cross_link_name_, use_sequence_tags_, tags);
-      all_candidates_count += cross_link_candidates.size();
-
-#ifdef DEBUG_OPENPEPXLLFALGO
-      OPENMS_LOG_DEBUG << "Size of enumerated candidates: " << double(cross_link_candidates.size()) * sizeof(OPXLDataStructs::ProteinProteinCrossLink) / 1024.0 / 1024.0 << " mb" << endl;
-#endif
 
       spectrum_counter++;
       cout << "Processing spectrum " << spectrum_counter << " / " << spectra.size() << " |\tSpectrum ID: " << spectrum.getNativeID() << "\t| at: " << DateTime::now().getTime() << endl;
-      cout << "Number of peaks: " << spectrum.size() << " |\tNumber of candidates: " << cross_link_candidates.size() << endl;
-
-      if (cross_link_candidates.empty())
-      {
-        continue;
-      }
 
       // lists for one spectrum, to determine best match to the spectrum
       vector< OPXLDataStructs::CrossLinkSpectrumMatch > all_csms_spectrum;
       vector< OPXLDataStructs::CrossLinkSpectrumMatch > mainscore_csms_spectrum;
 
-#pragma omp parallel for schedule(guided)
-      for (SignedSize i = 0; i < static_cast<SignedSize>(cross_link_candidates.size()); ++i)
-      {
-        OPXLDataStructs::ProteinProteinCrossLink cross_link_candidate = cross_link_candidates[i];
-
-        std::vector< SimpleTSGXLMS::SimplePeak > theoretical_spec_linear_alpha;
-        theoretical_spec_linear_alpha.reserve(1500);
-        std::vector< SimpleTSGXLMS::SimplePeak > theoretical_spec_linear_beta;
-        std::vector< SimpleTSGXLMS::SimplePeak > theoretical_spec_xlinks_alpha;
-        std::vector< SimpleTSGXLMS::SimplePeak > theoretical_spec_xlinks_beta;
-
-        bool type_is_cross_link = cross_link_candidate.getType() == OPXLDataStructs::CROSS;
-        bool type_is_loop = cross_link_candidate.getType() == OPXLDataStructs::LOOP;
-        Size link_pos_B = 0;
-        if (type_is_loop)
-        {
-          link_pos_B = cross_link_candidate.cross_link_position.second;
-        }
-        AASequence alpha;
-        AASequence beta;
-        if (cross_link_candidate.alpha) { alpha = *cross_link_candidate.alpha; }
-        if (cross_link_candidate.beta) { beta = *cross_link_candidate.beta; }
-
-        specGen_mainscore.getLinearIonSpectrum(theoretical_spec_linear_alpha, alpha, cross_link_candidate.cross_link_position.first, 2, link_pos_B);
-        if (type_is_cross_link)
+      // candidates are enumerated and scored in batches, only the best matches are kept for the full scoring below
+      // (storing all candidates of a proteome-wide database at once can exceed the available memory)
+      Size candidates_count(0);
+      OPXLHelper::collectPrecursorCandidates(precursor_correction_steps_, precursor_mass, precursor_mass_tolerance_, precursor_mass_tolerance_unit_ppm_, filtered_peptide_masses, cross_link_mass_, cross_link_mass_mono_link_, cross_link_residue1_, cross_link_residue2_, cross_link_name_, use_sequence_tags_, tags, candidate_batch_size_,
+        [&](vector <OPXLDataStructs::ProteinProteinCrossLink>& cross_link_candidates)
         {
-          theoretical_spec_linear_beta.reserve(1500);
-          specGen_mainscore.getLinearIonSpectrum(theoretical_spec_linear_beta, beta, cross_link_candidate.cross_link_position.second, 2);
-        }
-
-        // Something like this can happen, e.g. with a loop link connecting the first and last residue of a peptide
-        if ( theoretical_spec_linear_alpha.empty() )
-        {
-          continue;
-        }
+          candidates_count += cross_link_candidates.size();
 
-        vector< pair< Size, Size > > matched_spec_linear_alpha;
-        vector< pair< Size, Size > > matched_spec_linear_beta;
-        vector< pair< Size, Size > > matched_spec_xlinks_alpha;
-        vector< pair< Size, Size > > matched_spec_xlinks_beta;
-
-        PeakSpectrum::IntegerDataArray exp_charges;
-        if (spectrum.getIntegerDataArrays().size() > 0)
-        {
-          exp_charges = spectrum.getIntegerDataArrays()[0];
-        }
-        OPXLSpectrumProcessingAlgorithms::getSpectrumAlignmentSimple(matched_spec_linear_alpha, fragment_mass_tolerance_, fragment_mass_tolerance_unit_ppm_, theoretical_spec_linear_alpha, spectrum, exp_charges);
-        OPXLSpectrumProcessingAlgorithms::getSpectrumAlignmentSimple(matched_spec_linear_beta, fragment_mass_tolerance_, fragment_mass_tolerance_unit_ppm_, theoretical_spec_linear_beta, spectrum, exp_charges);
-
-        // drop candidates with almost no linear fragment peak matches before making the more complex theoretical spectra and aligning them
-        // this removes hits that no one would trust after manual validation anyway and reduces time wasted on really bad spectra or candidates without any matching peaks
-        if (matched_spec_linear_alpha.size() < 2 || (type_is_cross_link && matched_spec_linear_beta.size() < 2) )
-        {
-          continue;
-        }
-        theoretical_spec_xlinks_alpha.reserve(1500);
-
-        if (type_is_cross_link)
-        {
-          theoretical_spec_xlinks_beta.reserve(1500);
-          specGen_mainscore.getXLinkIonSpectrum(theoretical_spec_xlinks_alpha, cross_link_candidate, true, 2, precursor_charge);
-          specGen_mainscore.getXLinkIonSpectrum(theoretical_spec_xlinks_beta, cross_link_candidate, false, 2, precursor_charge);
-        }
-        else
-        {
-          // Function for mono-links or loop-links
-          specGen_mainscore.getXLinkIonSpectrum(theoretical_spec_xlinks_alpha, alpha, cross_link_candidate.cross_link_position.first, precursor_mass, 1, precursor_charge, link_pos_B);
-        }
-        if (theoretical_spec_xlinks_alpha.empty())
-        {
-          continue;
-        }
-
-        OPXLSpectrumProcessingAlgorithms::getSpectrumAlignmentSimple(matched_spec_xlinks_alpha, fragment_mass_tolerance_xlinks_, fragment_mass_tolerance_unit_ppm_, theoretical_spec_xlinks_alpha, spectrum, exp_charges);
-        OPXLSpectrumProcessingAlgorithms::getSpectrumAlignmentSimple(matched_spec_xlinks_beta, fragment_mass_tolerance_xlinks_, fragment_mass_tolerance_unit_ppm_, theoretical_spec_xlinks_beta, spectrum, exp_charges);
-
-        // the maximal xlink ion charge is (precursor charge - 1) and the minimal xlink ion charge is 2.
-        // we need the difference between min and max here, which is (precursor_charge - 3) in most cases
-        // but we also need a number > 0, we set 1 as the minimum, in case the precursor charge is only 3 or smaller
-        Size n_xlink_charges = 1;
-        if (precursor_charge > 3)
-        {
-          n_xlink_charges = precursor_charge - 3;
-        }
-
-        // compute match odds (unweighted), the 3 is the number of charge states in the theoretical spectra
-        double match_odds_c_alpha = XQuestScores::matchOddsScoreSimpleSpec(theoretical_spec_linear_alpha, matched_spec_linear_alpha.size(), fragment_mass_tolerance_, fragment_mass_tolerance_unit_ppm_);
-        double match_odds_x_alpha = XQuestScores::matchOddsScoreSimpleSpec(theoretical_spec_xlinks_alpha, matched_spec_xlinks_alpha.size(), fragment_mass_tolerance_xlinks_, fragment_mass_tolerance_unit_ppm_, true, n_xlink_charges);
-        double match_odds = 0;
-        double match_odds_alpha = 0;
-        double match_odds_beta = 0;
-
-        if (type_is_cross_link)
-        {
-          double match_odds_c_beta = XQuestScores::matchOddsScoreSimpleSpec(theoretical_spec_linear_beta, matched_spec_linear_beta.size(), fragment_mass_tolerance_, fragment_mass_tolerance_unit_ppm_);
-          double match_odds_x_beta = XQuestScores::matchOddsScoreSimpleSpec(theoretical_spec_xlinks_beta, matched_spec_xlinks_beta.size(), fragment_mass_tolerance_xlinks_, fragment_mass_tolerance_unit_ppm_, true, n_xlink_charges);
-          match_odds = (match_odds_c_alpha + match_odds_x_alpha + match_odds_c_beta + match_odds_x_beta) / 4;
-          match_odds_alpha = (match_odds_c_alpha + match_odds_x_alpha) / 2;
-          match_odds_beta = (match_odds_c_beta + match_odds_x_beta) / 2;
-        }
-        else
-        {
-          match_odds = (match_odds_c_alpha + match_odds_x_alpha) / 2;
-          match_odds_alpha = match_odds;
-        }
+#pragma omp parallel for schedule(guided)
+          for (SignedSize i = 0; i < static_cast<SignedSize>(cross_link_candidates.size()); ++i)
+          {
+            OPXLDataStructs::ProteinProteinCrossLink cross_link_candidate = cross_link_candidates[i];
+
+            std::vector< SimpleTSGXLMS::SimplePeak > theoretical_spec_linear_alpha;
+            theoretical_spec_linear_alpha.reserve(1500);
+            std::vector< SimpleTSGXLMS::SimplePeak > theoretical_spec_linear_beta;
+            std::vector< SimpleTSGXLMS::SimplePeak > theoretical_spec_xlinks_alpha;
+            std::vector< SimpleTSGXLMS::SimplePeak > theoretical_spec_xlinks_beta;
+
+            bool type_is_cross_link = cross_link_candidate.getType() == OPXLDataStructs::CROSS;
+            bool type_is_loop = cross_link_candidate.getType() == OPXLDataStructs::LOOP;
+            Size link_pos_B = 0;
+            if (type_is_loop)
+            {
+              link_pos_B = cross_link_candidate.cross_link_position.second;
+            }
+            AASequence alpha;
+            AASequence beta;
+            if (cross_link_candidate.alpha) { alpha = *cross_link_candidate.alpha; }
+            if (cross_link_candidate.beta) { beta = *cross_link_candidate.beta; }
+
+            specGen_mainscore.getLinearIonSpectrum(theoretical_spec_linear_alpha, alpha, cross_link_candidate.cross_link_position.first, 2, link_pos_B);
+            if (type_is_cross_link)
+            {
+              theoretical_spec_linear_beta.reserve(1500);
+              specGen_mainscore.getLinearIonSpectrum(theoretical_spec_linear_beta, beta, cross_link_candidate.cross_link_position.second, 2);
+            }
+
+            // Something like this can happen, e.g. with a loop link connecting the first and last residue of a peptide
+            if ( theoretical_spec_linear_alpha.empty() )
+            {
+              continue;
+            }
+
+            vector< pair< Size, Size > > matched_spec_linear_alpha;
+            vector< pair< Size, Size > > matched_spec_linear_beta;
+            vector< pair< Size, Size > > matched_spec_xlinks_alpha;
+            vector< pair< Size, Size > > matched_spec_xlinks_beta;
+
+            PeakSpectrum::IntegerDataArray exp_charges;
+            if (spectrum.getIntegerDataArrays().size() > 0)
+            {
+              exp_charges = spectrum.getIntegerDataArrays()[0];
+            }
+            OPXLSpectrumProcessingAlgorithms::getSpectrumAlignmentSimple(matched_spec_linear_alpha, fragment_mass_tolerance_, fragment_mass_tolerance_unit_ppm_, theoretical_spec_linear_alpha, spectrum, exp_charges);
+            OPXLSpectrumProcessingAlgorithms::getSpectrumAlignmentSimple(matched_spec_linear_beta, fragment_mass_tolerance_, fragment_mass_tolerance_unit_ppm_, theoretical_spec_linear_beta, spectrum, exp_charges);
+
+            // drop candidates with almost no linear fragment peak matches before making the more complex theoretical spectra and aligning them
+            // this removes hits that no one would trust after manual validation anyway and reduces time wasted on really bad spectra or candidates without any matching peaks
+            if (matched_spec_linear_alpha.size() < 2 || (type_is_cross_link && matched_spec_linear_beta.size() < 2) )
+            {
+              continue;
+            }
+            theoretical_spec_xlinks_alpha.reserve(1500);
+
+            if (type_is_cross_link)
+            {
+              theoretical_spec_xlinks_beta.reserve(1500);
+              specGen_mainscore.getXLinkIonSpectrum(theoretical_spec_xlinks_alpha, cross_link_candidate, true, 2, precursor_charge);
+              specGen_mainscore.getXLinkIonSpectrum(theoretical_spec_xlinks_beta, cross_link_candidate, false, 2, precursor_charge);
+            }
+            else
+            {
+              // Function for mono-links or loop-links
+              specGen_mainscore.getXLinkIonSpectrum(theoretical_spec_xlinks_alpha, alpha, cross_link_candidate.cross_link_position.first, precursor_mass, 1, precursor_charge, link_pos_B);
+            }
+            if (theoretical_spec_xlinks_alpha.empty())
+            {
+              continue;
+            }
+
+            OPXLSpectrumProcessingAlgorithms::getSpectrumAlignmentSimple(matched_spec_xlinks_alpha, fragment_mass_tolerance_xlinks_, fragment_mass_tolerance_unit_ppm_, theoretical_spec_xlinks_alpha, spectrum, exp_charges);
+            OPXLSpectrumProcessingAlgorithms::getSpectrumAlignmentSimple(matched_spec_xlinks_beta, fragment_mass_tolerance_xlinks_, fragment_mass_tolerance_unit_ppm_, theoretical_spec_xlinks_beta, spectrum, exp_charges);
+
+            // the maximal xlink ion charge is (precursor charge - 1) and the minimal xlink ion charge is 2.
+            // we need the difference between min and max here, which is (precursor_charge - 3) in most cases
+            // but we also need a number > 0, we set 1 as the minimum, in case the precursor charge is only 3 or smaller
+            Size n_xlink_charges = 1;
+            if (precursor_charge > 3)
+            {
+              n_xlink_charges = precursor_charge - 3;
+            }
+
+            // compute match odds (unweighted), the 3 is the number of charge states in the theoretical spectra
+            double match_odds_c_alpha = XQuestScores::matchOddsScoreSimpleSpec(theoretical_spec_linear_alpha, matched_spec_linear_alpha.size(), fragment_mass_tolerance_, fragment_mass_tolerance_unit_ppm_);
+            double match_odds_x_alpha = XQuestScores::matchOddsScoreSimpleSpec(theoretical_spec_xlinks_alpha, matched_spec_xlinks_alpha.size(), fragment_mass_tolerance_xlinks_, fragment_mass_tolerance_unit_ppm_, true, n_xlink_charges);
+            double match_odds = 0;
+            double match_odds_alpha = 0;
+            double match_odds_beta = 0;
+
+            if (type_is_cross_link)
+            {
+              double match_odds_c_beta = XQuestScores::matchOddsScoreSimpleSpec(theoretical_spec_linear_beta, matched_spec_linear_beta.size(), fragment_mass_tolerance_, fragment_mass_tolerance_unit_ppm_);
+              double match_odds_x_beta = XQuestScores::matchOddsScoreSimpleSpec(theoretical_spec_xlinks_beta, matched_spec_xlinks_beta.size(), fragment_mass_tolerance_xlinks_, fragment_mass_tolerance_unit_ppm_, true, n_xlink_charges);
+              match_odds = (match_odds_c_alpha + match_odds_x_alpha + match_odds_c_beta + match_odds_x_beta) / 4;
+              match_odds_alpha = (match_odds_c_alpha + match_odds_x_alpha) / 2;
+              match_odds_beta = (match_odds_c_beta + match_odds_x_beta) / 2;
+            }
+            else
+            {
+              match_odds = (match_odds_c_alpha + match_odds_x_alpha) / 2;
+              match_odds_alpha = match_odds;
+            }
+
+            OPXLDataStructs::CrossLinkSpectrumMatch csm;
+            csm.cross_link = cross_link_candidate;
+            csm.precursor_correction = cross_link_candidate.precursor_correction;
+            double rel_error = OPXLHelper::computePrecursorError(csm, precursor_mz, precursor_charge);
+
+            double new_match_odds_weight = 0.2;
+            double new_rel_error_weight = -0.03;
+            double new_score = new_match_odds_weight * std::log(1e-7 + match_odds) + new_rel_error_weight * abs(rel_error);
+
+            csm.score = new_score;
+            csm.match_odds = match_odds;
+            csm.match_odds_alpha = match_odds_alpha;
+            csm.match_odds_beta = match_odds_beta;
+            csm.precursor_error_ppm = rel_error;
 
-        OPXLDataStructs::CrossLinkSpectrumMatch csm;
-        csm.cross_link = cross_link_candidate;
-        csm.precursor_correction = cross_link_candidate.precursor_correction;
-        double rel_error = OPXLHelper::computePrecursorError(csm, precursor_mz, precursor_charge);
+#pragma omp critical (mainscore_csms_spectrum_access)
+            mainscore_csms_spectrum.push_back(csm);
 
-        double new_match_odds_weight = 0.2;
-        double new_rel_error_weight = -0.03;
-        double new_score = new_match_odds_weight * std::log(1e-7 + match_odds) + new_rel_error_weight * abs(rel_error);
+          }
 
-        csm.score = new_score;
-        csm.match_odds = match_odds;
-        csm.match_odds_alpha = match_odds_alpha;
-        csm.match_odds_beta = match_odds_beta;
-        csm.precursor_error_ppm = rel_error;
+          if (mainscore_csms_spectrum.size() > static_cast<Size>(number_top_hits_))
+          {
+            std::sort(mainscore_csms_spectrum.rbegin(), mainscore_csms_spectrum.rend(), OPXLDataStructs::CLSMScoreComparator());
+            mainscore_csms_spectrum.resize(number_top_hits_);
+          }
+        });
 
-#pragma omp critical (mainscore_csms_spectrum_access)
-        mainscore_csms_spectrum.push_back(csm);
+      all_candidates_count += candidates_count;
+      cout << "Number of peaks: " << spectrum.size() << " |\tNumber of candidates: " << candidates_count << endl;
 
+      if (candidates_count == 0)
+      {
+        continue;
       }
+
       std::sort(mainscore_csms_spectrum.rbegin(), mainscore_csms_spectrum.rend(), OPXLDataStructs::CLSMScoreComparator());
 
       int last_candidate_index = static_cast<int>(mainscore_csms_spectrum.size());
@@ -0,0 +1,310 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CHEMISTRY/CompactAASequence.h>
+
+#include <OpenMS/CHEMISTRY/ResidueDB.h>
+#include <OpenMS/CONCEPT/Constants.h>
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/CONCEPT/LogStream.h>
+
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+
+namespace OpenMS
+{
+  namespace
+  {
+    /// process-wide table of interned residues (ID = position in residues)
+    struct ResidueRegistry
+    {
+      std::vector<const Residue*> residues;
+      std::unordered_map<const Residue*, CompactAASequence::ResidueID> ids;
+    };
+
+    /// immutable snapshot of the registry, read lock-free and replaced under a critical section
+    std::shared_ptr<const ResidueRegistry>& residueRegistry()
+    {
+      static std::shared_ptr<const ResidueRegistry> registry(new ResidueRegistry());
+      return registry;
+    }
+
+    void hashCombine(std::size_t& seed, std::size_t value)
+    {
+      seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+  }
+
+  CompactAASequence::CompactAASequence() :
+    prefix_masses_(1, 0.0),
+    n_term_mod_(nullptr),
+    c_term_mod_(nullptr),
+    first_unknown_(0),
+    last_unknown_(0),
+    hash_(0)
+  {
+  }
+
+  CompactAASequence::CompactAASequence(const AASequence& seq) :
+    CompactAASequence()
+  {
+    assign(seq);
+  }
+
+  void CompactAASequence::assign(const AASequence& seq)
+  {
+    static const Residue* const unknown = ResidueDB::getInstance()->getResidue("X");
+
+    n_term_mod_ = seq.getNTerminalModification();
+    c_term_mod_ = seq.getCTerminalModification();
+    first_unknown_ = seq.size();
+    last_unknown_ = seq.size();
+    hash_ = 0;
+
+    residues_.clear();
+    residues_.reserve(seq.size());
+    prefix_masses_.clear();
+    prefix_masses_.reserve(seq.size() + 1);
+    prefix_masses_.push_back(0.0);
+    hashCombine(hash_, std::hash<const void*>()(n_term_mod_));
+    for (Size i = 0; i < seq.size(); ++i)
+    {
+      const Residue* r = &seq[i];
+      if (r == unknown)
+      {
+        if (first_unknown_ == seq.size()) first_unknown_ = i;
+        last_unknown_ = i;
+      }
+      const ResidueID id = getResidueID(r);
+      residues_.push_back(id);
+      prefix_masses_.push_back(prefix_masses_.back() + r->getMonoWeight(Residue::Internal));
+      hashCombine(hash_, std::hash<ResidueID>()(id));
+    }
+    hashCombine(hash_, std::hash<const void*>()(c_term_mod_));
+  }
+
+  AASequence CompactAASequence::toAASequence() const
+  {
+    AASequence seq;
+    for (ResidueID id : residues_)
+    {
+      seq += getResidueByID(id);
+    }
+    seq.setNTerminalModification(n_term_mod_);
+    seq.setCTerminalModification(c_term_mod_);
+    return seq;
+  }
+
+  Size CompactAASequence::size() const
+  {
+    return residues_.size();
+  }
+
+  bool CompactAASequence::empty() const
+  {
+    return residues_.empty();
+  }
+
+  const std::vector<CompactAASequence::ResidueID>& CompactAASequence::getResidueIDs() const
+  {
+    return residues_;
+  }
+
+  const Residue& CompactAASequence::getResidue(Size index) const
+  {
+    if (index >= residues_.size())
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, index, residues_.size());
+    }
+    return *getResidueByID(residues_[index]);
+  }
+
+  const ResidueModification* CompactAASequence::getNTerminalModification() const
+  {
+    return n_term_mod_;
+  }
+
+  const ResidueModification* CompactAASequence::getCTerminalModification() const
+  {
+    return c_term_mod_;
+  }
+
+  std::size_t CompactAASequence::getHash() const
+  {
+    return hash_;
+  }
+
+  const std::vector<double>& CompactAASequence::getPrefixMasses() const
+  {
+    return prefix_masses_;
+  }
+
+  double CompactAASequence::getMonoWeight(Residue::ResidueType type, Int charge) const
+  {
+    if (residues_.empty())
+    {
+      OPENMS_LOG_ERROR << "CompactAASequence::getMonoWeight: Mass for ResidueType " << type << " not defined for sequences of length 0." << std::endl;
+      return 0.0;
+    }
+    return getMonoWeight_(0, residues_.size(), true, true, type, charge);
+  }
+
+  double CompactAASequence::getPrefixMonoWeight(Size length, Residue::ResidueType type, Int charge) const
+  {
+    if (length > residues_.size())
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, length, residues_.size());
+    }
+    // as in AASequence::getPrefix, the C-terminal modification is only kept for the full sequence
+    return getMonoWeight_(0, length, true, length == residues_.size(), type, charge);
+  }
+
+  double CompactAASequence::getSuffixMonoWeight(Size length, Residue::ResidueType type, Int charge) const
+  {
+    if (length > residues_.size())
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, length, residues_.size());
+    }
+    // as in AASequence::getSuffix, the N-terminal modification is only kept for the full sequence
+    return getMonoWeight_(residues_.size() - length, residues_.size(), length == residues_.size(), true, type, charge);
+  }
+
+  double CompactAASequence::getMonoWeight_(Size begin, Size end, bool n_term, bool c_term, Residue::ResidueType type, Int charge) const
+  {
+    if (begin == end) return 0.0;
+
+    // exact for prefixes and suffixes, which are the only ranges queried
+    if (first_unknown_ < end && last_unknown_ >= begin && first_unknown_ != residues_.size())
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Cannot get weight of sequence with unknown AA 'X' with unknown mass.", toAASequence().toString());
+    }
+
+    // offsets from internal residues to the given residue type (indexed by Residue::ResidueType)
+    static const double internal_to[] =
+    {
+      Residue::getInternalToFull().getMonoWeight(),
+      0.0,
+      Residue::getInternalToNTerm().getMonoWeight(),
+      Residue::getInternalToCTerm().getMonoWeight(),
+      Residue::getInternalToAIon().getMonoWeight(),
+      Residue::getInternalToBIon().getMonoWeight(),
+      Residue::getInternalToCIon().getMonoWeight(),
+      Residue::getInternalToXIon().getMonoWeight(),
+      Residue::getInternalToYIon().getMonoWeight(),
+      Residue::getInternalToZIon().getMonoWeight()
+    };
+
+    double mono_weight(Constants::PROTON_MASS_U * charge + prefix_masses_[end] - prefix_masses_[begin]);
+
+    // terminal modifications
+    if (n_term && n_term_mod_ != nullptr &&
+        (type == Residue::Full || type == Residue::AIon ||
+         type == Residue::BIon || type == Residue::CIon ||
+         type == Residue::NTerminal))
+    {
+      mono_weight += n_term_mod_->getDiffMonoMass();
+    }
+
+    if (c_term && c_term_mod_ != nullptr &&
+        (type == Residue::Full || type == Residue::XIon ||
+         type == Residue::YIon || type == Residue::ZIon ||
+         type == Residue::CTerminal))
+    {
+      mono_weight += c_term_mod_->getDiffMonoMass();
+    }
+
+    if (type > Residue::ZIon)
+    {
+      OPENMS_LOG_ERROR << "CompactAASequence::getMonoWeight: unknown ResidueType" << std::endl;
+      return mono_weight;
+    }
+    return mono_weight + internal_to[type];
+  }
+
+  bool CompactAASequence::operator==(const CompactAASequence& rhs) const
+  {
+    return hash_ == rhs.hash_ &&
+           n_term_mod_ == rhs.n_term_mod_ &&
+           c_term_mod_ == rhs.c_term_mod_ &&
+           residues_ == rhs.residues_;
+  }
+
+  bool CompactAASequence::operator!=(const CompactAASequence& rhs) const
+  {
+    return !(*this == rhs);
+  }
+
+  CompactAASequence::ResidueID CompactAASequence::getResidueID(const Residue* residue)
+  {
+    std::shared_ptr<const ResidueRegistry>& registry = residueRegistry();
+    {
+      const std::shared_ptr<const ResidueRegistry> snapshot = std::atomic_load(&registry);
+      auto it = snapshot->ids.find(residue);
+      if (it != snapshot->ids.end()) return it->second;
+    }
+
+    ResidueID id;
+    #pragma omp critical (CompactAASequence_registry)
+    {
+      // re-check: another thread may have added the residue in the meantime
+      const std::shared_ptr<const ResidueRegistry> current = std::atomic_load(&registry);
+      auto it = current->ids.find(residue);
+      if (it != current->ids.end())
+      {
+        id = it->second;
+      }
+      else
+      {
+        std::shared_ptr<ResidueRegistry> updated(new ResidueRegistry(*current));
+        id = ResidueID(updated->residues.size());
+        updated->residues.push_back(residue);
+        updated->ids[residue] = id;
+        std::atomic_store(&registry, std::shared_ptr<const ResidueRegistry>(updated));
+      }
+    }
+    return id;
+  }
+
+  const Residue* CompactAASequence::getResidueByID(ResidueID id)
+  {
+    const std::shared_ptr<const ResidueRegistry> snapshot = std::atomic_load(&residueRegistry());
+    if (id >= snapshot->residues.size())
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, id, snapshot->residues.size());
+    }
+    return snapshot->residues[id];
+  }
+
+} // namespace OpenMS
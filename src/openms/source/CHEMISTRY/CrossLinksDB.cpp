@@ -356,13 +356,15 @@ namespace OpenMS
         }
       }
     }
+    publishSnapshot_();
   }
 
   void CrossLinksDB::getAllSearchModifications(vector<String>& modifications) const
   {
     modifications.clear();
 
-    for (vector<ResidueModification*>::const_iterator it = mods_.begin(); it != mods_.end(); ++it)
+    const std::shared_ptr<const Snapshot_> snapshot = getSnapshot_();
+    for (vector<const ResidueModification*>::const_iterator it = snapshot->mods.begin(); it != snapshot->mods.end(); ++it)
     {
       if ((*it)->getPSIMODAccession() != "")
       {
@@ -63,7 +63,7 @@ namespace OpenMS
 
   EmpiricalFormula::EmpiricalFormula(SignedSize number, const Element* element, SignedSize charge)
   {
-    formula_[element] = number;
+    formula_.emplace_back(element, number);
     charge_ = charge;
   }
 
@@ -128,7 +128,7 @@ namespace OpenMS
     // without requesting a negative number of hydrogens.
     bool ret = estimateFromWeightAndComp(remaining_weight, C, H, N, O, 0.0, P);
 
-    formula_.at(db->getElement("S")) = S;
+    add_(formula_, db->getElement("S"), S);
 
     return ret;
   }
@@ -148,11 +148,11 @@ namespace OpenMS
 
     formula_.clear();
 
-    formula_.insert(make_pair(db->getElement("C"), (SignedSize) Math::round(C * factor)));
-    formula_.insert(make_pair(db->getElement("N"), (SignedSize) Math::round(N * factor)));
-    formula_.insert(make_pair(db->getElement("O"), (SignedSize) Math::round(O * factor)));
-    formula_.insert(make_pair(db->getElement("S"), (SignedSize) Math::round(S * factor)));
-    formula_.insert(make_pair(db->getElement("P"), (SignedSize) Math::round(P * factor)));
+    add_(formula_, db->getElement("C"), (SignedSize) Math::round(C * factor));
+    add_(formula_, db->getElement("N"), (SignedSize) Math::round(N * factor));
+    add_(formula_, db->getElement("O"), (SignedSize) Math::round(O * factor));
+    add_(formula_, db->getElement("S"), (SignedSize) Math::round(S * factor));
+    add_(formula_, db->getElement("P"), (SignedSize) Math::round(P * factor));
 
     double remaining_mass = average_weight-getAverageWeight();
     SignedSize adjusted_H = Math::round(remaining_mass / db->getElement("H")->getAverageWeight());
@@ -165,7 +165,7 @@ namespace OpenMS
     }
 
     // Only insert hydrogens if their number is not negative.
-    formula_.insert(make_pair(db->getElement("H"), adjusted_H));
+    add_(formula_, db->getElement("H"), adjusted_H);
     // The approximation had no issues.
     return true;
   }
@@ -198,7 +198,7 @@ namespace OpenMS
 
   SignedSize EmpiricalFormula::getNumberOf(const Element* element) const
   {
-    const auto& it  = formula_.find(element);
+    const auto& it  = find_(formula_, element);
     if (it != formula_.end())
     {
       return it->second;
@@ -254,7 +254,7 @@ namespace OpenMS
   EmpiricalFormula EmpiricalFormula::operator*(const SignedSize& times) const
   {
     EmpiricalFormula ef(*this);
-    for (const auto& it : formula_) ef.formula_[it.first] *= times;
+    for (auto& it : ef.formula_) it.second *= times;
     ef.charge_ *= times;
     ef.removeZeroedElements_();
     return ef;
@@ -266,15 +266,7 @@ namespace OpenMS
     ef.formula_ = formula.formula_;
     for (const auto& it : formula_)
     {
-      auto ef_it  = ef.formula_.find(it.first);
-      if (ef_it != ef.formula_.end())
-      {
-        ef_it->second += it.second;
-      }
-      else
-      {
-        ef.formula_.insert(it);
-      }
+      add_(ef.formula_, it.first, it.second);
     }
     ef.charge_ = charge_ + formula.charge_;
     ef.removeZeroedElements_();
@@ -285,15 +277,7 @@ namespace OpenMS
   {
     for (const auto& it : formula.formula_)
     {
-      auto f_it  = formula_.find(it.first);
-      if (f_it != formula_.end())
-      {
-        f_it->second += it.second;
-      }
-      else
-      {
-        formula_.insert(it);
-      }
+      add_(formula_, it.first, it.second);
     }
     charge_ += formula.charge_;
     removeZeroedElements_();
@@ -305,17 +289,7 @@ namespace OpenMS
     EmpiricalFormula ef(*this);
     for (const auto& it : formula.formula_)
     {
-      const Element* e = it.first;
-      SignedSize num = it.second;
-      auto ef_it  = ef.formula_.find(e);
-      if (ef_it != ef.formula_.end())
-      {
-        ef_it->second -= num;
-      }
-      else
-      {
-        ef.formula_[e] = -num;
-      }
+      add_(ef.formula_, it.first, -it.second);
     }
 
     ef.charge_ = charge_ - formula.charge_;
@@ -327,15 +301,7 @@ namespace OpenMS
   {
     for (const auto& it : formula.formula_)
     {
-      auto f_it  = formula_.find(it.first);
-      if (f_it != formula_.end())
-      {
-        f_it->second -= it.second;
-      }
-      else
-      {
-        formula_[it.first] = -it.second;
-      }
+      add_(formula_, it.first, -it.second);
     }
     charge_ -= formula.charge_;
     removeZeroedElements_();
@@ -354,7 +320,7 @@ namespace OpenMS
 
   bool EmpiricalFormula::hasElement(const Element* element) const
   {
-    return formula_.find(element) != formula_.end();
+    return find_(formula_, element) != formula_.end();
   }
 
   bool EmpiricalFormula::contains(const EmpiricalFormula& ef)
@@ -422,7 +388,7 @@ namespace OpenMS
     return os;
   }
 
-  Int EmpiricalFormula::parseFormula_(std::map<const Element*, SignedSize>& ef, const String& input_formula) const
+  Int EmpiricalFormula::parseFormula_(MapType_& ef, const String& input_formula) const
   {
     Int charge = 0;
     String formula(input_formula);
@@ -585,16 +551,7 @@ namespace OpenMS
       {
         if (num != 0)
         {
-          const Element* e = db->getElement(symbol);
-          std::map<const Element*, SignedSize>::iterator it = ef.find(e);
-          if (it != ef.end())
-          {
-            it->second += num;
-          }
-          else
-          {
-            ef.insert(std::make_pair(e, num));
-          }
+          add_(ef, db->getElement(symbol), num);
         }
       }
       else
@@ -604,35 +561,39 @@ namespace OpenMS
     }
 
     // remove elements with 0 counts
-    std::map<const Element*, SignedSize>::iterator it = ef.begin();
-    while (it != ef.end())
-    {
-      if (it->second == 0)
-      {
-        ef.erase(it++);   // Note: post increment needed! Otherwise iterator is invalidated
-      }
-      else
-      {
-        ++it;
-      }
-    }
+    ef.erase(std::remove_if(ef.begin(), ef.end(), [](const MapType_::value_type& e) { return e.second == 0; }), ef.end());
 
     return charge;
   }
 
   void EmpiricalFormula::removeZeroedElements_()
   {
-    MapType_::iterator it = formula_.begin();
-    while (it != formula_.end())
+    formula_.erase(std::remove_if(formula_.begin(), formula_.end(), [](const MapType_::value_type& e) { return e.second == 0; }), formula_.end());
+  }
+
+  EmpiricalFormula::MapType_::const_iterator EmpiricalFormula::find_(const MapType_& ef, const Element* element)
+  {
+    // few elements: a linear scan beats binary search here
+    for (auto it = ef.begin(); it != ef.end(); ++it)
     {
-      if (it->second == 0)
-      {
-        formula_.erase(it++);   // Note: post increment needed! Otherwise iterator is invalidated
-      }
-      else
-      {
-        ++it;
-      }
+      if (it->first == element) return it;
+      if (std::less<const Element*>()(element, it->first)) break;
+    }
+    return ef.end();
+  }
+
+  void EmpiricalFormula::add_(MapType_& ef, const Element* element, SignedSize number)
+  {
+    // keep the entries sorted by element
+    auto it = ef.begin();
+    while (it != ef.end() && std::less<const Element*>()(it->first, element)) ++it;
+    if (it != ef.end() && it->first == element)
+    {
+      it->second += number;
+    }
+    else
+    {
+      ef.emplace(it, element, number);
     }
   }
 
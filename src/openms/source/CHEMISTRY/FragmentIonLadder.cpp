@@ -0,0 +1,75 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CHEMISTRY/FragmentIonLadder.h>
+
+#include <algorithm>
+
+namespace OpenMS
+{
+
+  void FragmentIonLadder::clear()
+  {
+    mz.clear();
+    ion_type.clear();
+    ion_number.clear();
+    charge.clear();
+  }
+
+  void FragmentIonLadder::reserve_(Size n)
+  {
+    mz.reserve(n);
+    ion_type.reserve(n);
+    ion_number.reserve(n);
+    charge.reserve(n);
+  }
+
+  void FragmentIonLadder::sortIfUnsorted_()
+  {
+    if (std::is_sorted(mz.begin(), mz.end())) return;
+
+    // insertion sort keeps the arrays in sync without extra storage (and is stable)
+    for (Size i = 1; i < mz.size(); ++i)
+    {
+      for (Size j = i; j > 0 && mz[j] < mz[j - 1]; --j)
+      {
+        std::swap(mz[j], mz[j - 1]);
+        std::swap(ion_type[j], ion_type[j - 1]);
+        std::swap(ion_number[j], ion_number[j - 1]);
+        std::swap(charge[j], charge[j - 1]);
+      }
+    }
+  }
+
+} // namespace OpenMS
@@ -111,6 +111,7 @@ namespace OpenMS
     {
       readFromOBOFile(xlmod_file);
     }
+    publishSnapshot_();
     is_instantiated_ = true;
   }
 
@@ -128,14 +129,63 @@ namespace OpenMS
     return is_instantiated_;
   }
 
-  Size ModificationsDB::getNumberOfModifications() const
+  std::shared_ptr<const ModificationsDB::Snapshot_> ModificationsDB::getSnapshot_() const
+  {
+    return std::atomic_load(&snapshot_);
+  }
+
+  Size ModificationsDB::Snapshot_::shardOf(const String& name)
+  {
+    return std::hash<String>()(name) % NAME_SHARDS;
+  }
+
+  const std::set<const ResidueModification*>* ModificationsDB::Snapshot_::find(const String& name) const
+  {
+    const NameShard_& shard = *name_shards[shardOf(name)];
+    auto it = shard.find(name);
+    return it == shard.end() ? nullptr : &it->second;
+  }
+
+  void ModificationsDB::publishSnapshot_(const ResidueModification* new_mod, const std::vector<String>& changed_names)
   {
-    Size s;
-    #pragma omp critical (OpenMS_ModificationsDB)
+    std::shared_ptr<const Snapshot_> old_snapshot = getSnapshot_();
+    std::shared_ptr<Snapshot_> snapshot(new Snapshot_);
+
+    if (new_mod != nullptr && old_snapshot && old_snapshot->mods.size() + 1 == mods_.size())
+    {
+      // a single modification was added: copy only the shards of its names
+      snapshot->mods = old_snapshot->mods;
+      snapshot->mods.push_back(new_mod);
+      snapshot->name_shards = old_snapshot->name_shards;
+      std::vector<std::shared_ptr<NameShard_> > copied(Snapshot_::NAME_SHARDS);
+      for (const String& name : changed_names)
+      {
+        Size shard_idx = Snapshot_::shardOf(name);
+        if (!copied[shard_idx])
+        {
+          copied[shard_idx].reset(new NameShard_(*snapshot->name_shards[shard_idx]));
+          snapshot->name_shards[shard_idx] = copied[shard_idx];
+        }
+        (*copied[shard_idx])[name] = modification_names_[name];
+      }
+    }
+    else
     {
-      s = mods_.size();
+      snapshot->mods.assign(mods_.begin(), mods_.end());
+      std::vector<std::shared_ptr<NameShard_> > shards(Snapshot_::NAME_SHARDS);
+      for (auto& shard : shards) shard.reset(new NameShard_);
+      for (const auto& entry : modification_names_)
+      {
+        shards[Snapshot_::shardOf(entry.first)]->insert(entry);
+      }
+      snapshot->name_shards.assign(shards.begin(), shards.end());
     }
-    return s;
+    std::atomic_store(&snapshot_, std::shared_ptr<const Snapshot_>(std::move(snapshot)));
+  }
+
+  Size ModificationsDB::getNumberOfModifications() const
+  {
+    return getSnapshot_()->mods.size();
   }
 
   const ResidueModification* ModificationsDB::searchModificationsFast(const String& mod_name_,
@@ -152,49 +202,46 @@ namespace OpenMS
     char res = '?'; // empty
     if (!residue.empty()) res = residue[0];
 
-    #pragma omp critical(OpenMS_ModificationsDB)
+    const std::shared_ptr<const Snapshot_> snapshot = getSnapshot_();
+    const std::set<const ResidueModification*>* modifications = snapshot->find(mod_name);
+    if (modifications == nullptr)
     {
-      bool found = true;
-      auto modifications = modification_names_.find(mod_name);
-      if (modifications == modification_names_.end())
+      // Try to fix things, Skyline for example uses unimod:10 and not UniMod:10 syntax
+      if (mod_name.size() > 6 && mod_name.prefix(6).toLower() == "unimod")
       {
-        // Try to fix things, Skyline for example uses unimod:10 and not UniMod:10 syntax
-        if (mod_name.size() > 6 && mod_name.prefix(6).toLower() == "unimod")
-        {
-          mod_name = "UniMod" + mod_name.substr(6, mod_name.size() - 6);
-        }
+        mod_name = "UniMod" + mod_name.substr(6, mod_name.size() - 6);
+      }
 
-        modifications = modification_names_.find(mod_name);
-        if (modifications == modification_names_.end())
-        {
-          OPENMS_LOG_WARN << OPENMS_PRETTY_FUNCTION << "Modification not found: " << mod_name << endl;
-          found = false; 
-        }
+      modifications = snapshot->find(mod_name);
+      if (modifications == nullptr)
+      {
+        OPENMS_LOG_WARN << OPENMS_PRETTY_FUNCTION << "Modification not found: " << mod_name << endl;
       }
+    }
 
-      int nr_mods = 0;
-      if (found)
+    int nr_mods = 0;
+    if (modifications != nullptr)
+    {
+      for (const auto& it : *modifications)
       {
-        for (const auto& it : modifications->second)
+        if ( residuesMatch_(res, it) &&
+             (term_spec == ResidueModification::NUMBER_OF_TERM_SPECIFICITY ||
+             (term_spec == it->getTermSpecificity())))
         {
-          if ( residuesMatch_(res, it) &&
-               (term_spec == ResidueModification::NUMBER_OF_TERM_SPECIFICITY ||
-               (term_spec == it->getTermSpecificity())))
-          {
-            mod = it;
-            nr_mods++;
-          }
+          mod = it;
+          nr_mods++;
         }
       }
-      if (nr_mods > 1) multiple_matches = true;
     }
+    if (nr_mods > 1) multiple_matches = true;
     return mod;
   }
 
   const ResidueModification* ModificationsDB::getModification(Size index) const
   {
-    OPENMS_PRECONDITION(index < mods_.size(), "Index out of bounds in ModificationsDB::getModification(Size index)." );
-    return mods_[index];
+    const std::shared_ptr<const Snapshot_> snapshot = getSnapshot_();
+    OPENMS_PRECONDITION(index < snapshot->mods.size(), "Index out of bounds in ModificationsDB::getModification(Size index)." );
+    return snapshot->mods[index];
   }
 
   void ModificationsDB::searchModifications(set<const ResidueModification*>& mods,
@@ -209,39 +256,35 @@ namespace OpenMS
     char res = '?'; // empty
     if (!residue.empty()) res = residue[0];
 
-    #pragma omp critical(OpenMS_ModificationsDB)
+    const std::shared_ptr<const Snapshot_> snapshot = getSnapshot_();
+    const std::set<const ResidueModification*>* modifications = snapshot->find(mod_name);
+    if (modifications == nullptr)
     {
-      bool found = true;
-      auto modifications = modification_names_.find(mod_name);
-      if (modifications == modification_names_.end())
+      // Try to fix things, Skyline for example uses unimod:10 and not UniMod:10 syntax
+      if (mod_name.size() > 6 && mod_name.prefix(6).toLower() == "unimod")
       {
-        // Try to fix things, Skyline for example uses unimod:10 and not UniMod:10 syntax
-        if (mod_name.size() > 6 && mod_name.prefix(6).toLower() == "unimod")
-        {
-          mod_name = "UniMod" + mod_name.substr(6, mod_name.size() - 6);
-        }
+        mod_name = "UniMod" + mod_name.substr(6, mod_name.size() - 6);
+      }
 
-        modifications = modification_names_.find(mod_name);
-        if (modifications == modification_names_.end())
-        {
-          OPENMS_LOG_WARN << OPENMS_PRETTY_FUNCTION << "Modification not found: " << mod_name << endl;
-          found = false; 
-        }
+      modifications = snapshot->find(mod_name);
+      if (modifications == nullptr)
+      {
+        OPENMS_LOG_WARN << OPENMS_PRETTY_FUNCTION << "Modification not found: " << mod_name << endl;
       }
+    }
 
-      if (found)
+    if (modifications != nullptr)
+    {
+      for (const auto& it : *modifications)
       {
-        for (const auto& it : modifications->second)
+        if ( residuesMatch_(res, it) &&
+             (term_spec == ResidueModification::NUMBER_OF_TERM_SPECIFICITY ||
+             (term_spec == it->getTermSpecificity())))
         {
-          if ( residuesMatch_(res, it) &&
-               (term_spec == ResidueModification::NUMBER_OF_TERM_SPECIFICITY ||
-               (term_spec == it->getTermSpecificity())))
-          {
-            mods.insert(it);
-          }
+          mods.insert(it);
         }
       }
-    } 
+    }
   }
 
   const ResidueModification* ModificationsDB::getModification(const String& mod_name, const String& residue, ResidueModification::TermSpecificity term_spec) const
@@ -278,45 +321,31 @@ namespace OpenMS
 
   bool ModificationsDB::has(const String & modification) const
   {
-    bool has_mod;
-    #pragma omp critical(OpenMS_ModificationsDB)
-    {
-      has_mod = (modification_names_.find(modification) != modification_names_.end());
-    }
-    return has_mod;
+    return getSnapshot_()->find(modification) != nullptr;
   }
 
   Size ModificationsDB::findModificationIndex(const String & mod_name) const
   {
-    if (!has(mod_name))
+    const std::shared_ptr<const Snapshot_> snapshot = getSnapshot_();
+    const std::set<const ResidueModification*>* modifications = snapshot->find(mod_name);
+    if (modifications == nullptr)
     {
       throw Exception::ElementNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Modification not found: " + mod_name);
     }
 
-    bool one_mod(true);
-    #pragma omp critical(OpenMS_ModificationsDB)
-    {
-      if (modification_names_.find(mod_name)->second.size() > 1)
-      {
-        one_mod = false;
-      }
-    }
-    if (!one_mod) 
+    if (modifications->size() > 1)
     {
       throw Exception::ElementNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "More than one modification with name: " + mod_name);
     }
 
     Size index(numeric_limits<Size>::max());
-    #pragma omp critical(OpenMS_ModificationsDB)
+    const ResidueModification* mod = *(modifications->begin());
+    for (Size i = 0; i != snapshot->mods.size(); ++i)
     {
-      const ResidueModification* mod = *(modification_names_.find(mod_name)->second.begin());
-      for (Size i = 0; i != mods_.size(); ++i)
+      if (snapshot->mods[i] == mod)
       {
-        if (mods_[i] == mod)
-        {
-          index = i;
-          break;
-        }
+        index = i;
+        break;
       }
     }
 
@@ -332,17 +361,15 @@ namespace OpenMS
     mods.clear();
     char res = '?'; // empty
     if (!residue.empty()) res = residue[0];
-    #pragma omp critical(OpenMS_ModificationsDB)
+    const std::shared_ptr<const Snapshot_> snapshot = getSnapshot_();
+    for (auto const & m : snapshot->mods)
     {
-      for (auto const & m : mods_)
+      if ((fabs(m->getDiffMonoMass() - mass) <= max_error) &&
+          residuesMatch_(res, m) &&
+          ((term_spec == ResidueModification::NUMBER_OF_TERM_SPECIFICITY) ||
+           (term_spec == m->getTermSpecificity())))
       {
-        if ((fabs(m->getDiffMonoMass() - mass) <= max_error) &&
-            residuesMatch_(res, m) &&
-            ((term_spec == ResidueModification::NUMBER_OF_TERM_SPECIFICITY) ||
-             (term_spec == m->getTermSpecificity())))
-        {
-          mods.push_back(m->getFullId());
-        }
+        mods.push_back(m->getFullId());
       }
     }
   }
@@ -352,17 +379,15 @@ namespace OpenMS
     mods.clear();
     char res = '?'; // empty
     if (!residue.empty()) res = residue[0];
-    #pragma omp critical(OpenMS_ModificationsDB)
+    const std::shared_ptr<const Snapshot_> snapshot = getSnapshot_();
+    for (auto const & m : snapshot->mods)
     {
-      for (auto const & m : mods_)
+      if ((fabs(m->getDiffMonoMass() - mass) <= max_error) &&
+          residuesMatch_(res, m) &&
+          ((term_spec == ResidueModification::NUMBER_OF_TERM_SPECIFICITY) ||
+           (term_spec == m->getTermSpecificity())))
       {
-        if ((fabs(m->getDiffMonoMass() - mass) <= max_error) &&
-            residuesMatch_(res, m) &&
-            ((term_spec == ResidueModification::NUMBER_OF_TERM_SPECIFICITY) ||
-             (term_spec == m->getTermSpecificity())))
-        {
-          mods.push_back(m);
-        }
+        mods.push_back(m);
       }
     }
   }
@@ -375,18 +400,16 @@ namespace OpenMS
     if (!residue.empty()) res = residue[0];
     double diff = 0;
     Size cnt = 0;
-    #pragma omp critical(OpenMS_ModificationsDB)
+    const std::shared_ptr<const Snapshot_> snapshot = getSnapshot_();
+    for (auto const & m : snapshot->mods)
     {
-      for (auto const & m : mods_)
+      diff = fabs(m->getDiffMonoMass() - mass);
+      if ((diff <= max_error) &&
+          residuesMatch_(res, m) &&
+          ((term_spec == ResidueModification::NUMBER_OF_TERM_SPECIFICITY) ||
+           (term_spec == m->getTermSpecificity())))
       {
-        diff = fabs(m->getDiffMonoMass() - mass);
-        if ((diff <= max_error) &&
-            residuesMatch_(res, m) &&
-            ((term_spec == ResidueModification::NUMBER_OF_TERM_SPECIFICITY) ||
-             (term_spec == m->getTermSpecificity())))
-        {
-          diff_idx2mods.emplace(make_pair(diff, cnt++), m->getFullId());
-        }
+        diff_idx2mods.emplace(make_pair(diff, cnt++), m->getFullId());
       }
     }
     for (const auto& foo_mod : diff_idx2mods)
@@ -403,18 +426,16 @@ namespace OpenMS
     if (!residue.empty()) res = residue[0];
     double diff = 0;
     Size cnt = 0;
-    #pragma omp critical(OpenMS_ModificationsDB)
+    const std::shared_ptr<const Snapshot_> snapshot = getSnapshot_();
+    for (auto const & m : snapshot->mods)
     {
-      for (auto const & m : mods_)
+      diff = fabs(m->getDiffMonoMass() - mass);
+      if ((diff <= max_error) &&
+          residuesMatch_(res, m) &&
+          ((term_spec == ResidueModification::NUMBER_OF_TERM_SPECIFICITY) ||
+           (term_spec == m->getTermSpecificity())))
       {
-        diff = fabs(m->getDiffMonoMass() - mass);
-        if ((diff <= max_error) &&
-            residuesMatch_(res, m) &&
-            ((term_spec == ResidueModification::NUMBER_OF_TERM_SPECIFICITY) ||
-             (term_spec == m->getTermSpecificity())))
-        {
-          diff_idx2mods.emplace(make_pair(diff, cnt++), m);
-        }
+        diff_idx2mods.emplace(make_pair(diff, cnt++), m);
       }
     }
     for (const auto& foo_mod : diff_idx2mods)
@@ -430,22 +451,20 @@ namespace OpenMS
     const ResidueModification* mod = nullptr;
     char res = '?'; // empty
     if (!residue.empty()) res = residue[0];
-    #pragma omp critical(OpenMS_ModificationsDB)
+    const std::shared_ptr<const Snapshot_> snapshot = getSnapshot_();
+    for (auto const & m : snapshot->mods)
     {
-      for (auto const & m : mods_)
+      // using less instead of less-or-equal will pick the first matching
+      // modification of equally heavy modifications (in our case this is the
+      // first matching UniMod entry)
+      double mass_error = fabs(m->getDiffMonoMass() - mass);
+      if ((mass_error < min_error) &&
+          residuesMatch_(res, m) &&
+          ((term_spec == ResidueModification::NUMBER_OF_TERM_SPECIFICITY) ||
+           (term_spec == m->getTermSpecificity())))
       {
-        // using less instead of less-or-equal will pick the first matching
-        // modification of equally heavy modifications (in our case this is the
-        // first matching UniMod entry)
-        double mass_error = fabs(m->getDiffMonoMass() - mass);
-        if ((mass_error < min_error) &&
-            residuesMatch_(res, m) &&
-            ((term_spec == ResidueModification::NUMBER_OF_TERM_SPECIFICITY) ||
-             (term_spec == m->getTermSpecificity())))
-        {
-          min_error = mass_error;
-          mod = m;
-        }
+        min_error = mass_error;
+        mod = m;
       }
     }
     return mod;
@@ -474,6 +493,9 @@ namespace OpenMS
         mods_.push_back(m);
       }
     }
+
+    #pragma omp critical(OpenMS_ModificationsDB)
+    publishSnapshot_();
   }
 
   const ResidueModification* ModificationsDB::addModification(std::unique_ptr<ResidueModification> new_mod)
@@ -496,6 +518,7 @@ namespace OpenMS
         mods_.push_back(new_mod.get());
         new_mod.release(); // do not delete the object; 
         ret = mods_.back();
+        publishSnapshot_(ret, {ret->getFullId(), ret->getId(), ret->getFullName(), ret->getUniModAccession()});
       }
     }
     return ret;
@@ -800,6 +823,7 @@ namespace OpenMS
           }
         }
       }
+      publishSnapshot_();
     }
   }
 
@@ -807,14 +831,12 @@ namespace OpenMS
   {
     modifications.clear();
 
-    #pragma omp critical(OpenMS_ModificationsDB)
+    const std::shared_ptr<const Snapshot_> snapshot = getSnapshot_();
+    for (auto const & m : snapshot->mods)
     {
-      for (auto const & m : mods_)
+      if (m->getUniModRecordId() > 0)
       {
-        if (m->getUniModRecordId() > 0)
-        {
-          modifications.push_back(m->getFullId());
-        }
+        modifications.push_back(m->getFullId());
       }
     }
 
@@ -48,6 +48,7 @@ namespace OpenMS
   ResidueDB::ResidueDB()
   { 
     initResidues_();
+    publishModifiedResidues_();
   }
 
   ResidueDB* ResidueDB::getInstance()
@@ -70,14 +71,12 @@ namespace OpenMS
       throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "No residue specified.", "");
     }
 
+    // no lock required: unmodified residues are only added in the constructor
     const Residue* r{};
-    #pragma omp critical (ResidueDB)
-    {   
-      auto it = residue_names_.find(name);
-      if (it != residue_names_.end()) 
-      { 
-        r = it->second; 
-      }
+    auto it = residue_names_.find(name);
+    if (it != residue_names_.end()) 
+    { 
+      r = it->second; 
     }
     if (r == nullptr)
     {
@@ -95,35 +94,22 @@ namespace OpenMS
 
   Size ResidueDB::getNumberOfResidues() const
   {
-    Size s;
-    #pragma omp critical (ResidueDB)
-    {
-      s = const_residues_.size();
-    } 
-    return s;
+    return const_residues_.size();
   }
 
   Size ResidueDB::getNumberOfModifiedResidues() const
   {
-    Size s;
-    #pragma omp critical (ResidueDB)
-    {
-      s = const_modified_residues_.size();
-    } 
-    return s;
+    return std::atomic_load(&modified_residues_)->residues.size();
   }
 
   const set<const Residue*> ResidueDB::getResidues(const String& residue_set) const
   {
     set<const Residue*> s;
-    #pragma omp critical (ResidueDB)
+    auto it = residues_by_set_.find(residue_set);
+    if (it != residues_by_set_.end())
     {
-      auto it = residues_by_set_.find(residue_set);
-      if (it != residues_by_set_.end())
-      {
-        s = it->second;
-      }
-    } 
+      s = it->second;
+    }
 
     if (s.empty()) 
     {
@@ -154,23 +140,14 @@ namespace OpenMS
 
   bool ResidueDB::hasResidue(const String& res_name) const
   {
-    bool found = false;
-    #pragma omp critical (ResidueDB)
-    {
-      found = residue_names_.find(res_name) != residue_names_.end();
-    }  
-    return found;
+    return residue_names_.find(res_name) != residue_names_.end();
   }
 
   bool ResidueDB::hasResidue(const Residue* residue) const
   {
-    bool found = false;
-    #pragma omp critical (ResidueDB)
-    {
-      found = (const_residues_.find(residue) != const_residues_.end() ||
-          const_modified_residues_.find(residue) != const_modified_residues_.end());
-    } 
-    return found;
+    if (const_residues_.find(residue) != const_residues_.end()) return true;
+    const std::shared_ptr<const ModifiedResidues_> modified = std::atomic_load(&modified_residues_);
+    return modified->residues.find(residue) != modified->residues.end();
   }
 
   void ResidueDB::buildResidues_()
@@ -299,12 +276,15 @@ namespace OpenMS
 
   const set<String> ResidueDB::getResidueSets() const
   {
-    set<String> rs;
-    #pragma omp critical (ResidueDB)
-    {
-      rs = residue_sets_; 
-    }
-    return rs;
+    return residue_sets_;
+  }
+
+  void ResidueDB::publishModifiedResidues_()
+  {
+    std::shared_ptr<ModifiedResidues_> modified(new ModifiedResidues_);
+    modified->names = residue_mod_names_;
+    modified->residues = const_modified_residues_;
+    std::atomic_store(&modified_residues_, std::shared_ptr<const ModifiedResidues_>(std::move(modified)));
   }
 
   void ResidueDB::addModifiedResidueNames_(const Residue* r)
@@ -385,75 +365,66 @@ namespace OpenMS
     OPENMS_PRECONDITION(!modification.empty(), "Modification cannot be empty")
     // search if the mod already exists
     const String & res_name = residue->getName();
-    Residue* res{};
-    bool residue_found(true), mod_found(true);
-    #pragma omp critical (ResidueDB)
+
+    // Perform a single lookup of the residue name in the snapshot of modified
+    // residues, we assume that if it is present there then we have seen it
+    // before and can directly grab it. If its not present, we may have as
+    // unmodified residue in residue_names_ but need to create a new entry as
+    // modified residue. If the residue itself is unknow, we throw.
+    const std::shared_ptr<const ModifiedResidues_> modified = std::atomic_load(&modified_residues_);
+    const auto& rm_entry = modified->names.find(res_name);
+    if (rm_entry == modified->names.end() && residue_names_.find(res_name) == residue_names_.end())
     {
-      // Perform a single lookup of the residue name in our database, we assume
-      // that if it is present in residue_mod_names_ then we have seen it
-      // before and can directly grab it. If its not present, we may have as
-      // unmodified residue in residue_names_ but need to create a new entry as
-      // modified residue. If the residue itself is unknow, we will throw (see
-      // below).
-      const auto& rm_entry = residue_mod_names_.find(res_name);
-      if (rm_entry == residue_mod_names_.end())
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Residue not found: ", res_name);
+    }
+
+    const ResidueModification* mod{};
+    try
+    {
+      // terminal modifications don't apply to residues (side chain), so only consider internal ones
+      static const ModificationsDB* mdb = ModificationsDB::getInstance();
+      mod = mdb->getModification(modification, residue->getOneLetterCode(), ResidueModification::ANYWHERE);
+    }
+    catch (...)
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Modification not found: ", modification);
+    }
+
+    // check if modified residue is already present in ResidueDB
+    const String& id = mod->getId().empty() ? mod->getFullId() : mod->getId();
+    if (rm_entry != modified->names.end())
+    {
+      const auto& inner = rm_entry->second.find(id);
+      if (inner != rm_entry->second.end())
       {
-        if (residue_names_.find(res_name) == residue_names_.end())
-        {
-          residue_found = false;
-        }
+        return inner->second;
       }
+    }
 
-      if (residue_found)
+    // create and register this modified residue (check again under the lock,
+    // another thread might have created it in the meantime)
+    const Residue* res{};
+    #pragma omp critical (ResidueDB)
+    {
+      const auto& entry = residue_mod_names_.find(res_name);
+      if (entry != residue_mod_names_.end())
       {
-        const ResidueModification* mod{};
-        try
-        {
-          // terminal modifications don't apply to residues (side chain), so only consider internal ones
-          static const ModificationsDB* mdb = ModificationsDB::getInstance();
-          mod = mdb->getModification(modification, residue->getOneLetterCode(), ResidueModification::ANYWHERE);
-        }
-        catch (...)
-        {
-          mod_found = false;
-        }
-
-        // check if modification in ResidueDB
-        if (mod_found)
+        const auto& inner = entry->second.find(id);
+        if (inner != entry->second.end())
         {
-          // check if modified residue is already present in ResidueDB
-          bool found = false;
-          if (rm_entry != residue_mod_names_.end())
-          {
-            const String& id = mod->getId().empty() ? mod->getFullId() : mod->getId();
-            const auto& inner = rm_entry->second.find(id);
-            if (inner != rm_entry->second.end())
-            {
-              res = const_cast<Residue*>(inner->second);
-              found = true;
-            }
-          }
-          if (!found)
-          {
-            // create and register this modified residue
-            res = new Residue(*residue_names_.at(res_name));
-            res->setModification(mod);
-            addResidue_(res);            
-          }
+          res = inner->second;
         }
       }
+      if (res == nullptr)
+      {
+        Residue* new_res = new Residue(*residue_names_.at(res_name));
+        new_res->setModification(mod);
+        addResidue_(new_res);
+        publishModifiedResidues_();
+        res = new_res;
+      }
     }
 
-    // throwing (uncaught) exceptions needs to happen outside of critical section (see OpenMP reference manual)
-    if (!residue_found)
-    {
-      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Residue not found: ", res_name);
-    }
-    else if (!mod_found)
-    {
-      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Modification not found: ", modification);
-    }
-    
     return res;
   }
 }
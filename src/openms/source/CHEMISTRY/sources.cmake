@@ -4,6 +4,7 @@ set(directory source/CHEMISTRY)
 ### list all filenames of the directory here
 set(sources_list
 AASequence.cpp
+CompactAASequence.cpp
 CrossLinksDB.cpp
 DecoyGenerator.cpp
 Element.cpp
@@ -11,6 +12,7 @@ ElementDB.cpp
 EmpiricalFormula.cpp
 EnzymaticDigestionLogModel.cpp
 EnzymaticDigestion.cpp
+FragmentIonLadder.cpp
 DigestionEnzyme.cpp
 DigestionEnzymeProtein.cpp
 DigestionEnzymeRNA.cpp
@@ -87,4 +87,14 @@ namespace OpenMS
     return static_cast<double>(s.nonZeros()) / denominator;
   }
 
+  BinnedSpectrumCompareFunctor::BatchKernel_ BinnedSharedPeakCount::batchKernel_() const
+  {
+    return BatchKernel_::SHARED_BINS;
+  }
+
+  double BinnedSharedPeakCount::batchScore_(const SpectrumStatistics_& spec1, const SpectrumStatistics_& spec2, const PairStatistics_& pair) const
+  {
+    size_t denominator(max(spec1.non_zeros, spec2.non_zeros));
+    return static_cast<double>(pair.shared_bins) / denominator;
+  }
 }
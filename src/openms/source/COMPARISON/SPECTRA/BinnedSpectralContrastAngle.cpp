@@ -85,5 +85,14 @@ namespace OpenMS
 
     return score;
   }
-}
 
+  BinnedSpectrumCompareFunctor::BatchKernel_ BinnedSpectralContrastAngle::batchKernel_() const
+  {
+    return BatchKernel_::SHARED_BINS;
+  }
+
+  double BinnedSpectralContrastAngle::batchScore_(const SpectrumStatistics_& spec1, const SpectrumStatistics_& spec2, const PairStatistics_& pair) const
+  {
+    return pair.dot_product / (sqrt(spec1.sum_of_squares * spec2.sum_of_squares));
+  }
+}
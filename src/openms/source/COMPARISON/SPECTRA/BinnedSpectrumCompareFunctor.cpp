@@ -38,12 +38,46 @@
 #include <OpenMS/COMPARISON/SPECTRA/BinnedSumAgreeingIntensities.h>
 #include <OpenMS/CONCEPT/Factory.h>
 
-
+#include <algorithm>
+#include <exception>
+#include <limits>
 
 using namespace std;
 
 namespace OpenMS
 {
+  namespace
+  {
+    using BinIndex = BinnedSpectrum::SparseVectorIndexType;
+
+    /// binned spectra packed into one contiguous block in compressed sparse row (CSR) layout
+    struct PackedBins
+    {
+      explicit PackedBins(const vector<const BinnedSpectrum*>& specs)
+      {
+        offsets.reserve(specs.size() + 1);
+        offsets.push_back(0);
+        for (const BinnedSpectrum* s : specs)
+        {
+          offsets.push_back(offsets.back() + s->getBins().nonZeros());
+        }
+        indices.reserve(offsets.back());
+        values.reserve(offsets.back());
+        for (const BinnedSpectrum* s : specs)
+        {
+          // bins of a sparse vector are stored sorted by index
+          const BinnedSpectrum::SparseVectorType& bins = s->getBins();
+          indices.insert(indices.end(), bins.innerIndexPtr(), bins.innerIndexPtr() + bins.nonZeros());
+          values.insert(values.end(), bins.valuePtr(), bins.valuePtr() + bins.nonZeros());
+        }
+      }
+
+      vector<Size> offsets; ///< bins of spectrum i are stored at [offsets[i], offsets[i + 1])
+      vector<BinIndex> indices;
+      vector<float> values;
+    };
+  }
+
   BinnedSpectrumCompareFunctor::BinnedSpectrumCompareFunctor() :
     DefaultParamHandler(BinnedSpectrumCompareFunctor::getProductName())
   {
@@ -67,6 +101,201 @@ namespace OpenMS
     return *this;
   }
 
+  vector<double> BinnedSpectrumCompareFunctor::compare(const BinnedSpectrum& spec, const vector<BinnedSpectrum>& specs) const
+  {
+    vector<double> scores(specs.size());
+    if (specs.empty()) { return scores; }
+
+    vector<const BinnedSpectrum*> specs2;
+    specs2.reserve(specs.size());
+    for (const BinnedSpectrum& s : specs) { specs2.push_back(&s); }
+
+    compareBatch_(vector<const BinnedSpectrum*>(1, &spec), specs2, scores.data());
+    return scores;
+  }
+
+  Matrix<double> BinnedSpectrumCompareFunctor::compare(const vector<BinnedSpectrum>& specs1, const vector<BinnedSpectrum>& specs2) const
+  {
+    Matrix<double> scores(specs1.size(), specs2.size());
+    if (specs1.empty() || specs2.empty()) { return scores; }
+
+    vector<const BinnedSpectrum*> s1, s2;
+    s1.reserve(specs1.size());
+    s2.reserve(specs2.size());
+    for (const BinnedSpectrum& s : specs1) { s1.push_back(&s); }
+    for (const BinnedSpectrum& s : specs2) { s2.push_back(&s); }
+
+    // Matrix stores its elements row-major in one contiguous block
+    compareBatch_(s1, s2, &scores(0, 0));
+    return scores;
+  }
+
+  BinnedSpectrumCompareFunctor::BatchKernel_ BinnedSpectrumCompareFunctor::batchKernel_() const
+  {
+    return BatchKernel_::PAIRWISE;
+  }
+
+  double BinnedSpectrumCompareFunctor::batchScore_(const SpectrumStatistics_&, const SpectrumStatistics_&, const PairStatistics_&) const
+  {
+    throw Exception::NotImplemented(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);
+  }
+
+  void BinnedSpectrumCompareFunctor::compareBatch_(const vector<const BinnedSpectrum*>& specs1, const vector<const BinnedSpectrum*>& specs2, double* scores) const
+  {
+    // work is split into tiles of (rows x columns): the packed bins of a column block are reused from cache for all rows of the tile
+    const Size row_block = 16;
+    const Size col_block = 256;
+    const Size n_rows = specs1.size();
+    const Size n_cols = specs2.size();
+    const Size n_row_blocks = (n_rows + row_block - 1) / row_block;
+    const Size n_col_blocks = (n_cols + col_block - 1) / col_block;
+    const SignedSize n_tiles = (SignedSize)(n_row_blocks * n_col_blocks);
+
+    const BatchKernel_ kernel = batchKernel_();
+
+    if (kernel == BatchKernel_::PAIRWISE)
+    {
+      Size error_idx = numeric_limits<Size>::max();
+      std::exception_ptr error;
+
+#pragma omp parallel for schedule(dynamic, 1)
+      for (SignedSize t = 0; t < n_tiles; ++t)
+      {
+        const Size r_begin = (t / n_col_blocks) * row_block, r_end = min(n_rows, r_begin + row_block);
+        const Size c_begin = (t % n_col_blocks) * col_block, c_end = min(n_cols, c_begin + col_block);
+        try
+        {
+          for (Size r = r_begin; r < r_end; ++r)
+          {
+            for (Size c = c_begin; c < c_end; ++c)
+            {
+              scores[r * n_cols + c] = (*this)(*specs1[r], *specs2[c]);
+            }
+          }
+        }
+        catch (...)
+        {
+#pragma omp critical (BinnedSpectrumCompareFunctor_error)
+          {
+            if ((Size)t < error_idx)
+            {
+              error_idx = t;
+              error = std::current_exception();
+            }
+          }
+        }
+      }
+      if (error) std::rethrow_exception(error);
+      return;
+    }
+
+    const bool with_agreeing = kernel == BatchKernel_::SHARED_BINS_AGREEING;
+
+    // same expressions as used by the pairwise operators
+    auto statistics = [](const BinnedSpectrum* s)
+    {
+      SpectrumStatistics_ stats;
+      stats.sum = s->getBins().sum();
+      stats.sum_of_squares = s->getBins().dot(s->getBins());
+      stats.non_zeros = s->getBins().nonZeros();
+      return stats;
+    };
+    vector<SpectrumStatistics_> stats1, stats2;
+    stats1.reserve(n_rows);
+    stats2.reserve(n_cols);
+    for (const BinnedSpectrum* s : specs1) { stats1.push_back(statistics(s)); }
+    for (const BinnedSpectrum* s : specs2) { stats2.push_back(statistics(s)); }
+
+    const PackedBins rows(specs1);
+    const PackedBins cols(specs2);
+
+#pragma omp parallel
+    {
+      // row spectrum scattered into a dense array covering the bins from its first to its last occupied bin
+      vector<float> dense;
+      vector<unsigned char> occupied;
+
+#pragma omp for schedule(dynamic, 1)
+      for (SignedSize t = 0; t < n_tiles; ++t)
+      {
+        const Size r_begin = (t / n_col_blocks) * row_block, r_end = min(n_rows, r_begin + row_block);
+        const Size c_begin = (t % n_col_blocks) * col_block, c_end = min(n_cols, c_begin + col_block);
+
+        for (Size r = r_begin; r < r_end; ++r)
+        {
+          const BinIndex* r_idx = rows.indices.data() + rows.offsets[r];
+          const float* r_val = rows.values.data() + rows.offsets[r];
+          const Size r_size = rows.offsets[r + 1] - rows.offsets[r];
+
+          if (r_size == 0)
+          {
+            // no shared bins with any spectrum
+            for (Size c = c_begin; c < c_end; ++c)
+            {
+              scores[r * n_cols + c] = batchScore_(stats1[r], stats2[c], PairStatistics_());
+            }
+            continue;
+          }
+
+          const BinIndex first = r_idx[0];
+          const BinIndex last = r_idx[r_size - 1];
+          const Size span = (Size)(last - first) + 1;
+          if (dense.size() < span)
+          {
+            dense.resize(span, 0.0f);
+            occupied.resize(span, 0);
+          }
+          for (Size k = 0; k < r_size; ++k)
+          {
+            dense[r_idx[k] - first] = r_val[k];
+            occupied[r_idx[k] - first] = 1;
+          }
+
+          for (Size c = c_begin; c < c_end; ++c)
+          {
+            // restrict column bins to the range covered by the row spectrum
+            const BinIndex* c_begin_idx = cols.indices.data() + cols.offsets[c];
+            const BinIndex* c_end_idx = cols.indices.data() + cols.offsets[c + 1];
+            const BinIndex* lo = lower_bound(c_begin_idx, c_end_idx, first);
+            const BinIndex* hi = upper_bound(lo, c_end_idx, last);
+            const float* c_val = cols.values.data() + (lo - cols.indices.data());
+            const Size n = hi - lo;
+
+            // Note: accumulate in float and in bin order like Eigen's sparse dot product, so batched and pairwise scores agree.
+            //       Bins not occupied in the row spectrum contribute a zero product (or a non-positive agreeing intensity).
+            float dot(0), agreeing(0);
+            Size shared(0);
+            for (Size k = 0; k < n; ++k)
+            {
+              const Size pos = lo[k] - first;
+              const float a = dense[pos];
+              const float b = c_val[k];
+              dot += a * b;
+              shared += occupied[pos];
+              if (with_agreeing)
+              {
+                agreeing += max(0.0f, (a + b) * 0.5f - std::fabs(a - b));
+              }
+            }
+
+            PairStatistics_ pair;
+            pair.dot_product = dot;
+            pair.agreeing_intensities = agreeing;
+            pair.shared_bins = shared;
+            scores[r * n_cols + c] = batchScore_(stats1[r], stats2[c], pair);
+          }
+
+          // reset only the touched part of the dense array
+          for (Size k = 0; k < r_size; ++k)
+          {
+            dense[r_idx[k] - first] = 0.0f;
+            occupied[r_idx[k] - first] = 0;
+          }
+        }
+      }
+    }
+  }
+
   void BinnedSpectrumCompareFunctor::registerChildren()
   {
     Factory<BinnedSpectrumCompareFunctor>::registerProduct(BinnedSharedPeakCount::getProductName(), &BinnedSharedPeakCount::create);
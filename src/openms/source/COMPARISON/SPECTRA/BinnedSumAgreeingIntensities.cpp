@@ -90,5 +90,14 @@ namespace OpenMS
     // resulting score normalized to interval [0,1]
     return min(sum_nn / ((sum1 + sum2) / 2.0), 1.0);
   }
-}
 
+  BinnedSpectrumCompareFunctor::BatchKernel_ BinnedSumAgreeingIntensities::batchKernel_() const
+  {
+    return BatchKernel_::SHARED_BINS_AGREEING;
+  }
+
+  double BinnedSumAgreeingIntensities::batchScore_(const SpectrumStatistics_& spec1, const SpectrumStatistics_& spec2, const PairStatistics_& pair) const
+  {
+    return min(pair.agreeing_intensities / ((spec1.sum + spec2.sum) / 2.0), 1.0);
+  }
+}
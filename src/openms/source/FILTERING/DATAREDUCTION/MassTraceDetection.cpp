@@ -38,6 +38,10 @@
 
 #include <boost/dynamic_bitset.hpp>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
     MassTraceDetection::MassTraceDetection() :
@@ -206,20 +210,30 @@ namespace OpenMS
       std::vector<Size> spec_offsets;
       spec_offsets.push_back(0);
 
-      Size spectra_count(0);
-
       // *********************************************************** //
       //  Step 1: Detecting potential chromatographic apices
       // *********************************************************** //
+      std::vector<const MSSpectrum*> ms1_spectra;
       for (PeakMap::ConstIterator it = input_exp.begin(); it != input_exp.end(); ++it)
       {
         // check if this is a MS1 survey scan
         if (it->getMSLevel() != 1) continue;
-
+        ms1_spectra.push_back(&(*it));
+      }
+      Size spectra_count(ms1_spectra.size());
+
+      // spectra are filtered in parallel, the apices are concatenated in
+      // spectrum order afterwards
+      std::vector<std::vector<Apex> > spectrum_apices(spectra_count);
+      work_exp.getSpectra().resize(spectra_count);
+#pragma omp parallel for schedule(dynamic, 100)
+      for (SignedSize spec_idx = 0; spec_idx < (SignedSize)spectra_count; ++spec_idx)
+      {
+        const MSSpectrum& spectrum = *ms1_spectra[spec_idx];
         std::vector<Size> indices_passing;
-        for (Size peak_idx = 0; peak_idx < it->size(); ++peak_idx)
+        for (Size peak_idx = 0; peak_idx < spectrum.size(); ++peak_idx)
         {
-          double tmp_peak_int((*it)[peak_idx].getIntensity());
+          double tmp_peak_int(spectrum[peak_idx].getIntensity());
           if (tmp_peak_int > noise_threshold_int_)
           {
             // Assume that noise_threshold_int_ contains the noise level of the
@@ -227,17 +241,20 @@ namespace OpenMS
             // --> add this peak as possible chromatographic apex
             if (tmp_peak_int > chrom_peak_snr_ * noise_threshold_int_)
             {
-              chrom_apices.emplace_back(tmp_peak_int, spectra_count, indices_passing.size());
+              spectrum_apices[spec_idx].emplace_back(tmp_peak_int, spec_idx, indices_passing.size());
             }
             indices_passing.push_back(peak_idx);
-            ++total_peak_count;
           }
         }
-        PeakMap::SpectrumType tmp_spec(*it);
-        tmp_spec.select(indices_passing);
-        work_exp.addSpectrum(tmp_spec);
-        spec_offsets.push_back(spec_offsets.back() + tmp_spec.size());
-        ++spectra_count;
+        work_exp[spec_idx] = spectrum;
+        work_exp[spec_idx].select(indices_passing);
+      }
+
+      for (Size spec_idx = 0; spec_idx < spectra_count; ++spec_idx)
+      {
+        chrom_apices.insert(chrom_apices.end(), spectrum_apices[spec_idx].begin(), spectrum_apices[spec_idx].end());
+        total_peak_count += work_exp[spec_idx].size();
+        spec_offsets.push_back(spec_offsets.back() + work_exp[spec_idx].size());
       }
 
       if (spectra_count < 3)
@@ -301,265 +318,329 @@ namespace OpenMS
       this->startProgress(0, total_peak_count, "mass trace detection");
       Size peaks_detected(0);
 
-      for (auto m_it = chrom_apices.crbegin(); m_it != chrom_apices.crend(); ++m_it)
+      // Apices are processed in blocks in order of decreasing intensity. All
+      // apices of a block are first grown concurrently against the peaks
+      // visited before the block. The candidates are then committed serially
+      // in the original order: a candidate is only affected by the traces
+      // committed before it if one of its gathered peaks was taken in the
+      // meantime, in which case it is grown again. This gives the same traces
+      // as processing the apices one after another.
+      Size block_size(1);
+#ifdef _OPENMP
+      block_size = 16 * omp_get_max_threads();
+#endif
+      std::vector<TraceCandidate_> candidates;
+      bool max_traces_reached(false);
+
+      for (Size block_start = 0; block_start < chrom_apices.size() && !max_traces_reached; block_start += block_size)
       {
-        Size apex_scan_idx(m_it->scan_idx);
-        Size apex_peak_idx(m_it->peak_idx);
+        const Size block_end = std::min(block_start + block_size, chrom_apices.size());
+        candidates.clear();
+        candidates.resize(block_end - block_start);
 
-        if (peak_visited[spec_offsets[apex_scan_idx] + apex_peak_idx])
+#pragma omp parallel for schedule(dynamic, 1)
+        for (SignedSize i = block_start; i < (SignedSize)block_end; ++i)
         {
-          continue;
+          const Apex& apex = chrom_apices[chrom_apices.size() - 1 - i];
+          if (peak_visited[spec_offsets[apex.scan_idx] + apex.peak_idx])
+          {
+            continue;
+          }
+          extendApex_(apex, work_exp, spec_offsets, peak_visited, fwhm_meta_idx, candidates[i - block_start]);
         }
 
-        Peak2D apex_peak;
-        apex_peak.setRT(work_exp[apex_scan_idx].getRT());
-        apex_peak.setMZ(work_exp[apex_scan_idx][apex_peak_idx].getMZ());
-        apex_peak.setIntensity(work_exp[apex_scan_idx][apex_peak_idx].getIntensity());
+        for (Size i = block_start; i < block_end; ++i)
+        {
+          const Apex& apex = chrom_apices[chrom_apices.size() - 1 - i];
+          if (peak_visited[spec_offsets[apex.scan_idx] + apex.peak_idx])
+          {
+            continue;
+          }
 
-        Size trace_up_idx(apex_scan_idx);
-        Size trace_down_idx(apex_scan_idx);
+          TraceCandidate_& candidate = candidates[i - block_start];
+          bool outdated = candidate.gathered_idx.empty();
+          for (const auto& idx : candidate.gathered_idx)
+          {
+            if (peak_visited[spec_offsets[idx.first] + idx.second])
+            {
+              outdated = true;
+              break;
+            }
+          }
+          if (outdated)
+          {
+            candidate = TraceCandidate_();
+            extendApex_(apex, work_exp, spec_offsets, peak_visited, fwhm_meta_idx, candidate);
+          }
+          if (!candidate.accepted) continue;
 
-        std::list<PeakType> current_trace;
-        current_trace.push_back(apex_peak);
-        std::vector<double> fwhms_mz; // peak-FWHM meta values of collected peaks
+          // mark all peaks as visited
+          for (Size j = 0; j < candidate.gathered_idx.size(); ++j)
+          {
+            peak_visited[spec_offsets[candidate.gathered_idx[j].first] + candidate.gathered_idx[j].second] = true;
+          }
 
-        // Initialization for the iterative version of weighted m/z mean calculation
-        double centroid_mz(apex_peak.getMZ());
-        double prev_counter(apex_peak.getIntensity() * apex_peak.getMZ());
-        double prev_denom(apex_peak.getIntensity());
+          candidate.trace.setLabel("T" + String(trace_number));
+          ++trace_number;
 
-        updateIterativeWeightedMeanMZ(apex_peak.getMZ(), apex_peak.getIntensity(), centroid_mz, prev_counter, prev_denom);
+          peaks_detected += candidate.trace.getSize();
+          found_masstraces.push_back(std::move(candidate.trace));
+          this->setProgress(peaks_detected);
 
-        std::vector<std::pair<Size, Size> > gathered_idx;
-        gathered_idx.emplace_back(apex_scan_idx, apex_peak_idx);
-        if (fwhm_meta_idx != -1)
-        {
-          fwhms_mz.push_back(work_exp[apex_scan_idx].getFloatDataArrays()[fwhm_meta_idx][apex_peak_idx]);
+          // check if we already reached the (optional) maximum number of traces
+          if (max_traces > 0 && found_masstraces.size() == max_traces)
+          {
+            max_traces_reached = true;
+            break;
+          }
         }
+      }
 
-        Size up_hitting_peak(0), down_hitting_peak(0);
-        Size up_scan_counter(0), down_scan_counter(0);
+      this->endProgress();
+
+    }
+
+    bool MassTraceDetection::extendApex_(const Apex& apex,
+                                         const PeakMap& work_exp,
+                                         const std::vector<Size>& spec_offsets,
+                                         const boost::dynamic_bitset<>& peak_visited,
+                                         const int fwhm_meta_idx,
+                                         TraceCandidate_& candidate)
+    {
+      Size apex_scan_idx(apex.scan_idx);
+      Size apex_peak_idx(apex.peak_idx);
+
+      Peak2D apex_peak;
+      apex_peak.setRT(work_exp[apex_scan_idx].getRT());
+      apex_peak.setMZ(work_exp[apex_scan_idx][apex_peak_idx].getMZ());
+      apex_peak.setIntensity(work_exp[apex_scan_idx][apex_peak_idx].getIntensity());
 
-        bool toggle_up = true, toggle_down = true;
+      Size trace_up_idx(apex_scan_idx);
+      Size trace_down_idx(apex_scan_idx);
 
-        Size conseq_missed_peak_up(0), conseq_missed_peak_down(0);
-        Size max_consecutive_missing(trace_termination_outliers_);
+      std::list<PeakType> current_trace;
+      current_trace.push_back(apex_peak);
+      std::vector<double> fwhms_mz; // peak-FWHM meta values of collected peaks
 
-        double current_sample_rate(1.0);
-        // Size min_scans_to_consider(std::floor((min_sample_rate_ /2)*10));
-        Size min_scans_to_consider(5);
+      // Initialization for the iterative version of weighted m/z mean calculation
+      double centroid_mz(apex_peak.getMZ());
+      double prev_counter(apex_peak.getIntensity() * apex_peak.getMZ());
+      double prev_denom(apex_peak.getIntensity());
 
-        // double outlier_ratio(0.3);
+      updateIterativeWeightedMeanMZ(apex_peak.getMZ(), apex_peak.getIntensity(), centroid_mz, prev_counter, prev_denom);
 
-        // double ftl_mean(centroid_mz);
-        double ftl_sd((centroid_mz / 1e6) * mass_error_ppm_);
-        double intensity_so_far(apex_peak.getIntensity());
+      std::vector<std::pair<Size, Size> > gathered_idx;
+      gathered_idx.emplace_back(apex_scan_idx, apex_peak_idx);
+      if (fwhm_meta_idx != -1)
+      {
+        fwhms_mz.push_back(work_exp[apex_scan_idx].getFloatDataArrays()[fwhm_meta_idx][apex_peak_idx]);
+      }
 
-        while (((trace_down_idx > 0) && toggle_down) ||
-               ((trace_up_idx < work_exp.size() - 1) && toggle_up)
-                )
+      Size up_hitting_peak(0), down_hitting_peak(0);
+      Size up_scan_counter(0), down_scan_counter(0);
+
+      bool toggle_up = true, toggle_down = true;
+
+      Size conseq_missed_peak_up(0), conseq_missed_peak_down(0);
+      Size max_consecutive_missing(trace_termination_outliers_);
+
+      double current_sample_rate(1.0);
+      // Size min_scans_to_consider(std::floor((min_sample_rate_ /2)*10));
+      Size min_scans_to_consider(5);
+
+      // double outlier_ratio(0.3);
+
+      // double ftl_mean(centroid_mz);
+      double ftl_sd((centroid_mz / 1e6) * mass_error_ppm_);
+      double intensity_so_far(apex_peak.getIntensity());
+
+      while (((trace_down_idx > 0) && toggle_down) ||
+             ((trace_up_idx < work_exp.size() - 1) && toggle_up)
+              )
+      {
+        // *********************************************************** //
+        // Step 2.1 MOVE DOWN in RT dim
+        // *********************************************************** //
+        if ((trace_down_idx > 0) && toggle_down)
         {
-          // *********************************************************** //
-          // Step 2.1 MOVE DOWN in RT dim
-          // *********************************************************** //
-          if ((trace_down_idx > 0) && toggle_down)
+          const MSSpectrum& spec_trace_down = work_exp[trace_down_idx - 1];
+          if (!spec_trace_down.empty())
           {
-            const MSSpectrum& spec_trace_down = work_exp[trace_down_idx - 1];
-            if (!spec_trace_down.empty())
-            {
-              Size next_down_peak_idx = spec_trace_down.findNearest(centroid_mz);
-              double next_down_peak_mz = spec_trace_down[next_down_peak_idx].getMZ();
-              double next_down_peak_int = spec_trace_down[next_down_peak_idx].getIntensity();
+            Size next_down_peak_idx = spec_trace_down.findNearest(centroid_mz);
+            double next_down_peak_mz = spec_trace_down[next_down_peak_idx].getMZ();
+            double next_down_peak_int = spec_trace_down[next_down_peak_idx].getIntensity();
 
-              double right_bound = centroid_mz + 3 * ftl_sd;
-              double left_bound = centroid_mz - 3 * ftl_sd;
+            double right_bound = centroid_mz + 3 * ftl_sd;
+            double left_bound = centroid_mz - 3 * ftl_sd;
 
-              if ((next_down_peak_mz <= right_bound) &&
-                  (next_down_peak_mz >= left_bound) &&
-                  !peak_visited[spec_offsets[trace_down_idx - 1] + next_down_peak_idx]
-                      )
+            if ((next_down_peak_mz <= right_bound) &&
+                (next_down_peak_mz >= left_bound) &&
+                !peak_visited[spec_offsets[trace_down_idx - 1] + next_down_peak_idx]
+                    )
+            {
+              Peak2D next_peak;
+              next_peak.setRT(spec_trace_down.getRT());
+              next_peak.setMZ(next_down_peak_mz);
+              next_peak.setIntensity(next_down_peak_int);
+
+              current_trace.push_front(next_peak);
+              // FWHM average
+              if (fwhm_meta_idx != -1)
               {
-                Peak2D next_peak;
-                next_peak.setRT(spec_trace_down.getRT());
-                next_peak.setMZ(next_down_peak_mz);
-                next_peak.setIntensity(next_down_peak_int);
-
-                current_trace.push_front(next_peak);
-                // FWHM average
-                if (fwhm_meta_idx != -1)
-                {
-                  fwhms_mz.push_back(spec_trace_down.getFloatDataArrays()[fwhm_meta_idx][next_down_peak_idx]);
-                }
-                // Update the m/z mean of the current trace as we added a new peak
-                updateIterativeWeightedMeanMZ(next_down_peak_mz, next_down_peak_int, centroid_mz, prev_counter, prev_denom);
-                gathered_idx.emplace_back(trace_down_idx - 1, next_down_peak_idx);
+                fwhms_mz.push_back(spec_trace_down.getFloatDataArrays()[fwhm_meta_idx][next_down_peak_idx]);
+              }
+              // Update the m/z mean of the current trace as we added a new peak
+              updateIterativeWeightedMeanMZ(next_down_peak_mz, next_down_peak_int, centroid_mz, prev_counter, prev_denom);
+              gathered_idx.emplace_back(trace_down_idx - 1, next_down_peak_idx);
 
-                // Update the m/z variance dynamically
-                if (reestimate_mt_sd_)           //  && (down_hitting_peak+1 > min_flank_scans))
+              // Update the m/z variance dynamically
+              if (reestimate_mt_sd_)           //  && (down_hitting_peak+1 > min_flank_scans))
+              {
+                // if (ftl_t > min_fwhm_scans)
                 {
-                  // if (ftl_t > min_fwhm_scans)
-                  {
-                    updateWeightedSDEstimateRobust(next_peak, centroid_mz, ftl_sd, intensity_so_far);
-                  }
+                  updateWeightedSDEstimateRobust(next_peak, centroid_mz, ftl_sd, intensity_so_far);
                 }
-
-                ++down_hitting_peak;
-                conseq_missed_peak_down = 0;
-              }
-              else
-              {
-                ++conseq_missed_peak_down;
               }
 
+              ++down_hitting_peak;
+              conseq_missed_peak_down = 0;
             }
-            --trace_down_idx;
-            ++down_scan_counter;
+            else
+            {
+              ++conseq_missed_peak_down;
+            }
+
+          }
+          --trace_down_idx;
+          ++down_scan_counter;
 
-            // trace termination criterion: max allowed number of
-            // consecutive outliers reached OR cancel extension if
-            // sampling_rate falls below min_sample_rate_
-            if (trace_termination_criterion_ == "outlier")
+          // trace termination criterion: max allowed number of
+          // consecutive outliers reached OR cancel extension if
+          // sampling_rate falls below min_sample_rate_
+          if (trace_termination_criterion_ == "outlier")
+          {
+            if (conseq_missed_peak_down > max_consecutive_missing)
             {
-              if (conseq_missed_peak_down > max_consecutive_missing)
-              {
-                toggle_down = false;
-              }
+              toggle_down = false;
             }
-            else if (trace_termination_criterion_ == "sample_rate")
+          }
+          else if (trace_termination_criterion_ == "sample_rate")
+          {
+            current_sample_rate = (double)(down_hitting_peak + up_hitting_peak + 1) /
+                                  (double)(down_scan_counter + up_scan_counter + 1);
+            if (down_scan_counter > min_scans_to_consider && current_sample_rate < min_sample_rate_)
             {
-              current_sample_rate = (double)(down_hitting_peak + up_hitting_peak + 1) /
-                                    (double)(down_scan_counter + up_scan_counter + 1);
-              if (down_scan_counter > min_scans_to_consider && current_sample_rate < min_sample_rate_)
-              {
-                // std::cout << "stopping down..." << std::endl;
-                toggle_down = false;
-              }
+              // std::cout << "stopping down..." << std::endl;
+              toggle_down = false;
             }
           }
+        }
 
-          // *********************************************************** //
-          // Step 2.2 MOVE UP in RT dim
-          // *********************************************************** //
-          if ((trace_up_idx < work_exp.size() - 1) && toggle_up)
+        // *********************************************************** //
+        // Step 2.2 MOVE UP in RT dim
+        // *********************************************************** //
+        if ((trace_up_idx < work_exp.size() - 1) && toggle_up)
+        {
+          const MSSpectrum& spec_trace_up = work_exp[trace_up_idx + 1];
+          if (!spec_trace_up.empty())
           {
-            const MSSpectrum& spec_trace_up = work_exp[trace_up_idx + 1];
-            if (!spec_trace_up.empty())
-            {
-              Size next_up_peak_idx = spec_trace_up.findNearest(centroid_mz);
-              double next_up_peak_mz = spec_trace_up[next_up_peak_idx].getMZ();
-              double next_up_peak_int = spec_trace_up[next_up_peak_idx].getIntensity();
+            Size next_up_peak_idx = spec_trace_up.findNearest(centroid_mz);
+            double next_up_peak_mz = spec_trace_up[next_up_peak_idx].getMZ();
+            double next_up_peak_int = spec_trace_up[next_up_peak_idx].getIntensity();
 
-              double right_bound = centroid_mz + 3 * ftl_sd;
-              double left_bound = centroid_mz - 3 * ftl_sd;
+            double right_bound = centroid_mz + 3 * ftl_sd;
+            double left_bound = centroid_mz - 3 * ftl_sd;
 
-              if ((next_up_peak_mz <= right_bound) &&
-                  (next_up_peak_mz >= left_bound) &&
-                  !peak_visited[spec_offsets[trace_up_idx + 1] + next_up_peak_idx])
-              {
-                Peak2D next_peak;
-                next_peak.setRT(spec_trace_up.getRT());
-                next_peak.setMZ(next_up_peak_mz);
-                next_peak.setIntensity(next_up_peak_int);
+            if ((next_up_peak_mz <= right_bound) &&
+                (next_up_peak_mz >= left_bound) &&
+                !peak_visited[spec_offsets[trace_up_idx + 1] + next_up_peak_idx])
+            {
+              Peak2D next_peak;
+              next_peak.setRT(spec_trace_up.getRT());
+              next_peak.setMZ(next_up_peak_mz);
+              next_peak.setIntensity(next_up_peak_int);
 
-                current_trace.push_back(next_peak);
-                if (fwhm_meta_idx != -1)
-                {
-                  fwhms_mz.push_back(spec_trace_up.getFloatDataArrays()[fwhm_meta_idx][next_up_peak_idx]);
-                }
-                // Update the m/z mean of the current trace as we added a new peak
-                updateIterativeWeightedMeanMZ(next_up_peak_mz, next_up_peak_int, centroid_mz, prev_counter, prev_denom);
-                gathered_idx.emplace_back(trace_up_idx + 1, next_up_peak_idx);
+              current_trace.push_back(next_peak);
+              if (fwhm_meta_idx != -1)
+              {
+                fwhms_mz.push_back(spec_trace_up.getFloatDataArrays()[fwhm_meta_idx][next_up_peak_idx]);
+              }
+              // Update the m/z mean of the current trace as we added a new peak
+              updateIterativeWeightedMeanMZ(next_up_peak_mz, next_up_peak_int, centroid_mz, prev_counter, prev_denom);
+              gathered_idx.emplace_back(trace_up_idx + 1, next_up_peak_idx);
 
-                // Update the m/z variance dynamically
-                if (reestimate_mt_sd_)           //  && (up_hitting_peak+1 > min_flank_scans))
+              // Update the m/z variance dynamically
+              if (reestimate_mt_sd_)           //  && (up_hitting_peak+1 > min_flank_scans))
+              {
+                // if (ftl_t > min_fwhm_scans)
                 {
-                  // if (ftl_t > min_fwhm_scans)
-                  {
-                    updateWeightedSDEstimateRobust(next_peak, centroid_mz, ftl_sd, intensity_so_far);
-                  }
+                  updateWeightedSDEstimateRobust(next_peak, centroid_mz, ftl_sd, intensity_so_far);
                 }
-
-                ++up_hitting_peak;
-                conseq_missed_peak_up = 0;
-
               }
-              else
-              {
-                ++conseq_missed_peak_up;
-              }
-
-            }
 
-            ++trace_up_idx;
-            ++up_scan_counter;
+              ++up_hitting_peak;
+              conseq_missed_peak_up = 0;
 
-            if (trace_termination_criterion_ == "outlier")
-            {
-              if (conseq_missed_peak_up > max_consecutive_missing)
-              {
-                toggle_up = false;
-              }
             }
-            else if (trace_termination_criterion_ == "sample_rate")
+            else
             {
-              current_sample_rate = (double)(down_hitting_peak + up_hitting_peak + 1) / (double)(down_scan_counter + up_scan_counter + 1);
-
-              if (up_scan_counter > min_scans_to_consider && current_sample_rate < min_sample_rate_)
-              {
-                // std::cout << "stopping up" << std::endl;
-                toggle_up = false;
-              }
+              ++conseq_missed_peak_up;
             }
 
-
           }
 
-        }
-
-        // std::cout << "current sr: " << current_sample_rate << std::endl;
-        double num_scans(down_scan_counter + up_scan_counter + 1 - conseq_missed_peak_down - conseq_missed_peak_up);
+          ++trace_up_idx;
+          ++up_scan_counter;
 
-        double mt_quality((double)current_trace.size() / (double)num_scans);
-        // std::cout << "mt quality: " << mt_quality << std::endl;
-        double rt_range(std::fabs(current_trace.rbegin()->getRT() - current_trace.begin()->getRT()));
-
-        // *********************************************************** //
-        // Step 2.3 check if minimum length and quality of mass trace criteria are met
-        // *********************************************************** //
-        bool max_trace_criteria = (max_trace_length_ < 0.0 || rt_range < max_trace_length_);
-        if (rt_range >= min_trace_length_ && max_trace_criteria && mt_quality >= min_sample_rate_)
-        {
-          // std::cout << "T" << trace_number << "\t" << mt_quality << std::endl;
-
-          // mark all peaks as visited
-          for (Size i = 0; i < gathered_idx.size(); ++i)
+          if (trace_termination_criterion_ == "outlier")
           {
-            peak_visited[spec_offsets[gathered_idx[i].first] +  gathered_idx[i].second] = true;
+            if (conseq_missed_peak_up > max_consecutive_missing)
+            {
+              toggle_up = false;
+            }
           }
+          else if (trace_termination_criterion_ == "sample_rate")
+          {
+            current_sample_rate = (double)(down_hitting_peak + up_hitting_peak + 1) / (double)(down_scan_counter + up_scan_counter + 1);
 
-          // create new MassTrace object and store collected peaks from list current_trace
-          MassTrace new_trace(current_trace);
-          new_trace.updateWeightedMeanRT();
-          new_trace.updateWeightedMeanMZ();
-          if (!fwhms_mz.empty()) new_trace.fwhm_mz_avg = Math::median(fwhms_mz.begin(), fwhms_mz.end());
-          new_trace.setQuantMethod(quant_method_);
-          //new_trace.setCentroidSD(ftl_sd);
-          new_trace.updateWeightedMZsd();
-          new_trace.setLabel("T" + String(trace_number));
-          ++trace_number;
-
-          found_masstraces.push_back(new_trace);
+            if (up_scan_counter > min_scans_to_consider && current_sample_rate < min_sample_rate_)
+            {
+              // std::cout << "stopping up" << std::endl;
+              toggle_up = false;
+            }
+          }
 
-          peaks_detected += new_trace.getSize();
-          this->setProgress(peaks_detected);
 
-          // check if we already reached the (optional) maximum number of traces
-          if (max_traces > 0 && found_masstraces.size() == max_traces) break;
         }
+
       }
 
-      this->endProgress();
+      // std::cout << "current sr: " << current_sample_rate << std::endl;
+      double num_scans(down_scan_counter + up_scan_counter + 1 - conseq_missed_peak_down - conseq_missed_peak_up);
 
+      double mt_quality((double)current_trace.size() / (double)num_scans);
+      // std::cout << "mt quality: " << mt_quality << std::endl;
+      double rt_range(std::fabs(current_trace.rbegin()->getRT() - current_trace.begin()->getRT()));
+
+      // *********************************************************** //
+      // Step 2.3 check if minimum length and quality of mass trace criteria are met
+      // *********************************************************** //
+      candidate.gathered_idx.swap(gathered_idx);
+      bool max_trace_criteria = (max_trace_length_ < 0.0 || rt_range < max_trace_length_);
+      candidate.accepted = (rt_range >= min_trace_length_ && max_trace_criteria && mt_quality >= min_sample_rate_);
+      if (candidate.accepted)
+      {
+        // create new MassTrace object and store collected peaks from list current_trace
+        MassTrace& new_trace = candidate.trace;
+        new_trace = MassTrace(current_trace);
+        new_trace.updateWeightedMeanRT();
+        new_trace.updateWeightedMeanMZ();
+        if (!fwhms_mz.empty()) new_trace.fwhm_mz_avg = Math::median(fwhms_mz.begin(), fwhms_mz.end());
+        new_trace.setQuantMethod(quant_method_);
+        //new_trace.setCentroidSD(ftl_sd);
+        new_trace.updateWeightedMZsd();
+      }
+      return candidate.accepted;
     }
 
     void MassTraceDetection::updateMembers_()
@@ -35,6 +35,10 @@
 
 #include <OpenMS/FILTERING/TRANSFORMERS/SpectraMerger.h>
 
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
 using namespace std;
 namespace OpenMS
 {
@@ -90,6 +94,8 @@ namespace OpenMS
     defaults_.setMinFloat("precursor_method:mz_tolerance", 0);
     defaults_.setValue("precursor_method:rt_tolerance", 5.0, "Max RT distance of the precursor entries of two spectra to be merged in [s].");
     defaults_.setMinFloat("precursor_method:rt_tolerance", 0);
+    defaults_.setValue("precursor_method:linkage", "single", "Linkage for clustering precursors. 'single': merge all spectra connected by a chain of precursors within the tolerances. 'complete': only merge spectra if all their precursors are within the tolerances of each other.");
+    defaults_.setValidStrings("precursor_method:linkage", ListUtils::create<String>("single,complete"));
 
     defaultsToParam_();
   }
@@ -112,4 +118,141 @@ namespace OpenMS
     return *this;
   }
 
+  vector<vector<Size> > SpectraMerger::clusterPrecursors_(const vector<BaseFeature>& data, const SpectraDistance_& distance, bool complete_linkage) const
+  {
+    const Size n = data.size();
+    const double rt_tolerance = distance.getParameters().getValue("rt_tolerance");
+    const double mz_tolerance = distance.getParameters().getValue("mz_tolerance");
+
+    // grid cells are (slightly) larger than the tolerances, so all linkable precursors are found in the neighboring cells
+    const double rt_cell = rt_tolerance > 0 ? rt_tolerance * 1.0001 : 1.0;
+    const double mz_cell = mz_tolerance > 0 ? mz_tolerance * 1.0001 : 1.0;
+
+    typedef pair<Int64, Int64> GridCell; // (m/z cell, RT cell)
+    vector<pair<GridCell, Size> > grid;
+    grid.reserve(n);
+    for (Size i = 0; i < n; ++i)
+    {
+      grid.emplace_back(GridCell((Int64)floor(data[i].getMZ() / mz_cell), (Int64)floor(data[i].getRT() / rt_cell)), i);
+    }
+    sort(grid.begin(), grid.end());
+
+    // find linked pairs: a pair is linked if the hierarchical clustering would see a distance below 1
+    // (the distance matrix stores 1 - similarity as float)
+    vector<pair<Size, Size> > links;
+#pragma omp parallel
+    {
+      vector<pair<Size, Size> > links_local;
+#pragma omp for schedule(dynamic, 1000)
+      for (SignedSize g = 0; g < (SignedSize)n; ++g)
+      {
+        const GridCell& cell = grid[g].first;
+        const Size i = grid[g].second;
+        for (Int64 d_mz = -1; d_mz <= 1; ++d_mz)
+        {
+          for (Int64 d_rt = -1; d_rt <= 1; ++d_rt)
+          {
+            const GridCell neighbor(cell.first + d_mz, cell.second + d_rt);
+            auto it = lower_bound(grid.begin(), grid.end(), make_pair(neighbor, Size(0)));
+            for (; it != grid.end() && it->first == neighbor; ++it)
+            {
+              const Size j = it->second;
+              if (j <= i) continue; // each pair once
+              const float dist = 1 - distance(data[j], data[i]);
+              if (dist < 1) links_local.emplace_back(i, j);
+            }
+          }
+        }
+      }
+#pragma omp critical (SpectraMerger_links)
+      links.insert(links.end(), links_local.begin(), links_local.end());
+    }
+
+    // connected components (union-find)
+    vector<Size> parent(n);
+    iota(parent.begin(), parent.end(), 0);
+    auto find_root = [&parent](Size i)
+    {
+      while (parent[i] != i)
+      {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+      }
+      return i;
+    };
+    for (const auto& l : links)
+    {
+      Size a = find_root(l.first);
+      Size b = find_root(l.second);
+      if (a != b) parent[max(a, b)] = min(a, b);
+    }
+    links.clear();
+
+    // collect components (elements in ascending order, components ordered by their first element)
+    vector<vector<Size> > components;
+    vector<Size> component_of_root(n, n);
+    for (Size i = 0; i < n; ++i)
+    {
+      const Size root = find_root(i);
+      if (component_of_root[root] == n)
+      {
+        component_of_root[root] = components.size();
+        components.emplace_back();
+      }
+      components[component_of_root[root]].push_back(i);
+    }
+    components.erase(remove_if(components.begin(), components.end(), [](const vector<Size>& c) { return c.size() <= 1; }), components.end());
+
+    if (!complete_linkage) return components;
+
+    // complete linkage within each component
+    vector<vector<vector<Size> > > component_clusters(components.size());
+#pragma omp parallel for schedule(dynamic, 1)
+    for (SignedSize c = 0; c < (SignedSize)components.size(); ++c)
+    {
+      const vector<Size>& component = components[c];
+      vector<BaseFeature> component_data;
+      component_data.reserve(component.size());
+      for (Size i : component) component_data.push_back(data[i]);
+
+      vector<BinaryTreeNode> tree;
+      DistanceMatrix<float> dist; // will be filled
+      CompleteLinkage cl;
+      ClusterHierarchical ch;
+      // clustering ; threshold is implicitly at 1.0, i.e. distances of 1.0 (== similarity 0) will not be clustered
+      ch.cluster<BaseFeature, SpectraDistance_>(component_data, distance, cl, tree, dist);
+
+      // count number of real tree nodes (not the -1 ones):
+      Size node_count = 0;
+      for (Size ii = 0; ii < tree.size(); ++ii)
+      {
+        if (tree[ii].distance >= 1)
+        {
+          tree[ii].distance = -1;
+        }
+        if (tree[ii].distance != -1)
+        {
+          ++node_count;
+        }
+      }
+      vector<vector<Size> > clusters;
+      ClusterAnalyzer().cut(component.size() - node_count, tree, clusters);
+
+      for (const vector<Size>& cluster : clusters)
+      {
+        if (cluster.size() <= 1) continue;
+        vector<Size> mapped;
+        for (Size k : cluster) mapped.push_back(component[k]);
+        component_clusters[c].push_back(mapped);
+      }
+    }
+
+    vector<vector<Size> > clusters;
+    for (auto& cc : component_clusters)
+    {
+      for (auto& cluster : cc) clusters.push_back(std::move(cluster));
+    }
+    return clusters;
+  }
+
 }
@@ -82,47 +82,88 @@ namespace OpenMS
      /   = 47       ->       63
 
 
-  this can be done by first subtracting 43 from each value
-  and then looking up a value in a table as found in the code,
-  e.g. lookup[char - 43] - 62
-
-  The following string can be produced by this Python snippet:
-
-offset = 62
-s = ""
-s += chr(62 + offset)
-s += '$' * 3
-s += "".join([ chr(52 + i + offset) for i in range(10) ])
-s += '$' * 7
-s += "".join([ chr(i + offset) for i in range(26) ])
-s += '$' * 6
-s += "".join([ chr(26 + i + offset) for i in range(26) ])
-print s
-
-"|$$$rstuvwxyz{$$$$$$$>?@ABCDEFGHIJKLMNOPQRSTUVW$$$$$$XYZ[\]^_`abcdefghijklmnopq"
-
-  however, this is basically just convenience to produce printable characters.
-  We could also go for a direct mapping:
-
-s = '$' * 42
-s += hex(62)
-s += '$' * 3
-s += "".join([ hex(52 + i) for i in range(10) ])
-s += '$' * 7
-s += "".join([ hex(i) for i in range(26) ])
-s += '$' * 6
-s += "".join([ hex(26 + i) for i in range(26) ])
-print s
-
-"$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$0x3e$$$0x340x350x360x370x380x390x3a0x3b0x3c0x3d$$$$$$$0x00x10x20x30x40x50x60x70x80x90xa0xb0xc0xd0xe0xf0x100x110x120x130x140x150x160x170x180x19$$$$$$0x1a0x1b0x1c0x1d0x1e0x1f0x200x210x220x230x240x250x260x270x280x290x2a0x2b0x2c0x2d0x2e0x2f0x300x310x320x33"
-
-  which would allow lookup[char] without any adding or subtraction step (but
-  needs a 42 byte extra memory in the local cache).
+  this is done with a direct lookup table over all 256 byte values (see
+  DecoderTable_ below), which allows lookup[char] without any adding or
+  subtraction step. Characters outside of the base64 alphabet are marked
+  with the highest bit set, which allows to validate a whole input string
+  with a single check after decoding. The padding character '=' decodes to
+  zero.
 
   */
 
+  namespace
+  {
+    struct DecoderTable_
+    {
+      unsigned char values[256];
+
+      DecoderTable_()
+      {
+        const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::fill(values, values + 256, 0x80);
+        for (unsigned char i = 0; i < 64; ++i)
+        {
+          values[(unsigned char) alphabet[i]] = i;
+        }
+        values[(unsigned char) '='] = 0;
+      }
+    };
+
+    const DecoderTable_ decoder_table;
+  }
+
   const char Base64::encoder_[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-  const char Base64::decoder_[] = "|$$$}rstuvwxyz{$$$$$$$>?@ABCDEFGHIJKLMNOPQRSTUVW$$$$$$XYZ[\\]^_`abcdefghijklmnopq";
+
+  SignedSize Base64::decodeBase64_(const char* in, Size in_size, unsigned char* out)
+  {
+    const unsigned char* lookup = decoder_table.values;
+    unsigned char invalid = 0;
+    unsigned char* to = out;
+
+    // decode 4 Base64-Chars to 3 Byte, validity is only checked once at the end
+    for (Size i = 0; i < in_size; i += 4)
+    {
+      const unsigned char a = lookup[(unsigned char) in[i]];
+      const unsigned char b = lookup[(unsigned char) in[i + 1]];
+      const unsigned char c = lookup[(unsigned char) in[i + 2]];
+      const unsigned char d = lookup[(unsigned char) in[i + 3]];
+      invalid |= a | b | c | d;
+
+      *to++ = (unsigned char) ((a << 2) | (b >> 4));
+      *to++ = (unsigned char) ((b << 4) | (c >> 2));
+      *to++ = (unsigned char) ((c << 6) | d);
+    }
+
+    if (invalid & 0x80)
+    {
+      return -1;
+    }
+
+    // last one or two '=' are skipped if contained
+    SignedSize written = to - out;
+    if (in[in_size - 1] == '=') --written;
+    if (in[in_size - 2] == '=') --written;
+    return written;
+  }
+
+  void Base64::decodeBytes_(const String& in, String& out)
+  {
+    out.clear();
+    if (in.size() >= 4 && in.size() % 4 == 0)
+    {
+      out.resize(in.size() / 4 * 3);
+      SignedSize written = decodeBase64_(in.c_str(), in.size(), reinterpret_cast<unsigned char*>(&out[0]));
+      if (written >= 0)
+      {
+        out.resize(written);
+        return;
+      }
+    }
+
+    // fall back to the lenient Qt decoder (e.g. for line breaks in the input)
+    QByteArray decoded = QByteArray::fromBase64(QByteArray::fromRawData(in.c_str(), (int) in.size()));
+    out.assign(decoded.constData(), decoded.size());
+  }
 
   void Base64::encodeStrings(const std::vector<String>& in, String& out, bool zlib_compression, bool append_null_byte)
   {
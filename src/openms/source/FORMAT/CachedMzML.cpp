@@ -44,6 +44,9 @@
 
 #include <OpenMS/FORMAT/HANDLERS/CachedMzMLHandler.h>
 
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
 namespace OpenMS
 {
 
@@ -58,13 +61,13 @@ namespace OpenMS
 
   CachedmzML::~CachedmzML()
   {
-    ifs_.close();
   }
 
   CachedmzML::CachedmzML(const CachedmzML & rhs) :
     meta_ms_experiment_(rhs.meta_ms_experiment_),
-    ifs_(rhs.filename_cached_.c_str(), std::ios::binary),
+    mapped_region_(rhs.mapped_region_),
     filename_(rhs.filename_),
+    filename_cached_(rhs.filename_cached_),
     spectra_index_(rhs.spectra_index_),
     chrom_index_(rhs.chrom_index_)
   {
@@ -81,27 +84,48 @@ namespace OpenMS
     spectra_index_ = cache.getSpectraIndex();
     chrom_index_ = cache.getChromatogramIndex();;
 
-    // open the filestream
-    ifs_.open(filename_cached_.c_str(), std::ios::binary);
+    // map the file into memory (the mapping stays valid after the file handle is closed)
+    try
+    {
+      boost::interprocess::file_mapping file(filename_cached_.c_str(), boost::interprocess::read_only);
+      mapped_region_.reset(new boost::interprocess::mapped_region(file, boost::interprocess::read_only));
+    }
+    catch (boost::interprocess::interprocess_exception& e)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        String("Cannot map file into memory: ") + e.what(), filename_cached_);
+    }
 
     // load the meta data from disk
     MzMLFile().load(filename, meta_ms_experiment_);
   }
 
-  MSSpectrum CachedmzML::getSpectrum(Size id)
+  const char* CachedmzML::getMappedData_(std::streampos pos) const
   {
-    OPENMS_PRECONDITION(id < getNrSpectra(), "Id cannot be larger than number of spectra");
+    if (mapped_region_ == nullptr || static_cast<Size>(pos) >= mapped_region_->get_size())
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "Error while accessing position " + String(static_cast<Size>(pos)) + " of the cached file.", filename_cached_);
+    }
+    return static_cast<const char*>(mapped_region_->get_address()) + static_cast<std::streamoff>(pos);
+  }
 
-    if ( !ifs_.seekg(spectra_index_[id]) )
+  const char* CachedmzML::getMappedDataEnd_() const
+  {
+    if (mapped_region_ == nullptr)
     {
-      std::cerr << "Error while reading spectrum " << id << " - seekg created an error when trying to change position to " << spectra_index_[id] << "." << std::endl;
-      std::cerr << "Maybe an invalid position was supplied to seekg, this can happen for example when reading large files (>2GB) on 32bit systems." << std::endl;
       throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
-        "Error while changing position of input stream pointer.", filename_cached_);
+        "No cached file mapped into memory.", filename_cached_);
     }
+    return static_cast<const char*>(mapped_region_->get_address()) + mapped_region_->get_size();
+  }
+
+  MSSpectrum CachedmzML::getSpectrum(Size id)
+  {
+    OPENMS_PRECONDITION(id < getNrSpectra(), "Id cannot be larger than number of spectra");
 
     MSSpectrum s = meta_ms_experiment_.getSpectrum(id);
-    Internal::CachedMzMLHandler::readSpectrum(s, ifs_);
+    Internal::CachedMzMLHandler::readSpectrum(s, getMappedData_(spectra_index_[id]), getMappedDataEnd_());
     return s;
   }
 
@@ -109,16 +133,8 @@ namespace OpenMS
   {
     OPENMS_PRECONDITION(id < getNrChromatograms(), "Id cannot be larger than number of chromatograms");
 
-    if ( !ifs_.seekg(chrom_index_[id]) )
-    {
-      std::cerr << "Error while reading chromatogram " << id << " - seekg created an error when trying to change position to " << chrom_index_[id] << "." << std::endl;
-      std::cerr << "Maybe an invalid position was supplied to seekg, this can happen for example when reading large files (>2GB) on 32bit systems." << std::endl;
-      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
-        "Error while changing position of input stream pointer.", filename_cached_);
-    }
-
     MSChromatogram c = meta_ms_experiment_.getChromatogram(id);
-    Internal::CachedMzMLHandler::readChromatogram(c, ifs_);
+    Internal::CachedMzMLHandler::readChromatogram(c, getMappedData_(chrom_index_[id]), getMappedDataEnd_());
     return c;
   }
 
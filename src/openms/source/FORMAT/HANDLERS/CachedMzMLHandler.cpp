@@ -37,6 +37,8 @@
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/FORMAT/MzMLFile.h>
 
+#include <cstring>
+
 namespace OpenMS
 {
 namespace Internal
@@ -399,11 +401,144 @@ namespace Internal
     return data;
   }
 
+  namespace
+  {
+    /// throw if fewer than @p n bytes are left between @p pos and @p end
+    inline void checkRemaining_(const char* pos, const char* end, Size n)
+    {
+      if (pos > end || static_cast<Size>(end - pos) < n)
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Unexpected end of cached data (file truncated or corrupt?). Aborting.", "memory");
+      }
+    }
+
+    /// throw if fewer than @p count elements of size @p elem_size are left (without overflowing @p count * @p elem_size)
+    inline void checkRemaining_(const char* pos, const char* end, Size count, Size elem_size)
+    {
+      if (pos > end || count > static_cast<Size>(end - pos) / elem_size)
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Unexpected end of cached data (file truncated or corrupt?). Aborting.", "memory");
+      }
+    }
+
+    /// copy a value from (possibly unaligned) memory and advance the position
+    template <typename T>
+    inline void readFromMemory_(const char*& pos, const char* end, T& value)
+    {
+      checkRemaining_(pos, end, sizeof(T));
+      std::memcpy(&value, pos, sizeof(T));
+      pos += sizeof(T);
+    }
+  }
+
+  std::vector<OpenSwath::BinaryDataArrayPtr> CachedMzMLHandler::readSpectrumFast(const char* data, const char* end, int& ms_level, double& rt)
+  {
+    std::vector<OpenSwath::BinaryDataArrayPtr> result;
+    result.push_back(OpenSwath::BinaryDataArrayPtr(new OpenSwath::BinaryDataArray));
+    result.push_back(OpenSwath::BinaryDataArrayPtr(new OpenSwath::BinaryDataArray));
+
+    Size spec_size = -1;
+    Size nr_float_arrays = -1;
+    const char* pos = data;
+    readFromMemory_(pos, end, spec_size);
+    readFromMemory_(pos, end, nr_float_arrays);
+    readFromMemory_(pos, end, ms_level);
+    readFromMemory_(pos, end, rt);
+
+    if (static_cast<int>(spec_size) < 0)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
+        "Read an invalid spectrum length, something is wrong here. Aborting.", "memory");
+    }
+
+    readDataFast_(pos, end, result, spec_size, nr_float_arrays);
+    return result;
+  }
+
+  std::vector<OpenSwath::BinaryDataArrayPtr> CachedMzMLHandler::readChromatogramFast(const char* data, const char* end)
+  {
+    std::vector<OpenSwath::BinaryDataArrayPtr> result;
+    result.push_back(OpenSwath::BinaryDataArrayPtr(new OpenSwath::BinaryDataArray));
+    result.push_back(OpenSwath::BinaryDataArrayPtr(new OpenSwath::BinaryDataArray));
+
+    Size chrom_size = -1;
+    Size nr_float_arrays = -1;
+    const char* pos = data;
+    readFromMemory_(pos, end, chrom_size);
+    readFromMemory_(pos, end, nr_float_arrays);
+
+    if (static_cast<int>(chrom_size) < 0)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
+        "Read an invalid chromatogram length, something is wrong here. Aborting.", "memory");
+    }
+
+    readDataFast_(pos, end, result, chrom_size, nr_float_arrays);
+    return result;
+  }
+
+  void CachedMzMLHandler::readDataFast_(const char*& pos,
+                                        const char* end,
+                                        std::vector<OpenSwath::BinaryDataArrayPtr>& data,
+                                        const Size& data_size,
+                                        const Size& nr_float_arrays)
+  {
+    OPENMS_PRECONDITION(data.size() == 2, "Input data needs to have 2 slots.")
+
+    // check before resizing, a corrupt size would otherwise trigger a huge allocation
+    checkRemaining_(pos, end, data_size, 2 * sizeof(DatumSingleton));
+    data[0]->data.resize(data_size);
+    data[1]->data.resize(data_size);
+
+    if (data_size > 0)
+    {
+      std::memcpy(&(data[0]->data)[0], pos, data_size * sizeof(DatumSingleton));
+      pos += data_size * sizeof(DatumSingleton);
+      std::memcpy(&(data[1]->data)[0], pos, data_size * sizeof(DatumSingleton));
+      pos += data_size * sizeof(DatumSingleton);
+    }
+
+    for (Size k = 0; k < nr_float_arrays; k++)
+    {
+      data.push_back(OpenSwath::BinaryDataArrayPtr(new OpenSwath::BinaryDataArray));
+      Size len, len_name;
+      readFromMemory_(pos, end, len);
+      readFromMemory_(pos, end, len_name);
+
+      checkRemaining_(pos, end, len_name);
+      data.back()->description = std::string(pos, len_name);
+      pos += len_name;
+
+      checkRemaining_(pos, end, len, sizeof(DatumSingleton));
+      data.back()->data.resize(len);
+      if (len > 0)
+      {
+        std::memcpy(&(data.back()->data)[0], pos, len * sizeof(DatumSingleton));
+      }
+      pos += len * sizeof(DatumSingleton);
+    }
+  }
+
   void CachedMzMLHandler::readSpectrum(SpectrumType& spectrum, std::ifstream& ifs)
   {
     int ms_level;
     double rt;
     std::vector<OpenSwath::BinaryDataArrayPtr> data = readSpectrumFast(ifs, ms_level, rt);
+    fillSpectrum_(spectrum, data, ms_level, rt);
+  }
+
+  void CachedMzMLHandler::readSpectrum(SpectrumType& spectrum, const char* data, const char* end)
+  {
+    int ms_level;
+    double rt;
+    std::vector<OpenSwath::BinaryDataArrayPtr> arrays = readSpectrumFast(data, end, ms_level, rt);
+    fillSpectrum_(spectrum, arrays, ms_level, rt);
+  }
+
+  void CachedMzMLHandler::fillSpectrum_(SpectrumType& spectrum, const std::vector<OpenSwath::BinaryDataArrayPtr>& data, int ms_level, double rt)
+  {
     spectrum.reserve(data[0]->data.size());
     spectrum.setMSLevel(ms_level);
     spectrum.setRT(rt);
@@ -428,6 +563,17 @@ namespace Internal
   void CachedMzMLHandler::readChromatogram(ChromatogramType& chromatogram, std::ifstream& ifs)
   {
     std::vector<OpenSwath::BinaryDataArrayPtr> data = readChromatogramFast(ifs);
+    fillChromatogram_(chromatogram, data);
+  }
+
+  void CachedMzMLHandler::readChromatogram(ChromatogramType& chromatogram, const char* data, const char* end)
+  {
+    std::vector<OpenSwath::BinaryDataArrayPtr> arrays = readChromatogramFast(data, end);
+    fillChromatogram_(chromatogram, arrays);
+  }
+
+  void CachedMzMLHandler::fillChromatogram_(ChromatogramType& chromatogram, const std::vector<OpenSwath::BinaryDataArrayPtr>& data)
+  {
     chromatogram.reserve(data[0]->data.size());
 
     for (Size j = 0; j < data[0]->data.size(); j++)
@@ -443,7 +589,7 @@ namespace Internal
     {
       MSChromatogram::FloatDataArray fda;
       fda.reserve(data[j]->data.size());
-      for (const auto& k : fda) fda.push_back(k);
+      for (const auto& k : data[j]->data) fda.push_back(k);
       fda.setName(data[j]->description);
       fdas.push_back(fda);
     }
@@ -37,6 +37,9 @@
 #include <OpenMS/FORMAT/HANDLERS/IndexedMzMLDecoder.h>
 #include <OpenMS/FORMAT/HANDLERS/MzMLSpectrumDecoder.h>
 
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
 
 // #define DEBUG_READER
 
@@ -99,12 +102,13 @@ namespace Internal
   IndexedMzMLHandler::IndexedMzMLHandler(const IndexedMzMLHandler& source) :
     filename_(source.filename_),
     spectra_offsets_(source.spectra_offsets_),
+    spectra_native_ids_(source.spectra_native_ids_),
     chromatograms_offsets_(source.chromatograms_offsets_),
+    chromatograms_native_ids_(source.chromatograms_native_ids_),
     index_offset_(source.index_offset_),
     spectra_before_chroms_(source.spectra_before_chroms_),
-    // do not copy the filestream itself but open a new filestream using the same file
-    // this is critical for parallel access to the same file!
-    filestream_(source.filename_.c_str()),
+    // the read-only mapping is shared, reading from it does not modify any state
+    mapped_region_(source.mapped_region_),
     parsing_success_(source.parsing_success_),
     skip_xml_checks_(source.skip_xml_checks_)
   {
@@ -116,13 +120,25 @@ namespace Internal
 
   void IndexedMzMLHandler::openFile(String filename) 
   {
-    if (filestream_.is_open())
-    {
-      filestream_.close();
-    }
+    mapped_region_.reset();
+    spectra_offsets_.clear();
+    spectra_native_ids_.clear();
+    chromatograms_offsets_.clear();
+    chromatograms_native_ids_.clear();
     filename_ = filename;
-    filestream_.open(filename.c_str());
     parseFooter_(filename);
+    if (!parsing_success_) return;
+
+    try
+    {
+      boost::interprocess::file_mapping file(filename.c_str(), boost::interprocess::read_only);
+      mapped_region_.reset(new boost::interprocess::mapped_region(file, boost::interprocess::read_only));
+    }
+    catch (boost::interprocess::interprocess_exception& e)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        String("Cannot map file into memory: ") + e.what(), filename);
+    }
   }
 
   bool IndexedMzMLHandler::getParsingSuccess() const
@@ -140,7 +156,27 @@ namespace Internal
     return chromatograms_offsets_.size();
   }
 
-  std::string IndexedMzMLHandler::getChromatogramById_helper_(int id)
+  std::string IndexedMzMLHandler::getText_(std::streampos startidx, std::streampos endidx) const
+  {
+    if (mapped_region_ == nullptr || startidx < std::streampos(0) || endidx < startidx ||
+        static_cast<Size>(endidx) > mapped_region_->get_size())
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "Error while accessing position " + String(static_cast<Size>(startidx)) + " of the file.", filename_);
+    }
+
+    const char* data = static_cast<const char*>(mapped_region_->get_address());
+    std::string text(data + static_cast<std::streamoff>(startidx), static_cast<Size>(endidx - startidx));
+
+#ifdef DEBUG_READER
+    // print the full text we just read
+    std::cout << text << std::endl;
+#endif
+
+    return text;
+  }
+
+  std::string IndexedMzMLHandler::getChromatogramById_helper_(int id) const
   {
     int chromToGet = id;
 
@@ -184,23 +220,10 @@ namespace Internal
       endidx = chromatograms_offsets_[chromToGet + 1];
     }
 
-    std::streampos readl = endidx - startidx;
-    char* buffer = new char[readl + std::streampos(1)];
-    filestream_.seekg(startidx, filestream_.beg);
-    filestream_.read(buffer, readl);
-    buffer[readl] = '\0';
-    std::string text(buffer);
-    delete[] buffer;
-
-#ifdef DEBUG_READER
-    // print the full text we just read
-    std::cout << text << std::endl;
-#endif
-
-    return text;
+    return getText_(startidx, endidx);
   }
 
-  std::string IndexedMzMLHandler::getSpectrumById_helper_(int id)
+  std::string IndexedMzMLHandler::getSpectrumById_helper_(int id) const
   {
     int spectrumToGet = id;
 
@@ -244,23 +267,10 @@ namespace Internal
       endidx = spectra_offsets_[spectrumToGet + 1];
     }
 
-    std::streampos readl = endidx - startidx;
-    char* buffer = new char[readl + std::streampos(1)];
-    filestream_.seekg(startidx, filestream_.beg);
-    filestream_.read(buffer, readl);
-    buffer[readl] = '\0';
-    std::string text(buffer);
-    delete[] buffer;
-
-#ifdef DEBUG_READER
-    // print the full text we just read
-    std::cout << text << std::endl;
-#endif
-
-    return text;
+    return getText_(startidx, endidx);
   }
 
-  OpenMS::Interfaces::SpectrumPtr IndexedMzMLHandler::getSpectrumById(int id)
+  OpenMS::Interfaces::SpectrumPtr IndexedMzMLHandler::getSpectrumById(int id) const
   {
     OpenMS::Interfaces::SpectrumPtr sptr(new OpenMS::Interfaces::Spectrum);
     std::string text = IndexedMzMLHandler::getSpectrumById_helper_(id);
@@ -268,30 +278,77 @@ namespace Internal
     return sptr;
   }
 
-  const OpenMS::MSSpectrum IndexedMzMLHandler::getMSSpectrumById(int id)
+  const OpenMS::MSSpectrum IndexedMzMLHandler::getMSSpectrumById(int id) const
   {
     OpenMS::MSSpectrum s;
     getMSSpectrumById(id, s);
     return s;
   }
 
-  void IndexedMzMLHandler::getMSSpectrumByNativeId(std::string id, MSSpectrum& s)
+  void IndexedMzMLHandler::getMSSpectrumByNativeId(const std::string& id, MSSpectrum& s) const
   {
-    if (spectra_native_ids_.find(id) == spectra_native_ids_.end())
+    auto it = spectra_native_ids_.find(id);
+    if (it == spectra_native_ids_.end())
     {
       throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
           String( "Could not find spectrum id " + String(id) ));
     }
-    getMSSpectrumById(spectra_native_ids_[id], s);
+    getMSSpectrumById(it->second, s);
   }
 
-  void IndexedMzMLHandler::getMSSpectrumById(int id, MSSpectrum& s)
+  void IndexedMzMLHandler::getMSSpectrumById(int id, MSSpectrum& s) const
   {
     std::string text = IndexedMzMLHandler::getSpectrumById_helper_(id);
     MzMLSpectrumDecoder(skip_xml_checks_).domParseSpectrum(text, s);
   }
 
-  OpenMS::Interfaces::ChromatogramPtr IndexedMzMLHandler::getChromatogramById(int id)
+  void IndexedMzMLHandler::getMSSpectraById(const std::vector<int>& ids, std::vector<MSSpectrum>& spectra) const
+  {
+    // check all ids up front, we cannot throw from within the parallel region
+    for (int id : ids)
+    {
+      if (id < 0 || id >= (int)getNrSpectra())
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String( 
+              "id needs to be within [0, " + String(getNrSpectra()) + "), was " + String(id) ));
+      }
+    }
+    if (!parsing_success_)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
+          "Parsing was unsuccessful, cannot read file", "");
+    }
+    if (spectra.size() != ids.size())
+    {
+      spectra.resize(ids.size());
+    }
+
+    bool has_error = false;
+    String error_message;
+#pragma omp parallel for
+    for (SignedSize i = 0; i < (SignedSize)ids.size(); ++i)
+    {
+      try
+      {
+        getMSSpectrumById(ids[i], spectra[i]);
+      }
+      catch (Exception::BaseException& e)
+      {
+#pragma omp critical (IndexedMzMLHandler_getMSSpectraById)
+        {
+          has_error = true;
+          error_message = e.what();
+        }
+      }
+    }
+    if (has_error)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "Error while decoding spectra: " + error_message, filename_);
+    }
+  }
+
+  OpenMS::Interfaces::ChromatogramPtr IndexedMzMLHandler::getChromatogramById(int id) const
   {
     OpenMS::Interfaces::ChromatogramPtr cptr(new OpenMS::Interfaces::Chromatogram);
     std::string text = IndexedMzMLHandler::getChromatogramById_helper_(id);
@@ -299,25 +356,26 @@ namespace Internal
     return cptr;
   }
 
-  const OpenMS::MSChromatogram IndexedMzMLHandler::getMSChromatogramById(int id)
+  const OpenMS::MSChromatogram IndexedMzMLHandler::getMSChromatogramById(int id) const
   {
     OpenMS::MSChromatogram c;
     getMSChromatogramById(id, c);
     return c;
   }
 
-  void IndexedMzMLHandler::getMSChromatogramByNativeId(std::string id, OpenMS::MSChromatogram& c)
+  void IndexedMzMLHandler::getMSChromatogramByNativeId(const std::string& id, OpenMS::MSChromatogram& c) const
   {
-    if (chromatograms_native_ids_.find(id) == chromatograms_native_ids_.end())
+    auto it = chromatograms_native_ids_.find(id);
+    if (it == chromatograms_native_ids_.end())
     {
       throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
           String( "Could not find chromatogram id " + String(id) ));
     }
-    getMSChromatogramById(chromatograms_native_ids_[id], c);
+    getMSChromatogramById(it->second, c);
   }
   // const OpenMS::MSChromatogram IndexedMzMLHandler::getMSChromatogramById(int id)
 
-  void IndexedMzMLHandler::getMSChromatogramById(int id, MSChromatogram& c)
+  void IndexedMzMLHandler::getMSChromatogramById(int id, MSChromatogram& c) const
   {
     std::string text = IndexedMzMLHandler::getChromatogramById_helper_(id);
     MzMLSpectrumDecoder(skip_xml_checks_).domParseChromatogram(text, c);
@@ -44,10 +44,33 @@
 #include <OpenMS/INTERFACES/IMSDataConsumer.h>
 #include <OpenMS/SYSTEM/File.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
   namespace Internal
   {
+    namespace
+    {
+      /**
+        @brief Number of threads to decode a batch with, determined on the calling (parser) thread
+
+        OpenMP settings are per thread, so the background decoding task would
+        otherwise ignore the thread count set by the caller (e.g. TOPP -threads).
+        When parsing already happens inside a parallel region, the batch is
+        decoded by a single thread so the CPU is not oversubscribed.
+      */
+      int decodingThreads()
+      {
+#ifdef _OPENMP
+        return omp_in_parallel() ? 1 : omp_get_max_threads();
+#else
+        return 1;
+#endif
+      }
+    }
 
     /// Constructor for a read-only handler
     MzMLHandler::MzMLHandler(MapType& exp, const String& filename, const String& version, const ProgressLogger& logger)
@@ -140,29 +163,40 @@ namespace OpenMS
 
     void MzMLHandler::populateSpectraWithData_()
     {
+      // append the previous batch first to keep the order of the input
+      appendDecodedSpectra_();
+      if (spectrum_data_.empty()) return;
+
+      spectrum_data_decoding_.swap(spectrum_data_);
+      spectrum_data_.reserve(options_.getMaxDataPoolSize());
 
       // Whether spectrum should be populated with data
-      if (options_.getFillData())
+      if (!options_.getFillData()) return;
+
+      // decode the batch while the parser continues with the next one (only
+      // touches the batch itself and the read-only options)
+      const int threads = decodingThreads();
+      spectrum_decoding_ = std::async(std::launch::async, [this, threads]()
       {
         size_t errCount = 0;
         String error_message;
 #ifdef _OPENMP
-#pragma omp parallel for
+#pragma omp parallel for num_threads(threads)
 #endif
-        for (SignedSize i = 0; i < (SignedSize)spectrum_data_.size(); i++)
+        for (SignedSize i = 0; i < (SignedSize)spectrum_data_decoding_.size(); i++)
         {
           // parallel exception catching and re-throwing business
           if (!errCount) // no need to parse further if already an error was encountered
           {
             try
             {
-              populateSpectraWithData_(spectrum_data_[i].data,
-                                       spectrum_data_[i].default_array_length,
+              populateSpectraWithData_(spectrum_data_decoding_[i].data,
+                                       spectrum_data_decoding_[i].default_array_length,
                                        options_,
-                                       spectrum_data_[i].spectrum);
-              if (options_.getSortSpectraByMZ() && !spectrum_data_[i].spectrum.isSorted())
+                                       spectrum_data_decoding_[i].spectrum);
+              if (options_.getSortSpectraByMZ() && !spectrum_data_decoding_[i].spectrum.isSorted())
               {
-                spectrum_data_[i].spectrum.sortByPosition();
+                spectrum_data_decoding_[i].spectrum.sortByPosition();
               }
             }
 
@@ -187,51 +221,71 @@ namespace OpenMS
           std::cerr << "  You could try to disable sorting spectra while loading." << std::endl;
           throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, file_, "Error during parsing of binary data: '" + error_message + "'");
         }
+      });
+    }
+
+    void MzMLHandler::appendDecodedSpectra_()
+    {
+      if (spectrum_decoding_.valid())
+      {
+        spectrum_decoding_.get(); // re-throws errors from decoding
       }
 
       // Append all spectra to experiment / consumer
-      for (Size i = 0; i < spectrum_data_.size(); i++)
+      for (Size i = 0; i < spectrum_data_decoding_.size(); i++)
       {
         if (consumer_ != nullptr)
         {
-          consumer_->consumeSpectrum(spectrum_data_[i].spectrum);
+          consumer_->consumeSpectrum(spectrum_data_decoding_[i].spectrum);
           if (options_.getAlwaysAppendData())
           {
-            exp_->addSpectrum(std::move(spectrum_data_[i].spectrum));
+            exp_->addSpectrum(std::move(spectrum_data_decoding_[i].spectrum));
           }
         }
         else
         {
-          exp_->addSpectrum(std::move(spectrum_data_[i].spectrum));
+          exp_->addSpectrum(std::move(spectrum_data_decoding_[i].spectrum));
         }
       }
 
       // Delete batch
-      spectrum_data_.clear();
+      spectrum_data_decoding_.clear();
     }
 
     void MzMLHandler::populateChromatogramsWithData_()
     {
+      // append the previous batch first to keep the order of the input
+      appendDecodedChromatograms_();
+      if (chromatogram_data_.empty()) return;
+
+      chromatogram_data_decoding_.swap(chromatogram_data_);
+      chromatogram_data_.reserve(options_.getMaxDataPoolSize());
+
       // Whether chromatogram should be populated with data
-      if (options_.getFillData())
+      if (!options_.getFillData()) return;
+
+      // decode the batch while the parser continues with the next one (only
+      // touches the batch itself and the read-only options)
+      const int threads = decodingThreads();
+      chromatogram_decoding_ = std::async(std::launch::async, [this, threads]()
       {
         size_t errCount = 0;
         String error_message;
 #ifdef _OPENMP
-#pragma omp parallel for
+#pragma omp parallel for num_threads(threads)
 #endif
-        for (SignedSize i = 0; i < (SignedSize)chromatogram_data_.size(); i++)
+        for (SignedSize i = 0; i < (SignedSize)chromatogram_data_decoding_.size(); i++)
         {
           // parallel exception catching and re-throwing business
           try
           {
-            populateChromatogramsWithData_(chromatogram_data_[i].data,
-                                           chromatogram_data_[i].default_array_length,
+            populateChromatogramsWithData_(chromatogram_data_decoding_[i].data,
+                                           chromatogram_data_decoding_[i].default_array_length,
                                            options_,
-                                           chromatogram_data_[i].chromatogram);
-            if (options_.getSortChromatogramsByRT() && !chromatogram_data_[i].chromatogram.isSorted())
+                                           chromatogram_data_decoding_[i].chromatogram);
+            if (options_.getSortChromatogramsByRT() && !chromatogram_data_decoding_[i].chromatogram.isSorted())
             {
-              chromatogram_data_[i].chromatogram.sortByPosition();
+              chromatogram_data_decoding_[i].chromatogram.sortByPosition();
             }
           }
           catch (OpenMS::Exception::BaseException& e)
@@ -255,28 +309,35 @@ namespace OpenMS
           std::cerr << "  You could try to disable sorting spectra while loading." << std::endl;
           throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, file_, "Error during parsing of binary data: '" + error_message + "'");
         }
+      });
+    }
 
+    void MzMLHandler::appendDecodedChromatograms_()
+    {
+      if (chromatogram_decoding_.valid())
+      {
+        chromatogram_decoding_.get(); // re-throws errors from decoding
       }
 
       // Append all chromatograms to experiment / consumer
-      for (Size i = 0; i < chromatogram_data_.size(); i++)
+      for (Size i = 0; i < chromatogram_data_decoding_.size(); i++)
       {
         if (consumer_ != nullptr)
         {
-          consumer_->consumeChromatogram(chromatogram_data_[i].chromatogram);
+          consumer_->consumeChromatogram(chromatogram_data_decoding_[i].chromatogram);
           if (options_.getAlwaysAppendData())
           {
-            exp_->addChromatogram(std::move(chromatogram_data_[i].chromatogram));
+            exp_->addChromatogram(std::move(chromatogram_data_decoding_[i].chromatogram));
           }
         }
         else
         {
-          exp_->addChromatogram(std::move(chromatogram_data_[i].chromatogram));
+          exp_->addChromatogram(std::move(chromatogram_data_decoding_[i].chromatogram));
         }
       }
 
       // Delete batch
-      chromatogram_data_.clear();
+      chromatogram_data_decoding_.clear();
     }
 
     void MzMLHandler::addSpectrumMetaData_(const std::vector<MzMLHandlerHelper::BinaryData>& input_data,
@@ -1331,6 +1392,8 @@ namespace OpenMS
         // Flush the remaining data
         populateSpectraWithData_();
         populateChromatogramsWithData_();
+        appendDecodedSpectra_();
+        appendDecodedChromatograms_();
       }
     }
 
@@ -81,6 +81,52 @@ namespace OpenMS
       return tmp;
     }
 
+    /*
+     * @brief A single binary data row as read from the DATA table
+     */
+    struct SqlDataRow
+    {
+      Size container; ///< index in the containers vector
+      int compression; ///< compression of the blob
+      int data_type; ///< 0 = mz, 1 = int, 2 = rt
+      std::string blob; ///< raw (compressed) data
+      std::vector<double> data; ///< decoded data
+    };
+
+    /*
+     * @brief Decode the blob of a data row into its data vector
+     *
+     * compression is one of 0 = no, 1 = zlib, 2 = np-linear, 3 = np-slof, 4 =
+     * np-pic, 5 = np-linear + zlib, 6 = np-slof + zlib, 7 = np-pic + zlib
+     *
+     */
+    void decodeDataRow(SqlDataRow& row)
+    {
+      String stemp;
+      OpenMS::ZlibCompression::uncompressString(row.blob.data(), row.blob.size(), stemp);
+      if (row.compression == 1)
+      {
+        void* byte_buffer = reinterpret_cast<void *>(&stemp[0]);
+        Size buffer_size = stemp.size();
+        const double* float_buffer = reinterpret_cast<const double *>(byte_buffer);
+        if (buffer_size % sizeof(double) != 0)
+        {
+          throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Bad BufferCount?");
+        }
+        Size float_count = buffer_size / sizeof(double);
+        // copy values
+        row.data.assign(float_buffer, float_buffer + float_count);
+      }
+      else
+      {
+        MSNumpressCoder::NumpressConfig config;
+        config.setCompression(row.compression == 5 ? "linear" : "slof");
+        MSNumpressCoder().decodeNPRaw(stemp, row.data, config);
+      }
+      // the compressed data is not needed any more
+      std::string().swap(row.blob);
+    }
+
     /*
      *
      * This function populates a set of empty data containers (MSSpectrum or
@@ -97,140 +143,139 @@ namespace OpenMS
      * It is designed to work with containers of type MSSpectrum and
      * MSChromatogram to provide a single function for both use-cases.
      *
+     * Reading from SQLite is sequential, but the rows are collected in chunks
+     * and the (zlib / numpress) decoding of each chunk is done in parallel.
+     *
      */
     template<class ContainerT>
     void populateContainer_sub_(sqlite3_stmt *stmt, std::vector<ContainerT>& containers)
     {
+      // number of data rows which are decoded together
+      const Size chunk_size = 256;
+
       // perform first step
       sqlite3_step(stmt);
 
       std::vector<int> cont_data;
       cont_data.resize(containers.size());
       std::map<Size,Size> sql_container_map;
-      std::vector<double> data;
-      String stemp;
-      while (sqlite3_column_type( stmt, 0 ) != SQLITE_NULL)
+      std::vector<SqlDataRow> rows;
+      rows.reserve(chunk_size);
+      bool done = false;
+      while (!done)
       {
-        Size id_orig = sqlite3_column_int( stmt, 0 );
-
-        // map the sql table id to the index in the "containers" vector
-        if (sql_container_map.find(id_orig) == sql_container_map.end())
+        done = sqlite3_column_type( stmt, 0 ) == SQLITE_NULL;
+        if (!done)
         {
-          Size tmp = sql_container_map.size();
-          sql_container_map[id_orig] = tmp;
-        }
-        Size curr_id = sql_container_map[id_orig];
+          Size id_orig = sqlite3_column_int( stmt, 0 );
 
-        const unsigned char * native_id_ = sqlite3_column_text(stmt, 1);
-        std::string native_id(reinterpret_cast<const char*>(native_id_), sqlite3_column_bytes(stmt, 1));
-
-        if (curr_id >= containers.size())
-        {
-          throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
-              "Data for non-existent spectrum / chromatogram found");
-        }
-        if (native_id != containers[curr_id].getNativeID())
-        {
-          throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
-              String("Native id for spectrum / chromatogram does not match: ") + native_id + " != " +  containers[curr_id].getNativeID() );
-        }
-
-        int compression = sqlite3_column_int( stmt, 2 );
-        int data_type = sqlite3_column_int( stmt, 3 );
-
-        const void * raw_text = sqlite3_column_blob(stmt, 4);
-        size_t blob_bytes = sqlite3_column_bytes(stmt, 4);
+          // map the sql table id to the index in the "containers" vector
+          if (sql_container_map.find(id_orig) == sql_container_map.end())
+          {
+            Size tmp = sql_container_map.size();
+            sql_container_map[id_orig] = tmp;
+          }
+          Size curr_id = sql_container_map[id_orig];
 
-        // data_type is one of 0 = mz, 1 = int, 2 = rt
-        // compression is one of 0 = no, 1 = zlib, 2 = np-linear, 3 = np-slof, 4 = np-pic, 5 = np-linear + zlib, 6 = np-slof + zlib, 7 = np-pic + zlib
-        data.clear();
-        stemp.clear();
-        if (compression == 1)
-        {
-          OpenMS::ZlibCompression::uncompressString(raw_text, blob_bytes, stemp);
+          const unsigned char * native_id_ = sqlite3_column_text(stmt, 1);
+          std::string native_id(reinterpret_cast<const char*>(native_id_), sqlite3_column_bytes(stmt, 1));
 
-          void* byte_buffer = reinterpret_cast<void *>(&stemp[0]);
-          Size buffer_size = stemp.size();
-          const double* float_buffer = reinterpret_cast<const double *>(byte_buffer);
-          if (buffer_size % sizeof(double) != 0)
+          if (curr_id >= containers.size())
+          {
+            throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                "Data for non-existent spectrum / chromatogram found");
+          }
+          if (native_id != containers[curr_id].getNativeID())
           {
-            throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Bad BufferCount?");
+            throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
+                String("Native id for spectrum / chromatogram does not match: ") + native_id + " != " +  containers[curr_id].getNativeID() );
           }
-          Size float_count = buffer_size / sizeof(double);
-          // copy values
-          data.assign(float_buffer, float_buffer + float_count);
-        }
-        else if (compression == 5)
-        {
-          OpenMS::ZlibCompression::uncompressString(raw_text, blob_bytes, stemp);
-          MSNumpressCoder::NumpressConfig config;
-          config.setCompression("linear");
-          MSNumpressCoder().decodeNPRaw(stemp, data, config);
-        }
-        else if (compression == 6)
-        {
-          OpenMS::ZlibCompression::uncompressString(raw_text, blob_bytes, stemp);
-          MSNumpressCoder::NumpressConfig config;
-          config.setCompression("slof");
-          MSNumpressCoder().decodeNPRaw(stemp, data, config);
-        }
-        else
-        {
-          throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
-              "Compression not supported");
-        }
 
-        if (data_type == 1)
-        {
-          // intensity
-          if (containers[curr_id].empty()) containers[curr_id].resize(data.size());
-          std::vector< double >::iterator data_it = data.begin();
-          for (auto it = containers[curr_id].begin(); it != containers[curr_id].end(); ++it, ++data_it)
+          int compression = sqlite3_column_int( stmt, 2 );
+          int data_type = sqlite3_column_int( stmt, 3 );
+
+          // data_type is one of 0 = mz, 1 = int, 2 = rt
+          if (compression != 1 && compression != 5 && compression != 6)
           {
-            it->setIntensity(*data_it);
+            throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
+                "Compression not supported");
           }
-          cont_data[curr_id] += 1;
-        }
-        else if (data_type == 0)
-        {
-          // mz (should only occur in spectra)
-          if (boost::is_same<ContainerT, MSChromatogram>::value) 
+          if (data_type == 0 && boost::is_same<ContainerT, MSChromatogram>::value) 
           {
+            // mz (should only occur in spectra)
             throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
                 "Found m/z data type for chromatogram (instead of retention time)");
           }
-
-          if (containers[curr_id].empty()) containers[curr_id].resize(data.size());
-          std::vector< double >::iterator data_it = data.begin();
-          for (auto it = containers[curr_id].begin(); it != containers[curr_id].end(); ++it, ++data_it)
+          if (data_type == 2 && boost::is_same<ContainerT, MSSpectrum >::value) 
           {
-            it->setMZ(*data_it);
+            // rt (should only occur in chromatograms)
+            throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
+                "Found retention time data type for spectrum (instead of m/z)");
           }
-          cont_data[curr_id] += 1;
+          if (data_type < 0 || data_type > 2)
+          {
+            throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
+                "Found data type other than RT/Intensity for spectra");
+          }
+
+          // copy the blob, the pointer is only valid until the next step
+          const char * raw_text = static_cast<const char*>(sqlite3_column_blob(stmt, 4));
+          size_t blob_bytes = sqlite3_column_bytes(stmt, 4);
+          rows.push_back(SqlDataRow{curr_id, compression, data_type, std::string(raw_text, blob_bytes), {}});
+
+          sqlite3_step( stmt );
         }
-        else if (data_type == 2)
+
+        if (rows.size() < chunk_size && !done)
         {
-          // rt (should only occur in chromatograms)
-          if (boost::is_same<ContainerT, MSSpectrum >::value) 
+          continue;
+        }
+
+        // decode the current chunk in parallel
+        String error_message;
+#pragma omp parallel for
+        for (SignedSize k = 0; k < (SignedSize)rows.size(); ++k)
+        {
+          try
           {
-            throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
-                "Found retention time data type for spectrum (instead of m/z)");
+            decodeDataRow(rows[k]);
           }
-          if (containers[curr_id].empty()) containers[curr_id].resize(data.size());
-          std::vector< double >::iterator data_it = data.begin();
-          for (auto it = containers[curr_id].begin(); it != containers[curr_id].end(); ++it, ++data_it)
+          catch (Exception::BaseException& e)
           {
-            it->setMZ(*data_it);
+#pragma omp critical (MzMLSqliteHandler_decodeDataRow)
+            error_message = e.what();
           }
-          cont_data[curr_id] += 1;
         }
-        else
+        if (!error_message.empty())
         {
-          throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
-              "Found data type other than RT/Intensity for spectra");
+          throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+              "Error while decoding binary data: " + error_message);
         }
 
-        sqlite3_step( stmt );
+        for (SqlDataRow& row : rows)
+        {
+          ContainerT& container = containers[row.container];
+          if (container.empty()) container.resize(row.data.size());
+          std::vector< double >::const_iterator data_it = row.data.begin();
+          if (row.data_type == 1)
+          {
+            // intensity
+            for (auto it = container.begin(); it != container.end(); ++it, ++data_it)
+            {
+              it->setIntensity(*data_it);
+            }
+          }
+          else
+          {
+            // mz (spectra) or rt (chromatograms)
+            for (auto it = container.begin(); it != container.end(); ++it, ++data_it)
+            {
+              it->setMZ(*data_it);
+            }
+          }
+          cont_data[row.container] += 1;
+        }
+        rows.clear();
       }
 
       // ensure that all spectra/chromatograms have their data: we expect two data arrays per container (int and mz/rt)
@@ -442,13 +487,15 @@ namespace OpenMS
                           "SPECTRUM.ID as spec_id " \
                           "FROM SPECTRUM ";
 
+      // the retention times are bound as parameters (see below) so that they
+      // are used at full precision
       if (deltaRT > 0.0)
       {
-        select_sql += " WHERE RETENTION_TIME BETWEEN " + String(RT - deltaRT) + " AND " + String(RT + deltaRT);
+        select_sql += " WHERE RETENTION_TIME BETWEEN ?1 AND ?2";
       }
       else
       {
-        select_sql += " WHERE RETENTION_TIME >= " + String(RT);
+        select_sql += " WHERE RETENTION_TIME >= ?1";
       }
 
       // restrict by a given set of indices
@@ -463,6 +510,15 @@ namespace OpenMS
       // Execute SQL statement
       sqlite3_stmt * stmt;
       conn.prepareStatement(&stmt, select_sql);
+      if (deltaRT > 0.0)
+      {
+        sqlite3_bind_double(stmt, 1, RT - deltaRT);
+        sqlite3_bind_double(stmt, 2, RT + deltaRT);
+      }
+      else
+      {
+        sqlite3_bind_double(stmt, 1, RT);
+      }
       sqlite3_step(stmt);
 
       std::vector<size_t> result;
@@ -476,6 +532,30 @@ namespace OpenMS
       return result;
     }
 
+    std::vector<MzMLSqliteHandler::SpectrumRTEntry> MzMLSqliteHandler::getSpectraRTIndex() const
+    {
+      SqliteConnector conn(filename_);
+
+      sqlite3_stmt * stmt;
+      conn.prepareStatement(&stmt, "SELECT ID, NATIVE_ID, MSLEVEL, RETENTION_TIME FROM SPECTRUM ORDER BY ID;");
+      sqlite3_step(stmt);
+
+      std::vector<SpectrumRTEntry> result;
+      while (sqlite3_column_type(stmt, 0) != SQLITE_NULL)
+      {
+        SpectrumRTEntry entry;
+        entry.id = sqlite3_column_int(stmt, 0);
+        Sql::extractValue(&entry.native_id, stmt, 1);
+        if (sqlite3_column_type(stmt, 2) != SQLITE_NULL) entry.ms_level = sqlite3_column_int(stmt, 2);
+        if (sqlite3_column_type(stmt, 3) != SQLITE_NULL) entry.rt = sqlite3_column_double(stmt, 3);
+        result.push_back(entry);
+        sqlite3_step(stmt);
+      }
+      sqlite3_finalize(stmt);
+
+      return result;
+    }
+
     Size MzMLSqliteHandler::getNrChromatograms() const
     {
       SqliteConnector conn(filename_);
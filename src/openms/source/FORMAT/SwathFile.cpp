@@ -46,6 +46,7 @@
 #include <OpenMS/METADATA/ExperimentalSettings.h>
 #include <OpenMS/SYSTEM/File.h>
 
+#include <boost/make_shared.hpp>
 #include <memory> // for make_shared
 
 namespace OpenMS
@@ -272,19 +273,22 @@ namespace OpenMS
 
     OpenMS::Internal::MzMLSqliteSwathHandler sql_mass_reader(file);
     std::vector<OpenSwath::SwathMap> swath_maps = sql_mass_reader.readSwathWindows();
+
+    // read the spectrum meta data once, all maps share it
+    OpenMS::Internal::MzMLSqliteHandler handler(file, 0);
+    SpectrumAccessSqMass::SpectraRTIndexPtr spectra_rt =
+      boost::make_shared<const std::vector<Internal::MzMLSqliteHandler::SpectrumRTEntry> >(handler.getSpectraRTIndex());
     for (Size k = 0; k < swath_maps.size(); k++)
     {
       std::vector<int> indices = sql_mass_reader.readSpectraForWindow(swath_maps[k]);
-      OpenMS::Internal::MzMLSqliteHandler handler(file, 0);
-      OpenSwath::SpectrumAccessPtr sptr(new OpenMS::SpectrumAccessSqMass(handler, indices));
+      OpenSwath::SpectrumAccessPtr sptr(new OpenMS::SpectrumAccessSqMass(handler, indices, spectra_rt));
       swath_maps[k].sptr = sptr;
     }
 
     // also store the MS1 map
     OpenSwath::SwathMap ms1_map;
     std::vector<int> indices = sql_mass_reader.readMS1Spectra();
-    OpenMS::Internal::MzMLSqliteHandler handler(file, 0);
-    OpenSwath::SpectrumAccessPtr sptr(new OpenMS::SpectrumAccessSqMass(handler, indices));
+    OpenSwath::SpectrumAccessPtr sptr(new OpenMS::SpectrumAccessSqMass(handler, indices, spectra_rt));
     ms1_map.sptr = sptr;
     ms1_map.ms1 = true;
     swath_maps.push_back(ms1_map);
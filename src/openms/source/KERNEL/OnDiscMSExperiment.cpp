@@ -36,6 +36,8 @@
 
 #include <OpenMS/FORMAT/MzMLFile.h>
 
+#include <limits>
+
 namespace OpenMS
 {
 
@@ -48,27 +50,60 @@ namespace OpenMS
     options.setFillData(false);
     f.setOptions(options);
     f.load(filename, *meta_ms_experiment_.get());
+
+    // build the native id lookup eagerly so that later (concurrent) access is read-only
+    chromatograms_native_ids_.clear();
+    for (Size k = 0; k < meta_ms_experiment_->getChromatograms().size(); k++)
+    {
+      chromatograms_native_ids_.emplace(meta_ms_experiment_->getChromatograms()[k].getNativeID(), k);
+    }
+    spectra_native_ids_.clear();
+    for (Size k = 0; k < meta_ms_experiment_->getSpectra().size(); k++)
+    {
+      spectra_native_ids_.emplace(meta_ms_experiment_->getSpectra()[k].getNativeID(), k);
+    }
   }
 
-  MSChromatogram OnDiscMSExperiment::getMetaChromatogramById_(const std::string& id)
+  std::vector<MSSpectrum> OnDiscMSExperiment::getSpectra(const std::vector<Size>& ids) const
   {
-    if (chromatograms_native_ids_.empty())
+    // validate all indices up front (the indexed file addresses spectra by int)
+    const Size nr_spectra = getNrSpectra();
+    std::vector<int> int_ids;
+    int_ids.reserve(ids.size());
+    for (Size id : ids)
+    {
+      if (id >= nr_spectra || id > (Size)std::numeric_limits<int>::max())
+      {
+        throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, id, nr_spectra);
+      }
+      int_ids.push_back(int(id));
+    }
+
+    std::vector<MSSpectrum> spectra;
+    if (meta_ms_experiment_)
     {
-      for (Size k = 0; k < meta_ms_experiment_->getChromatograms().size(); k++)
+      spectra.reserve(ids.size());
+      for (Size id : ids)
       {
-        chromatograms_native_ids_.emplace(meta_ms_experiment_->getChromatograms()[k].getNativeID(), k);
+        spectra.push_back(meta_ms_experiment_->getSpectrum(id));
       }
     }
+    indexed_mzml_file_.getMSSpectraById(int_ids, spectra);
+    return spectra;
+  }
 
-    if (chromatograms_native_ids_.find(id) == chromatograms_native_ids_.end())
+  MSChromatogram OnDiscMSExperiment::getMetaChromatogramById_(const std::string& id) const
+  {
+    auto it = chromatograms_native_ids_.find(id);
+    if (it == chromatograms_native_ids_.end())
     {
       throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
           String("Could not find chromatogram with id '") + id + "'.");
     }
-    return meta_ms_experiment_->getChromatogram(chromatograms_native_ids_[id]);
+    return meta_ms_experiment_->getChromatogram(it->second);
   }
 
-  MSChromatogram OnDiscMSExperiment::getChromatogramByNativeId(const std::string& id)
+  MSChromatogram OnDiscMSExperiment::getChromatogramByNativeId(const std::string& id) const
   {
     if (!meta_ms_experiment_)
     {
@@ -82,25 +117,18 @@ namespace OpenMS
     return chromatogram;
   }
 
-  MSSpectrum OnDiscMSExperiment::getMetaSpectrumById_(const std::string& id)
+  MSSpectrum OnDiscMSExperiment::getMetaSpectrumById_(const std::string& id) const
   {
-    if (spectra_native_ids_.empty())
-    {
-      for (Size k = 0; k < meta_ms_experiment_->getSpectra().size(); k++)
-      {
-        spectra_native_ids_.emplace(meta_ms_experiment_->getSpectra()[k].getNativeID(), k);
-      }
-    }
-
-    if (spectra_native_ids_.find(id) == spectra_native_ids_.end())
+    auto it = spectra_native_ids_.find(id);
+    if (it == spectra_native_ids_.end())
     {
       throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
           String("Could not find spectrum with id '") + id + "'.");
     }
-    return meta_ms_experiment_->getSpectrum(spectra_native_ids_[id]);
+    return meta_ms_experiment_->getSpectrum(it->second);
   }
 
-  MSSpectrum OnDiscMSExperiment::getSpectrumByNativeId(const std::string& id)
+  MSSpectrum OnDiscMSExperiment::getSpectrumByNativeId(const std::string& id) const
   {
     if (!meta_ms_experiment_)
     {
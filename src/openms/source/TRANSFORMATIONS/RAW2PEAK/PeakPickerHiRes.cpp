@@ -41,6 +41,9 @@
 #include <OpenMS/MATH/MISC/SplineBisection.h>
 #include <OpenMS/MATH/MISC/CubicSpline2d.h>
 
+#include <exception>
+#include <limits>
+
 
 using namespace std;
 
@@ -426,14 +429,18 @@ namespace OpenMS
     Size progress = 0;
     startProgress(0, input.size() + input.getChromatograms().size(), "picking peaks");
 
-    // MSLevel -> stats
-    map<int, SpectraPickInfo> pick_info;
+    // spectra and chromatograms are independent and picked in parallel; the
+    // boundaries and statistics are collected in input order afterwards
+    std::vector<std::vector<PeakBoundary> > scan_boundaries(input.size());
+    std::vector<char> scan_picked(input.size(), false);
+    Size error_idx = std::numeric_limits<Size>::max();
+    std::exception_ptr error;
 
-    if (input.getNrSpectra() > 0)
+#pragma omp parallel for schedule(dynamic, 10)
+    for (SignedSize scan_idx = 0; scan_idx < (SignedSize)input.size(); ++scan_idx)
     {
-      for (Size scan_idx = 0; scan_idx != input.size(); ++scan_idx)
+      try
       {
-        bool was_picked{false};
         // auto mode
         if (ms_levels_.empty()) 
         {
@@ -444,10 +451,8 @@ namespace OpenMS
           }
           else
           {
-            std::vector<PeakBoundary> boundaries_s; // peak boundaries of a single spectrum
-            pick(input[scan_idx], output[scan_idx], boundaries_s);
-            was_picked = true;
-            boundaries_spec.push_back(std::move(boundaries_s));
+            pick(input[scan_idx], output[scan_idx], scan_boundaries[scan_idx]);
+            scan_picked[scan_idx] = true;
           }
         }
         // manual mode
@@ -457,33 +462,75 @@ namespace OpenMS
         }
         else
         {
-          std::vector<PeakBoundary> boundaries_s; // peak boundaries of a single spectrum
           SpectrumSettings::SpectrumType spectrum_type = input[scan_idx].getType(true); // uses meta-info and inspects data if needed
           if (spectrum_type == SpectrumSettings::CENTROID && check_spectrum_type)
           {
             throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, __FUNCTION__, "Error: Centroided data provided but profile spectra expected.");
           }
 
-          pick(input[scan_idx], output[scan_idx], boundaries_s);
-          was_picked = true;
-          boundaries_spec.push_back(std::move(boundaries_s));
+          pick(input[scan_idx], output[scan_idx], scan_boundaries[scan_idx]);
+          scan_picked[scan_idx] = true;
         }
-        pick_info[input[scan_idx].getMSLevel()].picked += was_picked;
-        ++pick_info[input[scan_idx].getMSLevel()].total;
-        setProgress(++progress);
       }
+      catch (...)
+      {
+        // report the error of the first failing spectrum, as in serial mode
+#pragma omp critical (PeakPickerHiRes_error)
+        if ((Size)scan_idx < error_idx)
+        {
+          error_idx = scan_idx;
+          error = std::current_exception();
+        }
+      }
+#pragma omp critical (PeakPickerHiRes_progress)
+      setProgress(++progress);
+    }
+    if (error) 
+    {
+      endProgress();
+      std::rethrow_exception(error);
     }
 
+    // MSLevel -> stats
+    map<int, SpectraPickInfo> pick_info;
+    for (Size scan_idx = 0; scan_idx != input.size(); ++scan_idx)
+    {
+      if (scan_picked[scan_idx])
+      {
+        boundaries_spec.push_back(std::move(scan_boundaries[scan_idx]));
+      }
+      pick_info[input[scan_idx].getMSLevel()].picked += scan_picked[scan_idx];
+      ++pick_info[input[scan_idx].getMSLevel()].total;
+    }
 
-    for (Size i = 0; i < input.getChromatograms().size(); ++i)
+    std::vector<std::vector<PeakBoundary> > chrom_boundaries(input.getChromatograms().size());
+    output.getChromatograms().resize(input.getChromatograms().size());
+#pragma omp parallel for schedule(dynamic, 10)
+    for (SignedSize i = 0; i < (SignedSize)input.getChromatograms().size(); ++i)
     {
-      MSChromatogram chromatogram;
-      std::vector<PeakBoundary> boundaries_c; // peak boundaries of a single chromatogram
-      pick(input.getChromatograms()[i], chromatogram, boundaries_c);
-      output.addChromatogram(chromatogram);
-      boundaries_chrom.push_back(boundaries_c);
+      try
+      {
+        pick(input.getChromatograms()[i], output.getChromatograms()[i], chrom_boundaries[i]);
+      }
+      catch (...)
+      {
+        // report the error of the first failing chromatogram, as in serial mode
+#pragma omp critical (PeakPickerHiRes_error)
+        if ((Size)i < error_idx)
+        {
+          error_idx = i;
+          error = std::current_exception();
+        }
+      }
+#pragma omp critical (PeakPickerHiRes_progress)
       setProgress(++progress);
     }
+    if (error)
+    {
+      endProgress();
+      std::rethrow_exception(error);
+    }
+    boundaries_chrom.insert(boundaries_chrom.end(), std::make_move_iterator(chrom_boundaries.begin()), std::make_move_iterator(chrom_boundaries.end()));
     endProgress();
 
     OPENMS_LOG_INFO << "Picked spectra by MS-level:\n";
@@ -509,33 +556,38 @@ namespace OpenMS
     // resize output with respect to input
     output.resize(input.size());
 
-    if (input.getNrSpectra() > 0)
+    // spectra are read (thread-safe) and picked in parallel
+    Size error_idx = std::numeric_limits<Size>::max();
+    std::exception_ptr error;
+#pragma omp parallel for schedule(dynamic, 10)
+    for (SignedSize scan_idx = 0; scan_idx < (SignedSize)input.size(); ++scan_idx)
     {
-      for (Size scan_idx = 0; scan_idx != input.size(); ++scan_idx)
+      try
       {
+        MSSpectrum s = input.getSpectrum(scan_idx);
         if (ms_levels_.empty()) //auto mode
         {
-          MSSpectrum s = input[scan_idx];
+          bool was_sorted = s.isSorted();
           s.sortByPosition();
 
           // determine type of spectral data (profile or centroided)
           SpectrumSettings::SpectrumType spectrumType = s.getType();
           if (spectrumType == SpectrumSettings::CENTROID)
           {
-            output[scan_idx] = input[scan_idx];
+            // keep centroided spectra unchanged
+            output[scan_idx] = was_sorted ? std::move(s) : input.getSpectrum(scan_idx);
           }
           else
           {
             pick(s, output[scan_idx]);
           }
         }
-        else if (!ListUtils::contains(ms_levels_, input[scan_idx].getMSLevel())) // manual mode
+        else if (!ListUtils::contains(ms_levels_, s.getMSLevel())) // manual mode
         {
-          output[scan_idx] = input[scan_idx];
+          output[scan_idx] = std::move(s);
         }
         else
         {
-          MSSpectrum s = input[scan_idx];
           s.sortByPosition();
 
           // determine type of spectral data (profile or centroided)
@@ -548,17 +600,52 @@ namespace OpenMS
 
           pick(s, output[scan_idx]);
         }
-        setProgress(++progress);
       }
+      catch (...)
+      {
+        // report the error of the first failing spectrum, as in serial mode
+#pragma omp critical (PeakPickerHiRes_error)
+        if ((Size)scan_idx < error_idx)
+        {
+          error_idx = scan_idx;
+          error = std::current_exception();
+        }
+      }
+#pragma omp critical (PeakPickerHiRes_progress)
+      setProgress(++progress);
+    }
+    if (error) 
+    {
+      endProgress();
+      std::rethrow_exception(error);
     }
 
-    for (Size i = 0; i < input.getNrChromatograms(); ++i)
+    output.getChromatograms().resize(input.getNrChromatograms());
+#pragma omp parallel for schedule(dynamic, 10)
+    for (SignedSize i = 0; i < (SignedSize)input.getNrChromatograms(); ++i)
     {
-      MSChromatogram chromatogram;
-      pick(input.getChromatogram(i), chromatogram);
-      output.addChromatogram(chromatogram);
+      try
+      {
+        pick(input.getChromatogram(i), output.getChromatograms()[i]);
+      }
+      catch (...)
+      {
+        // report the error of the first failing chromatogram, as in serial mode
+#pragma omp critical (PeakPickerHiRes_error)
+        if ((Size)i < error_idx)
+        {
+          error_idx = i;
+          error = std::current_exception();
+        }
+      }
+#pragma omp critical (PeakPickerHiRes_progress)
       setProgress(++progress);
     }
+    if (error)
+    {
+      endProgress();
+      std::rethrow_exception(error);
+    }
     endProgress();
 
     return;
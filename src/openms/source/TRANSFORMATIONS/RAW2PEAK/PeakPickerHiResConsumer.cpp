@@ -0,0 +1,195 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/TRANSFORMATIONS/RAW2PEAK/PeakPickerHiResConsumer.h>
+
+#include <OpenMS/CONCEPT/LogStream.h>
+#include <OpenMS/DATASTRUCTURES/ListUtils.h>
+
+#include <algorithm>
+#include <exception>
+#include <limits>
+
+namespace OpenMS
+{
+
+  PeakPickerHiResConsumer::PeakPickerHiResConsumer(const PeakPickerHiRes& pp, Interfaces::IMSDataConsumer* next_consumer, Size batch_size) :
+    pp_(pp),
+    next_consumer_(next_consumer),
+    batch_size_(std::max(batch_size, Size(1))),
+    ms_levels_(pp.getParameters().getValue("ms_levels").toIntList())
+  {
+    if (next_consumer_ == nullptr)
+    {
+      throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "PeakPickerHiResConsumer requires a consumer to pass on the picked data.");
+    }
+    spectra_.reserve(batch_size_);
+    chromatograms_.reserve(batch_size_);
+  }
+
+  PeakPickerHiResConsumer::~PeakPickerHiResConsumer()
+  {
+    // exceptions must not escape a destructor; call flush() explicitly to see them
+    try
+    {
+      flush();
+    }
+    catch (std::exception& e)
+    {
+      OPENMS_LOG_ERROR << "PeakPickerHiResConsumer: could not pass on remaining data: " << e.what() << std::endl;
+    }
+  }
+
+  void PeakPickerHiResConsumer::setExpectedSize(Size expectedSpectra, Size expectedChromatograms)
+  {
+    next_consumer_->setExpectedSize(expectedSpectra, expectedChromatograms);
+  }
+
+  void PeakPickerHiResConsumer::setExperimentalSettings(const ExperimentalSettings& exp)
+  {
+    next_consumer_->setExperimentalSettings(exp);
+  }
+
+  void PeakPickerHiResConsumer::consumeSpectrum(SpectrumType& s)
+  {
+    // keep the input order between spectra and chromatograms
+    flushChromatograms_();
+    spectra_.push_back(s);
+    if (spectra_.size() >= batch_size_) flushSpectra_();
+  }
+
+  void PeakPickerHiResConsumer::consumeChromatogram(ChromatogramType& c)
+  {
+    flushSpectra_();
+    chromatograms_.push_back(c);
+    if (chromatograms_.size() >= batch_size_) flushChromatograms_();
+  }
+
+  void PeakPickerHiResConsumer::flush()
+  {
+    flushSpectra_();
+    flushChromatograms_();
+  }
+
+  void PeakPickerHiResConsumer::flushSpectra_()
+  {
+    if (spectra_.empty()) return;
+
+    Size error_idx = std::numeric_limits<Size>::max();
+    std::exception_ptr error;
+
+#pragma omp parallel for schedule(dynamic, 1)
+    for (SignedSize i = 0; i < (SignedSize)spectra_.size(); ++i)
+    {
+      SpectrumType& s = spectra_[i];
+      try
+      {
+        if (ms_levels_.empty()) // auto mode
+        {
+          if (s.getType() == SpectrumSettings::CENTROID) continue;
+        }
+        else if (!ListUtils::contains(ms_levels_, s.getMSLevel()))
+        {
+          continue;
+        }
+
+        SpectrumType s_out;
+        pp_.pick(s, s_out);
+        s = std::move(s_out);
+      }
+      catch (...)
+      {
+#pragma omp critical (PeakPickerHiResConsumer_error)
+        if ((Size)i < error_idx)
+        {
+          error_idx = i;
+          error = std::current_exception();
+        }
+      }
+    }
+
+    if (error)
+    {
+      spectra_.clear();
+      std::rethrow_exception(error);
+    }
+
+    for (SpectrumType& s : spectra_)
+    {
+      next_consumer_->consumeSpectrum(s);
+    }
+    spectra_.clear();
+  }
+
+  void PeakPickerHiResConsumer::flushChromatograms_()
+  {
+    if (chromatograms_.empty()) return;
+
+    Size error_idx = std::numeric_limits<Size>::max();
+    std::exception_ptr error;
+
+#pragma omp parallel for schedule(dynamic, 1)
+    for (SignedSize i = 0; i < (SignedSize)chromatograms_.size(); ++i)
+    {
+      try
+      {
+        ChromatogramType c_out;
+        pp_.pick(chromatograms_[i], c_out);
+        chromatograms_[i] = std::move(c_out);
+      }
+      catch (...)
+      {
+#pragma omp critical (PeakPickerHiResConsumer_error)
+        if ((Size)i < error_idx)
+        {
+          error_idx = i;
+          error = std::current_exception();
+        }
+      }
+    }
+
+    if (error)
+    {
+      chromatograms_.clear();
+      std::rethrow_exception(error);
+    }
+
+    for (ChromatogramType& c : chromatograms_)
+    {
+      next_consumer_->consumeChromatogram(c);
+    }
+    chromatograms_.clear();
+  }
+
+} // namespace OpenMS
@@ -119,6 +119,13 @@ public:
     OPENSWATHALGO_DLLAPI XCorrArrayType normalizedCrossCorrelation(std::vector<double>& data1,
                                                                    std::vector<double>& data2, const int& maxdelay, const int& lag);
 
+    /// Calculate crosscorrelation on std::vector data that is already normalized
+    /// (see standardize_data), the result is identical to normalizedCrossCorrelation
+    /// on the raw data. Use this to normalize each array only once when computing
+    /// the crosscorrelation of many pairs.
+    OPENSWATHALGO_DLLAPI XCorrArrayType normalizedCrossCorrelationPost(const std::vector<double>& normalized_data1,
+                                                                       const std::vector<double>& normalized_data2, const int maxdelay, const int lag);
+
     /// Calculate crosscorrelation on std::vector data without normalization
     OPENSWATHALGO_DLLAPI XCorrArrayType calculateCrossCorrelation(const std::vector<double>& data1,
                                                                   const std::vector<double>& data2, const int& maxdelay, const int& lag);
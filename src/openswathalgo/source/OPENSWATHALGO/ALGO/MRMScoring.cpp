@@ -44,6 +44,76 @@
 namespace OpenSwath
 {
 
+  namespace
+  {
+    /// Standardize each array once so it can be reused for all pairwise cross-correlations
+    std::vector< std::vector< double > > standardizeAll_(const std::vector< std::vector< double > >& data)
+    {
+      std::vector< std::vector< double > > standardized(data);
+      for (std::size_t i = 0; i < standardized.size(); i++)
+      {
+        Scoring::standardize_data(standardized[i]);
+      }
+      return standardized;
+    }
+
+    /// Retrieve the (standardized) intensities of the fragment features with the given ids
+    std::vector< std::vector< double > > standardizedIntensities_(OpenSwath::IMRMFeature* mrmfeature, const std::vector<std::string>& native_ids)
+    {
+      std::vector< std::vector< double > > intensities(native_ids.size());
+      for (std::size_t i = 0; i < native_ids.size(); i++)
+      {
+        mrmfeature->getFeature(native_ids[i])->getIntensity(intensities[i]);
+        Scoring::standardize_data(intensities[i]);
+      }
+      return intensities;
+    }
+
+    /// Retrieve the (standardized) intensities of the precursor features with the given ids
+    std::vector< std::vector< double > > standardizedPrecursorIntensities_(OpenSwath::IMRMFeature* mrmfeature, const std::vector<std::string>& precursor_ids)
+    {
+      std::vector< std::vector< double > > intensities(precursor_ids.size());
+      for (std::size_t i = 0; i < precursor_ids.size(); i++)
+      {
+        mrmfeature->getPrecursorFeature(precursor_ids[i])->getIntensity(intensities[i]);
+        Scoring::standardize_data(intensities[i]);
+      }
+      return intensities;
+    }
+
+    /// Fill the upper triangle (including the diagonal) of the cross-correlation matrix of one set of arrays
+    void fillSymmetricXCorrMatrix_(const std::vector< std::vector< double > >& standardized, MRMScoring::XCorrMatrixType& xcorr_matrix)
+    {
+      xcorr_matrix.resize(standardized.size());
+      for (std::size_t i = 0; i < standardized.size(); i++)
+      {
+        xcorr_matrix[i].resize(standardized.size());
+        for (std::size_t j = i; j < standardized.size(); j++)
+        {
+          // compute normalized cross correlation
+          xcorr_matrix[i][j] = Scoring::normalizedCrossCorrelationPost(standardized[i], standardized[j], boost::numeric_cast<int>(standardized[i].size()), 1);
+        }
+      }
+    }
+
+    /// Fill the full cross-correlation matrix between two sets of arrays
+    void fillContrastXCorrMatrix_(const std::vector< std::vector< double > >& standardized1,
+                                  const std::vector< std::vector< double > >& standardized2,
+                                  MRMScoring::XCorrMatrixType& xcorr_matrix)
+    {
+      xcorr_matrix.resize(standardized1.size());
+      for (std::size_t i = 0; i < standardized1.size(); i++)
+      {
+        xcorr_matrix[i].resize(standardized2.size());
+        for (std::size_t j = 0; j < standardized2.size(); j++)
+        {
+          // compute normalized cross correlation
+          xcorr_matrix[i][j] = Scoring::normalizedCrossCorrelationPost(standardized1[i], standardized2[j], boost::numeric_cast<int>(standardized1[i].size()), 1);
+        }
+      }
+    }
+  }
+
   const MRMScoring::XCorrMatrixType& MRMScoring::getXCorrMatrix() const
   {
     return xcorr_matrix_;
@@ -51,18 +121,7 @@ namespace OpenSwath
 
   void MRMScoring::initializeXCorrMatrix(const std::vector< std::vector< double > >& data)
   {
-    xcorr_matrix_.resize(data.size());
-    for (std::size_t i = 0; i < data.size(); i++)
-    {
-      xcorr_matrix_[i].resize(data.size());
-      for (std::size_t j = i; j < data.size(); j++)
-      {
-        // compute normalized cross correlation
-        std::vector< double > tmp1(data[i]);
-        std::vector< double > tmp2(data[j]);
-        xcorr_matrix_[i][j] = Scoring::normalizedCrossCorrelation(tmp1, tmp2, boost::numeric_cast<int>(data[i].size()), 1);
-      }
-    }
+    fillSymmetricXCorrMatrix_(standardizeAll_(data), xcorr_matrix_);
   }
 
   const MRMScoring::XCorrMatrixType& MRMScoring::getXCorrContrastMatrix() const
@@ -82,147 +141,63 @@ namespace OpenSwath
 
   void MRMScoring::initializeXCorrMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& native_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    xcorr_matrix_.resize(native_ids.size());
-    for (std::size_t i = 0; i < native_ids.size(); i++)
-    {
-      String native_id = native_ids[i];
-      FeatureType fi = mrmfeature->getFeature(native_id);
-      xcorr_matrix_[i].resize(native_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = i; j < native_ids.size(); j++)
-      {
-        String native_id2 = native_ids[j];
-        FeatureType fj = mrmfeature->getFeature(native_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute normalized cross correlation
-        xcorr_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
-      }
-    }
+    fillSymmetricXCorrMatrix_(standardizedIntensities_(mrmfeature, native_ids), xcorr_matrix_);
   }
 
   void MRMScoring::initializeXCorrContrastMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& native_ids_set1, const std::vector<String>& native_ids_set2)
   {
-    std::vector<double> intensityi, intensityj;
-    xcorr_contrast_matrix_.resize(native_ids_set1.size());
-    for (std::size_t i = 0; i < native_ids_set1.size(); i++)
-    { 
-      String native_id = native_ids_set1[i];
-      FeatureType fi = mrmfeature->getFeature(native_id);
-      xcorr_contrast_matrix_[i].resize(native_ids_set2.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = 0; j < native_ids_set2.size(); j++)
-      {
-        String native_id2 = native_ids_set2[j];
-        FeatureType fj = mrmfeature->getFeature(native_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute normalized cross correlation
-        xcorr_contrast_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
-      }
-    }
+    fillContrastXCorrMatrix_(standardizedIntensities_(mrmfeature, native_ids_set1),
+                             standardizedIntensities_(mrmfeature, native_ids_set2),
+                             xcorr_contrast_matrix_);
   }
 
   void MRMScoring::initializeXCorrPrecursorMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    xcorr_precursor_matrix_.resize(precursor_ids.size());
-    for (std::size_t i = 0; i < precursor_ids.size(); i++)
-    {
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
-      xcorr_precursor_matrix_[i].resize(precursor_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = i; j < precursor_ids.size(); j++)
-      {
-        String precursor_id2 = precursor_ids[j];
-        FeatureType fj = mrmfeature->getPrecursorFeature(precursor_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute normalized cross correlation
-        xcorr_precursor_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
-      }
-    }
+    fillSymmetricXCorrMatrix_(standardizedPrecursorIntensities_(mrmfeature, precursor_ids), xcorr_precursor_matrix_);
   }
 
   void MRMScoring::initializeXCorrPrecursorContrastMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids, const std::vector<String>& native_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    xcorr_precursor_contrast_matrix_.resize(precursor_ids.size());
-    for (std::size_t i = 0; i < precursor_ids.size(); i++)
-    { 
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
-      xcorr_precursor_contrast_matrix_[i].resize(native_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = 0; j < native_ids.size(); j++)
-      {
-        String native_id = native_ids[j];
-        FeatureType fj = mrmfeature->getFeature(native_id);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute normalized cross correlation
-        xcorr_precursor_contrast_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
-      }
-    }
+    fillContrastXCorrMatrix_(standardizedPrecursorIntensities_(mrmfeature, precursor_ids),
+                             standardizedIntensities_(mrmfeature, native_ids),
+                             xcorr_precursor_contrast_matrix_);
   }
 
   void MRMScoring::initializeXCorrPrecursorContrastMatrix(const std::vector< std::vector< double > >& data_precursor, const std::vector< std::vector< double > >& data_fragments)
   {
-    xcorr_precursor_contrast_matrix_.resize(data_precursor.size());
-    for (std::size_t i = 0; i < data_precursor.size(); i++)
-    { 
-      xcorr_precursor_contrast_matrix_[i].resize(data_fragments.size());
-      for (std::size_t j = 0; j < data_fragments.size(); j++)
-      {
-        // compute normalized cross correlation
-        std::vector< double > tmp1(data_precursor[i]);
-        std::vector< double > tmp2(data_fragments[j]);
-        xcorr_precursor_contrast_matrix_[i][j] = Scoring::normalizedCrossCorrelation(tmp1, tmp2, boost::numeric_cast<int>(tmp1.size()), 1);
+    fillContrastXCorrMatrix_(standardizeAll_(data_precursor), standardizeAll_(data_fragments), xcorr_precursor_contrast_matrix_);
 #ifdef MRMSCORING_TESTING
-        std::cout << " fill xcorr_precursor_contrast_matrix_ "<< tmp1.size() << " / " << tmp2.size() << " : " << xcorr_precursor_contrast_matrix_[i][j].data.size() << std::endl;
-#endif
+    for (std::size_t i = 0; i < xcorr_precursor_contrast_matrix_.size(); i++)
+    {
+      for (std::size_t j = 0; j < xcorr_precursor_contrast_matrix_[i].size(); j++)
+      {
+        std::cout << " fill xcorr_precursor_contrast_matrix_ "<< data_precursor[i].size() << " / " << data_fragments[j].size() << " : " << xcorr_precursor_contrast_matrix_[i][j].data.size() << std::endl;
       }
     }
+#endif
   }
 
   void MRMScoring::initializeXCorrPrecursorCombinedMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids, const std::vector<String>& native_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    std::vector<FeatureType> features;
-
-    for (std::size_t i = 0; i < precursor_ids.size(); i++)
-    { 
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
-      features.push_back(fi);
-    }
-    for (std::size_t j = 0; j < native_ids.size(); j++)
-    {
-      String native_id = native_ids[j];
-      FeatureType fj = mrmfeature->getFeature(native_id);
-      features.push_back(fj);
-    }
-
-    xcorr_precursor_combined_matrix_.resize(features.size());
-    for (std::size_t i = 0; i < features.size(); i++)
-    { 
-      FeatureType fi = features[i];
-      xcorr_precursor_combined_matrix_[i].resize(features.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = 0; j < features.size(); j++)
-      {
-        FeatureType fj = features[j];
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute normalized cross correlation
-        xcorr_precursor_combined_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
+    std::vector< std::vector< double > > intensities = standardizedPrecursorIntensities_(mrmfeature, precursor_ids);
+    std::vector< std::vector< double > > fragment_intensities = standardizedIntensities_(mrmfeature, native_ids);
+    intensities.insert(intensities.end(), fragment_intensities.begin(), fragment_intensities.end());
+
+    // the cross-correlation of (j, i) at lag -d is exactly the one of (i, j)
+    // at lag d (same products summed in the same order), compute each pair once
+    fillSymmetricXCorrMatrix_(intensities, xcorr_precursor_combined_matrix_);
+    for (std::size_t i = 0; i < intensities.size(); i++)
+    {
+      for (std::size_t j = 0; j < i; j++)
+      {
+        const XCorrArrayType& mirror = xcorr_precursor_combined_matrix_[j][i];
+        XCorrArrayType& xcorr = xcorr_precursor_combined_matrix_[i][j];
+        xcorr.data.resize(mirror.data.size());
+        for (std::size_t k = 0; k < mirror.data.size(); k++)
+        {
+          const Scoring::XCorrEntry& entry = mirror.data[mirror.data.size() - 1 - k];
+          xcorr.data[k] = std::make_pair(-entry.first, entry.second);
+        }
       }
     }
   }
@@ -164,10 +164,16 @@ namespace OpenSwath
       // normalize the data
       standardize_data(data1);
       standardize_data(data2);
-      XCorrArrayType result = calculateCrossCorrelation(data1, data2, maxdelay, lag);
+      return normalizedCrossCorrelationPost(data1, data2, maxdelay, lag);
+    }
+
+    XCorrArrayType normalizedCrossCorrelationPost(const std::vector<double>& normalized_data1,
+                                                  const std::vector<double>& normalized_data2, const int maxdelay, const int lag)
+    {
+      XCorrArrayType result = calculateCrossCorrelation(normalized_data1, normalized_data2, maxdelay, lag);
       for (XCorrArrayType::iterator it = result.begin(); it != result.end(); ++it)
       {
-        it->second = it->second / data1.size();
+        it->second = it->second / normalized_data1.size();
       }
       return result;
     }
@@ -182,17 +188,18 @@ namespace OpenSwath
       int datasize = boost::numeric_cast<int>(data1.size());
       int i, j, delay;
 
+      const double* x = data1.data();
+      const double* y = data2.data();
       for (delay = -maxdelay; delay <= maxdelay; delay = delay + lag)
       {
+        // only the overlap 0 <= i < datasize and 0 <= i + delay < datasize
+        // contributes, restrict the loop to it instead of testing each i
+        const int start = std::max(0, -delay);
+        const int end = std::min(datasize, datasize - delay);
         double sxy = 0;
-        for (i = 0; i < datasize; ++i)
+        for (i = start, j = start + delay; i < end; ++i, ++j)
         {
-          j = i + delay;
-          if (j < 0 || j >= datasize)
-          {
-            continue;
-          }
-          sxy += (data1[i]) * (data2[j]);
+          sxy += x[i] * y[j];
         }
         result.data.push_back(std::make_pair(delay, sxy));
       }
@@ -14,4 +14,5 @@ cdef extern from "<OpenMS/ANALYSIS/OPENSWATH/OpenSwathOSWWriter.h>" namespace "O
         void writeHeader() nogil except +
         String prepareLine(LightCompound & compound, LightTransition * tr, FeatureMap & output, String id_) nogil except +
         void writeLines(libcpp_vector[ String ] to_osw_output) nogil except +
+        void flush() nogil except +
 
@@ -389,6 +389,7 @@ set(chemistry_executables_list
   AAIndex_test
   AASequence_test
   CoarseIsotopeDistribution_test
+  CompactAASequence_test
   CrossLinksDB_test
   DecoyGenerator_test
   DigestionEnzymeProtein_test
@@ -398,6 +399,7 @@ set(chemistry_executables_list
   EnzymaticDigestionLogModel_test
   EnzymaticDigestion_test
   FineIsotopeDistribution_test
+  FragmentIonLadder_test
   IMSAlphabetParser_test
   IMSAlphabetTextParser_test
   IMSAlphabet_test
@@ -481,6 +483,7 @@ set(analysis_executables_list
   FeatureHandle_test
   FIAMSDataProcessor_test
   FIAMSScheduler_test
+  FragmentIonIndex_test
   HiddenMarkovModel_test
   IDBoostGraph_test
   IDMapper_test
@@ -613,6 +616,7 @@ set(transformations_executables_list
   OptimizePick_test
   PeakPickerCWT_test
   PeakPickerHiRes_test
+  PeakPickerHiResConsumer_test
   PeakPickerIterative_test
   PeakPickerMaxima_test
   PeakPickerSH_test
@@ -685,6 +689,7 @@ if(NOT DISABLE_OPENSWATH)
     IonMobilityScoring_test
     CachedMzML_test
     CachedMzMLHandler_test
+    OpenSwathOSWWriter_test
     HDF5_test
   )
 endif(NOT DISABLE_OPENSWATH)
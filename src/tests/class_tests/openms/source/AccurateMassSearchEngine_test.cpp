@@ -51,6 +51,8 @@
 #include <OpenMS/KERNEL/MSSpectrum.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
 
+#include <fstream>
+
 ///////////////////////////
 
 using namespace OpenMS;
@@ -180,6 +182,36 @@ START_SECTION((void queryByMZ(const double& observed_mz, const Int& observed_cha
 }
 END_SECTION
 
+START_SECTION(([EXTRA] database entries with unparsable formulas))
+{
+  // copy of the test database with an additional entry at the mass of C17H11N5 whose formula cannot be parsed
+  String mapping_file;
+  NEW_TMP_FILE(mapping_file);
+  {
+    std::ifstream ifs(OPENMS_GET_TEST_DATA_PATH("reducedHMDBMapping.tsv"));
+    std::ofstream ofs(mapping_file.c_str());
+    ofs << ifs.rdbuf();
+    ofs << String(EmpiricalFormula("C17H11N5").getMonoWeight()) << "\tC17H11Xx5\tHMDB:HMDB99999\n";
+  }
+  Param ams_param_tmp = ams_param;
+  ams_param_tmp.setValue("db:mapping", ListUtils::create<String>(mapping_file));
+  ams_param_tmp.setValue("mass_error_value", 17.0);
+  AccurateMassSearchEngine ams_unparsable;
+  ams_unparsable.setParameters(ams_param_tmp);
+  ams_unparsable.init(); // does not throw, the entry is skipped with a warning
+
+  // same hits as with the original database
+  double mz = EmpiricalFormula("C17H11N5").getMonoWeight() + EmpiricalFormula("Na").getMonoWeight() - Constants::ELECTRON_MASS_U;
+  std::vector<AccurateMassSearchResult> results;
+  ams_unparsable.queryByMZ(mz, 1, "positive", results);
+  TEST_EQUAL(results.size(), 8)
+  for (const AccurateMassSearchResult& r : results)
+  {
+    TEST_NOT_EQUAL(r.getFormulaString(), "C17H11Xx5")
+  }
+}
+END_SECTION
+
 AccurateMassSearchEngine ams_feat_test;
 ams_feat_test.setParameters(ams_param);
 ams_feat_test.init();
@@ -184,14 +184,9 @@ START_SECTION((template < typename ToType > void decode(const String &in, ByteOr
   src = "whoPutMeHere:somecrazyperson,obviously!WhatifIcontaininvalidcharacterslikethese";
   TEST_EXCEPTION(Exception::ConversionError, b64.decode(src, Base64::BYTEORDER_BIGENDIAN, res) );
 
-  // TODO : some error checking and handling
-  // currently there is no "safe" Base64 decoding that checks that all
-  // characters are actually valid and the string is actually encoding to
-  // floats.
-  // 
-  // src = "Q A..A=="; // spaces and dots are not allowed
-  // b64.decode(src, Base64::BYTEORDER_BIGENDIAN, res);
-  // TEST_EQUAL(res.size(), 0)
+  src = "Q A..A=="; // spaces and dots are not allowed
+  TEST_EXCEPTION(Exception::ConversionError, b64.decode(src, Base64::BYTEORDER_BIGENDIAN, res) );
+  TEST_EQUAL(res.size(), 0)
 }
 END_SECTION
 
@@ -261,6 +256,33 @@ START_SECTION([EXTRA] zlib functionality)
   TEST_REAL_SIMILAR(data[0], 300.15f)
   TEST_REAL_SIMILAR(data[1], 303.998f)
   TEST_REAL_SIMILAR(data[2], 304.6f)  
+
+  // larger arrays are inflated in several steps
+  data_double.clear();
+  for (Size i = 0; i < 100000; ++i)
+  {
+    data_double.push_back(i * 0.5);
+  }
+  b64.encode(data_double, Base64::BYTEORDER_LITTLEENDIAN, str, true);
+  b64.decode(str, Base64::BYTEORDER_LITTLEENDIAN, res_double, true);
+  TEST_EQUAL(res_double.size(), 100000)
+  TEST_REAL_SIMILAR(res_double[1], 0.5)
+  TEST_REAL_SIMILAR(res_double[99999], 49999.5)
+
+  // line breaks in the base64 string are skipped
+  data.clear();
+  data.push_back(120.0f);
+  data.push_back(100.0f);
+  b64.encode(data, Base64::BYTEORDER_BIGENDIAN, str, true);
+  str = str.prefix(4) + "\n" + str.suffix(str.size() - 4);
+  b64.decode(str, Base64::BYTEORDER_BIGENDIAN, res, true);
+  TEST_EQUAL(res.size(), 2)
+  TEST_REAL_SIMILAR(res[0], 120)
+  TEST_REAL_SIMILAR(res[1], 100)
+
+  // corrupted compressed data
+  src = "JhOWQ8b/l0PMTJhD";
+  TEST_EXCEPTION(Exception::ConversionError, b64.decode(src, Base64::BYTEORDER_LITTLEENDIAN, res, true) );
 }
 END_SECTION
 
@@ -420,10 +442,17 @@ START_SECTION((template < typename ToType > void decodeIntegers(const String &in
   b64.decodeIntegers(src, Base64::BYTEORDER_BIGENDIAN,res,false);
   TEST_EQUAL(res.size(), 0)
 
-  // src = "Q A..A=="; // spaces and dots are not allowed
-  // b64.decodeIntegers(src, Base64::BYTEORDER_BIGENDIAN,res,false);
-  // TODO : some error checking and handling
-  // TEST_EQUAL(res.size(), 0)
+  src = "Q A..A=="; // spaces and dots are not allowed
+  TEST_EXCEPTION(Exception::ConversionError, b64.decodeIntegers(src, Base64::BYTEORDER_BIGENDIAN,res,false) );
+
+  // conversion to non-integer types
+  vector<double> converted_res;
+  src = "AAAAAAAAAAUAAAAAAAAAAwAAAAAAAAAJ";
+  b64.decodeIntegers(src, Base64::BYTEORDER_BIGENDIAN, converted_res, false);
+  TEST_EQUAL(converted_res.size(), 3)
+  TEST_REAL_SIMILAR(converted_res[0], 5)
+  TEST_REAL_SIMILAR(converted_res[1], 3)
+  TEST_REAL_SIMILAR(converted_res[2], 9)
 }
 END_SECTION
 
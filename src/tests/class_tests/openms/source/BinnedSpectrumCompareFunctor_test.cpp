@@ -38,6 +38,7 @@
 ///////////////////////////
 #include <OpenMS/COMPARISON/SPECTRA/BinnedSpectrumCompareFunctor.h>
 #include <OpenMS/CONCEPT/Factory.h>
+#include <OpenMS/FORMAT/DTAFile.h>
 
 using namespace OpenMS;
 using namespace std;
@@ -96,6 +97,70 @@ START_SECTION((static void registerChildren()))
 }
 END_SECTION
 
+// spectra with partially overlapping bins (low and high resolution binning)
+PeakSpectrum s1;
+DTAFile().load(OPENMS_GET_TEST_DATA_PATH("PILISSequenceDB_DFPIANGER_1.dta"), s1);
+vector<BinnedSpectrum> lowres, hires;
+for (Size i = 0; i != 5; ++i)
+{
+  PeakSpectrum s = s1;
+  s.resize(s.size() - 3 * i);
+  for (Size k = 0; k < s.size(); k += i + 1)
+  {
+    s[k].setIntensity(s[k].getIntensity() * (1.0 + 0.5 * i));
+    s[k].setMZ(s[k].getMZ() + 0.01 * i);
+  }
+  lowres.push_back(BinnedSpectrum(s, 1.5, false, 2, 0.0));
+  hires.push_back(BinnedSpectrum(s, BinnedSpectrum::DEFAULT_BIN_WIDTH_HIRES, false, 0, BinnedSpectrum::DEFAULT_BIN_OFFSET_HIRES));
+}
+
+START_SECTION((std::vector<double> compare(const BinnedSpectrum& spec, const std::vector<BinnedSpectrum>& specs) const))
+{
+  BinnedSpectrumCompareFunctor::registerChildren();
+  for (const String& name : Factory<BinnedSpectrumCompareFunctor>::registeredProducts())
+  {
+    BinnedSpectrumCompareFunctor* c = Factory<BinnedSpectrumCompareFunctor>::create(name);
+    for (const vector<BinnedSpectrum>* specs : {&lowres, &hires})
+    {
+      vector<double> scores = c->compare((*specs)[1], *specs);
+      TEST_EQUAL(scores.size(), specs->size())
+      for (Size j = 0; j != specs->size(); ++j)
+      {
+        TEST_REAL_SIMILAR(scores[j], (*c)((*specs)[1], (*specs)[j]))
+      }
+    }
+    TEST_EQUAL(c->compare(lowres[0], vector<BinnedSpectrum>()).empty(), true)
+    delete c;
+  }
+}
+END_SECTION
+
+START_SECTION((Matrix<double> compare(const std::vector<BinnedSpectrum>& specs1, const std::vector<BinnedSpectrum>& specs2) const))
+{
+  for (const String& name : Factory<BinnedSpectrumCompareFunctor>::registeredProducts())
+  {
+    BinnedSpectrumCompareFunctor* c = Factory<BinnedSpectrumCompareFunctor>::create(name);
+    for (const vector<BinnedSpectrum>* specs : {&lowres, &hires})
+    {
+      vector<BinnedSpectrum> specs1(specs->begin(), specs->begin() + 3);
+      Matrix<double> scores = c->compare(specs1, *specs);
+      TEST_EQUAL(scores.rows(), 3)
+      TEST_EQUAL(scores.cols(), specs->size())
+      for (Size i = 0; i != specs1.size(); ++i)
+      {
+        for (Size j = 0; j != specs->size(); ++j)
+        {
+          TEST_REAL_SIMILAR(scores(i, j), (*c)(specs1[i], (*specs)[j]))
+        }
+      }
+    }
+    Matrix<double> empty = c->compare(vector<BinnedSpectrum>(), lowres);
+    TEST_EQUAL(empty.rows(), 0)
+    delete c;
+  }
+}
+END_SECTION
+
 START_SECTION((static const String getProductName()))
 {
 	TEST_EQUAL(BinnedSpectrumCompareFunctor::getProductName(), "BinnedSpectrumCompareFunctor")
@@ -43,6 +43,10 @@
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/FORMAT/MzMLFile.h>
 
+#include <cstring>
+#include <iterator>
+#include <limits>
+
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wshadow"
 
@@ -412,6 +416,173 @@ START_SECTION( static inline void readChromatogramFast(OpenSwath::BinaryDataArra
 }
 END_SECTION
 
+START_SECTION(static std::vector<OpenSwath::BinaryDataArrayPtr> readSpectrumFast(const char* data, const char* end, int& ms_level, double& rt))
+{
+  // read the whole cached file into memory
+  std::ifstream ifs_(tmp_filename.c_str(), std::ios::binary);
+  std::string buffer((std::istreambuf_iterator<char>(ifs_)), std::istreambuf_iterator<char>());
+  const char* end = &buffer[0] + buffer.size();
+
+  std::vector<std::streampos> spectra_index = cache_.getSpectraIndex();
+  TEST_EQUAL(spectra_index.size(), 4)
+
+  int ms_level = -1;
+  double rt = -1.0;
+  std::vector<OpenSwath::BinaryDataArrayPtr> darray = CachedMzMLHandler::readSpectrumFast(&buffer[0] + static_cast<std::streamoff>(spectra_index[0]), end, ms_level, rt);
+  TEST_EQUAL(darray.size() >= 2, true)
+  TEST_EQUAL(darray[0]->data.size(), exp.getSpectrum(0).size())
+  TEST_EQUAL(darray[1]->data.size(), exp.getSpectrum(0).size())
+  TEST_EQUAL(ms_level, exp.getSpectrum(0).getMSLevel())
+  TEST_REAL_SIMILAR(rt, exp.getSpectrum(0).getRT())
+  for (Size i = 0; i < darray[0]->data.size(); i++)
+  {
+    TEST_REAL_SIMILAR(darray[0]->data[i], exp.getSpectrum(0)[i].getMZ())
+    TEST_REAL_SIMILAR(darray[1]->data[i], exp.getSpectrum(0)[i].getIntensity())
+  }
+
+  // meta data arrays
+  darray = CachedMzMLHandler::readSpectrumFast(&buffer[0] + static_cast<std::streamoff>(spectra_index[1]), end, ms_level, rt);
+  TEST_EQUAL(darray.size(), 4)
+  TEST_EQUAL(darray[2]->description, "signal to noise array")
+  TEST_EQUAL(darray[3]->description, "user-defined name")
+
+  // should not read beyond the end of the buffer (header, peak data and meta data arrays)
+  const char* spec1 = &buffer[0] + static_cast<std::streamoff>(spectra_index[1]);
+  TEST_EXCEPTION_WITH_MESSAGE(Exception::ParseError, CachedMzMLHandler::readSpectrumFast(spec1, spec1 + 10, ms_level, rt),
+    "memory in: Unexpected end of cached data (file truncated or corrupt?). Aborting.")
+  TEST_EXCEPTION_WITH_MESSAGE(Exception::ParseError, CachedMzMLHandler::readSpectrumFast(spec1, spec1 + 64, ms_level, rt),
+    "memory in: Unexpected end of cached data (file truncated or corrupt?). Aborting.")
+  const char* spec2 = &buffer[0] + static_cast<std::streamoff>(spectra_index[2]);
+  TEST_EXCEPTION_WITH_MESSAGE(Exception::ParseError, CachedMzMLHandler::readSpectrumFast(spec1, spec2 - 1, ms_level, rt),
+    "memory in: Unexpected end of cached data (file truncated or corrupt?). Aborting.")
+  darray = CachedMzMLHandler::readSpectrumFast(spec1, spec2, ms_level, rt);
+  TEST_EQUAL(darray.size(), 4)
+}
+END_SECTION
+
+START_SECTION(static std::vector<OpenSwath::BinaryDataArrayPtr> readChromatogramFast(const char* data, const char* end))
+{
+  // read the whole cached file into memory
+  std::ifstream ifs_(tmp_filename.c_str(), std::ios::binary);
+  std::string buffer((std::istreambuf_iterator<char>(ifs_)), std::istreambuf_iterator<char>());
+  const char* end = &buffer[0] + buffer.size();
+
+  std::vector<std::streampos> chrom_index = cache_.getChromatogramIndex();
+  TEST_EQUAL(chrom_index.size(), 2)
+
+  std::vector<OpenSwath::BinaryDataArrayPtr> darray = CachedMzMLHandler::readChromatogramFast(&buffer[0] + static_cast<std::streamoff>(chrom_index[0]), end);
+  TEST_EQUAL(darray.size() >= 2, true)
+  TEST_EQUAL(darray[0]->data.size(), exp.getChromatogram(0).size())
+  TEST_EQUAL(darray[1]->data.size(), exp.getChromatogram(0).size())
+  for (Size i = 0; i < darray[0]->data.size(); i++)
+  {
+    TEST_REAL_SIMILAR(darray[0]->data[i], exp.getChromatogram(0)[i].getRT())
+    TEST_REAL_SIMILAR(darray[1]->data[i], exp.getChromatogram(0)[i].getIntensity())
+  }
+
+  // should not read beyond the end of the buffer
+  const char* chrom1 = &buffer[0] + static_cast<std::streamoff>(chrom_index[1]);
+  TEST_EXCEPTION_WITH_MESSAGE(Exception::ParseError, CachedMzMLHandler::readChromatogramFast(chrom1, chrom1 + 4),
+    "memory in: Unexpected end of cached data (file truncated or corrupt?). Aborting.")
+  TEST_EXCEPTION_WITH_MESSAGE(Exception::ParseError, CachedMzMLHandler::readChromatogramFast(chrom1, chrom1 + 2 * sizeof(Size) + 8),
+    "memory in: Unexpected end of cached data (file truncated or corrupt?). Aborting.")
+
+  // a corrupt length must not lead to a huge allocation or a read past the end
+  std::string corrupt(buffer);
+  Size huge_size = std::numeric_limits<Size>::max() / 2;
+  std::memcpy(&corrupt[0] + static_cast<std::streamoff>(chrom_index[1]), &huge_size, sizeof(Size));
+  const char* corrupt_chrom1 = &corrupt[0] + static_cast<std::streamoff>(chrom_index[1]);
+  TEST_EXCEPTION_WITH_MESSAGE(Exception::ParseError, CachedMzMLHandler::readChromatogramFast(corrupt_chrom1, &corrupt[0] + corrupt.size()),
+    "memory in: Unexpected end of cached data (file truncated or corrupt?). Aborting.")
+}
+END_SECTION
+
+START_SECTION(static void readSpectrum(SpectrumType& spectrum, const char* data, const char* end))
+{
+  std::ifstream ifs_(tmp_filename.c_str(), std::ios::binary);
+  std::string buffer((std::istreambuf_iterator<char>(ifs_)), std::istreambuf_iterator<char>());
+  const char* end = &buffer[0] + buffer.size();
+
+  std::vector<std::streampos> spectra_index = cache_.getSpectraIndex();
+  const char* data = &buffer[0] + static_cast<std::streamoff>(spectra_index[1]);
+  MSSpectrum s;
+  CachedMzMLHandler::readSpectrum(s, data, end);
+  const MSSpectrum& scomp = exp.getSpectrum(1);
+  TEST_EQUAL(s.size(), scomp.size())
+  TEST_EQUAL(s.getMSLevel(), scomp.getMSLevel())
+  TEST_REAL_SIMILAR(s.getRT(), scomp.getRT())
+  TEST_EQUAL(s.getFloatDataArrays().size(), 2)
+  TEST_EQUAL(s.getFloatDataArrays()[0].getName(), "signal to noise array")
+  TEST_EQUAL(s.getFloatDataArrays()[0].size(), scomp.getFloatDataArrays()[0].size())
+  for (Size k = 0; k < s.getFloatDataArrays()[0].size(); k++)
+  {
+    TEST_REAL_SIMILAR(s.getFloatDataArrays()[0][k], scomp.getFloatDataArrays()[0][k])
+  }
+
+  MSSpectrum s_trunc;
+  TEST_EXCEPTION_WITH_MESSAGE(Exception::ParseError, CachedMzMLHandler::readSpectrum(s_trunc, data, data + 20),
+    "memory in: Unexpected end of cached data (file truncated or corrupt?). Aborting.")
+}
+END_SECTION
+
+START_SECTION(static void readChromatogram(ChromatogramType& chromatogram, const char* data, const char* end))
+{
+  // chromatogram with float data arrays (these were not restored from memory before)
+  PeakMap fda_exp;
+  MSChromatogram chrom;
+  for (Size i = 0; i < 5; ++i)
+  {
+    ChromatogramPeak p;
+    p.setRT(10.0 * i);
+    p.setIntensity(100.0 + i);
+    chrom.push_back(p);
+  }
+  chrom.getFloatDataArrays().resize(2);
+  chrom.getFloatDataArrays()[0].setName("first array");
+  chrom.getFloatDataArrays()[1].setName("second array");
+  for (Size i = 0; i < 5; ++i)
+  {
+    chrom.getFloatDataArrays()[0].push_back(0.5f * i);
+    chrom.getFloatDataArrays()[1].push_back(2.0f * i + 1.0f);
+  }
+  fda_exp.addChromatogram(chrom);
+
+  std::string fda_filename;
+  NEW_TMP_FILE(fda_filename);
+  CachedMzMLHandler fda_cache;
+  fda_cache.writeMemdump(fda_exp, fda_filename);
+  fda_cache.createMemdumpIndex(fda_filename);
+  TEST_EQUAL(fda_cache.getChromatogramIndex().size(), 1)
+
+  std::ifstream ifs_(fda_filename.c_str(), std::ios::binary);
+  std::string buffer((std::istreambuf_iterator<char>(ifs_)), std::istreambuf_iterator<char>());
+  const char* data = &buffer[0] + static_cast<std::streamoff>(fda_cache.getChromatogramIndex()[0]);
+  // the chromatogram is followed by the two element counts at the end of the file
+  const char* end = &buffer[0] + buffer.size() - 2 * sizeof(Size);
+
+  MSChromatogram c;
+  CachedMzMLHandler::readChromatogram(c, data, end);
+  TEST_EQUAL(c.size(), 5)
+  TEST_REAL_SIMILAR(c[4].getRT(), 40.0)
+  TEST_REAL_SIMILAR(c[4].getIntensity(), 104.0)
+  TEST_EQUAL(c.getFloatDataArrays().size(), 2)
+  TEST_EQUAL(c.getFloatDataArrays()[0].getName(), "first array")
+  TEST_EQUAL(c.getFloatDataArrays()[1].getName(), "second array")
+  TEST_EQUAL(c.getFloatDataArrays()[0].size(), 5)
+  TEST_EQUAL(c.getFloatDataArrays()[1].size(), 5)
+  for (Size i = 0; i < 5; ++i)
+  {
+    TEST_REAL_SIMILAR(c.getFloatDataArrays()[0][i], 0.5 * i)
+    TEST_REAL_SIMILAR(c.getFloatDataArrays()[1][i], 2.0 * i + 1.0)
+  }
+
+  // truncated within the last float data array
+  MSChromatogram c_trunc;
+  TEST_EXCEPTION_WITH_MESSAGE(Exception::ParseError, CachedMzMLHandler::readChromatogram(c_trunc, data, end - 1),
+    "memory in: Unexpected end of cached data (file truncated or corrupt?). Aborting.")
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -43,6 +43,9 @@
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/FORMAT/MzMLFile.h>
 
+#include <fstream>
+#include <iterator>
+
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wshadow"
 
@@ -180,6 +183,45 @@ START_SECTION(( [EXTRA] testCaching))
 }
 END_SECTION
 
+START_SECTION(( [EXTRA] truncated cached file))
+{
+  std::string tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+
+  PeakMap exp;
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("MzMLFile_1.mzML"), exp);
+  CachedmzML::store(tmp_filename, exp);
+
+  // cut 64 bytes from the data of the last chromatogram, keep the two element counts at the end
+  std::string cached = tmp_filename + ".cached";
+  std::string buffer;
+  {
+    std::ifstream ifs(cached.c_str(), std::ios::binary);
+    buffer.assign((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+  }
+  Size counts_size = 2 * sizeof(Size);
+  std::string truncated = buffer.substr(0, buffer.size() - counts_size - 64) + buffer.substr(buffer.size() - counts_size);
+  {
+    std::ofstream ofs(cached.c_str(), std::ios::binary | std::ios::trunc);
+    ofs.write(truncated.data(), truncated.size());
+  }
+
+  CachedmzML cache;
+  CachedmzML::load(tmp_filename, cache);
+  TEST_EQUAL(cache.getNrChromatograms(), 2)
+
+  // all other data is still accessible
+  for (Size i = 0; i < cache.getNrSpectra(); i++)
+  {
+    TEST_EQUAL(cache.getSpectrum(i).size(), exp.getSpectrum(i).size())
+  }
+  TEST_EQUAL(cache.getChromatogram(0).size(), exp.getChromatogram(0).size())
+
+  // the last chromatogram extends beyond the end of the mapped file
+  TEST_EXCEPTION(Exception::ParseError, cache.getChromatogram(1))
+}
+END_SECTION
+
 START_SECTION(( size_t getNrSpectra() const ))
     TEST_EQUAL(cache_example.getNrSpectra(), 4)
 END_SECTION
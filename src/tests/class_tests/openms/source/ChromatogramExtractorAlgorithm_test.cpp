@@ -136,6 +136,58 @@ START_SECTION(void extractChromatograms(const OpenSwath::SpectrumAccessPtr input
 }
 END_SECTION
 
+START_SECTION([EXTRA RT window] void extractChromatograms(const OpenSwath::SpectrumAccessPtr input, std::vector< OpenSwath::ChromatogramPtr > &output, std::vector< ExtractionCoordinates >& extraction_coordinates, double mz_extraction_window, bool ppm, String filter))
+{
+  // mix coordinates with and without RT window: the restricted chromatograms
+  // need to be exactly the corresponding part of the unrestricted ones
+  double extract_window = 0.05;
+  boost::shared_ptr<PeakMap > exp(new PeakMap);
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("ChromatogramExtractor_input.mzML"), *exp);
+  OpenSwath::SpectrumAccessPtr expptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp);
+
+  ChromatogramExtractorAlgorithm extractor;
+  std::vector< ChromatogramExtractorAlgorithm::ExtractionCoordinates > coordinates, coordinates_full;
+  std::vector< OpenSwath::ChromatogramPtr > out_exp, out_full;
+  for (int i = 0; i < 3; i++)
+  {
+    out_exp.push_back(OpenSwath::ChromatogramPtr(new OpenSwath::Chromatogram));
+    out_full.push_back(OpenSwath::ChromatogramPtr(new OpenSwath::Chromatogram));
+  }
+
+  ChromatogramExtractorAlgorithm::ExtractionCoordinates coord;
+  coord.mz = 618.31; coord.rt_start = 3050; coord.rt_end = 3130; coord.id = "tr1";
+  coordinates.push_back(coord);
+  coord.mz = 628.45; coord.rt_start = 0; coord.rt_end = -1; coord.id = "tr2";
+  coordinates.push_back(coord);
+  coord.mz = 654.38; coord.rt_start = 3100; coord.rt_end = 3110; coord.id = "tr3";
+  coordinates.push_back(coord);
+  coordinates_full = coordinates;
+  for (Size i = 0; i < coordinates_full.size(); i++) coordinates_full[i].rt_end = -1;
+
+  extractor.extractChromatograms(expptr, out_exp, coordinates, extract_window, false, -1, "tophat");
+  extractor.extractChromatograms(expptr, out_full, coordinates_full, extract_window, false, -1, "tophat");
+
+  TEST_EQUAL(out_full[0]->getTimeArray()->data.size(), 59);
+  TEST_EQUAL(out_exp[1]->getTimeArray()->data.size(), 59);
+  TEST_EQUAL(out_exp[0]->getTimeArray()->data.size(), 23);
+  TEST_EQUAL(out_exp[2]->getTimeArray()->data.size(), 3);
+  for (Size i = 0; i < coordinates.size(); i++)
+  {
+    std::vector<double> expected_rt, expected_int;
+    for (Size j = 0; j < out_full[i]->getTimeArray()->data.size(); j++)
+    {
+      double rt = out_full[i]->getTimeArray()->data[j];
+      if (coordinates[i].rt_end - coordinates[i].rt_start > 0 &&
+          (rt < coordinates[i].rt_start || rt > coordinates[i].rt_end)) continue;
+      expected_rt.push_back(rt);
+      expected_int.push_back(out_full[i]->getIntensityArray()->data[j]);
+    }
+    TEST_EQUAL(out_exp[i]->getTimeArray()->data == expected_rt, true)
+    TEST_EQUAL(out_exp[i]->getIntensityArray()->data == expected_int, true)
+  }
+}
+END_SECTION
+
 START_SECTION([EXTRA] void extractChromatograms(const OpenSwath::SpectrumAccessPtr input, std::vector< OpenSwath::ChromatogramPtr > &output, std::vector< ExtractionCoordinates >& extraction_coordinates, double mz_extraction_window, bool ppm, String filter))
 {
   typedef OpenMS::DataArrays::FloatDataArray FloatDataArray;
@@ -0,0 +1,232 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/CHEMISTRY/CompactAASequence.h>
+#include <OpenMS/CHEMISTRY/ResidueDB.h>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(CompactAASequence, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+CompactAASequence* ptr = nullptr;
+CompactAASequence* null_ptr = nullptr;
+START_SECTION(CompactAASequence())
+{
+  ptr = new CompactAASequence();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->size(), 0)
+  TEST_EQUAL(ptr->empty(), true)
+  TEST_EQUAL(ptr->getPrefixMasses().size(), 1)
+}
+END_SECTION
+
+START_SECTION(~CompactAASequence())
+{
+  delete ptr;
+}
+END_SECTION
+
+const AASequence seq = AASequence::fromString(".(Acetyl)PEPM(Oxidation)TIDEK.(Amidated)");
+const CompactAASequence compact(seq);
+
+START_SECTION(CompactAASequence(const AASequence& seq))
+{
+  TEST_EQUAL(compact.size(), seq.size())
+  TEST_EQUAL(compact.empty(), false)
+  TEST_EQUAL(compact.getNTerminalModification(), seq.getNTerminalModification())
+  TEST_EQUAL(compact.getCTerminalModification(), seq.getCTerminalModification())
+}
+END_SECTION
+
+START_SECTION(void assign(const AASequence& seq))
+{
+  CompactAASequence c(AASequence::fromString("PEPTIDEPEPTIDE"));
+  c.assign(seq);
+  TEST_EQUAL(c == compact, true)
+  TEST_EQUAL(c.getHash(), compact.getHash())
+  TEST_EQUAL(c.getPrefixMasses().size(), seq.size() + 1)
+  TEST_REAL_SIMILAR(c.getMonoWeight(), seq.getMonoWeight())
+}
+END_SECTION
+
+START_SECTION(AASequence toAASequence() const)
+{
+  TEST_EQUAL(compact.toAASequence(), seq)
+  TEST_EQUAL(CompactAASequence().toAASequence(), AASequence())
+}
+END_SECTION
+
+START_SECTION(Size size() const)
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(bool empty() const)
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(const std::vector<ResidueID>& getResidueIDs() const)
+{
+  const vector<CompactAASequence::ResidueID>& ids = compact.getResidueIDs();
+  TEST_EQUAL(ids.size(), seq.size())
+  TEST_EQUAL(ids[0], ids[2]) // both 'P'
+  TEST_NOT_EQUAL(ids[1], ids[2])
+}
+END_SECTION
+
+START_SECTION(const Residue& getResidue(Size index) const)
+{
+  for (Size i = 0; i < seq.size(); ++i)
+  {
+    TEST_EQUAL(&compact.getResidue(i), &seq[i])
+  }
+  TEST_EXCEPTION(Exception::IndexOverflow, compact.getResidue(seq.size()))
+}
+END_SECTION
+
+START_SECTION(const ResidueModification* getNTerminalModification() const)
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(const ResidueModification* getCTerminalModification() const)
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION(std::size_t getHash() const)
+{
+  TEST_EQUAL(compact.getHash(), CompactAASequence(AASequence::fromString(".(Acetyl)PEPM(Oxidation)TIDEK.(Amidated)")).getHash())
+  TEST_NOT_EQUAL(compact.getHash(), CompactAASequence(AASequence::fromString(".(Acetyl)PEPMTIDEK.(Amidated)")).getHash())
+  TEST_NOT_EQUAL(compact.getHash(), CompactAASequence(AASequence::fromString("PEPM(Oxidation)TIDEK.(Amidated)")).getHash())
+  TEST_EQUAL(std::hash<CompactAASequence>()(compact), compact.getHash())
+}
+END_SECTION
+
+START_SECTION(const std::vector<double>& getPrefixMasses() const)
+{
+  const vector<double>& masses = compact.getPrefixMasses();
+  TEST_EQUAL(masses.size(), seq.size() + 1)
+  TEST_REAL_SIMILAR(masses[0], 0.0)
+  TEST_REAL_SIMILAR(masses.back(), seq.getMonoWeight(Residue::Internal))
+}
+END_SECTION
+
+START_SECTION(double getMonoWeight(Residue::ResidueType type = Residue::Full, Int charge = 0) const)
+{
+  TEST_REAL_SIMILAR(compact.getMonoWeight(), seq.getMonoWeight())
+  TEST_REAL_SIMILAR(compact.getMonoWeight(Residue::Full, 2), seq.getMonoWeight(Residue::Full, 2))
+  TEST_REAL_SIMILAR(compact.getMonoWeight(Residue::Internal), seq.getMonoWeight(Residue::Internal))
+  TEST_REAL_SIMILAR(compact.getMonoWeight(Residue::BIon, 1), seq.getMonoWeight(Residue::BIon, 1))
+  TEST_REAL_SIMILAR(compact.getMonoWeight(Residue::YIon, 1), seq.getMonoWeight(Residue::YIon, 1))
+
+  CompactAASequence unknown(AASequence::fromString("PEPXIDE"));
+  TEST_EXCEPTION(Exception::InvalidValue, unknown.getMonoWeight())
+}
+END_SECTION
+
+START_SECTION(double getPrefixMonoWeight(Size length, Residue::ResidueType type = Residue::Full, Int charge = 0) const)
+{
+  TEST_REAL_SIMILAR(compact.getPrefixMonoWeight(0, Residue::BIon, 1), 0.0)
+  for (Size i = 1; i <= seq.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(compact.getPrefixMonoWeight(i, Residue::BIon, 1), seq.getPrefix(i).getMonoWeight(Residue::BIon, 1))
+    TEST_REAL_SIMILAR(compact.getPrefixMonoWeight(i, Residue::AIon, 2), seq.getPrefix(i).getMonoWeight(Residue::AIon, 2))
+    TEST_REAL_SIMILAR(compact.getPrefixMonoWeight(i, Residue::Full), seq.getPrefix(i).getMonoWeight(Residue::Full))
+  }
+  TEST_EXCEPTION(Exception::IndexOverflow, compact.getPrefixMonoWeight(seq.size() + 1))
+
+  CompactAASequence unknown(AASequence::fromString("PEPXIDE"));
+  TEST_REAL_SIMILAR(unknown.getPrefixMonoWeight(3, Residue::BIon, 1), AASequence::fromString("PEP").getMonoWeight(Residue::BIon, 1))
+  TEST_EXCEPTION(Exception::InvalidValue, unknown.getPrefixMonoWeight(4, Residue::BIon, 1))
+}
+END_SECTION
+
+START_SECTION(double getSuffixMonoWeight(Size length, Residue::ResidueType type = Residue::Full, Int charge = 0) const)
+{
+  TEST_REAL_SIMILAR(compact.getSuffixMonoWeight(0, Residue::YIon, 1), 0.0)
+  for (Size i = 1; i <= seq.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(compact.getSuffixMonoWeight(i, Residue::YIon, 1), seq.getSuffix(i).getMonoWeight(Residue::YIon, 1))
+    TEST_REAL_SIMILAR(compact.getSuffixMonoWeight(i, Residue::ZIon, 2), seq.getSuffix(i).getMonoWeight(Residue::ZIon, 2))
+    TEST_REAL_SIMILAR(compact.getSuffixMonoWeight(i, Residue::Full), seq.getSuffix(i).getMonoWeight(Residue::Full))
+  }
+  TEST_EXCEPTION(Exception::IndexOverflow, compact.getSuffixMonoWeight(seq.size() + 1))
+
+  CompactAASequence unknown(AASequence::fromString("PEPXIDE"));
+  TEST_REAL_SIMILAR(unknown.getSuffixMonoWeight(3, Residue::YIon, 1), AASequence::fromString("IDE").getMonoWeight(Residue::YIon, 1))
+  TEST_EXCEPTION(Exception::InvalidValue, unknown.getSuffixMonoWeight(4, Residue::YIon, 1))
+}
+END_SECTION
+
+START_SECTION(bool operator==(const CompactAASequence& rhs) const)
+{
+  TEST_EQUAL(compact == CompactAASequence(seq), true)
+  TEST_EQUAL(compact == CompactAASequence(AASequence::fromString("PEPTIDEK")), false)
+  TEST_EQUAL(CompactAASequence() == CompactAASequence(), true)
+}
+END_SECTION
+
+START_SECTION(bool operator!=(const CompactAASequence& rhs) const)
+{
+  TEST_EQUAL(compact != CompactAASequence(seq), false)
+  TEST_EQUAL(compact != CompactAASequence(AASequence::fromString("PEPTIDEK")), true)
+}
+END_SECTION
+
+START_SECTION(static ResidueID getResidueID(const Residue* residue))
+{
+  const Residue* r = ResidueDB::getInstance()->getResidue("W");
+  CompactAASequence::ResidueID id = CompactAASequence::getResidueID(r);
+  TEST_EQUAL(CompactAASequence::getResidueID(r), id)
+  TEST_EQUAL(CompactAASequence::getResidueByID(id), r)
+}
+END_SECTION
+
+START_SECTION(static const Residue* getResidueByID(ResidueID id))
+{
+  TEST_EQUAL(CompactAASequence::getResidueByID(compact.getResidueIDs()[3]), &seq[3])
+  TEST_EXCEPTION(Exception::IndexOverflow, CompactAASequence::getResidueByID(numeric_limits<CompactAASequence::ResidueID>::max()))
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -608,6 +608,22 @@ START_SECTION(([EXTRA] Check correct charge semantics))
   TEST_EQUAL(ef11.getCharge(), 3)
 END_SECTION
 
+START_SECTION(([EXTRA] Formulas with more elements than stored inline))
+  EmpiricalFormula ef1("C6H12O6N2S1P1Se1Fe1");
+  EmpiricalFormula ef2("C-6H-12O-6N-2S-1P-1Se-1Fe-1Cl2");
+  EmpiricalFormula sum = ef1 + ef2;
+  TEST_EQUAL(sum, EmpiricalFormula("Cl2"))
+  TEST_EQUAL(sum.getNumberOf(db->getElement("C")), 0)
+  TEST_EQUAL(sum.hasElement(db->getElement("Cl")), true)
+  TEST_EQUAL(sum.hasElement(db->getElement("Fe")), false)
+  TEST_EQUAL(ef1 - ef1, EmpiricalFormula())
+  TEST_EQUAL(ef1 * 2, EmpiricalFormula("C12H24O12N4S2P2Se2Fe2"))
+  EmpiricalFormula ef3("Fe1Se1P1S1N2O6H12C6"); // same formula, different order
+  TEST_EQUAL(ef1, ef3)
+  TEST_EQUAL(ef1.toString(), ef3.toString())
+  TEST_REAL_SIMILAR(ef1.getMonoWeight(), ef3.getMonoWeight())
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -0,0 +1,307 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/ID/FragmentIonIndex.h>
+///////////////////////////
+
+#include <OpenMS/CHEMISTRY/TheoreticalSpectrumGenerator.h>
+#include <OpenMS/KERNEL/MSSpectrum.h>
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(FragmentIonIndex, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+FragmentIonIndex* ptr = nullptr;
+FragmentIonIndex* null_ptr = nullptr;
+START_SECTION(FragmentIonIndex())
+{
+  ptr = new FragmentIonIndex();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->size(), 0)
+}
+END_SECTION
+
+START_SECTION(~FragmentIonIndex())
+{
+  delete ptr;
+}
+END_SECTION
+
+const ModifiedPeptideGenerator::MapToResidueType fixed_mods = ModifiedPeptideGenerator::getModifications(StringList());
+const ModifiedPeptideGenerator::MapToResidueType variable_mods = ModifiedPeptideGenerator::getModifications(ListUtils::create<String>("Oxidation (M)"));
+
+FragmentIonIndex index;
+index.build({"PEPTIDEK", "SAMPLER", "PEPTIDEK", "AMLNGR"}, fixed_mods, variable_mods, 2, 0.05);
+
+START_SECTION((void build(std::vector<String> sequences, const ModifiedPeptideGenerator::MapToResidueType& fixed_modifications, const ModifiedPeptideGenerator::MapToResidueType& variable_modifications, Size max_variable_mods_per_peptide, double bin_size)))
+{
+  // 3 unique sequences, 2 of them with and without oxidation
+  TEST_EQUAL(index.size(), 5)
+  TEST_REAL_SIMILAR(index.getBinSize(), 0.05)
+
+  FragmentIonIndex tmp;
+  TEST_EXCEPTION(Exception::InvalidParameter, tmp.build({"PEPTIDEK"}, fixed_mods, variable_mods, 2, 0.0))
+  TEST_EXCEPTION(Exception::InvalidParameter, tmp.build({"PEPTIDEK"}, fixed_mods, variable_mods, 2, numeric_limits<double>::quiet_NaN()))
+  TEST_EXCEPTION(Exception::InvalidParameter, tmp.build({"PEPTIDEK"}, fixed_mods, variable_mods, 2, numeric_limits<double>::infinity()))
+  // fragment bins would exceed the UInt32 range
+  TEST_EXCEPTION(Exception::InvalidParameter, tmp.build({"PEPTIDEK"}, fixed_mods, variable_mods, 2, 1e-8))
+}
+END_SECTION
+
+START_SECTION((const Peptide& getPeptide(Size index) const))
+{
+  for (Size i = 1; i < index.size(); ++i)
+  {
+    TEST_EQUAL(index.getPeptide(i - 1).mass <= index.getPeptide(i).mass, true)
+  }
+}
+END_SECTION
+
+START_SECTION((const String& getSequence(Size sequence_index) const))
+{
+  TEST_EQUAL(index.getSequence(0), "AMLNGR")
+  TEST_EQUAL(index.getSequence(1), "PEPTIDEK")
+  TEST_EQUAL(index.getSequence(2), "SAMPLER")
+}
+END_SECTION
+
+START_SECTION((AASequence getModifiedSequence(Size index, const ModifiedPeptideGenerator::MapToResidueType& fixed_modifications, const ModifiedPeptideGenerator::MapToResidueType& variable_modifications, Size max_variable_mods_per_peptide) const))
+{
+  Size n_oxidized = 0;
+  for (Size i = 0; i != index.size(); ++i)
+  {
+    AASequence seq = index.getModifiedSequence(i, fixed_mods, variable_mods, 2);
+    TEST_REAL_SIMILAR(seq.getMonoWeight(), index.getPeptide(i).mass)
+    TEST_EQUAL(seq.toUnmodifiedString(), index.getSequence(index.getPeptide(i).sequence_index))
+    if (seq.isModified()) ++n_oxidized;
+  }
+  TEST_EQUAL(n_oxidized, 2)
+}
+END_SECTION
+
+START_SECTION((std::pair<Size, Size> getPeptideRange(double min_mass, double max_mass) const))
+{
+  const double mass = AASequence::fromString("PEPTIDEK").getMonoWeight();
+  pair<Size, Size> range = index.getPeptideRange(mass - 0.01, mass + 0.01);
+  TEST_EQUAL(range.second - range.first, 1)
+  TEST_EQUAL(index.getSequence(index.getPeptide(range.first).sequence_index), "PEPTIDEK")
+
+  range = index.getPeptideRange(0.0, 1e6);
+  TEST_EQUAL(range.first, 0)
+  TEST_EQUAL(range.second, index.size())
+
+  range = index.getPeptideRange(1e5, 1e6);
+  TEST_EQUAL(range.first, range.second)
+}
+END_SECTION
+
+START_SECTION((void countSharedPeaks(const PeakSpectrum& spectrum, double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm, Size first, Size last, std::vector<UInt32>& counts) const))
+{
+  TheoreticalSpectrumGenerator tsg;
+  Param param = tsg.getParameters();
+  param.setValue("add_first_prefix_ion", "true");
+  tsg.setParameters(param);
+  PeakSpectrum spec;
+  tsg.getSpectrum(spec, AASequence::fromString("PEPTIDEK"), 1, 1);
+
+  vector<UInt32> counts;
+  index.countSharedPeaks(spec, 10.0, true, 0, index.size(), counts);
+  TEST_EQUAL(counts.size(), index.size())
+  for (Size i = 0; i != index.size(); ++i)
+  {
+    if (index.getSequence(index.getPeptide(i).sequence_index) == "PEPTIDEK")
+    {
+      // every peak is a fragment of PEPTIDEK
+      TEST_EQUAL(counts[i], spec.size())
+    }
+    else
+    {
+      TEST_EQUAL(counts[i] < spec.size(), true)
+    }
+  }
+
+  // sub range
+  vector<UInt32> sub_counts;
+  index.countSharedPeaks(spec, 0.02, false, 1, 3, sub_counts);
+  TEST_EQUAL(sub_counts.size(), 2)
+
+  // empty range
+  index.countSharedPeaks(spec, 10.0, true, 2, 2, counts);
+  TEST_EQUAL(counts.size(), 0)
+}
+END_SECTION
+
+START_SECTION((void setSettings(const String& settings)))
+{
+  index.setSettings("bin_size=0.05");
+  TEST_EQUAL(index.getSettings(), "bin_size=0.05")
+}
+END_SECTION
+
+START_SECTION((const String& getSettings() const))
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION((double getBinSize() const))
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION((Size size() const))
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION((void store(const String& filename) const))
+{
+  String tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  index.store(tmp_filename);
+
+  FragmentIonIndex loaded;
+  loaded.load(tmp_filename);
+  TEST_EQUAL(loaded.size(), index.size())
+  TEST_EQUAL(loaded.getSettings(), index.getSettings())
+  TEST_REAL_SIMILAR(loaded.getBinSize(), index.getBinSize())
+  for (Size i = 0; i != index.size(); ++i)
+  {
+    TEST_EQUAL(loaded.getPeptide(i).sequence_index, index.getPeptide(i).sequence_index)
+    TEST_EQUAL(loaded.getPeptide(i).modification_index, index.getPeptide(i).modification_index)
+    TEST_REAL_SIMILAR(loaded.getPeptide(i).mass, index.getPeptide(i).mass)
+  }
+  TEST_EQUAL(loaded.getSequence(1), "PEPTIDEK")
+
+  TheoreticalSpectrumGenerator tsg;
+  PeakSpectrum spec;
+  tsg.getSpectrum(spec, AASequence::fromString("SAMPLER"), 1, 1);
+  vector<UInt32> counts, loaded_counts;
+  index.countSharedPeaks(spec, 0.02, false, 0, index.size(), counts);
+  loaded.countSharedPeaks(spec, 0.02, false, 0, loaded.size(), loaded_counts);
+  TEST_EQUAL(loaded_counts == counts, true)
+}
+END_SECTION
+
+START_SECTION((void load(const String& filename)))
+{
+  FragmentIonIndex loaded;
+  TEST_EXCEPTION(Exception::FileNotFound, loaded.load("this_file_does_not_exist.bin"))
+  TEST_EXCEPTION(Exception::ParseError, loaded.load(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta")))
+
+  // corrupt copies of a valid index file
+  String tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  index.store(tmp_filename);
+  string buffer;
+  {
+    ifstream ifs(tmp_filename.c_str(), std::ios::binary);
+    buffer.assign((istreambuf_iterator<char>(ifs)), istreambuf_iterator<char>());
+  }
+  String corrupt_filename;
+  NEW_TMP_FILE(corrupt_filename);
+  auto loadCorrupt = [&](Size pos, const void* value, Size size)
+  {
+    string corrupt = buffer;
+    memcpy(&corrupt[pos], value, size);
+    ofstream ofs(corrupt_filename.c_str(), std::ios::binary);
+    ofs.write(corrupt.data(), corrupt.size());
+    ofs.close();
+    FragmentIonIndex corrupt_index;
+    corrupt_index.load(corrupt_filename);
+  };
+
+  // layout: magic, version, bin size, settings, sequences, peptides, bin offsets, postings
+  Size pos = 2 * sizeof(UInt32) + sizeof(double);
+  UInt64 length;
+  memcpy(&length, &buffer[pos], sizeof(length));
+  pos += sizeof(UInt64) + length;
+  const Size sequences_pos = pos;
+  UInt64 n_sequences;
+  memcpy(&n_sequences, &buffer[pos], sizeof(n_sequences));
+  pos += sizeof(UInt64);
+  for (UInt64 i = 0; i < n_sequences; ++i)
+  {
+    memcpy(&length, &buffer[pos], sizeof(length));
+    pos += sizeof(UInt64) + length;
+  }
+  const Size peptides_pos = pos + sizeof(UInt64); // first peptide: sequence index, modification index, mass
+  const Size bin_offsets_pos = peptides_pos + index.size() * (2 * sizeof(UInt32) + sizeof(double)) + sizeof(UInt64);
+  const Size last_posting_pos = buffer.size() - sizeof(UInt32);
+
+  // unchanged copy loads
+  UInt32 first_sequence_index = index.getPeptide(0).sequence_index;
+  loadCorrupt(peptides_pos, &first_sequence_index, sizeof(UInt32));
+
+  // sequence index out of range
+  UInt32 invalid_sequence = (UInt32)n_sequences;
+  TEST_EXCEPTION(Exception::ParseError, loadCorrupt(peptides_pos, &invalid_sequence, sizeof(UInt32)))
+
+  // posting refers to a peptide that does not exist
+  UInt32 invalid_posting = (UInt32)index.size();
+  TEST_EXCEPTION(Exception::ParseError, loadCorrupt(last_posting_pos, &invalid_posting, sizeof(UInt32)))
+
+  // bin offsets must not decrease
+  UInt64 invalid_offset = numeric_limits<UInt64>::max() / 2;
+  TEST_EXCEPTION(Exception::ParseError, loadCorrupt(bin_offsets_pos + sizeof(UInt64), &invalid_offset, sizeof(UInt64)))
+
+  // bin size must be positive and finite
+  const Size bin_size_pos = 2 * sizeof(UInt32);
+  double invalid_bin_size = 0.0;
+  TEST_EXCEPTION(Exception::ParseError, loadCorrupt(bin_size_pos, &invalid_bin_size, sizeof(double)))
+  invalid_bin_size = -0.05;
+  TEST_EXCEPTION(Exception::ParseError, loadCorrupt(bin_size_pos, &invalid_bin_size, sizeof(double)))
+  invalid_bin_size = numeric_limits<double>::quiet_NaN();
+  TEST_EXCEPTION(Exception::ParseError, loadCorrupt(bin_size_pos, &invalid_bin_size, sizeof(double)))
+  invalid_bin_size = numeric_limits<double>::infinity();
+  TEST_EXCEPTION(Exception::ParseError, loadCorrupt(bin_size_pos, &invalid_bin_size, sizeof(double)))
+
+  // huge number of sequences (must not be allocated)
+  UInt64 huge = numeric_limits<UInt64>::max() / 2;
+  TEST_EXCEPTION(Exception::ParseError, loadCorrupt(sequences_pos, &huge, sizeof(UInt64)))
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -0,0 +1,132 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/CHEMISTRY/FragmentIonLadder.h>
+///////////////////////////
+
+#include <OpenMS/CHEMISTRY/TheoreticalSpectrumGenerator.h>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(FragmentIonLadder, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+START_SECTION(Size size() const)
+{
+  FragmentIonLadder ladder;
+  TEST_EQUAL(ladder.size(), 0)
+  TEST_EQUAL(ladder.empty(), true)
+}
+END_SECTION
+
+START_SECTION(bool empty() const)
+  NOT_TESTABLE // tested above
+END_SECTION
+
+START_SECTION((template <bool B_IONS, bool Y_IONS, int MIN_CHARGE, int MAX_CHARGE> void generate(const CompactAASequence& peptide, bool add_first_prefix_ion = false)))
+{
+  TheoreticalSpectrumGenerator tsg;
+  Param param = tsg.getParameters();
+  param.setValue("add_metainfo", "true");
+  tsg.setParameters(param);
+
+  const AASequence peptide = AASequence::fromString(".(Acetyl)PEPM(Oxidation)TIDEK.(Amidated)");
+  const CompactAASequence compact(peptide);
+  FragmentIonLadder ladder;
+
+  // same ions as TheoreticalSpectrumGenerator
+  PeakSpectrum spec;
+  tsg.getSpectrum(spec, peptide, 1, 3);
+  ladder.generate<true, true, 1, 3>(compact);
+  TEST_EQUAL(ladder.size(), spec.size())
+  ABORT_IF(ladder.size() != spec.size())
+  for (Size i = 0; i < spec.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(ladder.mz[i], spec[i].getMZ())
+    String name = spec.getStringDataArrays()[0][i];
+    TEST_EQUAL(Residue::residueTypeToIonLetter(ladder.ion_type[i]) + String(ladder.ion_number[i]) + String(Size(ladder.charge[i]), '+'), name)
+    TEST_EQUAL(ladder.charge[i], spec.getIntegerDataArrays()[0][i])
+  }
+
+  // first prefix ion, only b ions
+  param.setValue("add_first_prefix_ion", "true");
+  param.setValue("add_y_ions", "false");
+  tsg.setParameters(param);
+  spec.clear(true);
+  tsg.getSpectrum(spec, peptide, 2, 2);
+  ladder.generate<true, false, 2, 2>(compact, true);
+  TEST_EQUAL(ladder.size(), spec.size())
+  ABORT_IF(ladder.size() != spec.size())
+  for (Size i = 0; i < spec.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(ladder.mz[i], spec[i].getMZ())
+    TEST_EQUAL(ladder.ion_type[i], Residue::BIon)
+    TEST_EQUAL(ladder.charge[i], 2)
+  }
+
+  // only y ions
+  ladder.generate<false, true, 1, 1>(compact);
+  TEST_EQUAL(ladder.size(), peptide.size() - 1)
+  TEST_REAL_SIMILAR(ladder.mz[0], peptide.getSuffix(1).getMonoWeight(Residue::YIon, 1))
+  TEST_EQUAL(ladder.ion_number.back(), peptide.size() - 1)
+
+  // too short for fragments
+  ladder.generate<true, true, 1, 1>(CompactAASequence(AASequence::fromString("K")));
+  TEST_EQUAL(ladder.empty(), true)
+}
+END_SECTION
+
+START_SECTION(void clear())
+{
+  FragmentIonLadder ladder;
+  ladder.generate<true, true, 1, 2>(CompactAASequence(AASequence::fromString("PEPTIDE")));
+  TEST_EQUAL(ladder.empty(), false)
+  ladder.clear();
+  TEST_EQUAL(ladder.empty(), true)
+  TEST_EQUAL(ladder.ion_type.empty(), true)
+  TEST_EQUAL(ladder.ion_number.empty(), true)
+  TEST_EQUAL(ladder.charge.empty(), true)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
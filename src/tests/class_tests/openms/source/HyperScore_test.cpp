@@ -41,6 +41,7 @@
 #include <OpenMS/KERNEL/MSSpectrum.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/CHEMISTRY/TheoreticalSpectrumGenerator.h>
+#include <OpenMS/CHEMISTRY/FragmentIonLadder.h>
 
 using namespace OpenMS;
 using namespace std;
@@ -117,6 +118,35 @@ START_SECTION((static double compute(double fragment_mass_tolerance, bool fragme
 }
 END_SECTION
 
+START_SECTION((static double compute(double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm, const PeakSpectrum& exp_spectrum, const FragmentIonLadder& theo_ladder)))
+{
+  PeakSpectrum exp_spectrum;
+  FragmentIonLadder theo_ladder;
+
+  CompactAASequence peptide(AASequence::fromString("PEPTIDE"));
+
+  // empty spectrum
+  theo_ladder.generate<true, true, 1, 1>(peptide);
+  TEST_REAL_SIMILAR(HyperScore::compute(0.1, false, exp_spectrum, theo_ladder), 0.0);
+
+  // full match, 11 identical masses, identical intensities (=1)
+  tsg.getSpectrum(exp_spectrum, peptide.toAASequence(), 1, 1);
+  TEST_REAL_SIMILAR(HyperScore::compute(0.1, false, exp_spectrum, theo_ladder), 13.8516496);
+  TEST_REAL_SIMILAR(HyperScore::compute(10, true, exp_spectrum, theo_ladder), 13.8516496);
+
+  // no match
+  theo_ladder.generate<true, true, 1, 3>(CompactAASequence(AASequence::fromString("YYYYYY")));
+  TEST_REAL_SIMILAR(HyperScore::compute(1e-5, false, exp_spectrum, theo_ladder), 0.0);
+
+  // full match, 33 identical masses, identical intensities (=1)
+  exp_spectrum.clear(true);
+  tsg.getSpectrum(exp_spectrum, peptide.toAASequence(), 1, 3);
+  theo_ladder.generate<true, true, 1, 3>(peptide);
+  TEST_REAL_SIMILAR(HyperScore::compute(0.1, false, exp_spectrum, theo_ladder), 67.8210771);
+  TEST_REAL_SIMILAR(HyperScore::compute(10, true, exp_spectrum, theo_ladder), 67.8210771);
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
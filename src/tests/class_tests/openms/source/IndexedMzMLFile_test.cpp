@@ -225,6 +225,46 @@ START_SECTION(( void getMSSpectrumByNativeId(std::string id, OpenMS::MSSpectrum&
 }
 END_SECTION
 
+START_SECTION(( void getMSSpectraById(const std::vector<int>& ids, std::vector<OpenMS::MSSpectrum>& spectra) const ))
+{
+  IndexedMzMLHandler file(OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML"));
+
+  PeakMap exp;
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML"),exp);
+
+  std::vector<int> ids;
+  for (int i = (int)file.getNrSpectra() - 1; i >= 0; --i) ids.push_back(i);
+  ids.push_back(0);
+
+  std::vector<OpenMS::MSSpectrum> spectra;
+  file.getMSSpectraById(ids, spectra);
+  TEST_EQUAL(spectra.size(), ids.size())
+  for (Size i = 0; i < ids.size(); ++i)
+  {
+    TEST_EQUAL(spectra[i].size(), exp.getSpectra()[ids[i]].size() )
+    TEST_EQUAL(spectra[i].getNativeID(), exp.getSpectra()[ids[i]].getNativeID() )
+  }
+
+  // concurrent access to the same object gives the same result
+  std::vector<OpenMS::MSSpectrum> spectra_parallel(ids.size());
+#pragma omp parallel for
+  for (SignedSize i = 0; i < (SignedSize)ids.size(); ++i)
+  {
+    file.getMSSpectrumById(ids[i], spectra_parallel[i]);
+  }
+  for (Size i = 0; i < ids.size(); ++i)
+  {
+    TEST_EQUAL(spectra_parallel[i] == spectra[i], true)
+  }
+
+  // Test Exceptions
+  ids.push_back(-1);
+  TEST_EXCEPTION(Exception::IllegalArgument, file.getMSSpectraById(ids, spectra));
+  ids.back() = (int)file.getNrSpectra();
+  TEST_EXCEPTION(Exception::IllegalArgument, file.getMSSpectraById(ids, spectra));
+}
+END_SECTION
+
 START_SECTION(( OpenMS::Interfaces::ChromatogramPtr getChromatogramById(int id) ))
 {
   IndexedMzMLHandler file(OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML"));
@@ -97,6 +97,34 @@ START_SECTION((void align(const PeakMap& map, TransformationDescription& trafo))
 }
 END_SECTION
 
+START_SECTION((template <typename MapType> void align(const std::vector<MapType>& maps, std::vector<TransformationDescription>& trafos)))
+{
+  MzMLFile f;
+  PeakMap reference;
+  f.load(OPENMS_GET_TEST_DATA_PATH("MapAlignmentAlgorithmPoseClustering_in1.mzML.gz"), reference);
+  std::vector<PeakMap > maps(3);
+  f.load(OPENMS_GET_TEST_DATA_PATH("MapAlignmentAlgorithmPoseClustering_in2.mzML.gz"), maps[0]);
+  maps[2] = maps[1] = maps[0];
+
+  MapAlignmentAlgorithmPoseClustering aligner;
+  aligner.setReference(reference);
+
+  std::vector<TransformationDescription> trafos;
+  aligner.align(maps, trafos);
+  TEST_EQUAL(trafos.size(), 3);
+
+  // same result as aligning the maps one by one
+  TransformationDescription trafo;
+  aligner.align(maps[0], trafo);
+  for (const TransformationDescription& t : trafos)
+  {
+    TEST_EQUAL(t.getModelType(), "linear");
+    TEST_EQUAL(t.getDataPoints().size(), trafo.getDataPoints().size());
+    TEST_REAL_SIMILAR(t.apply(1000.0), trafo.apply(1000.0));
+  }
+}
+END_SECTION
+
 START_SECTION((void align(const FeatureMap& map, TransformationDescription& trafo)))
 {
   // Tested extensively in TEST/TOPP
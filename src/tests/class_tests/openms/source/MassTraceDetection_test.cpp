@@ -172,6 +172,19 @@ START_SECTION((void run(const PeakMap &, std::vector< MassTrace > &)))
       }
 
     }
+
+    // the maximal number of traces stops the detection after the most intense traces
+    {
+      output_mt.clear();
+      test_mtd.run(input, output_mt, 2);
+      TEST_EQUAL(output_mt.size(), 2);
+      for (Size i = 0; i < output_mt.size(); ++i)
+      {
+        TEST_EQUAL(output_mt[i].getLabel(), "T" + String(i + 1));
+        TEST_EQUAL(output_mt[i].getSize(), exp_mt_lengths[i]);
+        TEST_REAL_SIMILAR(output_mt[i].getCentroidMZ(), exp_mt_mzs[i]);
+      }
+    }
 }
 END_SECTION
 
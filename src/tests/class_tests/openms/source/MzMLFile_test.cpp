@@ -42,6 +42,13 @@
 #include <OpenMS/FORMAT/FileTypes.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
 
+#include <fstream>
+#include <iterator>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace OpenMS;
 using namespace std;
 
@@ -1232,6 +1239,74 @@ START_SECTION(void transform(const String& filename_in, Interfaces::IMSDataConsu
 }
 END_SECTION
 
+START_SECTION(([EXTRA] background decoding of binary data))
+{
+  String in = OPENMS_GET_TEST_DATA_PATH("MzMLFile_1.mzML");
+
+  // reference: one batch decoded by a single thread
+  PeakMap exp_serial;
+  {
+#ifdef _OPENMP
+    int max_threads = omp_get_max_threads();
+    omp_set_num_threads(1);
+#endif
+    MzMLFile mzml;
+    mzml.getOptions().setMaxDataPoolSize(1000);
+    mzml.load(in, exp_serial);
+#ifdef _OPENMP
+    omp_set_num_threads(max_threads);
+#endif
+  }
+  TEST_EQUAL(exp_serial.size(), 4)
+  TEST_EQUAL(exp_serial.getChromatograms().size(), 2)
+
+  // every spectrum / chromatogram is its own batch, decoded while parsing continues
+  PeakMap exp_pipelined;
+  {
+    MzMLFile mzml;
+    mzml.getOptions().setMaxDataPoolSize(1);
+    mzml.load(in, exp_pipelined);
+  }
+  TEST_EQUAL(exp_pipelined == exp_serial, true)
+  TEST_EQUAL(exp_pipelined.getChromatograms() == exp_serial.getChromatograms(), true)
+
+  // loading from within a parallel region (decoded by a single thread)
+  std::vector<PeakMap> exp_parallel(2);
+#pragma omp parallel for num_threads(2)
+  for (int i = 0; i < 2; ++i)
+  {
+    MzMLFile mzml;
+    mzml.getOptions().setMaxDataPoolSize(1);
+    mzml.load(in, exp_parallel[i]);
+  }
+  TEST_EQUAL(exp_parallel[0] == exp_serial, true)
+  TEST_EQUAL(exp_parallel[1] == exp_serial, true)
+
+  // malformed binary data in the first spectrum, the error of the background task reaches the caller
+  String content;
+  {
+    std::ifstream ifs(in.c_str());
+    content.assign((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+  }
+  Size begin = content.find("<binary>") + String("<binary>").size();
+  Size end = content.find("</binary>", begin);
+  content = content.substr(0, begin) + "AAAAA" + content.substr(end); // length not a multiple of 4
+  String broken;
+  NEW_TMP_FILE(broken);
+  {
+    std::ofstream ofs(broken.c_str());
+    ofs << content;
+  }
+  for (Size pool_size : {1, 1000})
+  {
+    MzMLFile mzml;
+    mzml.getOptions().setMaxDataPoolSize(pool_size);
+    PeakMap exp_broken;
+    TEST_EXCEPTION(Exception::ParseError, mzml.load(broken, exp_broken))
+  }
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -456,6 +456,25 @@ START_SECTION(std::vector<size_t> getSpectraIndicesbyRT(double RT, double deltaR
 }
 END_SECTION
 
+START_SECTION(std::vector<SpectrumRTEntry> getSpectraRTIndex() const)
+{
+  MzMLSqliteHandler handler(OPENMS_GET_TEST_DATA_PATH("SqliteMassFile_1.sqMass"), 0);
+
+  std::vector<MSSpectrum> exp;
+  handler.readSpectra(exp, {0, 1}, true);
+
+  std::vector<MzMLSqliteHandler::SpectrumRTEntry> res = handler.getSpectraRTIndex();
+  TEST_EQUAL(res.size(), 2)
+  TEST_EQUAL(res[0].id, 0)
+  TEST_EQUAL(res[1].id, 1)
+  TEST_REAL_SIMILAR(res[0].rt, 0.2961)
+  TEST_REAL_SIMILAR(res[1].rt, 0.4738)
+  TEST_EQUAL(res[0].native_id, exp[0].getNativeID())
+  TEST_EQUAL(res[1].native_id, exp[1].getNativeID())
+  TEST_EQUAL(res[0].ms_level, exp[0].getMSLevel())
+}
+END_SECTION
+
 START_SECTION(void writeExperiment(const MSExperiment & exp))
 {
   const MSExperiment exp_orig = [](){
@@ -150,6 +150,49 @@ START_SECTION(static std::vector<OPXLDataStructs::XLPrecursor> enumerateCrossLin
 
 END_SECTION
 
+START_SECTION(static void enumerateCrossLinksAndMasses(const std::vector<OPXLDataStructs::AASeqWithMass>&  peptides, double cross_link_mass_light, const DoubleList& cross_link_mass_mono_link, const StringList& cross_link_residue1, const StringList& cross_link_residue2, const std::vector< double >& spectrum_precursors, double precursor_mass_tolerance, bool precursor_mass_tolerance_unit_ppm, Size batch_size, const std::function<void(std::vector<OPXLDataStructs::XLPrecursor>&, std::vector< int >&)>& process_batch))
+
+  Size n_batches = 0;
+  Size max_batch_size = 0;
+  std::vector<OPXLDataStructs::XLPrecursor> precursors;
+  std::vector< int > spectrum_precursor_correction_positions;
+  OPXLHelper::enumerateCrossLinksAndMasses(peptides, cross_link_mass, cross_link_mass_mono_link, cross_link_residue1, cross_link_residue2, spectrum_precursors, precursor_mass_tolerance, precursor_mass_tolerance_unit_ppm, 1000,
+    [&](std::vector<OPXLDataStructs::XLPrecursor>& batch, std::vector< int >& correction_positions)
+    {
+      ++n_batches;
+      max_batch_size = std::max(max_batch_size, batch.size());
+      TEST_EQUAL(batch.size(), correction_positions.size())
+      precursors.insert(precursors.end(), batch.begin(), batch.end());
+      spectrum_precursor_correction_positions.insert(spectrum_precursor_correction_positions.end(), correction_positions.begin(), correction_positions.end());
+    });
+
+  // same candidates as the non-streaming version, in batches
+  TEST_EQUAL(precursors.size(), 9604)
+  TEST_EQUAL(spectrum_precursor_correction_positions.size(), 9604)
+  TEST_EQUAL(n_batches, 10)
+  TEST_EQUAL(max_batch_size, 1000)
+
+  std::vector< int > all_correction_positions;
+  std::vector<OPXLDataStructs::XLPrecursor> all_precursors = OPXLHelper::enumerateCrossLinksAndMasses(peptides, cross_link_mass, cross_link_mass_mono_link, cross_link_residue1, cross_link_residue2, spectrum_precursors, all_correction_positions, precursor_mass_tolerance, precursor_mass_tolerance_unit_ppm);
+  ABORT_IF(all_precursors.size() != precursors.size())
+  for (Size i = 0; i < precursors.size(); i += 500)
+  {
+    TEST_EQUAL(precursors[i].alpha_index, all_precursors[i].alpha_index)
+    TEST_EQUAL(precursors[i].beta_index, all_precursors[i].beta_index)
+    TEST_EQUAL(spectrum_precursor_correction_positions[i], all_correction_positions[i])
+  }
+
+  // alpha is never heavier than beta
+  for (const auto& p : precursors)
+  {
+    if (p.beta_index < peptides.size())
+    {
+      TEST_EQUAL(peptides[p.alpha_index].peptide_mass <= peptides[p.beta_index].peptide_mass, true)
+    }
+  }
+
+END_SECTION
+
 // building more data structures required in the following test
 std::cout << std::endl;
 std::vector< int > spectrum_precursor_correction_positions;
@@ -426,6 +469,41 @@ START_SECTION(static std::vector <OPXLDataStructs::ProteinProteinCrossLink> OPXL
 
 END_SECTION
 
+START_SECTION(static void collectPrecursorCandidates(const IntList& precursor_correction_steps, double precursor_mass, double precursor_mass_tolerance, bool precursor_mass_tolerance_unit_ppm, const std::vector<OPXLDataStructs::AASeqWithMass>& filtered_peptide_masses, double cross_link_mass, const DoubleList& cross_link_mass_mono_link, const StringList& cross_link_residue1, const StringList& cross_link_residue2, const String& cross_link_name, bool use_sequence_tags, const std::vector<std::string>& tags, Size batch_size, const std::function<void(std::vector<OPXLDataStructs::ProteinProteinCrossLink>&)>& process_batch))
+
+  IntList precursor_correction_steps;
+  precursor_correction_steps.push_back(2);
+  precursor_correction_steps.push_back(1);
+
+  double precursor_mass = 10668.85060;
+  String cross_link_name = "MyLinker";
+  precursor_mass_tolerance = 10;
+
+  Size n_batches = 0;
+  std::vector <OPXLDataStructs::ProteinProteinCrossLink> spectrum_candidates;
+  OPXLHelper::collectPrecursorCandidates(precursor_correction_steps, precursor_mass, precursor_mass_tolerance, precursor_mass_tolerance_unit_ppm, peptides, cross_link_mass, cross_link_mass_mono_link, cross_link_residue1, cross_link_residue2, cross_link_name, false, std::vector<std::string>(), 10,
+    [&](std::vector <OPXLDataStructs::ProteinProteinCrossLink>& batch)
+    {
+      ++n_batches;
+      spectrum_candidates.insert(spectrum_candidates.end(), batch.begin(), batch.end());
+    });
+
+  // same candidates as the non-streaming version
+  TEST_EQUAL(spectrum_candidates.size(), 1050)
+  TEST_EQUAL(n_batches > 1, true)
+  for (Size i = 0; i < spectrum_candidates.size(); i += 100)
+  {
+    TEST_REAL_SIMILAR(spectrum_candidates[i].alpha->getMonoWeight() + spectrum_candidates[i].beta->getMonoWeight() + spectrum_candidates[i].cross_linker_mass, precursor_mass - 1 * Constants::C13C12_MASSDIFF_U)
+  }
+
+  // no tags found: no candidates
+  n_batches = 0;
+  OPXLHelper::collectPrecursorCandidates(precursor_correction_steps, precursor_mass, precursor_mass_tolerance, precursor_mass_tolerance_unit_ppm, peptides, cross_link_mass, cross_link_mass_mono_link, cross_link_residue1, cross_link_residue2, cross_link_name, true, std::vector<std::string>(), 10,
+    [&](std::vector <OPXLDataStructs::ProteinProteinCrossLink>&) { ++n_batches; });
+  TEST_EQUAL(n_batches, 0)
+
+END_SECTION
+
 START_SECTION(static double OPXLHelper::computePrecursorError(OPXLDataStructs::CrossLinkSpectrumMatch csm, double precursor_mz, int precursor_charge))
 
   OPXLDataStructs::ProteinProteinCrossLink ppcl;
@@ -237,6 +237,32 @@ START_SECTION((MSSpectrum getSpectrum(Size id)))
 }
 END_SECTION
 
+START_SECTION((std::vector<MSSpectrum> getSpectra(const std::vector<Size>& ids) const))
+{
+  OnDiscPeakMap tmp; tmp.openFile(OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML"));
+  std::vector<Size> ids = {1, 0};
+  std::vector<MSSpectrum> spectra = tmp.getSpectra(ids);
+  TEST_EQUAL(spectra.size(), 2);
+  TEST_EQUAL(spectra[0].size(), 19800);
+  TEST_EQUAL(spectra[1].size(), 19914);
+  TEST_EQUAL(spectra[0] == tmp.getSpectrum(1), true);
+  TEST_EQUAL(spectra[1] == tmp.getSpectrum(0), true);
+
+  OnDiscPeakMap tmp2; tmp2.openFile(OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML"), true);
+  spectra = tmp2.getSpectra(ids);
+  TEST_EQUAL(spectra.size(), 2);
+  TEST_EQUAL(spectra[0].size(), 19800);
+  TEST_EQUAL(spectra[1].size(), 19914);
+
+  // out of range indices are rejected before anything is accessed
+  std::vector<Size> bad_ids = {0, tmp.getNrSpectra()};
+  TEST_EXCEPTION(Exception::IndexOverflow, tmp.getSpectra(bad_ids))
+  TEST_EXCEPTION(Exception::IndexOverflow, tmp2.getSpectra(bad_ids))
+  bad_ids = {std::numeric_limits<Size>::max()};
+  TEST_EXCEPTION(Exception::IndexOverflow, tmp.getSpectra(bad_ids))
+}
+END_SECTION
+
 START_SECTION(OpenMS::Interfaces::SpectrumPtr getSpectrumById(Size id))
 {
   OnDiscPeakMap tmp; tmp.openFile(OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML"));
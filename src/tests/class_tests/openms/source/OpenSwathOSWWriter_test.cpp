@@ -0,0 +1,221 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry               
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+// 
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution 
+//    may be used to endorse or promote products derived from this software 
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS. 
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING 
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// 
+// --------------------------------------------------------------------------
+// $Maintainer: George Rosenberger $
+// $Authors: George Rosenberger $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathOSWWriter.h>
+///////////////////////////
+
+#include <OpenMS/FORMAT/SqliteConnector.h>
+
+using namespace OpenMS;
+using namespace std;
+
+namespace
+{
+  /// batch inserting runs with ids [first, first + n)
+  std::vector<String> runBatch(Size first, Size n)
+  {
+    std::vector<String> batch;
+    for (Size i = first; i < first + n; ++i)
+    {
+      batch.push_back("INSERT INTO RUN (ID, FILENAME) VALUES (" + String(i) + ", 'run_" + String(i) + "');");
+    }
+    return batch;
+  }
+
+  Size countRuns(const String& filename)
+  {
+    SqliteConnector conn(filename, SqliteConnector::SqlOpenMode::READONLY);
+    return conn.countTableRows("RUN");
+  }
+}
+
+START_TEST(OpenSwathOSWWriter, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+OpenSwathOSWWriter* ptr = nullptr;
+OpenSwathOSWWriter* nullPointer = nullptr;
+
+START_SECTION(OpenSwathOSWWriter(const String& output_filename, const UInt64 run_id, const String& input_filename = "inputfile", bool ms1_scores = false, bool sonar = false, bool uis_scores = false))
+{
+  ptr = new OpenSwathOSWWriter("", 0);
+  TEST_NOT_EQUAL(ptr, nullPointer)
+}
+END_SECTION
+
+START_SECTION(~OpenSwathOSWWriter())
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION(bool isActive() const)
+{
+  TEST_EQUAL(OpenSwathOSWWriter("", 0).isActive(), false)
+  TEST_EQUAL(OpenSwathOSWWriter("out.osw", 0).isActive(), true)
+}
+END_SECTION
+
+START_SECTION(void writeLines(const std::vector<String>& to_osw_output))
+{
+  String filename;
+  NEW_TMP_FILE(filename);
+  OpenSwathOSWWriter writer(filename, 0);
+  writer.writeHeader();
+
+  for (Size i = 0; i < 10; ++i)
+  {
+    writer.writeLines(runBatch(5 * i, 5));
+  }
+  writer.writeLines(std::vector<String>()); // empty batches are ignored
+  writer.flush();
+  TEST_EQUAL(countRuns(filename), 50)
+
+  OpenSwathOSWWriter::WriterStatistics stats = writer.getStatistics();
+  TEST_EQUAL(stats.batches_written, 10)
+  TEST_EQUAL(stats.transactions >= 1, true)
+  TEST_EQUAL(stats.transactions <= 10, true)
+
+  // the writer can be used again after a flush
+  writer.writeLines(runBatch(50, 5));
+  writer.flush();
+  TEST_EQUAL(countRuns(filename), 55)
+  TEST_EQUAL(writer.getStatistics().batches_written, 11)
+}
+END_SECTION
+
+START_SECTION(void flush())
+{
+  String filename;
+  NEW_TMP_FILE(filename);
+  OpenSwathOSWWriter writer(filename, 0);
+  writer.writeHeader();
+
+  // nothing queued
+  writer.flush();
+
+  // an invalid statement is reported by the next call, together with the rest of its transaction it is not written
+  writer.writeLines(runBatch(0, 5));
+  writer.writeLines(std::vector<String>(1, "INSERT INTO NO_SUCH_TABLE (ID) VALUES (1);"));
+  TEST_EXCEPTION(Exception::IllegalArgument, writer.flush())
+  TEST_EXCEPTION(Exception::IllegalArgument, writer.writeLines(runBatch(5, 5)))
+  TEST_EXCEPTION(Exception::IllegalArgument, writer.flush())
+  TEST_EQUAL(writer.getStatistics().batches_written <= 1, true)
+  TEST_EQUAL(countRuns(filename) <= 5, true)
+}
+END_SECTION
+
+START_SECTION(WriterStatistics getStatistics() const)
+{
+  String filename;
+  NEW_TMP_FILE(filename);
+  OpenSwathOSWWriter writer(filename, 0);
+  writer.writeHeader();
+
+  OpenSwathOSWWriter::WriterStatistics stats = writer.getStatistics();
+  TEST_EQUAL(stats.batches_written, 0)
+  TEST_EQUAL(stats.transactions, 0)
+  TEST_EQUAL(stats.max_queue_depth, 0)
+  TEST_EQUAL(stats.producer_waits, 0)
+
+  // keep the writer busy with a slow statement so the queue fills up (at most 64 batches are queued)
+  writer.writeLines(std::vector<String>(1,
+    "WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c WHERE x < 5000000) SELECT COUNT(*) FROM c;"));
+  for (Size i = 0; i < 200; ++i)
+  {
+    writer.writeLines(runBatch(i, 1));
+  }
+  writer.flush();
+
+  stats = writer.getStatistics();
+  TEST_EQUAL(stats.batches_written, 201)
+  TEST_EQUAL(stats.max_queue_depth, 64)
+  TEST_EQUAL(stats.producer_waits > 0, true)
+  TEST_EQUAL(stats.transactions < 201, true)
+  TEST_EQUAL(countRuns(filename), 200)
+}
+END_SECTION
+
+START_SECTION(OpenSwathOSWWriter(const OpenSwathOSWWriter& rhs))
+{
+  String filename;
+  NEW_TMP_FILE(filename);
+  OpenSwathOSWWriter writer(filename, 0);
+  writer.writeHeader();
+  writer.writeLines(std::vector<String>(1, "INSERT INTO NO_SUCH_TABLE (ID) VALUES (1);"));
+  TEST_EXCEPTION(Exception::IllegalArgument, writer.flush())
+
+  // the copy has its own queue: neither the error nor the statistics are shared
+  OpenSwathOSWWriter copy(writer);
+  TEST_EQUAL(copy.isActive(), true)
+  TEST_EQUAL(copy.getStatistics().batches_written, 0)
+  copy.writeLines(runBatch(0, 3));
+  copy.flush();
+  TEST_EQUAL(copy.getStatistics().batches_written, 1)
+  TEST_EQUAL(writer.getStatistics().batches_written, 0)
+  TEST_EQUAL(countRuns(filename), 3)
+  TEST_EXCEPTION(Exception::IllegalArgument, writer.flush())
+}
+END_SECTION
+
+START_SECTION(OpenSwathOSWWriter& operator=(const OpenSwathOSWWriter& rhs))
+{
+  String filename_1, filename_2;
+  NEW_TMP_FILE(filename_1);
+  NEW_TMP_FILE(filename_2);
+  OpenSwathOSWWriter writer_1(filename_1, 0);
+  writer_1.writeHeader();
+  OpenSwathOSWWriter writer_2(filename_2, 0);
+  writer_2.writeHeader();
+
+  // pending output is written before the assignment
+  writer_1.writeLines(runBatch(0, 4));
+  writer_1 = writer_2;
+  TEST_EQUAL(countRuns(filename_1), 4)
+  TEST_EQUAL(writer_1.getStatistics().batches_written, 0)
+
+  writer_1.writeLines(runBatch(0, 2));
+  writer_1.flush();
+  TEST_EQUAL(countRuns(filename_2), 2)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -0,0 +1,157 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: Timo Sachsenberg $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+#include <OpenMS/FORMAT/MzMLFile.h>
+#include <OpenMS/FORMAT/DATAACCESS/MSDataStoringConsumer.h>
+
+///////////////////////////
+#include <OpenMS/TRANSFORMATIONS/RAW2PEAK/PeakPickerHiResConsumer.h>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(PeakPickerHiResConsumer, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+PeakPickerHiRes pp;
+MSDataStoringConsumer storage;
+
+PeakPickerHiResConsumer* ptr = nullptr;
+PeakPickerHiResConsumer* nullPointer = nullptr;
+START_SECTION((PeakPickerHiResConsumer(const PeakPickerHiRes& pp, Interfaces::IMSDataConsumer* next_consumer, Size batch_size = 500)))
+  ptr = new PeakPickerHiResConsumer(pp, &storage);
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EXCEPTION(Exception::MissingInformation, PeakPickerHiResConsumer(pp, nullptr))
+END_SECTION
+
+START_SECTION((~PeakPickerHiResConsumer()))
+  delete ptr;
+END_SECTION
+
+PeakMap input;
+MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("PeakPickerHiRes_orbitrap.mzML"), input);
+
+Param param = pp.getParameters();
+param.setValue("signal_to_noise", 1.0);
+pp.setParameters(param);
+
+PeakMap expected;
+pp.pickExperiment(input, expected);
+
+START_SECTION((void consumeSpectrum(SpectrumType& s)))
+{
+  MSDataStoringConsumer picked;
+  {
+    // a small batch size forces several parallel batches
+    PeakPickerHiResConsumer consumer(pp, &picked, 3);
+    consumer.setExpectedSize(input.size(), 0);
+    for (Size i = 0; i < input.size(); ++i)
+    {
+      MSSpectrum s = input[i];
+      consumer.consumeSpectrum(s);
+    }
+    consumer.flush();
+  }
+
+  const PeakMap& result = picked.getData();
+  TEST_EQUAL(result.size(), expected.size())
+  ABORT_IF(result.size() != expected.size())
+  for (Size i = 0; i < result.size(); ++i)
+  {
+    TEST_EQUAL(result[i].getRT(), expected[i].getRT())
+    TEST_EQUAL(result[i].size(), expected[i].size())
+    ABORT_IF(result[i].size() != expected[i].size())
+    for (Size j = 0; j < result[i].size(); ++j)
+    {
+      TEST_REAL_SIMILAR(result[i][j].getMZ(), expected[i][j].getMZ())
+      TEST_REAL_SIMILAR(result[i][j].getIntensity(), expected[i][j].getIntensity())
+    }
+  }
+}
+END_SECTION
+
+START_SECTION((void consumeChromatogram(ChromatogramType& c)))
+{
+  // use the profile data of the first spectrum as chromatogram
+  MSChromatogram chrom;
+  for (const Peak1D& p : input[0])
+  {
+    chrom.push_back(ChromatogramPeak(p.getMZ(), p.getIntensity()));
+  }
+  MSChromatogram chrom_expected;
+  pp.pick(chrom, chrom_expected);
+
+  MSDataStoringConsumer picked;
+  PeakPickerHiResConsumer consumer(pp, &picked, 2);
+  MSSpectrum s = input[0];
+  consumer.consumeSpectrum(s);
+  MSChromatogram c = chrom;
+  consumer.consumeChromatogram(c);
+  consumer.flush();
+
+  TEST_EQUAL(picked.getData().size(), 1)
+  TEST_EQUAL(picked.getData().getNrChromatograms(), 1)
+  ABORT_IF(picked.getData().getNrChromatograms() != 1)
+  TEST_EQUAL(picked.getData().getChromatograms()[0].size(), chrom_expected.size())
+}
+END_SECTION
+
+START_SECTION((void flush()))
+{
+  // spectra of unselected MS levels are passed on unchanged
+  Param p = pp.getParameters();
+  p.setValue("ms_levels", ListUtils::create<Int>("2"));
+  PeakPickerHiRes pp_ms2;
+  pp_ms2.setParameters(p);
+
+  MSDataStoringConsumer picked;
+  PeakPickerHiResConsumer consumer(pp_ms2, &picked);
+  MSSpectrum s = input[0];
+  s.setMSLevel(1);
+  consumer.consumeSpectrum(s);
+  TEST_EQUAL(picked.getData().size(), 0)
+  consumer.flush();
+  TEST_EQUAL(picked.getData().size(), 1)
+  TEST_EQUAL(picked.getData()[0].size(), input[0].size())
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
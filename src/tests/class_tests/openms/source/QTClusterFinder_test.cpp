@@ -46,6 +46,10 @@
 #include <OpenMS/METADATA/PeptideHit.h>
 #include <OpenMS/METADATA/PeptideIdentification.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace OpenMS;
 using namespace std;
 
@@ -258,6 +262,82 @@ START_SECTION((void run(const std::vector<FeatureMap >& input_maps, ConsensusMap
 }
 END_SECTION
 
+START_SECTION(([EXTRA] partitions clustered in parallel))
+{
+  // same data as the "complex case" above, m/z ~0 and ~200 end up in different partitions
+  vector<FeatureMap> input(3);
+  const double positions[3][3][2] = {{{0, 0}, {100, 200}, {-1, -1}},
+                                     {{4, 0.04}, {5, 0.05}, {104, 200.04}},
+                                     {{104, 200.04}, {108, 200.08}, {-1, -1}}};
+  const char* sequences[3][3] = {{"AAA", "CCC", ""}, {"DDD", "AAA", ""}, {"EEE", "CCC", ""}};
+  for (Size k = 0; k < 3; ++k)
+  {
+    for (Size m = 0; m < 3; ++m)
+    {
+      if (positions[k][m][0] < 0) continue;
+      Feature feat;
+      feat.setPosition(DPosition<2>(positions[k][m][0], positions[k][m][1]));
+      feat.setUniqueId(m);
+      if (String(sequences[k][m]) != "")
+      {
+        PeptideHit hit;
+        hit.setSequence(AASequence::fromString(sequences[k][m]));
+        feat.getPeptideIdentifications().resize(1);
+        feat.getPeptideIdentifications()[0].insertHit(hit);
+      }
+      input[k].push_back(feat);
+    }
+    input[k].updateRanges();
+  }
+
+  QTClusterFinder finder;
+  Param param = finder.getDefaults();
+  param.setValue("distance_RT:max_difference", 5.1);
+  param.setValue("distance_MZ:max_difference", 0.1);
+  param.setValue("use_identifications", "true");
+
+  // reference: all features in one partition
+  param.setValue("nr_partitions", 1);
+  finder.setParameters(param);
+  ConsensusMap serial;
+  finder.run(input, serial);
+  TEST_EQUAL(serial.size(), 4)
+
+  // several partitions, clustered by one and by several threads
+  param.setValue("nr_partitions", 100);
+  finder.setParameters(param);
+  ConsensusMap parallel;
+  finder.run(input, parallel);
+#ifdef _OPENMP
+  int max_threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif
+  ConsensusMap single_thread;
+  finder.run(input, single_thread);
+#ifdef _OPENMP
+  omp_set_num_threads(max_threads);
+#endif
+
+  serial.sortByMZ();
+  for (ConsensusMap* result : {&parallel, &single_thread})
+  {
+    TEST_EQUAL(result->size(), serial.size())
+    ABORT_IF(result->size() != serial.size())
+    result->sortByMZ();
+    for (Size i = 0; i < serial.size(); ++i)
+    {
+      TEST_REAL_SIMILAR((*result)[i].getRT(), serial[i].getRT())
+      TEST_REAL_SIMILAR((*result)[i].getMZ(), serial[i].getMZ())
+      TEST_EQUAL((*result)[i].getFeatures() == serial[i].getFeatures(), true)
+    }
+  }
+
+  // the error of a partition is passed on unchanged
+  input.resize(1);
+  TEST_EXCEPTION_WITH_MESSAGE(Exception::IllegalArgument, finder.run(input, parallel), "At least two input maps required")
+}
+END_SECTION
+
 START_SECTION((void run(const std::vector<ConsensusMap>& input_maps, ConsensusMap& result_map)))
 {
 	NOT_TESTABLE; // same as "run" for feature maps (tested above)
@@ -41,6 +41,8 @@
 #include <OpenMS/CHEMISTRY/ResidueDB.h>
 #include <OpenMS/CHEMISTRY/Residue.h>
 
+#include <algorithm>
+
 using namespace OpenMS;
 using namespace std;
 
@@ -128,6 +130,24 @@ START_SECTION(Size getNumberOfModifiedResidues() const)
 	TEST_EQUAL(ptr->getNumberOfModifiedResidues(), 2)
 END_SECTION
 
+START_SECTION([EXTRA] multithreaded creation of modified residues)
+{
+  // concurrent requests for the same modified residue must create it only once
+  Size nr_modified = ptr->getNumberOfModifiedResidues();
+  const Residue* ser = ptr->getResidue("S");
+  std::vector<const Residue*> results(1000, nullptr);
+#pragma omp parallel for
+  for (SignedSize i = 0; i < (SignedSize)results.size(); ++i)
+  {
+    results[i] = ptr->getModifiedResidue(ser, "Phospho");
+  }
+  TEST_EQUAL(ptr->getNumberOfModifiedResidues(), nr_modified + 1)
+  TEST_EQUAL((Size)std::count(results.begin(), results.end(), results[0]), results.size())
+  TEST_EQUAL(ptr->hasResidue(results[0]), true)
+  TEST_STRING_EQUAL(results[0]->getModificationName(), "Phospho")
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -33,11 +33,17 @@
 // --------------------------------------------------------------------------
 
 #include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
 
 ///////////////////////////
 #include <OpenMS/ANALYSIS/ID/SimpleSearchEngineAlgorithm.h>
 ///////////////////////////
 
+#include <OpenMS/METADATA/PeptideIdentification.h>
+#include <OpenMS/METADATA/ProteinIdentification.h>
+
+#include <fstream>
+
 using namespace OpenMS;
 using namespace std;
 
@@ -68,6 +74,59 @@ START_SECTION((ExitCodes search(const String &in_mzML, const String &in_db, std:
 }
 END_SECTION
 
+START_SECTION(([EXTRA] search with fragment ion index))
+{
+  // same data as the TOPP test
+  const String in_mzML = OPENMS_GET_TEST_DATA_PATH("../../../topp/SimpleSearchEngine_1.mzML");
+  const String in_db = OPENMS_GET_TEST_DATA_PATH("../../../topp/SimpleSearchEngine_1.fasta");
+
+  SimpleSearchEngineAlgorithm sse;
+  Param p = sse.getParameters();
+  p.setValue("precursor:mass_tolerance", 5.0);
+  p.setValue("fragment:mass_tolerance", 0.3);
+  p.setValue("fragment:mass_tolerance_unit", "Da");
+  sse.setParameters(p);
+  vector<ProteinIdentification> prot_ids;
+  vector<PeptideIdentification> pep_ids;
+  TEST_EQUAL(sse.search(in_mzML, in_db, prot_ids, pep_ids) == SimpleSearchEngineAlgorithm::ExitCodes::EXECUTION_OK, true)
+  TEST_EQUAL(pep_ids.empty(), false)
+
+  // scoring all candidates that share at least one peak gives the same results
+  String index_file;
+  NEW_TMP_FILE(index_file);
+  p.setValue("fragment_index:use", "true");
+  p.setValue("fragment_index:max_candidates", 0);
+  p.setValue("fragment_index:file", index_file);
+  sse.setParameters(p);
+
+  // first run builds and stores the index, second run loads it, third run rebuilds it from a corrupt file
+  for (Size run = 0; run < 3; ++run)
+  {
+    if (run == 2)
+    {
+      ofstream ofs(index_file.c_str(), std::ios::binary | std::ios::trunc);
+      ofs << "not a fragment ion index";
+    }
+    vector<ProteinIdentification> index_prot_ids;
+    vector<PeptideIdentification> index_pep_ids;
+    TEST_EQUAL(sse.search(in_mzML, in_db, index_prot_ids, index_pep_ids) == SimpleSearchEngineAlgorithm::ExitCodes::EXECUTION_OK, true)
+    TEST_EQUAL(index_pep_ids.size(), pep_ids.size())
+    for (Size i = 0; i < std::min(index_pep_ids.size(), pep_ids.size()); ++i)
+    {
+      TEST_REAL_SIMILAR(index_pep_ids[i].getRT(), pep_ids[i].getRT())
+      const vector<PeptideHit>& hits = pep_ids[i].getHits();
+      const vector<PeptideHit>& index_hits = index_pep_ids[i].getHits();
+      TEST_EQUAL(index_hits.size(), hits.size())
+      for (Size j = 0; j < std::min(index_hits.size(), hits.size()); ++j)
+      {
+        TEST_EQUAL(index_hits[j].getSequence(), hits[j].getSequence())
+        TEST_REAL_SIMILAR(index_hits[j].getScore(), hits[j].getScore())
+      }
+    }
+  }
+}
+END_SECTION
+
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
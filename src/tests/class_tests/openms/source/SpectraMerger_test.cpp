@@ -146,6 +146,43 @@ START_SECTION((template < typename MapType > void mergeSpectraPrecursors(MapType
 
 END_SECTION
 
+START_SECTION([EXTRA] void mergeSpectraPrecursors(MapType &exp) with single and complete linkage)
+{
+  // chain of precursors: neighbors are within the RT tolerance, the first and the last one are not
+  PeakMap chain;
+  for (Size i = 0; i < 3; ++i)
+  {
+    MSSpectrum s;
+    s.setMSLevel(2);
+    s.setRT(4.0 * i);
+    Precursor pc;
+    pc.setMZ(500.0);
+    s.getPrecursors().push_back(pc);
+    s.push_back(Peak1D(100.0, 10.0f));
+    s.push_back(Peak1D(200.0 + i, 20.0f));
+    chain.addSpectrum(s);
+  }
+
+  SpectraMerger merger;
+  Param p = merger.getParameters();
+  p.setValue("precursor_method:rt_tolerance", 5.0);
+  p.setValue("precursor_method:mz_tolerance", 0.01);
+
+  // single linkage: all three spectra are merged
+  PeakMap exp = chain;
+  merger.setParameters(p);
+  merger.mergeSpectraPrecursors(exp);
+  TEST_EQUAL(exp.size(), 1)
+
+  // complete linkage: the last spectrum is too far from the first one
+  exp = chain;
+  p.setValue("precursor_method:linkage", "complete");
+  merger.setParameters(p);
+  merger.mergeSpectraPrecursors(exp);
+  TEST_EQUAL(exp.size(), 2)
+}
+END_SECTION
+
 START_SECTION((template < typename MapType > void averageGaussian(MapType &exp)))
 	PeakMap exp;
 	MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("SpectraMerger_input_3.mzML"), exp);    // profile mode
@@ -82,6 +82,30 @@ START_SECTION(SpectrumAccessSqMass(const OpenMS::Internal::MzMLSqliteHandler& ha
 }
 END_SECTION
 
+START_SECTION(SpectrumAccessSqMass(const OpenMS::Internal::MzMLSqliteHandler& handler, const std::vector<int> & indices, const SpectraRTIndexPtr& spectra_rt))
+{
+  OpenMS::Internal::MzMLSqliteHandler handler(OPENMS_GET_TEST_DATA_PATH("SqliteMassFile_1.sqMass"), 0);
+  SpectrumAccessSqMass::SpectraRTIndexPtr spectra_rt(
+    new std::vector<Internal::MzMLSqliteHandler::SpectrumRTEntry>(handler.getSpectraRTIndex()));
+
+  // several subsets share the meta data read once
+  SpectrumAccessSqMass all(handler, {}, spectra_rt);
+  SpectrumAccessSqMass second(handler, {1}, spectra_rt);
+  TEST_EQUAL(all.getNrSpectra(), 2)
+  TEST_EQUAL(second.getNrSpectra(), 1)
+  TEST_EQUAL(spectra_rt.use_count(), 3)
+
+  // same answers as reading the meta data in the constructor
+  SpectrumAccessSqMass reference(handler, {1});
+  TEST_EQUAL(second.getSpectrumMetaById(0).id, reference.getSpectrumMetaById(0).id)
+  TEST_REAL_SIMILAR(second.getSpectrumMetaById(0).RT, reference.getSpectrumMetaById(0).RT)
+  TEST_EQUAL(second.getSpectraByRT(0.296, 1.1) == reference.getSpectraByRT(0.296, 1.1), true)
+  TEST_EQUAL(second.getSpectrumById(0)->getMZArray()->data.size(), 19800)
+
+  TEST_EXCEPTION(Exception::IllegalArgument, SpectrumAccessSqMass(handler, {1}, SpectrumAccessSqMass::SpectraRTIndexPtr()))
+}
+END_SECTION
+
 START_SECTION(SpectrumAccessSqMass(const SpectrumAccessSqMass& sp, const std::vector<int>& indices))
 {
   OpenMS::Internal::MzMLSqliteHandler handler(OPENMS_GET_TEST_DATA_PATH("SqliteMassFile_1.sqMass"), 0);
@@ -249,6 +273,68 @@ START_SECTION(void getAllSpectra(std::vector< OpenSwath::SpectrumPtr > & spectra
 }
 END_SECTION
 
+START_SECTION(OpenSwath::SpectrumMeta getSpectrumMetaById(int id) const)
+{
+  OpenMS::Internal::MzMLSqliteHandler handler(OPENMS_GET_TEST_DATA_PATH("SqliteMassFile_1.sqMass"), 0);
+
+  SpectrumAccessSqMass sqmass(handler);
+  std::vector<MSSpectrum> exp;
+  handler.readSpectra(exp, {0, 1}, true);
+
+  OpenSwath::SpectrumMeta m = sqmass.getSpectrumMetaById(0);
+  TEST_REAL_SIMILAR(m.RT, 0.2961)
+  TEST_EQUAL(m.id, exp[0].getNativeID())
+  TEST_EQUAL(m.ms_level, exp[0].getMSLevel())
+  m = sqmass.getSpectrumMetaById(1);
+  TEST_REAL_SIMILAR(m.RT, 0.4738)
+  TEST_EQUAL(m.id, exp[1].getNativeID())
+
+  // subset: index 0 refers to the 2nd spectrum
+  SpectrumAccessSqMass sqmass_subset(handler, {1});
+  m = sqmass_subset.getSpectrumMetaById(0);
+  TEST_REAL_SIMILAR(m.RT, 0.4738)
+  TEST_EQUAL(m.id, exp[1].getNativeID())
+  TEST_EXCEPTION(Exception::IllegalArgument, sqmass_subset.getSpectrumMetaById(1))
+}
+END_SECTION
+
+START_SECTION(std::vector<std::size_t> getSpectraByRT(double RT, double deltaRT) const)
+{
+  OpenMS::Internal::MzMLSqliteHandler handler(OPENMS_GET_TEST_DATA_PATH("SqliteMassFile_1.sqMass"), 0);
+
+  SpectrumAccessSqMass sqmass(handler);
+  std::vector<std::size_t> res = sqmass.getSpectraByRT(0.4738, 0.1);
+  TEST_EQUAL(res.size(), 1)
+  TEST_EQUAL(res[0], 1)
+  res = sqmass.getSpectraByRT(0.296, 1.1);
+  TEST_EQUAL(res.size(), 2)
+  TEST_EQUAL(res[0], 0)
+  TEST_EQUAL(res[1], 1)
+  res = sqmass.getSpectraByRT(0.0, 0.1);
+  TEST_EQUAL(res.size(), 0)
+  // zero deltaRT returns the first spectrum after RT
+  res = sqmass.getSpectraByRT(0.3, 0.0);
+  TEST_EQUAL(res.size(), 1)
+  TEST_EQUAL(res[0], 1)
+  res = sqmass.getSpectraByRT(0.5, 0.0);
+  TEST_EQUAL(res.size(), 0)
+
+  // indices refer to the subset
+  SpectrumAccessSqMass sqmass_subset(handler, {1});
+  res = sqmass_subset.getSpectraByRT(0.296, 1.1);
+  TEST_EQUAL(res.size(), 1)
+  TEST_EQUAL(res[0], 0)
+  res = sqmass_subset.getSpectraByRT(0.296, 0.1);
+  TEST_EQUAL(res.size(), 0)
+
+  // same results for light clones
+  boost::shared_ptr<OpenSwath::ISpectrumAccess> clone = sqmass_subset.lightClone();
+  res = clone->getSpectraByRT(0.296, 1.1);
+  TEST_EQUAL(res.size(), 1)
+  TEST_EQUAL(res[0], 0)
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
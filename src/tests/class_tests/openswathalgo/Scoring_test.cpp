@@ -350,6 +350,38 @@ BOOST_AUTO_TEST_CASE(test_MRMFeatureScoring_normalizedCrossCorrelation)
 }
 END_SECTION
 
+BOOST_AUTO_TEST_CASE(test_MRMFeatureScoring_normalizedCrossCorrelationPost)
+//START_SECTION((XCorrArrayType normalizedCrossCorrelationPost(const std::vector<double>& normalized_data1, const std::vector<double>& normalized_data2, const int maxdelay, const int lag)))
+{
+  static const double arr1[] = {0,1,3,5,2,0};
+  static const double arr2[] = {1,3,5,2,0,0};
+  std::vector<double> data1 (arr1, arr1 + sizeof(arr1) / sizeof(arr1[0]) );
+  std::vector<double> data2 (arr2, arr2 + sizeof(arr2) / sizeof(arr2[0]) );
+
+  Scoring::standardize_data(data1);
+  Scoring::standardize_data(data2);
+
+  OpenSwath::Scoring::XCorrArrayType result = Scoring::normalizedCrossCorrelationPost(data1, data2, 2, 1);
+
+  TEST_REAL_SIMILAR (result.data[4].second, -0.7374631);  // .find( 2)
+  TEST_REAL_SIMILAR (result.data[3].second, -0.567846);   // .find( 1)
+  TEST_REAL_SIMILAR (result.data[2].second,  0.4159292);  // .find( 0)
+  TEST_REAL_SIMILAR (result.data[1].second,  0.8215339);  // .find(-1)
+  TEST_REAL_SIMILAR (result.data[0].second,  0.15634218); // .find(-2)
+
+  TEST_EQUAL (result.data[4].first, 2)
+  TEST_EQUAL (result.data[0].first, -2)
+
+  // identical to normalizing on the fly
+  std::vector<double> raw1 (arr1, arr1 + sizeof(arr1) / sizeof(arr1[0]) );
+  std::vector<double> raw2 (arr2, arr2 + sizeof(arr2) / sizeof(arr2[0]) );
+  OpenSwath::Scoring::XCorrArrayType result_raw = Scoring::normalizedCrossCorrelation(raw1, raw2, 6, 1);
+  result = Scoring::normalizedCrossCorrelationPost(data1, data2, 6, 1);
+  TEST_EQUAL (result.data.size(), 13)
+  TEST_EQUAL (result.data == result_raw.data, true)
+}
+END_SECTION
+
 BOOST_AUTO_TEST_CASE(test_MRMFeatureScoring_calcxcorr_legacy_mquest_)
 //START_SECTION((MRMFeatureScoring::XCorrArrayType MRMFeatureScoring::calcxcorr(std::vector<double>& data1, std::vector<double>& data2, bool normalize)))
 {
@@ -46,10 +46,18 @@
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/MATH/MISC/MathFunctions.h>
 #include <OpenMS/METADATA/PeptideIdentification.h>
+#include <OpenMS/SYSTEM/File.h>
 
+#include <QtCore/QDateTime>
+#include <QtCore/QFileInfo>
+
+#include <algorithm>
 #include <ctime>
+#include <exception>
+#include <fstream>
+#include <limits>
+#include <memory>
 #include <vector>
-#include <map>
 #include <cmath>
 using namespace OpenMS;
 using namespace std;
@@ -81,6 +89,9 @@ using namespace std;
 
     @note Currently mzIdentML (mzid) is not directly supported as an input/output format of this tool. Convert mzid files to/from idXML using @ref TOPP_IDFileConverter if necessary.
 
+    Library spectra are preprocessed once, sorted by precursor m/z and looked up by binary search. Query spectra are scored in parallel.
+    To skip parsing and preprocessing of large libraries in subsequent runs, the preprocessed library can be stored in (and loaded from) a binary cache file given via @p lib_cache.
+
     <B>The command line parameters of this tool are:</B>
     @verbinclude TOPP_SpecLibSearcher.cli
     <B>INI file documentation of this tool:</B>
@@ -109,6 +120,8 @@ protected:
     registerOutputFileList_("out", "<files>", ListUtils::create<String>(""), "Output files. Have to be as many as input files");
     setValidFormats_("out", ListUtils::create<String>("idXML"));
 
+    registerStringOption_("lib_cache", "<file>", "", "Binary cache of the preprocessed library. Loaded instead of 'lib' if it was created from the same library file and filter/modification settings, otherwise (re)created.", false, true);
+
     registerTOPPSubsection_("precursor", "Precursor (Parent Ion) Options");
     registerDoubleOption_("precursor:mass_tolerance", "<tolerance>", 10.0, "Width of precursor mass tolerance window", false);
 
@@ -163,15 +176,16 @@ protected:
     addEmptyLine_();
   }
 
-  using MapLibraryPrecursorToLibrarySpectrum = multimap<double, PeakSpectrum>;
-    
-  MapLibraryPrecursorToLibrarySpectrum annotateIdentificationsToSpectra_(const vector<PeptideIdentification>& ids, 
+  /// annotated library spectra, sorted by precursor m/z
+  using LibrarySpectra = vector<PeakSpectrum>;
+
+  LibrarySpectra annotateIdentificationsToSpectra_(const vector<PeptideIdentification>& ids, 
     const PeakMap& library, 
     StringList variable_modifications, 
     StringList fixed_modifications,
     double remove_peaks_below_threshold)
   {
-    MapLibraryPrecursorToLibrarySpectrum annotated_lib;
+    LibrarySpectra annotated_lib;
 
     ModificationsDB* mdb = ModificationsDB::getInstance();
 
@@ -182,7 +196,6 @@ protected:
     for (; library_it < library.end(); ++library_it, ++id_it)
     {
       const MSSpectrum& lib_spec = *library_it;
-      const double& precursor_MZ = lib_spec.getPrecursors()[0].getMZ();
 
       const PeptideIdentification& id = *id_it;
       const AASequence& aaseq = id.getHits()[0].getSequence();
@@ -263,11 +276,154 @@ protected:
            lib_entry.push_back(peak);
          }
        }
-       annotated_lib.insert(make_pair(precursor_MZ, lib_entry));
+       annotated_lib.push_back(lib_entry);
      }
+
+    // stable sort keeps library order for entries with identical precursor m/z
+    stable_sort(annotated_lib.begin(), annotated_lib.end(), [](const PeakSpectrum& a, const PeakSpectrum& b)
+      {
+        return a.getPrecursors()[0].getMZ() < b.getPrecursors()[0].getMZ();
+      });
     return annotated_lib;
   }
 
+  /// fingerprint of everything the preprocessed library depends on (used to validate the cache)
+  String libraryFingerprint_(const String& in_lib,
+    const StringList& variable_modifications,
+    const StringList& fixed_modifications,
+    double remove_peaks_below_threshold) const
+  {
+    QFileInfo fi(in_lib.toQString());
+    return File::absolutePath(in_lib) + "|" + String(fi.size()) + "|" + String(fi.lastModified().toString(Qt::ISODate)) + "|"
+      + String(remove_peaks_below_threshold) + "|" + ListUtils::concatenate(fixed_modifications, ",") + "|"
+      + ListUtils::concatenate(variable_modifications, ",");
+  }
+
+  /// store the preprocessed library in a binary cache file
+  void storeLibraryCache_(const String& filename, const String& fingerprint, const LibrarySpectra& lib) const
+  {
+    std::ofstream ofs(filename.c_str(), std::ios::binary);
+    if (!ofs)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+
+    UInt32 magic = LIBRARY_CACHE_MAGIC, version = LIBRARY_CACHE_VERSION;
+    ofs.write((char*)&magic, sizeof(magic));
+    ofs.write((char*)&version, sizeof(version));
+    writeString_(ofs, fingerprint);
+
+    UInt64 n_entries = lib.size();
+    ofs.write((char*)&n_entries, sizeof(n_entries));
+    for (const PeakSpectrum& entry : lib)
+    {
+      const PeptideHit& hit = entry.getPeptideIdentifications()[0].getHits()[0];
+      double precursor_mz = entry.getPrecursors()[0].getMZ();
+      Int charge = hit.getCharge();
+      ofs.write((char*)&precursor_mz, sizeof(precursor_mz));
+      ofs.write((char*)&charge, sizeof(charge));
+      writeString_(ofs, hit.getSequence().toString());
+
+      UInt64 n_peaks = entry.size();
+      ofs.write((char*)&n_peaks, sizeof(n_peaks));
+      for (const Peak1D& p : entry)
+      {
+        double mz = p.getMZ();
+        float intensity = p.getIntensity();
+        ofs.write((char*)&mz, sizeof(mz));
+        ofs.write((char*)&intensity, sizeof(intensity));
+      }
+    }
+
+    if (!ofs)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+  }
+
+  /**
+    @brief load the preprocessed library from a binary cache file
+
+    @return false if the file does not exist or was created from a different library or with different settings
+    @throw Exception::ParseError if the cache is truncated or corrupt
+  */
+  bool loadLibraryCache_(const String& filename, const String& fingerprint, LibrarySpectra& lib) const
+  {
+    std::ifstream ifs(filename.c_str(), std::ios::binary);
+    if (!ifs) { return false; }
+
+    UInt32 magic(0), version(0);
+    ifs.read((char*)&magic, sizeof(magic));
+    ifs.read((char*)&version, sizeof(version));
+    if (!ifs || magic != LIBRARY_CACHE_MAGIC || version != LIBRARY_CACHE_VERSION) { return false; }
+
+    String stored_fingerprint;
+    if (!readString_(ifs, stored_fingerprint) || stored_fingerprint != fingerprint) { return false; }
+
+    UInt64 n_entries(0);
+    ifs.read((char*)&n_entries, sizeof(n_entries));
+
+    LibrarySpectra tmp;
+    for (UInt64 i = 0; ifs && i < n_entries; ++i)
+    {
+      double precursor_mz(0);
+      Int charge(0);
+      String sequence;
+      UInt64 n_peaks(0);
+      ifs.read((char*)&precursor_mz, sizeof(precursor_mz));
+      ifs.read((char*)&charge, sizeof(charge));
+      if (!readString_(ifs, sequence)) { break; }
+      ifs.read((char*)&n_peaks, sizeof(n_peaks));
+      if (!ifs) { break; }
+
+      PeakSpectrum entry;
+      Precursor precursor;
+      precursor.setMZ(precursor_mz);
+      entry.getPrecursors().push_back(precursor);
+      PeptideIdentification id;
+      id.insertHit(PeptideHit(0, 0, charge, AASequence::fromString(sequence)));
+      entry.getPeptideIdentifications().push_back(id);
+
+      for (UInt64 k = 0; ifs && k < n_peaks; ++k)
+      {
+        double mz(0);
+        float intensity(0);
+        ifs.read((char*)&mz, sizeof(mz));
+        ifs.read((char*)&intensity, sizeof(intensity));
+        entry.push_back(Peak1D(mz, intensity));
+      }
+      tmp.push_back(std::move(entry));
+    }
+
+    if (!ifs || tmp.size() != n_entries)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename, "Spectral library cache is truncated or corrupt.");
+    }
+    lib.swap(tmp);
+    return true;
+  }
+
+  static void writeString_(std::ofstream& ofs, const String& s)
+  {
+    UInt64 size = s.size();
+    ofs.write((char*)&size, sizeof(size));
+    ofs.write(s.c_str(), size);
+  }
+
+  static bool readString_(std::ifstream& ifs, String& s)
+  {
+    UInt64 size(0);
+    ifs.read((char*)&size, sizeof(size));
+    // guard against reading garbage lengths from foreign files
+    if (!ifs || size > (1 << 24)) { return false; }
+    s.resize(size);
+    if (size > 0) { ifs.read(&s[0], size); }
+    return (bool)ifs;
+  }
+
+  static const UInt32 LIBRARY_CACHE_MAGIC = 0x534C4331; // "SLC1"
+  static const UInt32 LIBRARY_CACHE_VERSION = 1;
+
   ExitCodes main_(int, const char**) override
   {
     //-------------------------------------------------------------
@@ -276,6 +432,7 @@ protected:
     StringList in_spec = getStringList_("in");
     StringList out = getStringList_("out");
     String in_lib = getStringOption_("lib");
+    String lib_cache = getStringOption_("lib_cache");
     String compare_function = getStringOption_("compare_function");
  
     float precursor_mass_tolerance = getDoubleOption_("precursor:mass_tolerance");
@@ -328,42 +485,78 @@ protected:
     // building map for faster search
     // -------------------------------------------------------------
 
-    // library containing already identified peptide spectra
-    vector<PeptideIdentification> ids;
-    spectral_library.load(in_lib, ids, library);
-
-    /*
-    // Output bin histogram
-    BinnedSpectrum bin_frequency(0.01, 1, PeakSpectrum());
-    for (auto const & s : library)
+    // library containing already identified peptide spectra (sorted by precursor m/z)
+    LibrarySpectra mslib;
+    const String fingerprint = libraryFingerprint_(in_lib, variable_modifications, fixed_modifications, remove_peaks_below_threshold);
+    if (!lib_cache.empty() && loadLibraryCache_(lib_cache, fingerprint, mslib))
     {
-      BinnedSpectrum b(0.01, 1, s);
-      // e.g.: bin_frequency.getBins() += b.getBins();  // sum up itensities
-      // e.g.: bin_frequency.getBins() += b.getBins().coeffs().cwiseMin(1.0f); // count occupied bins (by truncating intensities >= 1 to 1)
+      OPENMS_LOG_INFO << "Loaded preprocessed library (" << mslib.size() << " spectra) from cache: " << lib_cache << "\n";
     }
+    else
+    {
+      vector<PeptideIdentification> ids;
+      spectral_library.load(in_lib, ids, library);
+
+      /*
+      // Output bin histogram
+      BinnedSpectrum bin_frequency(0.01, 1, PeakSpectrum());
+      for (auto const & s : library)
+      {
+        BinnedSpectrum b(0.01, 1, s);
+        // e.g.: bin_frequency.getBins() += b.getBins();  // sum up itensities
+        // e.g.: bin_frequency.getBins() += b.getBins().coeffs().cwiseMin(1.0f); // count occupied bins (by truncating intensities >= 1 to 1)
+      }
 
-    for (BinnedSpectrum::SparseVectorIteratorType it(bin_frequency.getBins()); it; ++it)
+      for (BinnedSpectrum::SparseVectorIteratorType it(bin_frequency.getBins()); it; ++it)
+      {
+        // output m/z of bin start and average bin intensity
+        cout << it.index() * bin_frequency.getBinSize()  << "\t" << static_cast<float>(it.value()/library.size()) << "\n";
+        cout << static_cast<float>(it.value()) << "\n";
+        cout << static_cast<float>(library.size()) << "\n";
+      }
+      cout << endl;
+      */
+
+      mslib = annotateIdentificationsToSpectra_(ids, library, variable_modifications, fixed_modifications, remove_peaks_below_threshold);
+      library.clear(true);
+
+      if (!lib_cache.empty())
+      {
+        storeLibraryCache_(lib_cache, fingerprint, mslib);
+        OPENMS_LOG_INFO << "Stored preprocessed library in cache: " << lib_cache << "\n";
+      }
+    }
+
+    //compare function
+    PeakSpectrumCompareFunctor* comparor = Factory<PeakSpectrumCompareFunctor>::create(compare_function);
+    const bool spectrast_score = compare_function == "SpectraSTSimilarityScore";
+
+    // precursor m/z of the (sorted) library entries for binary search of the precursor window
+    vector<double> lib_precursor_mz;
+    lib_precursor_mz.reserve(mslib.size());
+    for (const PeakSpectrum& lib_spec : mslib)
     {
-      // output m/z of bin start and average bin intensity
-      cout << it.index() * bin_frequency.getBinSize()  << "\t" << static_cast<float>(it.value()/library.size()) << "\n";
-      cout << static_cast<float>(it.value()) << "\n";
-      cout << static_cast<float>(library.size()) << "\n";
+      lib_precursor_mz.push_back(lib_spec.getPrecursors()[0].getMZ());
     }
-    cout << endl;
-    */
 
-    MapLibraryPrecursorToLibrarySpectrum mslib = annotateIdentificationsToSpectra_(ids, library, variable_modifications, fixed_modifications, remove_peaks_below_threshold);
+    // SpectraST compares binned and normalized spectra: bin each library entry once instead of once per comparison
+    vector<BinnedSpectrum> lib_binned;
+    if (spectrast_score)
+    {
+      SpectraSTSimilarityScore* sp = static_cast<SpectraSTSimilarityScore*>(comparor);
+      lib_binned.reserve(mslib.size());
+      for (const PeakSpectrum& lib_spec : mslib)
+      {
+        lib_binned.push_back(sp->transform(lib_spec));
+      }
+    }
 
     time_t end_build_time = time(nullptr);
     OPENMS_LOG_INFO << "Time needed for preprocessing data: " << (end_build_time - start_build_time) << "\n";
-
-    //compare function
-    PeakSpectrumCompareFunctor* comparor = Factory<PeakSpectrumCompareFunctor>::create(compare_function);
  
    //-------------------------------------------------------------
     // calculations
     //-------------------------------------------------------------
-    double score;
     StringList::iterator in, out_file;
     for (in  = in_spec.begin(), out_file  = out.begin(); in < in_spec.end(); ++in, ++out_file)
     {
@@ -401,181 +594,218 @@ protected:
 
 
       /***********SEARCH**********/
-      for (UInt j = 0; j < query.size(); ++j)
-      {
-        //Set identifier for each identifications
-        PeptideIdentification pid;
-        pid.setIdentifier("test");
-        pid.setScoreType(compare_function);
-        ProteinHit pr_hit;
-        pr_hit.setAccession(j);
-        prot_id.insertHit(pr_hit);
-
-        // proper MS2?
-        if (query[j].empty() || query[j].getMSLevel() != 2) {continue; }
+      // query spectra are searched independently (in parallel), results are collected in input order
+      vector<PeptideIdentification> query_ids(query.size());
+      vector<char> query_reported(query.size(), 0);
 
-        if (query[j].getPrecursors().empty())
-        {
-          writeLog_("Warning MS2 spectrum without precursor information");
-          continue;
-        }
+      Size error_idx = numeric_limits<Size>::max();
+      std::exception_ptr error;
 
-        // filter query spectrum
-        double max_intensity = std::max_element(query[j].begin(), query[j].end(), 
-                                [](const Peak1D& l, const Peak1D& r) 
-                                { 
-                                  return (l.getIntensity() < r.getIntensity()); 
-                                })->getIntensity();
-
-        double min_high_intensity = max_intensity / cut_peaks_below;
+#pragma omp parallel
+      {
+        // compare functors may keep state between calls (e.g. SpectrumCheapDPCorr), so each thread uses its own
+        std::unique_ptr<PeakSpectrumCompareFunctor> local_comparor(Factory<PeakSpectrumCompareFunctor>::create(compare_function));
 
-        PeakSpectrum filtered_query;
-        for (UInt k = 0; k < query[j].size(); ++k)
+#pragma omp for schedule(dynamic, 10)
+        for (SignedSize j = 0; j < (SignedSize)query.size(); ++j)
         {
-          if (query[j][k].getIntensity() >= remove_peaks_below_threshold 
-           && query[j][k].getIntensity() >= min_high_intensity)
+          try
           {
-            Peak1D peak;
-            peak.setIntensity(sqrt(query[j][k].getIntensity()));
-            peak.setMZ(query[j][k].getMZ());
-            filtered_query.push_back(peak);
-          }
-        }
-
-        // retain only top N peaks
-        if (filtered_query.size() > max_peaks)
-        {
-          filtered_query.sortByIntensity(true);
-          filtered_query.resize(max_peaks);
-          filtered_query.sortByPosition();
-        }
-
-        if (filtered_query.size() < min_peaks) { continue; }
+            //Set identifier for each identifications
+            PeptideIdentification& pid = query_ids[j];
+            pid.setIdentifier("test");
+            pid.setScoreType(compare_function);
+            const String accession(j);
 
-        const double& query_rt = query[j].getRT();
-        const int& query_charge = query[j].getPrecursors()[0].getCharge();
-        const double query_mz = query[j].getPrecursors()[0].getMZ();
-        
-        if (query_charge > 0 && (query_charge < pc_min_charge || query_charge > pc_max_charge)) { continue; } 
+            // proper MS2?
+            if (query[j].empty() || query[j].getMSLevel() != 2) {continue; }
 
-        for (auto const & iso : isotopes)
-        {
-          // isotopic misassignment corrected query
-          const double ic_query_mz = query_mz - iso * Constants::C13C12_MASSDIFF_U;
+            if (query[j].getPrecursors().empty())
+            {
+#pragma omp critical (SpecLibSearcher_log)
+              writeLog_("Warning MS2 spectrum without precursor information");
+              continue;
+            }
 
-          // if tolerance unit is ppm convert to m/z
-          const double precursor_mass_tolerance_mz = precursor_mass_tolerance_unit_ppm ? ic_query_mz * precursor_mass_tolerance * 1e-6 : precursor_mass_tolerance;
+            // filter query spectrum
+            double max_intensity = std::max_element(query[j].begin(), query[j].end(), 
+                                    [](const Peak1D& l, const Peak1D& r) 
+                                    { 
+                                      return (l.getIntensity() < r.getIntensity()); 
+                                    })->getIntensity();
 
-          // skip matching of isotopic misassignments if charge not annotated
-          if (iso != 0 && query_charge == 0) { continue; }
+            double min_high_intensity = max_intensity / cut_peaks_below;
 
-          // skip matching of isotopic misassignments if search windows around isotopic peaks would overlap (resulting in more than one report of the same hit)
-          const double isotopic_peak_distance_mz = Constants::C13C12_MASSDIFF_U / query_charge;
-          if (iso != 0 && precursor_mass_tolerance_mz >= 0.5 * isotopic_peak_distance_mz) { continue; }
+            PeakSpectrum filtered_query;
+            for (UInt k = 0; k < query[j].size(); ++k)
+            {
+              if (query[j][k].getIntensity() >= remove_peaks_below_threshold 
+               && query[j][k].getIntensity() >= min_high_intensity)
+              {
+                Peak1D peak;
+                peak.setIntensity(sqrt(query[j][k].getIntensity()));
+                peak.setMZ(query[j][k].getMZ());
+                filtered_query.push_back(peak);
+              }
+            }
 
-          /* TODO: remove old code for charge estimation?
-          bool charge_one = false;
-          Int percent = (Int) Math::round((query[j].size() / 100.0) * 3.0);
-          Int margin  = (Int) Math::round((query[j].size() / 100.0) * 1.0);
-          for (vector<Peak1D>::iterator peak = query[j].end() - 1; percent >= 0; --peak, --percent)
-          {
-            if (peak->getMZ() < query_MZ)
+            // retain only top N peaks
+            if (filtered_query.size() > max_peaks)
             {
-              break;
+              filtered_query.sortByIntensity(true);
+              filtered_query.resize(max_peaks);
+              filtered_query.sortByPosition();
             }
-          }
-          if (percent > margin)
-          {
-            charge_one = true;
-          }
-          */
 
+            if (filtered_query.size() < min_peaks) { continue; }
 
-          // determine MS2 precursors that match to the current peptide mass
-          MapLibraryPrecursorToLibrarySpectrum::const_iterator low_it, up_it;
-        
-          low_it = mslib.lower_bound(ic_query_mz - 0.5 * precursor_mass_tolerance_mz);
-          up_it = mslib.upper_bound(ic_query_mz + 0.5 * precursor_mass_tolerance_mz);
+            const double& query_rt = query[j].getRT();
+            const int& query_charge = query[j].getPrecursors()[0].getCharge();
+            const double query_mz = query[j].getPrecursors()[0].getMZ();
         
-          // no matching precursor in data
-          if (low_it == up_it) { continue; }
-       
-          for (; low_it != up_it; ++low_it)
-          {
-            const PeakSpectrum& lib_spec = low_it->second;;
-            PeptideHit hit = lib_spec.getPeptideIdentifications()[0].getHits()[0];
-            const int& lib_charge = hit.getCharge();  
-
-            // check if charge state between library and experimental spectrum match
-            if (query_charge > 0 && lib_charge != query_charge) { continue; }
+            if (query_charge > 0 && (query_charge < pc_min_charge || query_charge > pc_max_charge)) { continue; } 
 
-            // Special treatment for SpectraST score as it computes a score based on the whole library
-            if (compare_function == "SpectraSTSimilarityScore")
+            // SpectraST: bin and normalize the query once for all library candidates
+            BinnedSpectrum query_binned;
+            if (spectrast_score)
             {
-              SpectraSTSimilarityScore* sp = static_cast<SpectraSTSimilarityScore*>(comparor);
-              BinnedSpectrum quer_bin_spec = sp->transform(filtered_query);
-              BinnedSpectrum lib_bin_spec = sp->transform(lib_spec);
-              score = (*sp)(filtered_query, lib_spec); //(*sp)(quer_bin,librar_bin);
-              double dot_bias = sp->dot_bias(quer_bin_spec, lib_bin_spec, score);
-              hit.setMetaValue("DOTBIAS", dot_bias);
+              query_binned = static_cast<SpectraSTSimilarityScore*>(local_comparor.get())->transform(filtered_query);
             }
-            else
+
+            for (auto const & iso : isotopes)
             {
-              score = (*comparor)(filtered_query, lib_spec);
-            }
+              // isotopic misassignment corrected query
+              const double ic_query_mz = query_mz - iso * Constants::C13C12_MASSDIFF_U;
 
-            DataValue RT(lib_spec.getRT());
-            DataValue MZ(lib_spec.getPrecursors()[0].getMZ());
-            hit.setMetaValue("lib:RT", RT);
-            hit.setMetaValue("lib:MZ", MZ);
-            hit.setMetaValue(Constants::UserParam::ISOTOPE_ERROR, iso);
-            hit.setScore(score);
-            PeptideEvidence pe;
-            pe.setProteinAccession(pr_hit.getAccession());
-            hit.addPeptideEvidence(pe);
-            pid.insertHit(hit);
-          }
-        }
+              // if tolerance unit is ppm convert to m/z
+              const double precursor_mass_tolerance_mz = precursor_mass_tolerance_unit_ppm ? ic_query_mz * precursor_mass_tolerance * 1e-6 : precursor_mass_tolerance;
 
-        pid.setHigherScoreBetter(true);
-        pid.sort();
+              // skip matching of isotopic misassignments if charge not annotated
+              if (iso != 0 && query_charge == 0) { continue; }
 
-        if (compare_function == "SpectraSTSimilarityScore")
-        {
-          if (!pid.empty() && !pid.getHits().empty())
-          {
-            vector<PeptideHit> final_hits;
-            final_hits.resize(pid.getHits().size());
-            SpectraSTSimilarityScore* sp = static_cast<SpectraSTSimilarityScore*>(comparor);
-            Size runner_up = 1;
-            for (; runner_up < pid.getHits().size(); ++runner_up)
+              // skip matching of isotopic misassignments if search windows around isotopic peaks would overlap (resulting in more than one report of the same hit)
+              const double isotopic_peak_distance_mz = Constants::C13C12_MASSDIFF_U / query_charge;
+              if (iso != 0 && precursor_mass_tolerance_mz >= 0.5 * isotopic_peak_distance_mz) { continue; }
+
+              /* TODO: remove old code for charge estimation?
+              bool charge_one = false;
+              Int percent = (Int) Math::round((query[j].size() / 100.0) * 3.0);
+              Int margin  = (Int) Math::round((query[j].size() / 100.0) * 1.0);
+              for (vector<Peak1D>::iterator peak = query[j].end() - 1; percent >= 0; --peak, --percent)
+              {
+                if (peak->getMZ() < query_MZ)
+                {
+                  break;
+                }
+              }
+              if (percent > margin)
+              {
+                charge_one = true;
+              }
+              */
+
+
+              // determine MS2 precursors that match to the current peptide mass
+              const Size low = lower_bound(lib_precursor_mz.begin(), lib_precursor_mz.end(), ic_query_mz - 0.5 * precursor_mass_tolerance_mz) - lib_precursor_mz.begin();
+              const Size up = upper_bound(lib_precursor_mz.begin(), lib_precursor_mz.end(), ic_query_mz + 0.5 * precursor_mass_tolerance_mz) - lib_precursor_mz.begin();
+
+              for (Size l = low; l < up; ++l)
+              {
+                const PeakSpectrum& lib_spec = mslib[l];
+                PeptideHit hit = lib_spec.getPeptideIdentifications()[0].getHits()[0];
+                const int& lib_charge = hit.getCharge();  
+
+                // check if charge state between library and experimental spectrum match
+                if (query_charge > 0 && lib_charge != query_charge) { continue; }
+
+                // Special treatment for SpectraST score as it computes a score based on the whole library
+                double score;
+                if (spectrast_score)
+                {
+                  const SpectraSTSimilarityScore* sp = static_cast<const SpectraSTSimilarityScore*>(local_comparor.get());
+                  score = (*sp)(query_binned, lib_binned[l]);
+                  double dot_bias = sp->dot_bias(query_binned, lib_binned[l], score);
+                  hit.setMetaValue("DOTBIAS", dot_bias);
+                }
+                else
+                {
+                  score = (*local_comparor)(filtered_query, lib_spec);
+                }
+
+                DataValue RT(lib_spec.getRT());
+                DataValue MZ(lib_spec.getPrecursors()[0].getMZ());
+                hit.setMetaValue("lib:RT", RT);
+                hit.setMetaValue("lib:MZ", MZ);
+                hit.setMetaValue(Constants::UserParam::ISOTOPE_ERROR, iso);
+                hit.setScore(score);
+                PeptideEvidence pe;
+                pe.setProteinAccession(accession);
+                hit.addPeptideEvidence(pe);
+                pid.insertHit(hit);
+              }
+            }
+
+            pid.setHigherScoreBetter(true);
+            pid.sort();
+
+            if (spectrast_score)
             {
-              if (pid.getHits()[0].getSequence().toUnmodifiedString() != pid.getHits()[runner_up].getSequence().toUnmodifiedString() 
-               || runner_up > 5)
+              if (!pid.empty() && !pid.getHits().empty())
               {
-                break;
+                vector<PeptideHit> final_hits;
+                final_hits.resize(pid.getHits().size());
+                SpectraSTSimilarityScore* sp = static_cast<SpectraSTSimilarityScore*>(local_comparor.get());
+                Size runner_up = 1;
+                for (; runner_up < pid.getHits().size(); ++runner_up)
+                {
+                  if (pid.getHits()[0].getSequence().toUnmodifiedString() != pid.getHits()[runner_up].getSequence().toUnmodifiedString() 
+                   || runner_up > 5)
+                  {
+                    break;
+                  }
+                }
+                double delta_D = sp->delta_D(pid.getHits()[0].getScore(), pid.getHits()[runner_up].getScore());
+                for (Size s = 0; s < pid.getHits().size(); ++s)
+                {
+                  final_hits[s] = pid.getHits()[s];
+                  final_hits[s].setMetaValue("delta D", delta_D);
+                  final_hits[s].setMetaValue("dot product", pid.getHits()[s].getScore());
+                  final_hits[s].setScore(sp->compute_F(pid.getHits()[s].getScore(), delta_D, pid.getHits()[s].getMetaValue("DOTBIAS")));
+                }
+                pid.setHits(final_hits);
+                pid.sort();
+                pid.setMZ(query[j].getPrecursors()[0].getMZ());
+                pid.setRT(query_rt);
               }
             }
-            double delta_D = sp->delta_D(pid.getHits()[0].getScore(), pid.getHits()[runner_up].getScore());
-            for (Size s = 0; s < pid.getHits().size(); ++s)
+
+            if (top_hits != -1 && (UInt)top_hits < pid.getHits().size())
             {
-              final_hits[s] = pid.getHits()[s];
-              final_hits[s].setMetaValue("delta D", delta_D);
-              final_hits[s].setMetaValue("dot product", pid.getHits()[s].getScore());
-              final_hits[s].setScore(sp->compute_F(pid.getHits()[s].getScore(), delta_D, pid.getHits()[s].getMetaValue("DOTBIAS")));
+              pid.getHits().resize(top_hits);
+            }
+            query_reported[j] = 1;
+          }
+          catch (...)
+          {
+#pragma omp critical (SpecLibSearcher_error)
+            {
+              if ((Size)j < error_idx)
+              {
+                error_idx = j;
+                error = std::current_exception();
+              }
             }
-            pid.setHits(final_hits);
-            pid.sort();
-            pid.setMZ(query[j].getPrecursors()[0].getMZ());
-            pid.setRT(query_rt);
           }
         }
+      }
+      if (error) std::rethrow_exception(error);
 
-        if (top_hits != -1 && (UInt)top_hits < pid.getHits().size())
-        {
-          pid.getHits().resize(top_hits);
-        }
-        peptide_ids.push_back(pid);
+      for (Size j = 0; j < query.size(); ++j)
+      {
+        ProteinHit pr_hit;
+        pr_hit.setAccession(j);
+        prot_id.insertHit(pr_hit);
+        if (query_reported[j]) { peptide_ids.push_back(query_ids[j]); }
       }
       protein_ids.push_back(prot_id);
 